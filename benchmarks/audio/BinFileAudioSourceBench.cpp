@@ -0,0 +1,89 @@
+//
+// Created by Robert on 2025-11-01.
+//
+
+#include <benchmark/benchmark.h>
+#include "../../src/audio/BinFileAudioSource.h"
+#include "../../src/core/CopySink.h"
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <vector>
+
+using namespace bpmfinder::audio;
+
+namespace
+{
+    class FirstChunkSink : public bpmfinder::core::CopySink<AudioChunk>
+    {
+    public:
+        void Process(AudioChunk) override { received = true; }
+        std::atomic<bool> received{false};
+    };
+
+    // Recordings of the given size in MB, written once and shared by all benchmarks
+    std::string GetRecording(const int64_t megabytes)
+    {
+        const auto path = std::filesystem::temp_directory_path() /
+            ("bpm_finder_bench_" + std::to_string(megabytes) + "mb.bin");
+        const auto size = static_cast<uintmax_t>(megabytes) * 1024 * 1024;
+        if (!std::filesystem::exists(path) || std::filesystem::file_size(path) != size)
+        {
+            const std::vector<float> block(1024 * 1024 / sizeof(float), 0.25f);
+            std::ofstream file(path, std::ios::binary);
+            for (int64_t i = 0; i < megabytes; ++i)
+            {
+                file.write(reinterpret_cast<const char*>(block.data()), 1024 * 1024);
+            }
+        }
+        return path.string();
+    }
+}
+
+// Time from Initialize until the first chunk arrives at a subscriber: should not depend on the file size
+static void BM_BinFileAudioSourceTimeToFirstChunk(benchmark::State& state)
+{
+    const auto mode = static_cast<BinFileReadMode>(state.range(0));
+    const auto filename = GetRecording(state.range(1));
+
+    for (auto _ : state)
+    {
+        BinFileAudioSource source(filename, 1024, mode);
+        FirstChunkSink sink;
+        source.Subscribe(&sink);
+        sink.Start();
+
+        source.Initialize();
+        source.Start();
+        while (!sink.received)
+        {
+            std::this_thread::yield();
+        }
+
+        state.PauseTiming();
+        source.Stop();
+        sink.Stop();
+        state.ResumeTiming();
+    }
+}
+
+// What the source did before: read the whole file into memory first
+static void BM_ReadWholeFile(benchmark::State& state)
+{
+    const auto filename = GetRecording(state.range(0));
+    for (auto _ : state)
+    {
+        std::vector<float> samples;
+        BinFileAudioSource::ReadSamples(filename, samples);
+        benchmark::DoNotOptimize(samples.data());
+    }
+}
+
+BENCHMARK(BM_BinFileAudioSourceTimeToFirstChunk)
+    ->ArgsProduct({
+        {static_cast<int64_t>(BinFileReadMode::MemoryMapped), static_cast<int64_t>(BinFileReadMode::Streaming)},
+        {16, 256}
+    })
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_ReadWholeFile)->Arg(16)->Arg(256)->Unit(benchmark::kMillisecond);
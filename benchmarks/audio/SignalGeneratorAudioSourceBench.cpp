@@ -0,0 +1,67 @@
+//
+// Created by Robert on 2025-11-07.
+//
+
+#include <benchmark/benchmark.h>
+#include "../../src/audio/SignalGeneratorAudioSource.h"
+#include "../../src/dsp/time_domain_onset_detection/TimeDomainOnsetDetectionDspPipeline.h"
+#include <chrono>
+#include <vector>
+
+using namespace bpmfinder::audio;
+using namespace bpmfinder::dsp::time_domain_onset_detection;
+
+// One chunk per iteration: clicks only (0), clicks in white noise (1), clicks in band-limited noise (2).
+// Has to be far faster than the pipeline, so it never is the bottleneck of a throughput measurement.
+static void BM_SignalGenerator(benchmark::State& state)
+{
+    SignalGeneratorOptions options;
+    if (state.range(0) > 0)
+    {
+        options.snrDb = 10.0f;
+    }
+    if (state.range(0) > 1)
+    {
+        options.noiseLowCutoff = 40.0f;
+        options.noiseHighCutoff = 800.0f;
+    }
+    SignalGenerator generator(options);
+    std::vector<float> chunk(1024);
+
+    for (auto _ : state)
+    {
+        generator.Generate(chunk.data(), chunk.size());
+        benchmark::DoNotOptimize(chunk.data());
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * chunk.size()));
+}
+
+// The whole live pipeline fed flat-out with 'range(0)' seconds of a click track, with backpressure.
+// 'realtime_factor' is how many times faster than real time the pipeline runs.
+static void BM_PipelineFlatOut(benchmark::State& state)
+{
+    TimeDomainOnsetDetectionConfig config;
+    SignalGeneratorOptions options;
+    options.sampleRate = config.sampleRate;
+    options.durationSeconds = static_cast<double>(state.range(0));
+    options.snrDb = 10.0f;
+
+    for (auto _ : state)
+    {
+        SignalGeneratorAudioSource source(options, config.chunkSize);
+        source.Initialize();
+        TimeDomainOnsetDetectionDspPipeline pipeline(source, config, 16, "");
+
+        pipeline.Start();
+        pipeline.WaitUntilFinished(std::chrono::minutes(5));
+        benchmark::DoNotOptimize(pipeline.GetCurrentBpm());
+    }
+
+    state.counters["realtime_factor"] = benchmark::Counter(options.durationSeconds,
+                                                           benchmark::Counter::kIsIterationInvariantRate);
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * state.range(0) * options.sampleRate);
+}
+
+BENCHMARK(BM_SignalGenerator)->DenseRange(0, 2)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_PipelineFlatOut)->Arg(60)->Unit(benchmark::kMillisecond)->UseRealTime();
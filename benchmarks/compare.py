@@ -0,0 +1,97 @@
+"""Compares two JSON results of bpm-finder-bench and fails on regressions.
+
+    bpm-finder-bench --benchmark_out=before.json --benchmark_out_format=json --benchmark_repetitions=5
+    ...
+    python3 benchmarks/compare.py before.json after.json [--threshold 5] [--metric cpu_time] [--filter Stage]
+
+With repetitions the medians are compared, otherwise the single runs. Exits with 1 if any benchmark got slower by
+more than the threshold (percent), with 2 if the files have no benchmark in common.
+"""
+
+import argparse
+import json
+import re
+import statistics
+import sys
+
+TIME_UNITS = {'ns': 1.0, 'us': 1e3, 'ms': 1e6, 's': 1e9}
+
+
+def load(filename, metric):
+    """Nanoseconds per iteration by benchmark name: the median aggregate if there is one, else the median of the
+    runs."""
+    with open(filename) as file:
+        data = json.load(file)
+
+    runs = {}
+    medians = {}
+    for benchmark in data.get('benchmarks', []):
+        if benchmark.get('error_occurred'):
+            continue
+        name = benchmark.get('run_name', benchmark['name'])
+        value = benchmark[metric] * TIME_UNITS[benchmark.get('time_unit', 'ns')]
+        if benchmark.get('run_type') == 'aggregate':
+            if benchmark.get('aggregate_name') == 'median':
+                medians[name] = value
+        else:
+            runs.setdefault(name, []).append(value)
+
+    results = {name: statistics.median(values) for name, values in runs.items()}
+    results.update(medians)
+    return results, data.get('context', {})
+
+
+def format_time(nanoseconds):
+    for unit, scale in (('s', 1e9), ('ms', 1e6), ('us', 1e3)):
+        if nanoseconds >= scale:
+            return f'{nanoseconds / scale:.3f} {unit}'
+    return f'{nanoseconds:.1f} ns'
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument('baseline')
+    parser.add_argument('contender')
+    parser.add_argument('--metric', choices=('real_time', 'cpu_time'), default='real_time')
+    parser.add_argument('--threshold', type=float, default=5.0, help='Percent slower that counts as a regression')
+    parser.add_argument('--filter', default='', help='Only benchmarks whose name matches this regular expression')
+    args = parser.parse_args()
+
+    baseline, baseline_context = load(args.baseline, args.metric)
+    contender, contender_context = load(args.contender, args.metric)
+    pattern = re.compile(args.filter)
+    names = [name for name in baseline if name in contender and pattern.search(name)]
+    if not names:
+        print('No benchmarks in common', file=sys.stderr)
+        return 2
+
+    for key in ('host_name', 'num_cpus', 'mhz_per_cpu', 'library_build_type'):
+        if baseline_context.get(key) != contender_context.get(key):
+            print(f'Note: {key} differs: {baseline_context.get(key)} / {contender_context.get(key)}')
+
+    width = max(len(name) for name in names)
+    print(f'{"Benchmark":<{width}}  {"Baseline":>12}  {"Contender":>12}  {"Change":>8}')
+    regressions = []
+    for name in names:
+        before, after = baseline[name], contender[name]
+        change = (after - before) / before * 100.0 if before > 0 else 0.0
+        marker = ''
+        if change > args.threshold:
+            marker = '  REGRESSION'
+            regressions.append(name)
+        elif change < -args.threshold:
+            marker = '  faster'
+        print(f'{name:<{width}}  {format_time(before):>12}  {format_time(after):>12}  {change:>+7.1f}%{marker}')
+
+    for name in sorted(set(baseline) ^ set(contender)):
+        if pattern.search(name):
+            print(f'Only in {"baseline" if name in baseline else "contender"}: {name}')
+
+    if regressions:
+        print(f'{len(regressions)} of {len(names)} benchmarks slower by more than {args.threshold:g}%')
+        return 1
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,122 @@
+//
+// Created by Robert on 2025-11-16.
+//
+
+#include <benchmark/benchmark.h>
+#include "../../src/core/CopyStage.h"
+#include "../../src/dsp/time_domain_onset_detection/TimeDomainOnsetDetectionResult.h"
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace bpmfinder::core;
+using namespace bpmfinder::dsp::time_domain_onset_detection;
+
+namespace
+{
+    using Result = TimeDomainOnsetDetectionResult;
+
+    constexpr size_t ChunkSize = 1024;
+    constexpr size_t QueueCapacity = 16; // What the app gives every stage
+
+    Result CreateResult()
+    {
+        Result result(0, bpmfinder::audio::AudioChunk(ChunkSize, 0.25f), 48000, ChunkSize, 40, 800, 1.0f);
+        result.bandPassFiltered = bpmfinder::audio::AudioChunk(ChunkSize, 0.125f);
+        return result;
+    }
+
+    // PushData and the pop of the worker thread on one thread, without waiting: the cost of the queue itself
+    class QueueOnly : public CopyObserver<Result>
+    {
+    public:
+        void Pop()
+        {
+            Result data = std::move(queue_.front());
+            queue_.pop();
+            benchmark::DoNotOptimize(data.rawAudio.data());
+        }
+    };
+
+    // Passes every result on, like a stage that does nothing
+    class ForwardStage final : public CopyStage<Result, Result>
+    {
+    protected:
+        void Process(Result data) override { Notify(data); }
+    };
+
+    class CountingSink final : public CopySink<Result>
+    {
+    public:
+        void Process(Result) override { received.fetch_add(1, std::memory_order_release); }
+        std::atomic<size_t> received{0};
+    };
+}
+
+static void BM_CopyObserverPushPop(benchmark::State& state)
+{
+    const Result result = CreateResult();
+    QueueOnly observer;
+    for (auto _ : state)
+    {
+        observer.PushData(result);
+        observer.Pop();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// Results through a chain of 'range(0)' forwarding stages into a sink, each on its own thread with a bounded queue
+// like in the pipeline. One iteration pushes a batch and waits until the sink has all of it; items are chunk hops,
+// so the time per item is the cost of one hop between two threads.
+static void BM_CopyStageHops(benchmark::State& state)
+{
+    constexpr size_t BatchSize = 256;
+    const auto hops = static_cast<size_t>(state.range(0));
+    const Result result = CreateResult();
+
+    std::vector<std::unique_ptr<ForwardStage>> stages;
+    for (size_t i = 0; i < hops; ++i)
+    {
+        stages.push_back(std::make_unique<ForwardStage>());
+        stages.back()->SetCapacity(QueueCapacity);
+        if (i > 0)
+        {
+            stages[i - 1]->Subscribe(stages.back().get());
+        }
+    }
+    CountingSink sink;
+    sink.SetCapacity(QueueCapacity);
+    stages.back()->Subscribe(&sink);
+
+    sink.Start();
+    for (const auto& stage : stages)
+    {
+        stage->Start();
+    }
+
+    size_t expected = 0;
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < BatchSize; ++i)
+        {
+            stages.front()->PushData(result);
+        }
+        expected += BatchSize;
+        while (sink.received.load(std::memory_order_acquire) < expected)
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    for (const auto& stage : stages)
+    {
+        stage->Stop();
+    }
+    sink.Stop();
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * BatchSize * (hops + 1)));
+}
+
+BENCHMARK(BM_CopyObserverPushPop);
+BENCHMARK(BM_CopyStageHops)->Arg(1)->Arg(8)->UseRealTime()->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,54 @@
+//
+// Created by Robert on 2025-11-16.
+//
+
+#include <benchmark/benchmark.h>
+#include "../../src/core/Seqlock.h"
+#include "../../src/dsp/time_domain_onset_detection/BpmSnapshot.h"
+#include <atomic>
+#include <thread>
+
+using namespace bpmfinder::core;
+using bpmfinder::dsp::time_domain_onset_detection::BpmSnapshot;
+
+// What the BpmCalculationStage pays per estimate
+static void BM_SeqlockStore(benchmark::State& state)
+{
+    Seqlock<BpmSnapshot> seqlock;
+    BpmSnapshot snapshot;
+    for (auto _ : state)
+    {
+        ++snapshot.chunkIndex;
+        seqlock.Store(snapshot);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// GetCurrentBpm from a GUI or the app, without (0) and with (1) a thread that stores all the time: the worst case,
+// the stage stores about 50 times per second
+static void BM_SeqlockLoad(benchmark::State& state)
+{
+    Seqlock<BpmSnapshot> seqlock;
+    std::atomic<bool> storing{state.range(0) != 0};
+    std::thread writer([&]
+    {
+        BpmSnapshot snapshot;
+        while (storing.load(std::memory_order_relaxed))
+        {
+            ++snapshot.chunkIndex;
+            seqlock.Store(snapshot);
+        }
+    });
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(seqlock.Load());
+    }
+
+    storing = false;
+    writer.join();
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_SeqlockStore);
+BENCHMARK(BM_SeqlockLoad)->Arg(0)->Arg(1)->UseRealTime();
@@ -0,0 +1,53 @@
+//
+// Created by Robert on 2025-10-28.
+//
+
+#include <benchmark/benchmark.h>
+#include "../../src/dsp/time_domain_onset_detection/MultiStreamOnsetDetectionEngine.h"
+#include "../../src/dsp/time_domain_onset_detection/TempoEstimation.h"
+#include <numeric>
+#include <random>
+#include <vector>
+
+using namespace bpmfinder::dsp::time_domain_onset_detection;
+
+// One chunk of every stream per iteration. The sliding window is pre-filled, so the tempo estimation runs on every
+// chunk just like it does in steady state.
+// 'realtime_streams' is the number of streams one core keeps up with in real time.
+static void BM_MultiStreamOnsetDetectionEngine(benchmark::State& state)
+{
+    const TimeDomainOnsetDetectionConfig config;
+    const auto streamCount = static_cast<size_t>(state.range(0));
+
+    std::vector<int> streamIds(streamCount);
+    std::iota(streamIds.begin(), streamIds.end(), 0);
+    MultiStreamOnsetDetectionEngine engine(streamIds, config);
+
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+    std::vector<float> frames(config.chunkSize * streamCount);
+    for (auto& sample : frames)
+    {
+        sample = distribution(generator);
+    }
+
+    const size_t windowChunks = CalculateOnsetBufferSize(config.sampleRate, config.chunkSize,
+                                                         config.slidingWindowSizeSeconds);
+    for (size_t i = 0; i < windowChunks; ++i)
+    {
+        engine.ProcessChunk(frames.data());
+    }
+
+    for (auto _ : state)
+    {
+        engine.ProcessChunk(frames.data());
+        benchmark::ClobberMemory();
+    }
+
+    const double chunkSeconds = static_cast<double>(config.chunkSize) / config.sampleRate;
+    state.counters["realtime_streams"] = benchmark::Counter(static_cast<double>(streamCount) * chunkSeconds,
+                                                            benchmark::Counter::kIsIterationInvariantRate);
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * config.chunkSize * streamCount));
+}
+
+BENCHMARK(BM_MultiStreamOnsetDetectionEngine)->RangeMultiplier(4)->Range(1, 1024)->Unit(benchmark::kMicrosecond);
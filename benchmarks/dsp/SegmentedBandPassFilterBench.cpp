@@ -0,0 +1,73 @@
+//
+// Created by Robert on 2025-10-27.
+//
+
+#include <benchmark/benchmark.h>
+#include "../../src/dsp/filters/SegmentedBandPassFilter.h"
+#include <random>
+#include <vector>
+
+using namespace bpmfinder::dsp::filters;
+
+namespace
+{
+    constexpr int sampleRate = 48000;
+    constexpr int lowCutoff = 40;
+    constexpr int highCutoff = 800;
+
+    // One minute of full scale white noise
+    const std::vector<float>& GetInput()
+    {
+        static const std::vector<float> input = []
+        {
+            std::mt19937 generator(42);
+            std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+            std::vector<float> samples(sampleRate * 60);
+            for (auto& sample : samples)
+            {
+                sample = distribution(generator);
+            }
+            return samples;
+        }();
+        return input;
+    }
+}
+
+// Baseline: the filter as it runs in the BandPassFilterStage, one sample after the other
+static void BM_SerialBandPassFilter(benchmark::State& state)
+{
+    const auto& input = GetInput();
+    std::vector<float> output(input.size());
+
+    for (auto _ : state)
+    {
+        BandPassFilter filter(lowCutoff, highCutoff, sampleRate);
+        for (size_t i = 0; i < input.size(); ++i)
+        {
+            output[i] = filter.Process(input[i]);
+        }
+        benchmark::DoNotOptimize(output.data());
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * input.size()));
+}
+
+BENCHMARK(BM_SerialBandPassFilter)->Unit(benchmark::kMillisecond);
+
+// Segmented offline filter, the argument is the number of segments / threads
+static void BM_SegmentedBandPassFilter(benchmark::State& state)
+{
+    const auto& input = GetInput();
+    const SegmentedBandPassFilter filter(lowCutoff, highCutoff, sampleRate, 1.0f,
+                                         static_cast<size_t>(state.range(0)));
+
+    for (auto _ : state)
+    {
+        auto output = filter.Process(input);
+        benchmark::DoNotOptimize(output.data());
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * input.size()));
+}
+
+BENCHMARK(BM_SegmentedBandPassFilter)->RangeMultiplier(2)->Range(1, 16)->UseRealTime()->Unit(benchmark::kMillisecond);
@@ -0,0 +1,72 @@
+//
+// Created by Robert on 2025-11-16.
+//
+
+#include <benchmark/benchmark.h>
+#include "../../src/audio/BinFileAudioSource.h"
+#include "../../src/audio/SignalGeneratorAudioSource.h"
+#include "../../src/dsp/time_domain_onset_detection/TimeDomainOnsetDetectionDspPipeline.h"
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+using namespace bpmfinder::audio;
+using namespace bpmfinder::dsp::time_domain_onset_detection;
+
+namespace
+{
+    constexpr int Seconds = 60;
+
+    // A minute of a click track in noise as raw floats, written once and shared by all benchmarks
+    std::string GetRecording(const int sampleRate)
+    {
+        const auto path = std::filesystem::temp_directory_path() / "bpm_finder_bench_click_track.bin";
+        const auto size = static_cast<uintmax_t>(Seconds) * sampleRate * sizeof(float);
+        if (!std::filesystem::exists(path) || std::filesystem::file_size(path) != size)
+        {
+            SignalGeneratorOptions options;
+            options.sampleRate = sampleRate;
+            options.durationSeconds = Seconds;
+            options.snrDb = 10.0f;
+            SignalGenerator generator(options);
+
+            std::vector<float> samples(static_cast<size_t>(Seconds) * sampleRate);
+            generator.Generate(samples.data(), samples.size());
+            std::ofstream file(path, std::ios::binary);
+            file.write(reinterpret_cast<const char*>(samples.data()),
+                       static_cast<std::streamsize>(samples.size() * sizeof(float)));
+        }
+        return path.string();
+    }
+}
+
+// The whole pipeline replaying a recording flat-out, from the construction of the source until the last stage is
+// drained, memory mapped (0) or streamed (1), every stage on its own thread (0) or all of them inline on the thread of
+// the source (1). 'realtime_factor' is how many times faster than real time that is.
+static void BM_PipelineBinFileReplay(benchmark::State& state)
+{
+    const TimeDomainOnsetDetectionConfig config;
+    const auto mode = static_cast<BinFileReadMode>(state.range(0));
+    const auto execution = state.range(1) == 0 ? bpmfinder::core::ExecutionMode::Threaded
+                                               : bpmfinder::core::ExecutionMode::Inline;
+    const auto filename = GetRecording(config.sampleRate);
+
+    size_t chunks = 0;
+    for (auto _ : state)
+    {
+        BinFileAudioSource source(filename, config.chunkSize, mode);
+        TimeDomainOnsetDetectionDspPipeline pipeline(source, config, 16, "");
+
+        pipeline.Start(execution);
+        pipeline.WaitUntilFinished(std::chrono::minutes(5));
+        chunks = pipeline.GetProcessedChunkCount();
+        benchmark::DoNotOptimize(pipeline.GetCurrentBpm());
+    }
+
+    state.counters["chunks"] = static_cast<double>(chunks);
+    state.counters["realtime_factor"] = benchmark::Counter(Seconds, benchmark::Counter::kIsIterationInvariantRate);
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * Seconds * config.sampleRate);
+}
+
+BENCHMARK(BM_PipelineBinFileReplay)->ArgsProduct({{0, 1}, {0, 1}})->Unit(benchmark::kMillisecond)->UseRealTime();
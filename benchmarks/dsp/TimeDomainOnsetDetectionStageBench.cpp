@@ -0,0 +1,233 @@
+//
+// Created by Robert on 2025-11-16.
+//
+
+#include <benchmark/benchmark.h>
+#include "../../src/audio/SignalGeneratorAudioSource.h"
+#include "../../src/dsp/filters/BandPassFilter.h"
+#include "../../src/dsp/time_domain_onset_detection/TimeDomainOnsetDetectionDspPipeline.h"
+#include <vector>
+
+using namespace bpmfinder::audio;
+using namespace bpmfinder::dsp::time_domain_onset_detection;
+
+namespace
+{
+    using Result = TimeDomainOnsetDetectionResult;
+
+    // Exposes Process, so the benchmarks call it on their own thread, without a queue in front of the stage
+    template <typename Stage>
+    class DirectStage : public Stage
+    {
+    public:
+        using Stage::Stage;
+        using Stage::Process;
+    };
+
+    // Keeps what a stage passes on, as input for the next one
+    class Collector : public bpmfinder::core::CopyObserver<Result>
+    {
+    public:
+        std::vector<Result> Take()
+        {
+            std::vector<Result> results;
+            while (!queue_.empty())
+            {
+                results.push_back(std::move(queue_.front()));
+                queue_.pop();
+            }
+            return results;
+        }
+    };
+
+    template <typename Stage, typename Input>
+    std::vector<Result> RunStage(Stage& stage, const std::vector<Input>& inputs)
+    {
+        Collector collector;
+        stage.Subscribe(&collector);
+        for (const auto& input : inputs)
+        {
+            stage.Process(input);
+        }
+        return collector.Take();
+    }
+
+    // Input of every stage for 30 s of a click track in noise, what the stages before it made of it. Long enough
+    // for the sliding window, so the later stages see peaks, intervals and a tempo like in steady state.
+    struct StageInputs
+    {
+        std::vector<AudioChunk> chunks;
+        std::vector<Result> bandPassFilter;
+        std::vector<Result> energy;
+        std::vector<Result> onsetDetection;
+        std::vector<Result> peakIndexDetection;
+        std::vector<Result> interOnsetInterval;
+        std::vector<Result> dominantInterval;
+        std::vector<Result> bpmCalculation;
+    };
+
+    const StageInputs& GetInputs()
+    {
+        static const StageInputs inputs = []
+        {
+            const TimeDomainOnsetDetectionConfig config;
+            SignalGeneratorOptions options;
+            options.sampleRate = config.sampleRate;
+            options.durationSeconds = 30.0;
+            options.snrDb = 10.0f;
+            SignalGenerator generator(options);
+
+            StageInputs result;
+            while (!generator.IsFinished())
+            {
+                AudioChunk chunk(config.chunkSize);
+                generator.Generate(chunk.data(), chunk.size());
+                result.chunks.push_back(std::move(chunk));
+            }
+
+            DirectStage<PipelineResultInitializationStage> initialization(
+                config.sampleRate, config.chunkSize, config.bandPassLowCutoff, config.bandPassHighCutoff,
+                config.bandPassGain);
+            DirectStage<BandPassFilterStage> bandPassFilter(config.bandPassLowCutoff, config.bandPassHighCutoff,
+                                                            config.bandPassGain, config.sampleRate);
+            DirectStage<EnergyCalculationStage> energy;
+            DirectStage<OnsetDetectionStage> onsetDetection;
+            DirectStage<PeakIndexDetectionStage> peakIndexDetection(config.slidingWindowSizeSeconds,
+                                                                    config.peakThreshold);
+            DirectStage<InterOnsetIntervalCalculationStage> interOnsetInterval;
+            DirectStage<DominantIntervalCalculationStage> dominantInterval;
+
+            result.bandPassFilter = RunStage(initialization, result.chunks);
+            result.energy = RunStage(bandPassFilter, result.bandPassFilter);
+            result.onsetDetection = RunStage(energy, result.energy);
+            result.peakIndexDetection = RunStage(onsetDetection, result.onsetDetection);
+            result.interOnsetInterval = RunStage(peakIndexDetection, result.peakIndexDetection);
+            result.dominantInterval = RunStage(interOnsetInterval, result.interOnsetInterval);
+            result.bpmCalculation = RunStage(dominantInterval, result.dominantInterval);
+            return result;
+        }();
+        return inputs;
+    }
+
+    // One Process call per iteration, round robin over the inputs. The whole input runs through the stage first,
+    // so stateful stages start timing with a full window. Process takes its input by value: every iteration includes
+    // a copy of the result, as the queue in front of the stage makes one too (BM_ResultCopy alone).
+    template <typename Stage, typename Input>
+    void ProcessInputs(benchmark::State& state, Stage& stage, const std::vector<Input>& inputs)
+    {
+        for (const auto& input : inputs)
+        {
+            stage.Process(input);
+        }
+
+        size_t index = 0;
+        for (auto _ : state)
+        {
+            stage.Process(inputs[index]);
+            index = index + 1 < inputs.size() ? index + 1 : 0;
+        }
+        state.SetItemsProcessed(state.iterations()); // Chunks
+    }
+}
+
+// The filter as the BandPassFilterStage runs it, one chunk of samples per iteration
+static void BM_BandPassFilterProcess(benchmark::State& state)
+{
+    const TimeDomainOnsetDetectionConfig config;
+    const auto& chunks = GetInputs().chunks;
+    bpmfinder::dsp::filters::BandPassFilter filter(config.bandPassLowCutoff, config.bandPassHighCutoff,
+                                                   config.sampleRate, config.bandPassGain);
+    AudioChunk output(config.chunkSize);
+
+    size_t index = 0;
+    for (auto _ : state)
+    {
+        const auto& chunk = chunks[index];
+        for (size_t i = 0; i < chunk.size(); ++i)
+        {
+            output[i] = filter.Process(chunk[i]);
+        }
+        benchmark::DoNotOptimize(output.data());
+        index = index + 1 < chunks.size() ? index + 1 : 0;
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * config.chunkSize)); // Samples
+}
+
+// What a queue hop copies: a result with its raw and filtered audio
+static void BM_ResultCopy(benchmark::State& state)
+{
+    const auto& inputs = GetInputs().energy;
+    size_t index = 0;
+    for (auto _ : state)
+    {
+        Result copy = inputs[index];
+        benchmark::DoNotOptimize(copy.bandPassFiltered.data());
+        index = index + 1 < inputs.size() ? index + 1 : 0;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_PipelineResultInitializationStage(benchmark::State& state)
+{
+    const TimeDomainOnsetDetectionConfig config;
+    DirectStage<PipelineResultInitializationStage> stage(config.sampleRate, config.chunkSize,
+                                                         config.bandPassLowCutoff, config.bandPassHighCutoff,
+                                                         config.bandPassGain);
+    ProcessInputs(state, stage, GetInputs().chunks);
+}
+
+static void BM_BandPassFilterStage(benchmark::State& state)
+{
+    const TimeDomainOnsetDetectionConfig config;
+    DirectStage<BandPassFilterStage> stage(config.bandPassLowCutoff, config.bandPassHighCutoff, config.bandPassGain,
+                                           config.sampleRate);
+    ProcessInputs(state, stage, GetInputs().bandPassFilter);
+}
+
+static void BM_EnergyCalculationStage(benchmark::State& state)
+{
+    DirectStage<EnergyCalculationStage> stage;
+    ProcessInputs(state, stage, GetInputs().energy);
+}
+
+static void BM_OnsetDetectionStage(benchmark::State& state)
+{
+    DirectStage<OnsetDetectionStage> stage;
+    ProcessInputs(state, stage, GetInputs().onsetDetection);
+}
+
+static void BM_PeakIndexDetectionStage(benchmark::State& state)
+{
+    const TimeDomainOnsetDetectionConfig config;
+    DirectStage<PeakIndexDetectionStage> stage(config.slidingWindowSizeSeconds, config.peakThreshold);
+    ProcessInputs(state, stage, GetInputs().peakIndexDetection);
+}
+
+static void BM_InterOnsetIntervalCalculationStage(benchmark::State& state)
+{
+    DirectStage<InterOnsetIntervalCalculationStage> stage;
+    ProcessInputs(state, stage, GetInputs().interOnsetInterval);
+}
+
+static void BM_DominantIntervalCalculationStage(benchmark::State& state)
+{
+    DirectStage<DominantIntervalCalculationStage> stage;
+    ProcessInputs(state, stage, GetInputs().dominantInterval);
+}
+
+static void BM_BpmCalculationStage(benchmark::State& state)
+{
+    DirectStage<BpmCalculationStage> stage;
+    ProcessInputs(state, stage, GetInputs().bpmCalculation);
+}
+
+BENCHMARK(BM_BandPassFilterProcess);
+BENCHMARK(BM_ResultCopy);
+BENCHMARK(BM_PipelineResultInitializationStage);
+BENCHMARK(BM_BandPassFilterStage);
+BENCHMARK(BM_EnergyCalculationStage);
+BENCHMARK(BM_OnsetDetectionStage);
+BENCHMARK(BM_PeakIndexDetectionStage);
+BENCHMARK(BM_InterOnsetIntervalCalculationStage);
+BENCHMARK(BM_DominantIntervalCalculationStage);
+BENCHMARK(BM_BpmCalculationStage);
@@ -0,0 +1,84 @@
+//
+// Created by Robert on 2025-11-11.
+//
+
+#include <benchmark/benchmark.h>
+#include "../../src/files/WriteBehindFile.h"
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+using namespace bpmfinder::files;
+
+namespace
+{
+    constexpr size_t ChunkSamples = 1024;
+
+    std::filesystem::path GetOutputPath()
+    {
+        return std::filesystem::temp_directory_path() / "bpm_finder_bench_write.bin";
+    }
+
+    // Writes range(0) MB in chunks of 1024 floats through 'append'
+    template <typename Append>
+    void WriteChunks(benchmark::State& state, Append append)
+    {
+        const std::vector<float> chunk(ChunkSamples, 0.25f);
+        const auto chunks = static_cast<size_t>(state.range(0)) * 1024 * 1024 / (ChunkSamples * sizeof(float));
+        for (size_t i = 0; i < chunks; ++i)
+        {
+            append(chunk);
+        }
+    }
+}
+
+// What the AudioBinFileSink did before: one ofstream::write per chunk, then tellp for a debug line
+static void BM_OfstreamWritePerChunk(benchmark::State& state)
+{
+    for (auto _ : state)
+    {
+        std::ofstream file(GetOutputPath(), std::ios::binary | std::ios::trunc);
+        WriteChunks(state, [&](const std::vector<float>& chunk)
+        {
+            file.write(reinterpret_cast<const char*>(chunk.data()),
+                       static_cast<std::streamsize>(chunk.size() * sizeof(float)));
+            benchmark::DoNotOptimize(static_cast<std::streamoff>(file.tellp()));
+        });
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0) * 1024 * 1024);
+    std::filesystem::remove(GetOutputPath());
+}
+
+// range(1): buffer size in KB, range(2): 1 for O_DIRECT, range(3): FsyncPolicy
+static void BM_WriteBehindFile(benchmark::State& state)
+{
+    WriteBehindOptions options;
+    options.bufferBytes = static_cast<size_t>(state.range(1)) * 1024;
+    options.directIo = state.range(2) != 0;
+    options.fsync = static_cast<FsyncPolicy>(state.range(3));
+
+    bool directIo = false;
+    for (auto _ : state)
+    {
+        WriteBehindFile file;
+        file.Open(GetOutputPath().string(), options);
+        WriteChunks(state, [&](const std::vector<float>& chunk)
+        {
+            file.Append(chunk.data(), chunk.size() * sizeof(float));
+        });
+        directIo = file.IsDirectIo();
+        file.Close();
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0) * 1024 * 1024);
+    state.counters["direct_io"] = directIo ? 1 : 0; // 0 where the file system does not support it
+    std::filesystem::remove(GetOutputPath());
+}
+
+// Time is wall clock until the file is closed, CPU is what the appending thread (the sink thread) spends
+BENCHMARK(BM_OfstreamWritePerChunk)->Arg(64)->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_WriteBehindFile)
+    ->ArgsProduct({{64}, {256, 1024, 4096}, {0, 1}, {static_cast<int64_t>(FsyncPolicy::Never)}})
+    ->Args({64, 1024, 0, static_cast<int64_t>(FsyncPolicy::Periodic)})
+    ->Args({64, 1024, 0, static_cast<int64_t>(FsyncPolicy::EveryBuffer)})
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,135 @@
+//
+// Created by Robert on 2025-11-15.
+//
+
+#include <benchmark/benchmark.h>
+#include <spdlog/async.h>
+#include <spdlog/sinks/basic_file_sink.h>
+#include <filesystem>
+#include <memory>
+#include <vector>
+
+// Compiled like a release build, whatever this one is: BPM_LOG_DEBUG is stripped
+#undef BPM_LOG_ACTIVE_LEVEL
+#define BPM_LOG_ACTIVE_LEVEL BPM_LOG_LEVEL_INFO
+#include "../../src/logging/Log.h"
+
+namespace
+{
+    constexpr size_t ChunkSize = 1024;
+
+    std::filesystem::path GetLogPath()
+    {
+        return std::filesystem::temp_directory_path() / "bpm_finder_bench_log.txt";
+    }
+
+    // A file sink with the pattern of the console sink, passing info and above. Loggers flush it after every message,
+    // as the console sink flushes stdout.
+    spdlog::sink_ptr CreateSink()
+    {
+        auto sink = std::make_shared<spdlog::sinks::basic_file_sink_mt>(GetLogPath().string(), true);
+        sink->set_level(spdlog::level::info);
+        sink->set_pattern("[%Y-%m-%d %H:%M:%S.%e] [%n] [%^%l%$] %v");
+        return sink;
+    }
+
+    // The work of the EnergyCalculationStage, per chunk, with 'log' called where its Process logs
+    template <typename Log>
+    void ProcessChunks(benchmark::State& state, Log log)
+    {
+        const std::vector<float> chunk(ChunkSize, 0.25f);
+        size_t chunkIndex = 0;
+        for (auto _ : state)
+        {
+            log(chunkIndex);
+            float energy = 0.0f;
+            for (const float sample : chunk)
+            {
+                energy += sample * sample;
+            }
+            benchmark::DoNotOptimize(energy);
+            ++chunkIndex;
+        }
+        state.SetItemsProcessed(state.iterations()); // Chunks
+    }
+}
+
+static void BM_ChunkWithoutLogging(benchmark::State& state)
+{
+    ProcessChunks(state, [](size_t) {});
+}
+
+// Before: LoggerFactory loggers were at trace level, only the sinks filtered, so every debug call formatted its
+// message to drop it afterwards
+static void BM_ChunkDebugLoggerAtTrace(benchmark::State& state)
+{
+    const auto logger = std::make_shared<spdlog::logger>("bench", CreateSink());
+    logger->set_level(spdlog::level::trace);
+    ProcessChunks(state, [&](const size_t chunkIndex)
+    {
+        logger->debug("[EnergyCalculationStage] Processing chunk {}/{} with index {}", chunkIndex, 0, chunkIndex);
+    });
+    std::filesystem::remove(GetLogPath());
+}
+
+// Loggers at the level of the sinks: the call returns after a level check, BPM_LOG_CALL skips the arguments as well
+static void BM_ChunkDebugLoggerAtInfo(benchmark::State& state)
+{
+    const auto logger = std::make_shared<spdlog::logger>("bench", CreateSink());
+    logger->set_level(spdlog::level::info);
+    ProcessChunks(state, [&](const size_t chunkIndex)
+    {
+        BPM_LOG_CALL(logger, spdlog::level::debug, "[EnergyCalculationStage] Processing chunk {}/{} with index {}",
+                     chunkIndex, 0, chunkIndex);
+    });
+    std::filesystem::remove(GetLogPath());
+}
+
+// Release builds: BPM_LOG_DEBUG is gone
+static void BM_ChunkDebugStripped(benchmark::State& state)
+{
+    const auto logger = std::make_shared<spdlog::logger>("bench", CreateSink());
+    ProcessChunks(state, [&](const size_t chunkIndex)
+    {
+        BPM_LOG_DEBUG(logger, "[EnergyCalculationStage] Processing chunk {}/{} with index {}", chunkIndex, 0,
+                      chunkIndex);
+        benchmark::DoNotOptimize(chunkIndex);
+    });
+    std::filesystem::remove(GetLogPath());
+}
+
+// A message that is written, like the BPM of the BpmCalculationStage, from the stage thread
+static void BM_ChunkInfoSync(benchmark::State& state)
+{
+    const auto logger = std::make_shared<spdlog::logger>("bench", CreateSink());
+    logger->flush_on(spdlog::level::info);
+    ProcessChunks(state, [&](const size_t chunkIndex)
+    {
+        BPM_LOG_INFO(logger, "BPM: {:.1f} at chunk {}", 120.0f, chunkIndex);
+    });
+    std::filesystem::remove(GetLogPath());
+}
+
+// The same through an async logger, as LoggerFactory::InitializeAsync creates them: the stage thread only queues
+static void BM_ChunkInfoAsync(benchmark::State& state)
+{
+    {
+        const auto threadPool = std::make_shared<spdlog::details::thread_pool>(8192, 1);
+        const auto logger = std::make_shared<spdlog::async_logger>("bench", CreateSink(), threadPool,
+                                                                   spdlog::async_overflow_policy::overrun_oldest);
+        logger->flush_on(spdlog::level::info);
+        ProcessChunks(state, [&](const size_t chunkIndex)
+        {
+            BPM_LOG_INFO(logger, "BPM: {:.1f} at chunk {}", 120.0f, chunkIndex);
+        });
+        state.counters["dropped"] = static_cast<double>(threadPool->overrun_counter());
+    }
+    std::filesystem::remove(GetLogPath());
+}
+
+BENCHMARK(BM_ChunkWithoutLogging);
+BENCHMARK(BM_ChunkDebugLoggerAtTrace);
+BENCHMARK(BM_ChunkDebugLoggerAtInfo);
+BENCHMARK(BM_ChunkDebugStripped);
+BENCHMARK(BM_ChunkInfoSync);
+BENCHMARK(BM_ChunkInfoAsync);
@@ -0,0 +1,264 @@
+//
+// Created by Robert on 2025-10-30.
+//
+
+#include "AnalysisResultCache.h"
+#include <bit>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <thread>
+
+namespace bpmfinder::app
+{
+    namespace
+    {
+        constexpr uint64_t Prime1 = 0x9E3779B185EBCA87ULL;
+        constexpr uint64_t Prime2 = 0xC2B2AE3D27D4EB4FULL;
+        constexpr uint64_t Prime3 = 0x165667B19E3779F9ULL;
+        constexpr uint64_t Prime4 = 0x85EBCA77C2B2AE63ULL;
+        constexpr uint64_t Prime5 = 0x27D4EB2F165667C5ULL;
+
+        // Bump whenever the layout of an entry or the meaning of a key changes
+        constexpr uint32_t FormatVersion = 1;
+        constexpr char BpmMagic[4] = {'B', 'P', 'M', 'R'};
+        constexpr char SeriesMagic[4] = {'B', 'P', 'M', 'S'};
+
+        uint64_t Round(const uint64_t accumulator, const uint64_t input)
+        {
+            return std::rotl(accumulator + input * Prime2, 31) * Prime1;
+        }
+
+        uint64_t Mix(uint64_t hash, const uint64_t value)
+        {
+            hash ^= Round(0, value);
+            return std::rotl(hash, 27) * Prime1 + Prime4;
+        }
+
+        uint64_t Avalanche(uint64_t hash)
+        {
+            hash ^= hash >> 33;
+            hash *= Prime2;
+            hash ^= hash >> 29;
+            hash *= Prime3;
+            hash ^= hash >> 32;
+            return hash;
+        }
+
+        uint64_t FloatBits(const float value)
+        {
+            return std::bit_cast<uint32_t>(value);
+        }
+
+        template <typename T>
+        void Append(std::vector<char>& buffer, const T& value)
+        {
+            const auto* bytes = reinterpret_cast<const char*>(&value);
+            buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+        }
+
+        void AppendFloats(std::vector<char>& buffer, const std::vector<float>& values)
+        {
+            const auto* bytes = reinterpret_cast<const char*>(values.data());
+            buffer.insert(buffer.end(), bytes, bytes + values.size() * sizeof(float));
+        }
+
+        bool ReadHeader(std::ifstream& file, const char (&magic)[4])
+        {
+            char fileMagic[4];
+            uint32_t version = 0;
+            file.read(fileMagic, sizeof(fileMagic));
+            file.read(reinterpret_cast<char*>(&version), sizeof(version));
+            return file.good() && std::memcmp(fileMagic, magic, sizeof(magic)) == 0 && version == FormatVersion;
+        }
+    }
+
+    AnalysisResultCache::AnalysisResultCache(std::filesystem::path directory)
+        : directory_(std::move(directory))
+    {
+        std::filesystem::create_directories(directory_);
+    }
+
+    uint64_t AnalysisResultCache::HashSamples(const float* samples, const size_t count)
+    {
+        const auto* bytes = reinterpret_cast<const unsigned char*>(samples);
+        const size_t length = count * sizeof(float);
+        size_t offset = 0;
+        uint64_t hash;
+
+        const auto readWord = [bytes](const size_t at)
+        {
+            uint64_t word;
+            std::memcpy(&word, bytes + at, sizeof(word));
+            return word;
+        };
+
+        if (length >= 32)
+        {
+            // Four independent lanes, so the multiplications of consecutive words do not wait for each other
+            uint64_t v1 = Prime1 + Prime2;
+            uint64_t v2 = Prime2;
+            uint64_t v3 = 0;
+            uint64_t v4 = 0 - Prime1;
+            for (; offset + 32 <= length; offset += 32)
+            {
+                v1 = Round(v1, readWord(offset));
+                v2 = Round(v2, readWord(offset + 8));
+                v3 = Round(v3, readWord(offset + 16));
+                v4 = Round(v4, readWord(offset + 24));
+            }
+
+            hash = std::rotl(v1, 1) + std::rotl(v2, 7) + std::rotl(v3, 12) + std::rotl(v4, 18);
+            hash = Mix(hash, v1);
+            hash = Mix(hash, v2);
+            hash = Mix(hash, v3);
+            hash = Mix(hash, v4);
+        }
+        else
+        {
+            hash = Prime5;
+        }
+
+        hash += length;
+
+        for (; offset + 8 <= length; offset += 8)
+        {
+            hash ^= Round(0, readWord(offset));
+            hash = std::rotl(hash, 27) * Prime1 + Prime4;
+        }
+        for (; offset < length; ++offset)
+        {
+            hash ^= bytes[offset] * Prime5;
+            hash = std::rotl(hash, 11) * Prime1;
+        }
+
+        return Avalanche(hash);
+    }
+
+    uint64_t AnalysisResultCache::GetUpstreamKey(
+        const uint64_t sampleHash, const dsp::time_domain_onset_detection::TimeDomainOnsetDetectionConfig& config)
+    {
+        uint64_t key = Mix(Prime5 + FormatVersion, sampleHash);
+        key = Mix(key, static_cast<uint64_t>(config.sampleRate));
+        key = Mix(key, static_cast<uint64_t>(config.chunkSize));
+        key = Mix(key, static_cast<uint64_t>(config.bandPassLowCutoff));
+        key = Mix(key, static_cast<uint64_t>(config.bandPassHighCutoff));
+        key = Mix(key, FloatBits(config.bandPassGain));
+        return Avalanche(key);
+    }
+
+    uint64_t AnalysisResultCache::GetResultKey(
+        const uint64_t upstreamKey, const dsp::time_domain_onset_detection::TimeDomainOnsetDetectionConfig& config)
+    {
+        uint64_t key = Mix(Prime5 + FormatVersion, upstreamKey);
+        key = Mix(key, static_cast<uint64_t>(config.slidingWindowSizeSeconds));
+        key = Mix(key, FloatBits(config.peakThreshold));
+        return Avalanche(key);
+    }
+
+    std::optional<float> AnalysisResultCache::LoadBpm(const uint64_t resultKey) const
+    {
+        std::ifstream file(GetEntryPath(resultKey, ".bpm"), std::ios::binary);
+        if (!file.is_open() || !ReadHeader(file, BpmMagic))
+        {
+            return std::nullopt;
+        }
+
+        float bpm = 0.0f;
+        file.read(reinterpret_cast<char*>(&bpm), sizeof(bpm));
+        if (!file.good())
+        {
+            return std::nullopt;
+        }
+        return bpm;
+    }
+
+    bool AnalysisResultCache::StoreBpm(const uint64_t resultKey, const float bpm) const
+    {
+        std::vector<char> content;
+        Append(content, BpmMagic);
+        Append(content, FormatVersion);
+        Append(content, bpm);
+        return WriteEntry(GetEntryPath(resultKey, ".bpm"), content);
+    }
+
+    std::optional<CachedOnsetSeries> AnalysisResultCache::LoadOnsetSeries(const uint64_t upstreamKey) const
+    {
+        std::ifstream file(GetEntryPath(upstreamKey, ".onset"), std::ios::binary);
+        if (!file.is_open() || !ReadHeader(file, SeriesMagic))
+        {
+            return std::nullopt;
+        }
+
+        CachedOnsetSeries series;
+        uint64_t chunkCount = 0;
+        file.read(reinterpret_cast<char*>(&series.sampleCount), sizeof(series.sampleCount));
+        file.read(reinterpret_cast<char*>(&chunkCount), sizeof(chunkCount));
+        if (!file.good() || chunkCount > series.sampleCount)
+        {
+            return std::nullopt;
+        }
+
+        series.energy.resize(chunkCount);
+        series.onsetStrength.resize(chunkCount);
+        const auto bytes = static_cast<std::streamsize>(chunkCount * sizeof(float));
+        file.read(reinterpret_cast<char*>(series.energy.data()), bytes);
+        file.read(reinterpret_cast<char*>(series.onsetStrength.data()), bytes);
+        if (!file.good())
+        {
+            return std::nullopt;
+        }
+        return series;
+    }
+
+    bool AnalysisResultCache::StoreOnsetSeries(const uint64_t upstreamKey, const CachedOnsetSeries& series) const
+    {
+        std::vector<char> content;
+        Append(content, SeriesMagic);
+        Append(content, FormatVersion);
+        Append(content, series.sampleCount);
+        Append(content, static_cast<uint64_t>(series.onsetStrength.size()));
+        AppendFloats(content, series.energy);
+        AppendFloats(content, series.onsetStrength);
+        return WriteEntry(GetEntryPath(upstreamKey, ".onset"), content);
+    }
+
+    std::filesystem::path AnalysisResultCache::GetEntryPath(const uint64_t key, const char* extension) const
+    {
+        char name[17];
+        std::snprintf(name, sizeof(name), "%016llx", static_cast<unsigned long long>(key));
+        return directory_ / (std::string(name) + extension);
+    }
+
+    bool AnalysisResultCache::WriteEntry(const std::filesystem::path& path, const std::vector<char>& content) const
+    {
+        std::ostringstream suffix;
+        suffix << ".tmp" << std::this_thread::get_id() << '-' << std::random_device{}();
+        auto temporaryPath = path;
+        temporaryPath += suffix.str();
+
+        {
+            std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+            if (!file.is_open())
+            {
+                return false;
+            }
+            file.write(content.data(), static_cast<std::streamsize>(content.size()));
+            if (!file.good())
+            {
+                return false;
+            }
+        }
+
+        std::error_code error;
+        std::filesystem::rename(temporaryPath, path, error);
+        if (error)
+        {
+            std::filesystem::remove(temporaryPath, error);
+            return false;
+        }
+        return true;
+    }
+}
@@ -0,0 +1,60 @@
+//
+// Created by Robert on 2025-10-30.
+//
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <vector>
+#include "dsp/time_domain_onset_detection/TimeDomainOnsetDetectionConfig.h"
+
+namespace bpmfinder::app
+{
+    // Intermediate results of a file: one value per chunk
+    struct CachedOnsetSeries
+    {
+        uint64_t sampleCount = 0;
+        std::vector<float> energy;
+        std::vector<float> onsetStrength;
+    };
+
+    // Persistent on-disk cache for the batch analysis, one file per entry in the cache directory.
+    //
+    // There are two levels of keys, both derived from a hash of the input samples:
+    // - the upstream key adds everything that shapes the onset curve (sample rate, chunk size, cutoffs, gain) and stores
+    //   the energy and onset strength series
+    // - the result key adds the downstream parameters (window, threshold) and stores the final BPM
+    // So changing only the window or the threshold can resume from the cached onset curve instead of filtering again.
+    //
+    // Entries are written to a temporary file and renamed into place, so several workers (or processes) can share one
+    // cache directory, readers never see a partially written entry.
+    class AnalysisResultCache
+    {
+    public:
+        explicit AnalysisResultCache(std::filesystem::path directory);
+
+        // 64 bit hash of the raw sample bits (xxHash64 style, four independent lanes)
+        static uint64_t HashSamples(const float* samples, size_t count);
+
+        static uint64_t GetUpstreamKey(uint64_t sampleHash,
+                                       const dsp::time_domain_onset_detection::TimeDomainOnsetDetectionConfig& config);
+        static uint64_t GetResultKey(uint64_t upstreamKey,
+                                     const dsp::time_domain_onset_detection::TimeDomainOnsetDetectionConfig& config);
+
+        [[nodiscard]] std::optional<float> LoadBpm(uint64_t resultKey) const;
+        bool StoreBpm(uint64_t resultKey, float bpm) const;
+
+        [[nodiscard]] std::optional<CachedOnsetSeries> LoadOnsetSeries(uint64_t upstreamKey) const;
+        bool StoreOnsetSeries(uint64_t upstreamKey, const CachedOnsetSeries& series) const;
+
+        [[nodiscard]] const std::filesystem::path& GetDirectory() const { return directory_; }
+
+    private:
+        [[nodiscard]] std::filesystem::path GetEntryPath(uint64_t key, const char* extension) const;
+        bool WriteEntry(const std::filesystem::path& path, const std::vector<char>& content) const;
+
+        std::filesystem::path directory_;
+    };
+}
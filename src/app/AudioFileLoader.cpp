@@ -0,0 +1,74 @@
+//
+// Created by Robert on 2025-11-16.
+//
+
+#include "AudioFileLoader.h"
+#include <algorithm>
+#include <cctype>
+#include "audio/BinFileAudioSource.h"
+#include "audio/SampleConversion.h"
+#include "audio/WavFileAudioSource.h"
+
+namespace bpmfinder::app
+{
+    bool AudioFileLoader::Load(const std::filesystem::path& file, const int defaultSampleRate, const int inputChannel,
+                               std::string& error)
+    {
+        mappedFile_.Close();
+        readSamples_.clear();
+        samples_ = nullptr;
+        sampleCount_ = 0;
+        sampleRate_ = defaultSampleRate;
+
+        if (IsWavFile(file))
+        {
+            audio::WavHeader header;
+            if (!audio::WavFileAudioSource::ReadSamples(file.string(), readSamples_, header))
+            {
+                error = "not a supported WAV file";
+                return false;
+            }
+            sampleRate_ = header.format.sampleRate;
+        }
+        else if (IsRecordingFile(file))
+        {
+            int channels = 1;
+            if (!audio::BinFileAudioSource::ReadSamples(file.string(), readSamples_, &sampleRate_, &channels))
+            {
+                error = "not a valid recording";
+                return false;
+            }
+            const size_t frames = readSamples_.size() / channels;
+            audio::DownmixInPlace(readSamples_.data(), frames, channels, inputChannel < channels ? inputChannel : -1);
+            readSamples_.resize(frames);
+        }
+        else if (mappedFile_.Open(file.string()))
+        {
+            samples_ = reinterpret_cast<const float*>(mappedFile_.GetData());
+            sampleCount_ = mappedFile_.GetSize() / sizeof(float);
+            return true;
+        }
+        else if (!audio::BinFileAudioSource::ReadSamples(file.string(), readSamples_))
+        {
+            error = "failed to open or read file";
+            return false;
+        }
+
+        samples_ = readSamples_.data();
+        sampleCount_ = readSamples_.size();
+        return true;
+    }
+
+    bool AudioFileLoader::IsWavFile(const std::filesystem::path& file)
+    {
+        auto extension = file.extension().string();
+        std::transform(extension.begin(), extension.end(), extension.begin(),
+                       [](const unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        return extension == ".wav";
+    }
+
+    bool AudioFileLoader::IsRecordingFile(const std::filesystem::path& file)
+    {
+        return file.extension() == ".bpmr";
+    }
+}
@@ -0,0 +1,45 @@
+//
+// Created by Robert on 2025-11-16.
+//
+
+#pragma once
+#include <filesystem>
+#include <string>
+#include <vector>
+#include "files/MemoryMappedFile.h"
+
+namespace bpmfinder::app
+{
+    // Loads a whole recording as mono floats at its own sample rate, for the offline analyses (analyze and sweep):
+    //   *.wav   decoded and mixed down, the sample rate comes from the header
+    //   *.bpmr  every frame up to the first damaged block, mixed down to inputChannel (the mean of all channels if it
+    //           is out of range), the sample rate comes from the recording
+    //   other   raw 32 bit floats, mono, in the waveform.bin format, at the default sample rate. Regular files are
+    //           mapped instead of read, so memory does not grow with the file; pipes are read until the writer closes.
+    class AudioFileLoader
+    {
+    public:
+        AudioFileLoader() = default;
+
+        AudioFileLoader(const AudioFileLoader&) = delete;
+        AudioFileLoader& operator=(const AudioFileLoader&) = delete;
+
+        // False if the file can not be opened, read or decoded, with the reason in 'error'
+        bool Load(const std::filesystem::path& file, int defaultSampleRate, int inputChannel, std::string& error);
+
+        // Valid until the next Load
+        [[nodiscard]] const float* GetSamples() const { return samples_; }
+        [[nodiscard]] size_t GetSampleCount() const { return sampleCount_; }
+        [[nodiscard]] int GetSampleRate() const { return sampleRate_; }
+
+        static bool IsWavFile(const std::filesystem::path& file);
+        static bool IsRecordingFile(const std::filesystem::path& file);
+
+    private:
+        files::MemoryMappedFile mappedFile_;
+        std::vector<float> readSamples_;
+        const float* samples_ = nullptr;
+        size_t sampleCount_ = 0;
+        int sampleRate_ = 0;
+    };
+}
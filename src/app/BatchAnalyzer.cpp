@@ -0,0 +1,273 @@
+//
+// Created by Robert on 2025-10-29.
+//
+
+#include "BatchAnalyzer.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <fstream>
+#include <thread>
+#include "AudioFileLoader.h"
+#include "dsp/time_domain_onset_detection/MultiStreamOnsetDetectionEngine.h"
+#include "dsp/time_domain_onset_detection/TempoEstimation.h"
+#include "logging/LoggerFactory.h"
+
+namespace bpmfinder::app
+{
+    namespace
+    {
+        // A CSV field as RFC 4180 has it: quoted, with quotes inside doubled, so commas, quotes and line breaks in
+        // file names and error messages stay in their field
+        std::string QuoteCsv(const std::string& text)
+        {
+            std::string quoted = "\"";
+            for (const char c : text)
+            {
+                if (c == '"')
+                {
+                    quoted += '"';
+                }
+                quoted += c;
+            }
+            return quoted + '"';
+        }
+    }
+
+    const char* ToString(const CacheStatus status)
+    {
+        switch (status)
+        {
+        case CacheStatus::Miss:
+            return "miss";
+        case CacheStatus::OnsetSeriesHit:
+            return "onset";
+        case CacheStatus::Hit:
+            return "hit";
+        default:
+            return "off";
+        }
+    }
+
+    BatchAnalyzer::BatchAnalyzer(const dsp::time_domain_onset_detection::TimeDomainOnsetDetectionConfig& config,
+                                 const unsigned jobs, std::shared_ptr<AnalysisResultCache> cache)
+        : config_(config),
+          jobs_(jobs > 0 ? jobs : std::max(1u, std::thread::hardware_concurrency())),
+          cache_(std::move(cache)),
+          logger_(logging::LoggerFactory::GetLogger("BatchAnalyzer"))
+    {
+    }
+
+    std::vector<FileAnalysisResult> BatchAnalyzer::Analyze(const std::vector<std::filesystem::path>& files)
+    {
+        std::vector<FileAnalysisResult> results(files.size());
+        std::atomic<size_t> nextFile{0};
+
+        const auto start = std::chrono::steady_clock::now();
+
+        // Bounded pool: never more workers than files, every worker pulls the next file until none are left
+        const size_t workerCount = std::min<size_t>(jobs_, files.size());
+        logger_->info("Analyzing {} files with {} workers", files.size(), workerCount);
+
+        std::vector<std::thread> workers;
+        workers.reserve(workerCount);
+        for (size_t w = 0; w < workerCount; ++w)
+        {
+            workers.emplace_back([&]
+            {
+                for (size_t i = nextFile++; i < files.size(); i = nextFile++)
+                {
+                    try
+                    {
+                        results[i] = AnalyzeFile(files[i]);
+                    }
+                    catch (const std::exception& e)
+                    {
+                        // One file that can not be read or analyzed is a failed row, the batch goes on
+                        results[i] = {};
+                        results[i].file = files[i];
+                        results[i].error = e.what();
+                        logger_->error("{}: {}", files[i].string(), results[i].error);
+                    }
+                }
+            });
+        }
+        for (auto& worker : workers)
+        {
+            worker.join();
+        }
+
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        summary_ = {};
+        summary_.fileCount = files.size();
+        summary_.wallSeconds = elapsed.count();
+        for (const auto& result : results)
+        {
+            summary_.audioSeconds += result.audioSeconds;
+            summary_.failedCount += result.success ? 0 : 1;
+        }
+        summary_.realtimeFactor = summary_.wallSeconds > 0.0 ? summary_.audioSeconds / summary_.wallSeconds : 0.0;
+
+        logger_->info("Analyzed {:.1f} s of audio in {:.3f} s ({:.1f}x realtime), {} of {} files failed",
+                      summary_.audioSeconds, summary_.wallSeconds, summary_.realtimeFactor,
+                      summary_.failedCount, summary_.fileCount);
+
+        return results;
+    }
+
+    FileAnalysisResult BatchAnalyzer::AnalyzeFile(const std::filesystem::path& file) const
+    {
+        FileAnalysisResult result;
+        result.file = file;
+
+        const auto start = std::chrono::steady_clock::now();
+
+        // The loader maps recordings in the waveform.bin format, so memory does not grow with the file size
+        auto config = config_;
+        AudioFileLoader loader;
+        if (!loader.Load(file, config.sampleRate, config.inputChannel, result.error))
+        {
+            logger_->error("{}: {}", file.string(), result.error);
+            return result;
+        }
+        config.sampleRate = loader.GetSampleRate();
+        const float* samples = loader.GetSamples();
+        const size_t sampleCount = loader.GetSampleCount();
+
+        const float bpm = AnalyzeSamples(samples, sampleCount, config, result);
+
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        result.success = true;
+        result.sampleCount = sampleCount;
+        result.audioSeconds = static_cast<double>(sampleCount) / config.sampleRate;
+        result.wallSeconds = elapsed.count();
+        result.realtimeFactor = result.wallSeconds > 0.0 ? result.audioSeconds / result.wallSeconds : 0.0;
+        result.bpm = bpm;
+
+        logger_->info("{}: {:.1f} BPM ({:.1f} s of audio, {:.1f}x realtime, cache: {})", file.string(), result.bpm,
+                      result.audioSeconds, result.realtimeFactor, ToString(result.cacheStatus));
+
+        return result;
+    }
+
+    float BatchAnalyzer::AnalyzeSamples(const float* samples, const size_t sampleCount,
+                                        const dsp::time_domain_onset_detection::TimeDomainOnsetDetectionConfig& config,
+                                        FileAnalysisResult& result) const
+    {
+        using namespace dsp::time_domain_onset_detection;
+
+        uint64_t upstreamKey = 0;
+        uint64_t resultKey = 0;
+        if (cache_)
+        {
+            upstreamKey = AnalysisResultCache::GetUpstreamKey(
+                AnalysisResultCache::HashSamples(samples, sampleCount), config);
+            resultKey = AnalysisResultCache::GetResultKey(upstreamKey, config);
+
+            if (const auto bpm = cache_->LoadBpm(resultKey))
+            {
+                result.cacheStatus = CacheStatus::Hit;
+                return bpm.value();
+            }
+
+            // Only the downstream parameters changed: the onset curve is still valid, skip the filter
+            const auto series = cache_->LoadOnsetSeries(upstreamKey);
+            if (series && series->sampleCount == sampleCount)
+            {
+                result.cacheStatus = CacheStatus::OnsetSeriesHit;
+                const float bpm = EstimateTempoFromOnsetSeries(series->onsetStrength, config);
+                cache_->StoreBpm(resultKey, bpm);
+                return bpm;
+            }
+
+            result.cacheStatus = CacheStatus::Miss;
+        }
+
+        // One stream engine: exactly the results of the pipeline, but without a thread and a queue per stage.
+        // Like the live pipeline we only look at full chunks, a trailing partial chunk is ignored.
+        MultiStreamOnsetDetectionEngine engine({0}, config);
+        const auto chunkSize = static_cast<size_t>(config.chunkSize);
+
+        CachedOnsetSeries series;
+        series.sampleCount = sampleCount;
+        if (cache_)
+        {
+            series.energy.reserve(sampleCount / chunkSize);
+            series.onsetStrength.reserve(sampleCount / chunkSize);
+        }
+
+        for (size_t offset = 0; offset + chunkSize <= sampleCount; offset += chunkSize)
+        {
+            engine.ProcessChunk(samples + offset);
+            if (cache_)
+            {
+                series.energy.push_back(engine.GetEnergy(0));
+                series.onsetStrength.push_back(engine.GetOnsetStrength(0));
+            }
+        }
+
+        const float bpm = engine.GetBpm(0);
+        if (cache_ && !(cache_->StoreOnsetSeries(upstreamKey, series) && cache_->StoreBpm(resultKey, bpm)))
+        {
+            logger_->warn("{}: failed to write the cache entries to {}", result.file.string(),
+                          cache_->GetDirectory().string());
+        }
+        return bpm;
+    }
+
+    std::vector<std::filesystem::path> BatchAnalyzer::CollectInputFiles(const std::vector<std::string>& paths)
+    {
+        std::vector<std::filesystem::path> files;
+        for (const auto& path : paths)
+        {
+            if (!std::filesystem::is_directory(path))
+            {
+                files.emplace_back(path);
+                continue;
+            }
+
+            std::vector<std::filesystem::path> directoryFiles;
+            for (const auto& entry : std::filesystem::directory_iterator(path))
+            {
+                const auto& file = entry.path();
+                if (entry.is_regular_file() && (file.extension() == ".bin" || AudioFileLoader::IsWavFile(file) ||
+                                               AudioFileLoader::IsRecordingFile(file)))
+                {
+                    directoryFiles.push_back(file);
+                }
+            }
+            std::sort(directoryFiles.begin(), directoryFiles.end());
+            files.insert(files.end(), directoryFiles.begin(), directoryFiles.end());
+        }
+        return files;
+    }
+
+    bool BatchAnalyzer::WriteResults(const std::filesystem::path& outputFile,
+                                     const std::vector<FileAnalysisResult>& results)
+    {
+        std::ofstream out(outputFile);
+        if (!out.is_open())
+        {
+            return false;
+        }
+
+        out << "file,success,samples,audio_seconds,wall_seconds,realtime_factor,bpm,cache,error\n";
+        for (const auto& result : results)
+        {
+            out << QuoteCsv(result.file.string()) << ','
+                << (result.success ? 1 : 0) << ','
+                << result.sampleCount << ','
+                << result.audioSeconds << ','
+                << result.wallSeconds << ','
+                << result.realtimeFactor << ','
+                << result.bpm << ','
+                << ToString(result.cacheStatus) << ','
+                << QuoteCsv(result.error) << '\n';
+        }
+
+        return out.good();
+    }
+}
@@ -0,0 +1,87 @@
+//
+// Created by Robert on 2025-10-29.
+//
+
+#pragma once
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+#include "AnalysisResultCache.h"
+#include "dsp/time_domain_onset_detection/TimeDomainOnsetDetectionConfig.h"
+#include "spdlog/logger.h"
+
+namespace bpmfinder::app
+{
+    enum class CacheStatus
+    {
+        Disabled,
+        Miss, // Full analysis, results stored in the cache
+        OnsetSeriesHit, // Resumed from the cached onset curve, only the tempo estimation ran
+        Hit // BPM taken from the cache, no DSP at all
+    };
+
+    const char* ToString(CacheStatus status);
+
+    struct FileAnalysisResult
+    {
+        std::filesystem::path file;
+        bool success = false;
+        std::string error;
+
+        size_t sampleCount = 0;
+        double audioSeconds = 0.0;
+        double wallSeconds = 0.0;
+        double realtimeFactor = 0.0; // audioSeconds / wallSeconds
+        float bpm = 0.0f; // 0 if no tempo was found
+        CacheStatus cacheStatus = CacheStatus::Disabled;
+    };
+
+    struct BatchAnalysisSummary
+    {
+        size_t fileCount = 0;
+        size_t failedCount = 0;
+        double audioSeconds = 0.0;
+        double wallSeconds = 0.0;
+        double realtimeFactor = 0.0; // Total audio over the wall clock time of the whole batch, all workers together
+    };
+
+    // Analyzes recordings in the waveform.bin format (raw 32 bit floats, mono, as written by the AudioBinFileSink),
+    // indexed recordings (*.bpmr) and WAV files (both at the sample rate in their header) as fast as possible, without
+    // real-time pacing. Every worker takes the next file, maps it into memory and runs the onset detection
+    // synchronously on its own thread, so one file never waits for another one.
+    class BatchAnalyzer
+    {
+    public:
+        // jobs = 0 uses one worker per hardware thread, without a cache every file is analyzed from scratch
+        explicit BatchAnalyzer(const dsp::time_domain_onset_detection::TimeDomainOnsetDetectionConfig& config,
+                               unsigned jobs = 0, std::shared_ptr<AnalysisResultCache> cache = nullptr);
+
+        // Results are in the same order as the files
+        [[nodiscard]] std::vector<FileAnalysisResult> Analyze(const std::vector<std::filesystem::path>& files);
+
+        // Summary of the last Analyze call
+        [[nodiscard]] const BatchAnalysisSummary& GetSummary() const { return summary_; }
+
+        [[nodiscard]] unsigned GetJobCount() const { return jobs_; }
+
+        // Expands directories to the *.bin, *.bpmr and *.wav files in them (sorted, not recursive), files are taken as they are
+        static std::vector<std::filesystem::path> CollectInputFiles(const std::vector<std::string>& paths);
+
+        // One CSV row per file, file and error are quoted (RFC 4180)
+        static bool WriteResults(const std::filesystem::path& outputFile, const std::vector<FileAnalysisResult>& results);
+
+    private:
+        [[nodiscard]] FileAnalysisResult AnalyzeFile(const std::filesystem::path& file) const;
+        [[nodiscard]] float AnalyzeSamples(const float* samples, size_t sampleCount,
+                                           const dsp::time_domain_onset_detection::TimeDomainOnsetDetectionConfig& config,
+                                           FileAnalysisResult& result) const;
+
+        dsp::time_domain_onset_detection::TimeDomainOnsetDetectionConfig config_;
+        unsigned jobs_;
+        std::shared_ptr<AnalysisResultCache> cache_;
+        BatchAnalysisSummary summary_;
+
+        std::shared_ptr<spdlog::logger> logger_;
+    };
+}
@@ -4,50 +4,164 @@
 
 #include "BpmFinderApp.h"
 #include <chrono>
+#include <ctime>
+#include <filesystem>
 #include <thread>
 
-#include "../files/bin/AudioBinFileSink.h"
 #include "dsp/time_domain_onset_detection/TimeDomainOnsetDetectionDspPipeline.h"
 
 namespace bpmfinder::app
 {
-    BpmFinderApp::BpmFinderApp() : running_(false), logger_(logging::LoggerFactory::GetLogger("BpmFinderApp"))
+    BpmFinderApp::BpmFinderApp(std::unique_ptr<audio::IAudioSource> source,
+                               const dsp::time_domain_onset_detection::TimeDomainOnsetDetectionConfig& config,
+                               const int durationSeconds, const size_t queueCapacity, std::string recordingFilename,
+                               std::string featureLogFilename)
+        : source_(std::move(source)),
+          config_(config),
+          durationSeconds_(durationSeconds),
+          queueCapacity_(queueCapacity),
+          recordingFilename_(std::move(recordingFilename)),
+          featureLogFilename_(std::move(featureLogFilename)),
+          publisher_(std::make_unique<dsp::time_domain_onset_detection::BpmResultPublisher>()),
+          running_(false),
+          logger_(logging::LoggerFactory::GetLogger("BpmFinderApp"))
     {
     }
 
-    BpmFinderApp::~BpmFinderApp() { Stop(); }
+    BpmFinderApp::~BpmFinderApp()
+    {
+        Stop();
+        if (snapshot_.valid())
+        {
+            snapshot_.wait();
+        }
+    }
 
-    void BpmFinderApp::Run()
+    bool BpmFinderApp::EnableFlightRecorder(const std::string& filename, const double seconds)
     {
-        auto chunkSize = 1024;
-        auto sampleRate = 48000;
-        auto bandPassLowCutoff = 40;
-        auto bandPassHighCutoff = 800;
-        auto bandPassGain = 1.0f;
+        files::recording::FlightRecorderOptions options;
+        options.sampleRate = static_cast<uint32_t>(config_.sampleRate);
+        options.chunkSize = static_cast<uint32_t>(config_.chunkSize);
+        options.seconds = seconds;
+
+        auto recorder = std::make_unique<files::recording::FlightRecorder>();
+        if (!recorder->Open(filename, options))
+        {
+            return false;
+        }
+        flightRecorder_ = std::move(recorder);
+        flightRecorderFilename_ = filename;
+        return true;
+    }
 
+    void BpmFinderApp::TakeSnapshot()
+    {
+        if (!flightRecorder_)
+        {
+            logger_->warn("Snapshot requested, but there is no flight recorder");
+            return;
+        }
+        if (snapshot_.valid() && snapshot_.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+        {
+            logger_->warn("Snapshot requested while the last one is still being written, ignored");
+            return;
+        }
+
+        char time[32];
+        const std::time_t now = std::time(nullptr);
+        std::strftime(time, sizeof(time), "%Y%m%d-%H%M%S", std::localtime(&now));
+        auto prefix = std::filesystem::path(flightRecorderFilename_);
+        prefix.replace_extension();
+        prefix += std::string("-snapshot-") + time;
+
+        // Writing a few hundred MB takes a while: the analysis goes on meanwhile
+        snapshot_ = std::async(std::launch::async, [this, prefix = prefix.string()]
+        {
+            if (flightRecorder_->Snapshot(prefix) < 0.0)
+            {
+                logger_->error("Snapshot {} failed", prefix);
+            }
+        });
+    }
+
+    bool BpmFinderApp::Run()
+    {
         dsp::time_domain_onset_detection::TimeDomainOnsetDetectionDspPipeline
-            dspPipeline(chunkSize, sampleRate, bandPassLowCutoff, bandPassHighCutoff, bandPassGain);
+            dspPipeline(*source_, config_, queueCapacity_, recordingFilename_, featureLogFilename_,
+                        flightRecorder_.get(), publisher_.get());
+        if (!dspPipeline.IsInitialized())
+        {
+            return false; // Nothing to analyze, the pipeline logged why
+        }
 
-        dspPipeline.Start();
+        dspPipeline.Start(executionMode_);
 
         running_ = true;
-        /**
-        while (running_)
+
+        if (durationSeconds_ > 0)
+        {
+            logger_->info("Analyzing for {} seconds...", durationSeconds_);
+        }
+        else
         {
-            std::this_thread::sleep_for(std::chrono::seconds(1));
+            logger_->info("Analyzing until the end of the stream...");
         }
-         **/
 
-        // Record for 10 seconds then stop gracefully
-        constexpr int recordingDurationSeconds = 30;
-        logger_->info("Recording for {} seconds...", recordingDurationSeconds);
-        for (int i = 0; i < recordingDurationSeconds && running_; ++i)
+        // The end of a file replay wakes us right away, the timeout only paces the log and the duration limit
+        constexpr auto pollInterval = std::chrono::milliseconds(100);
+        const auto start = std::chrono::steady_clock::now();
+        auto nextLog = start + std::chrono::seconds(1);
+        bool endOfStream = false;
+        while (running_ && !endOfStream)
+        {
+            const auto now = std::chrono::steady_clock::now();
+            if (durationSeconds_ > 0 && now - start >= std::chrono::seconds(durationSeconds_))
+            {
+                break;
+            }
+            if (now >= nextLog)
+            {
+                logger_->info("Analyzing... {} seconds, BPM: {:.1f}",
+                              std::chrono::duration_cast<std::chrono::seconds>(now - start).count(),
+                              dspPipeline.GetCurrentBpm());
+                nextLog += std::chrono::seconds(1);
+            }
+            if (snapshotRequested_.exchange(false, std::memory_order_relaxed))
+            {
+                TakeSnapshot();
+            }
+            endOfStream = dspPipeline.WaitForEndOfStream(pollInterval);
+        }
+
+        if (endOfStream)
+        {
+            dspPipeline.WaitUntilFinished(); // Waits for the sinks, everything the source sent went through the stages
+        }
+        else
+        {
+            dspPipeline.Stop();
+        }
+
+        publisher_->CloseResultBlock(); // The last estimate stays readable
+
+        if (const auto overruns = source_->GetOverrunCount(); overruns > 0)
+        {
+            logger_->warn("The source dropped {} samples in {} overruns", source_->GetLostSamples(), overruns);
+        }
+
+        // A request that came in at the very end still gets its snapshot, with everything the pipeline processed
+        if (snapshotRequested_.exchange(false, std::memory_order_relaxed))
+        {
+            TakeSnapshot();
+        }
+        if (snapshot_.valid())
         {
-            std::this_thread::sleep_for(std::chrono::seconds(1));
-            logger_->info("Recording... {}/{} seconds", i + 1, recordingDurationSeconds);
+            snapshot_.wait();
         }
 
-        dspPipeline.Stop();
+        lastBpm_ = dspPipeline.GetCurrentBpm();
+        logger_->info("BPM: {:.1f} after {} chunks", lastBpm_.load(), dspPipeline.GetProcessedChunkCount());
+        return true;
     }
 
     void BpmFinderApp::Stop()
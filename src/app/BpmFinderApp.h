@@ -4,6 +4,14 @@
 
 #pragma once
 #include <atomic>
+#include <future>
+#include <memory>
+#include <string>
+#include "audio/IAudioSource.h"
+#include "core/CopyObserver.h"
+#include "dsp/time_domain_onset_detection/BpmResultPublisher.h"
+#include "dsp/time_domain_onset_detection/TimeDomainOnsetDetectionConfig.h"
+#include "files/recording/FlightRecorder.h"
 #include "spdlog/logger.h"
 
 namespace bpmfinder::app
@@ -11,17 +19,65 @@ namespace bpmfinder::app
     class BpmFinderApp
     {
     public:
-        BpmFinderApp();
+        // durationSeconds limits how long Run analyzes, 0 = until the source reaches its end of stream or Stop.
+        // queueCapacity, recordingFilename and featureLogFilename are passed on to the pipeline.
+        BpmFinderApp(std::unique_ptr<audio::IAudioSource> source,
+                     const dsp::time_domain_onset_detection::TimeDomainOnsetDetectionConfig& config,
+                     int durationSeconds, size_t queueCapacity = 0,
+                     std::string recordingFilename = "waveform.bin", std::string featureLogFilename = "");
         ~BpmFinderApp();
 
-        // Start the main daemon loop (blocking)
-        void Run();
+        // Start the main daemon loop (blocking). False if the source could not be initialized, nothing was analyzed.
+        bool Run();
 
         // Stop the loop gracefully
         void Stop();
 
+        // Keeps the last 'seconds' of input and their features in a memory-mapped file while Run analyzes (see
+        // files/recording/FlightRecorder.h). Call before Run. False if the file could not be created.
+        bool EnableFlightRecorder(const std::string& filename, double seconds);
+
+        // Asks Run for a snapshot of the flight recorder, written next to its file as
+        // <name>-snapshot-<time>.bpmr/.bpmf by a background thread. Only sets a flag: safe from a signal handler.
+        void RequestSnapshot() { snapshotRequested_.store(true, std::memory_order_relaxed); }
+
+        // Threaded (default) or Inline, passed to the pipeline's Start. Inline suits sources that deliver faster than
+        // real time (a flat-out replay): the whole analysis runs on the source's thread. Call before Run.
+        void SetExecutionMode(const core::ExecutionMode mode) { executionMode_ = mode; }
+
+        // Publishes every estimate into the shared memory block 'name' for a front end in another process to poll
+        // (see ipc/SharedResultBlock.h). Call before Run. False if the block could not be created.
+        bool EnableResultBlock(const std::string& name) { return publisher_->OpenResultBlock(name); }
+
+        // Called with every estimate on a thread of its own, see dsp::time_domain_onset_detection::BpmResultPublisher
+        size_t AddBpmCallback(dsp::time_domain_onset_detection::BpmResultPublisher::Callback callback)
+        {
+            return publisher_->AddCallback(std::move(callback));
+        }
+
+        // BPM at the end of the last Run
+        [[nodiscard]] float GetLastBpm() const { return lastBpm_; }
+
     private:
+        void TakeSnapshot();
+
+        std::unique_ptr<audio::IAudioSource> source_;
+        dsp::time_domain_onset_detection::TimeDomainOnsetDetectionConfig config_;
+        int durationSeconds_;
+        size_t queueCapacity_;
+        std::string recordingFilename_;
+        std::string featureLogFilename_;
+        core::ExecutionMode executionMode_ = core::ExecutionMode::Threaded;
+
+        std::unique_ptr<files::recording::FlightRecorder> flightRecorder_;
+        std::string flightRecorderFilename_;
+        std::atomic<bool> snapshotRequested_{false};
+        std::future<void> snapshot_; // One at a time
+
+        std::unique_ptr<dsp::time_domain_onset_detection::BpmResultPublisher> publisher_;
+
         std::atomic<bool> running_;
+        std::atomic<float> lastBpm_{0.0f};
         std::shared_ptr<spdlog::logger> logger_;
     };
 }
@@ -3,8 +3,17 @@
 //
 
 #include "BpmFinderAppFactory.h"
+#include "audio/BinFileAudioSource.h"
+#include "audio/PcmStreamAudioSource.h"
+#include "audio/SharedMemoryAudioSource.h"
+#include "audio/WavFileAudioSource.h"
+#include "files/recording/RecordingReader.h"
+#ifdef _WIN32
+#include "audio/WasapiAudioSource.h"
+#endif
 #include "logging/LoggerFactory.h"
 #include <spdlog/spdlog.h>
+#include <filesystem>
 
 
 namespace bpmfinder::app
@@ -16,7 +25,8 @@ namespace bpmfinder::app
         const auto logger = logging::LoggerFactory::GetLogger("BpmFinderAppFactory");
         logger->info("Creating production app");
 
-        return std::make_unique<BpmFinderApp>();
+        constexpr dsp::time_domain_onset_detection::TimeDomainOnsetDetectionConfig config;
+        return std::make_unique<BpmFinderApp>(CreateLiveSource(config), config, LiveDurationSeconds);
     }
 
     std::unique_ptr<BpmFinderApp> BpmFinderAppFactory::CreateTestApp()
@@ -26,14 +36,210 @@ namespace bpmfinder::app
         const auto logger = logging::LoggerFactory::GetLogger("BpmFinderAppFactory");
         logger->info("Creating test app");
 
-        return std::make_unique<BpmFinderApp>();
+        constexpr dsp::time_domain_onset_detection::TimeDomainOnsetDetectionConfig config;
+        return std::make_unique<BpmFinderApp>(CreateLiveSource(config), config, LiveDurationSeconds);
+    }
+
+    std::unique_ptr<BpmFinderApp> BpmFinderAppFactory::CreateReplayApp(const std::string& filename,
+                                                                      const double speed, const double startSeconds,
+                                                                      const double durationSeconds,
+                                                                      const std::string& featureLogFilename)
+    {
+        InitializeLogging(true);
+
+        const auto logger = logging::LoggerFactory::GetLogger("BpmFinderAppFactory");
+        dsp::time_domain_onset_detection::TimeDomainOnsetDetectionConfig config;
+
+        // Recordings bring their sample rate, the pipeline has to run at it. Opening one only reads header and footer.
+        std::error_code error;
+        if (std::filesystem::is_regular_file(filename, error) &&
+            files::recording::RecordingReader::IsRecording(filename))
+        {
+            if (files::recording::RecordingReader reader; reader.Open(filename) && reader.GetSampleRate() > 0)
+            {
+                config.sampleRate = static_cast<int>(reader.GetSampleRate());
+            }
+        }
+
+        audio::BinFileReplayOptions options;
+        options.sampleRate = config.sampleRate;
+        options.startSeconds = startSeconds;
+        options.durationSeconds = durationSeconds;
+        size_t queueCapacity = 0;
+        if (speed > 0.0)
+        {
+            logger->info("Creating replay app for {} at {}x real time", filename, speed);
+            options.mode = audio::BinFileReplayMode::Paced;
+            options.speed = speed;
+        }
+        else
+        {
+            // Flat-out: bounded queues, so the source can only run as far ahead as the slowest stage allows
+            logger->info("Creating replay app for {}, flat-out", filename);
+            options.mode = audio::BinFileReplayMode::FlatOut;
+            queueCapacity = FlatOutQueueCapacity;
+        }
+
+        auto source = std::make_unique<audio::BinFileAudioSource>(filename, config.chunkSize);
+        source->SetReplayOptions(options);
+
+        // No recording: the input is a recording already
+        auto app = std::make_unique<BpmFinderApp>(std::move(source), config, 0, queueCapacity, "", featureLogFilename);
+        if (options.mode == audio::BinFileReplayMode::FlatOut)
+        {
+            app->SetExecutionMode(core::ExecutionMode::Inline); // Offline: one thread, no queues between the stages
+        }
+        return app;
+    }
+
+    std::unique_ptr<BpmFinderApp> BpmFinderAppFactory::CreateStreamApp(const std::string& path,
+                                                                      const audio::PcmStreamFormat& format)
+    {
+        InitializeLogging(true);
+
+        const auto logger = logging::LoggerFactory::GetLogger("BpmFinderAppFactory");
+        logger->info("Creating stream app for {}", path == "-" ? "stdin" : path);
+
+        dsp::time_domain_onset_detection::TimeDomainOnsetDetectionConfig config;
+        config.sampleRate = format.sampleRate;
+
+        // Bounded queues: a producer that is faster than real time (e.g. ffmpeg decoding a file) is throttled through
+        // the pipe instead of filling the memory. A real-time producer never fills them.
+        auto source = std::make_unique<audio::PcmStreamAudioSource>(path, format, config.chunkSize);
+        return std::make_unique<BpmFinderApp>(std::move(source), config, 0, FlatOutQueueCapacity, "");
+    }
+
+    std::unique_ptr<BpmFinderApp> BpmFinderAppFactory::CreateWavApp(const std::string& path,
+                                                                   const int pipedSampleRate)
+    {
+        InitializeLogging(true);
+
+        const auto logger = logging::LoggerFactory::GetLogger("BpmFinderAppFactory");
+        logger->info("Creating WAV app for {}", path == "-" ? "stdin" : path);
+
+        // The pipeline runs at the sample rate of the file. A piped WAV can only be read once, so its header is not
+        // known yet here and the rate has to be given; the source refuses a header with another one.
+        dsp::time_domain_onset_detection::TimeDomainOnsetDetectionConfig config;
+        config.sampleRate = pipedSampleRate;
+        int expectedSampleRate = 0;
+        std::error_code error;
+        if (std::filesystem::is_regular_file(path, error))
+        {
+            if (const auto header = audio::WavFileAudioSource::ReadFileHeader(path))
+            {
+                config.sampleRate = header->format.sampleRate;
+            }
+        }
+        else
+        {
+            logger->info("Expecting {} Hz for the piped WAV", config.sampleRate);
+            expectedSampleRate = config.sampleRate;
+        }
+
+        auto source = std::make_unique<audio::WavFileAudioSource>(
+            path, config.chunkSize, audio::WavFileAudioSource::DefaultReadBufferBytes, expectedSampleRate);
+        return std::make_unique<BpmFinderApp>(std::move(source), config, 0, FlatOutQueueCapacity, "");
+    }
+
+    std::unique_ptr<BpmFinderApp> BpmFinderAppFactory::CreateGeneratorApp(const audio::SignalGeneratorOptions& options)
+    {
+        InitializeLogging(true);
+
+        const auto logger = logging::LoggerFactory::GetLogger("BpmFinderAppFactory");
+        logger->info("Creating generator app");
+
+        dsp::time_domain_onset_detection::TimeDomainOnsetDetectionConfig config;
+        config.sampleRate = options.sampleRate;
+
+        // Flat-out needs bounded queues like a flat-out replay, paced it behaves like a live capture
+        const size_t queueCapacity = options.speed > 0.0 ? 0 : FlatOutQueueCapacity;
+        auto source = std::make_unique<audio::SignalGeneratorAudioSource>(options, config.chunkSize);
+        return std::make_unique<BpmFinderApp>(std::move(source), config, 0, queueCapacity, "");
+    }
+
+    std::unique_ptr<BpmFinderApp> BpmFinderAppFactory::CreateSharedMemoryApp(const std::string& name)
+    {
+        InitializeLogging(true);
+
+        const auto logger = logging::LoggerFactory::GetLogger("BpmFinderAppFactory");
+        logger->info("Creating shared memory app for {}", name);
+
+        dsp::time_domain_onset_detection::TimeDomainOnsetDetectionConfig config;
+        if (const auto format = audio::SharedMemoryAudioSource::ReadFormat(name))
+        {
+            config.sampleRate = format->sampleRate;
+        }
+
+        // Unbounded queues like a live capture: the producer never waits, a source that is held back would only
+        // fall behind the ring and lose samples
+        auto source = std::make_unique<audio::SharedMemoryAudioSource>(name, config.chunkSize);
+        return std::make_unique<BpmFinderApp>(std::move(source), config, 0, 0, "");
+    }
+
+    std::unique_ptr<BpmFinderApp> BpmFinderAppFactory::CreateRtpApp(const audio::RtpAudioSourceOptions& options)
+    {
+        InitializeLogging(true);
+
+        const auto logger = logging::LoggerFactory::GetLogger("BpmFinderAppFactory");
+        logger->info("Creating RTP app for port {}", options.port);
+
+        dsp::time_domain_onset_detection::TimeDomainOnsetDetectionConfig config;
+        config.sampleRate = options.sampleRate;
+
+        // Unbounded queues: the I/O thread serves every network source, holding it back would stall all of them
+        auto source = std::make_unique<audio::RtpAudioSource>(options, config.chunkSize);
+        return std::make_unique<BpmFinderApp>(std::move(source), config, 0, 0, "");
+    }
+
+    std::unique_ptr<BatchAnalyzer> BpmFinderAppFactory::CreateBatchAnalyzer(
+        const unsigned jobs, const std::filesystem::path& cacheDirectory)
+    {
+        InitializeLogging(true);
+
+        const auto logger = logging::LoggerFactory::GetLogger("BpmFinderAppFactory");
+        logger->info("Creating batch analyzer");
+
+        std::shared_ptr<AnalysisResultCache> cache;
+        if (!cacheDirectory.empty())
+        {
+            logger->info("Using result cache in {}", cacheDirectory.string());
+            cache = std::make_shared<AnalysisResultCache>(cacheDirectory);
+        }
+
+        return std::make_unique<BatchAnalyzer>(dsp::time_domain_onset_detection::TimeDomainOnsetDetectionConfig{},
+                                               jobs, std::move(cache));
+    }
+
+    std::unique_ptr<ParameterSweep> BpmFinderAppFactory::CreateParameterSweep(
+        ParameterGrid grid, const unsigned jobs, const float tolerance)
+    {
+        InitializeLogging(true);
+
+        const auto logger = logging::LoggerFactory::GetLogger("BpmFinderAppFactory");
+        logger->info("Creating parameter sweep");
+
+        return std::make_unique<ParameterSweep>(std::move(grid), jobs, tolerance);
+    }
+
+    std::unique_ptr<audio::IAudioSource> BpmFinderAppFactory::CreateLiveSource(
+        const dsp::time_domain_onset_detection::TimeDomainOnsetDetectionConfig& config)
+    {
+#ifdef _WIN32
+        return std::make_unique<audio::WasapiAudioSource>(config.chunkSize);
+#else
+        // No WASAPI: mono float PCM at the configured rate from stdin
+        audio::PcmStreamFormat format;
+        format.sampleRate = config.sampleRate;
+        return std::make_unique<audio::PcmStreamAudioSource>("-", format, config.chunkSize);
+#endif
     }
 
     void BpmFinderAppFactory::InitializeLogging(bool isProduction)
     {
         if (isProduction)
         {
-            logging::LoggerFactory::Initialize(spdlog::level::info);
+            // The stages only queue their messages, the console is written by the logging thread
+            logging::LoggerFactory::InitializeAsync(spdlog::level::info);
         }
         else
         {
@@ -4,7 +4,13 @@
 
 #pragma once
 #include <memory>
+#include <string>
+#include "BatchAnalyzer.h"
 #include "BpmFinderApp.h"
+#include "ParameterSweep.h"
+#include "audio/PcmStreamAudioSource.h"
+#include "audio/RtpAudioSource.h"
+#include "audio/SignalGeneratorAudioSource.h"
 
 namespace bpmfinder::app
 {
@@ -15,7 +21,48 @@ namespace bpmfinder::app
 
         static std::unique_ptr<BpmFinderApp> CreateTestApp();
 
+        // Replays a waveform.bin or *.bpmr recording through the live pipeline until its end.
+        // speed > 0 paces the replay at that multiple of real time, speed = 0 replays flat-out with backpressure.
+        // Of a *.bpmr only durationSeconds from startSeconds on are replayed (0 = up to the end), found through its
+        // index without reading what comes before. A featureLogFilename logs the features of every chunk.
+        static std::unique_ptr<BpmFinderApp> CreateReplayApp(const std::string& filename, double speed,
+                                                             double startSeconds = 0.0, double durationSeconds = 0.0,
+                                                             const std::string& featureLogFilename = "");
+
+        // Analyzes raw PCM from stdin ("-") or a FIFO until the input ends or the app is stopped
+        static std::unique_ptr<BpmFinderApp> CreateStreamApp(const std::string& path,
+                                                             const audio::PcmStreamFormat& format);
+
+        // Analyzes a WAV file at the sample rate in its header. A WAV on stdin ("-") or a FIFO is analyzed at
+        // pipedSampleRate, its header can not be read up front; Run fails if the header has another rate.
+        static std::unique_ptr<BpmFinderApp> CreateWavApp(const std::string& path, int pipedSampleRate = 48000);
+
+        // Analyzes synthetic test material at the sample rate of the options, paced or flat-out (options.speed = 0)
+        static std::unique_ptr<BpmFinderApp> CreateGeneratorApp(const audio::SignalGeneratorOptions& options);
+
+        // Analyzes what a producer process writes into the shared memory ring 'name', at the sample rate of the ring
+        static std::unique_ptr<BpmFinderApp> CreateSharedMemoryApp(const std::string& name);
+
+        // Analyzes PCM received over UDP or RTP at the sample rate of the options, until stopped
+        static std::unique_ptr<BpmFinderApp> CreateRtpApp(const audio::RtpAudioSourceOptions& options);
+
+        // Offline analysis of recordings, jobs = 0 uses one worker per hardware thread.
+        // An empty cache directory disables the result cache.
+        static std::unique_ptr<BatchAnalyzer> CreateBatchAnalyzer(unsigned jobs,
+                                                                  const std::filesystem::path& cacheDirectory = {});
+
+        // Evaluation of a parameter grid on a labelled corpus
+        static std::unique_ptr<ParameterSweep> CreateParameterSweep(ParameterGrid grid, unsigned jobs,
+                                                                    float tolerance);
+
     private:
+        // WASAPI loopback capture on Windows, stdin everywhere else
+        static std::unique_ptr<audio::IAudioSource> CreateLiveSource(
+            const dsp::time_domain_onset_detection::TimeDomainOnsetDetectionConfig& config);
+
         static void InitializeLogging(bool isProduction);
+
+        static constexpr int LiveDurationSeconds = 30;
+        static constexpr size_t FlatOutQueueCapacity = 16;
     };
 }
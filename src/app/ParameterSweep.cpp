@@ -0,0 +1,276 @@
+//
+// Created by Robert on 2025-10-31.
+//
+
+#include "ParameterSweep.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <map>
+#include <numeric>
+#include <sstream>
+#include <thread>
+#include <tuple>
+#include "AudioFileLoader.h"
+#include "dsp/time_domain_onset_detection/OnsetSeries.h"
+#include "dsp/time_domain_onset_detection/TempoEstimation.h"
+#include "logging/LoggerFactory.h"
+
+namespace bpmfinder::app
+{
+    using dsp::time_domain_onset_detection::TimeDomainOnsetDetectionConfig;
+
+    namespace
+    {
+        // Inner node of the prefix tree: one onset curve per recording, shared by all leaves (combination indices)
+        struct UpstreamNode
+        {
+            TimeDomainOnsetDetectionConfig config;
+            std::vector<size_t> leaves;
+        };
+
+        std::vector<UpstreamNode> BuildPrefixTree(const std::vector<TimeDomainOnsetDetectionConfig>& configurations)
+        {
+            std::vector<UpstreamNode> nodes;
+            std::map<std::tuple<int, int, int, int, float>, size_t> nodeIndex;
+
+            for (size_t i = 0; i < configurations.size(); ++i)
+            {
+                const auto& config = configurations[i];
+                const auto key = std::make_tuple(config.sampleRate, config.chunkSize, config.bandPassLowCutoff,
+                                                 config.bandPassHighCutoff, config.bandPassGain);
+
+                auto [it, inserted] = nodeIndex.try_emplace(key, nodes.size());
+                if (inserted)
+                {
+                    nodes.push_back({config, {}});
+                }
+                nodes[it->second].leaves.push_back(i);
+            }
+
+            return nodes;
+        }
+
+        // Runs work(index) for every index in [0, count) on up to 'jobs' threads
+        template <typename Work>
+        void RunOnWorkers(const size_t count, const unsigned jobs, Work work)
+        {
+            std::atomic<size_t> next{0};
+            std::vector<std::thread> workers;
+            const size_t workerCount = std::min<size_t>(jobs, count);
+            workers.reserve(workerCount);
+            for (size_t w = 0; w < workerCount; ++w)
+            {
+                workers.emplace_back([&]
+                {
+                    for (size_t i = next++; i < count; i = next++)
+                    {
+                        work(i);
+                    }
+                });
+            }
+            for (auto& worker : workers)
+            {
+                worker.join();
+            }
+        }
+
+        double SecondsSince(const std::chrono::steady_clock::time_point start)
+        {
+            return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+    }
+
+    std::vector<TimeDomainOnsetDetectionConfig> ParameterGrid::GetConfigurations() const
+    {
+        std::vector<TimeDomainOnsetDetectionConfig> configurations;
+        for (const auto& [low, high] : bandPassCutoffs)
+        {
+            for (const int window : slidingWindowSizeSeconds)
+            {
+                for (const float threshold : peakThresholds)
+                {
+                    auto config = base;
+                    config.bandPassLowCutoff = low;
+                    config.bandPassHighCutoff = high;
+                    config.slidingWindowSizeSeconds = window;
+                    config.peakThreshold = threshold;
+                    configurations.push_back(config);
+                }
+            }
+        }
+        return configurations;
+    }
+
+    ParameterSweep::ParameterSweep(ParameterGrid grid, const unsigned jobs, const float tolerance)
+        : grid_(std::move(grid)),
+          jobs_(jobs > 0 ? jobs : std::max(1u, std::thread::hardware_concurrency())),
+          tolerance_(tolerance),
+          logger_(logging::LoggerFactory::GetLogger("ParameterSweep"))
+    {
+    }
+
+    std::vector<SweepCombinationResult> ParameterSweep::Run(const std::vector<LabelledRecording>& corpus)
+    {
+        const auto start = std::chrono::steady_clock::now();
+
+        const auto configurations = grid_.GetConfigurations();
+        const auto nodes = BuildPrefixTree(configurations);
+
+        std::vector<SweepCombinationResult> results(configurations.size());
+        for (size_t c = 0; c < configurations.size(); ++c)
+        {
+            results[c].config = configurations[c];
+            results[c].bpm.assign(corpus.size(), 0.0f);
+        }
+
+        logger_->info("Sweeping {} combinations ({} upstream nodes) over {} recordings with {} workers",
+                      configurations.size(), nodes.size(), corpus.size(), jobs_);
+
+        // 1. Root level: read every recording once, mono at its own sample rate
+        std::vector<AudioFileLoader> recordings(corpus.size());
+        std::vector<char> loaded(corpus.size(), 0);
+        std::vector<double> loadSeconds(corpus.size(), 0.0);
+        RunOnWorkers(corpus.size(), jobs_, [&](const size_t r)
+        {
+            const auto loadStart = std::chrono::steady_clock::now();
+            std::string error;
+            loaded[r] = recordings[r].Load(corpus[r].file, grid_.base.sampleRate, grid_.base.inputChannel, error);
+            loadSeconds[r] = SecondsSince(loadStart);
+            if (!loaded[r])
+            {
+                logger_->error("{}: {}", corpus[r].file.string(), error);
+            }
+        });
+
+        // 2. One work item per recording and upstream node: onset curve once, then every leaf below the node.
+        // Every leaf writes its own slot, so the workers never share an output.
+        const size_t itemCount = corpus.size() * nodes.size();
+        std::vector<double> upstreamSeconds(itemCount, 0.0);
+        std::vector<double> downstreamSeconds(itemCount, 0.0);
+        RunOnWorkers(itemCount, jobs_, [&](const size_t item)
+        {
+            const size_t r = item / nodes.size();
+            const auto& node = nodes[item % nodes.size()];
+            if (!loaded[r])
+            {
+                return;
+            }
+            const auto& recording = recordings[r];
+
+            const auto upstreamStart = std::chrono::steady_clock::now();
+            auto config = node.config;
+            config.sampleRate = recording.GetSampleRate();
+            const auto series = dsp::time_domain_onset_detection::CalculateOnsetSeries(
+                recording.GetSamples(), recording.GetSampleCount(), config);
+            upstreamSeconds[item] = SecondsSince(upstreamStart);
+
+            const auto downstreamStart = std::chrono::steady_clock::now();
+            for (const size_t leaf : node.leaves)
+            {
+                config = configurations[leaf];
+                config.sampleRate = recording.GetSampleRate();
+                results[leaf].bpm[r] = dsp::time_domain_onset_detection::EstimateTempoFromOnsetSeries(
+                    series.onsetStrength, config);
+            }
+            downstreamSeconds[item] = SecondsSince(downstreamStart);
+        });
+
+        // 3. Score every combination against the labels, unreadable recordings count as wrong
+        for (auto& result : results)
+        {
+            double absoluteErrorSum = 0.0;
+            for (size_t r = 0; r < corpus.size(); ++r)
+            {
+                const double error = std::abs(result.bpm[r] - corpus[r].bpm);
+                absoluteErrorSum += error;
+                if (loaded[r] && error <= tolerance_ * corpus[r].bpm)
+                {
+                    ++result.correctCount;
+                }
+            }
+            result.accuracy = corpus.empty() ? 0.0 : static_cast<double>(result.correctCount) / corpus.size();
+            result.meanAbsoluteError = corpus.empty() ? 0.0 : absoluteErrorSum / corpus.size();
+        }
+
+        summary_ = {};
+        summary_.recordingCount = corpus.size();
+        summary_.failedRecordingCount = static_cast<size_t>(std::count(loaded.begin(), loaded.end(), 0));
+        summary_.combinationCount = configurations.size();
+        summary_.upstreamComputations = (corpus.size() - summary_.failedRecordingCount) * nodes.size();
+        summary_.downstreamComputations = (corpus.size() - summary_.failedRecordingCount) * configurations.size();
+        summary_.loadSeconds = std::accumulate(loadSeconds.begin(), loadSeconds.end(), 0.0);
+        summary_.upstreamSeconds = std::accumulate(upstreamSeconds.begin(), upstreamSeconds.end(), 0.0);
+        summary_.downstreamSeconds = std::accumulate(downstreamSeconds.begin(), downstreamSeconds.end(), 0.0);
+        summary_.wallSeconds = SecondsSince(start);
+
+        logger_->info("Sweep finished in {:.3f} s: {} upstream and {} downstream computations "
+                      "(load {:.3f} s, upstream {:.3f} s, downstream {:.3f} s, summed over workers)",
+                      summary_.wallSeconds, summary_.upstreamComputations, summary_.downstreamComputations,
+                      summary_.loadSeconds, summary_.upstreamSeconds, summary_.downstreamSeconds);
+
+        return results;
+    }
+
+    std::vector<LabelledRecording> ParameterSweep::LoadLabels(const std::filesystem::path& labelsFile)
+    {
+        std::vector<LabelledRecording> corpus;
+        std::ifstream in(labelsFile);
+        std::string line;
+        while (std::getline(in, line))
+        {
+            if (!line.empty() && line.back() == '\r')
+            {
+                line.pop_back();
+            }
+
+            const auto separator = line.rfind(',');
+            if (separator == std::string::npos)
+            {
+                continue;
+            }
+
+            std::filesystem::path file = line.substr(0, separator);
+            float bpm;
+            std::istringstream bpmText(line.substr(separator + 1));
+            if (!(bpmText >> bpm))
+            {
+                continue; // Header or malformed line
+            }
+
+            if (file.is_relative())
+            {
+                file = labelsFile.parent_path() / file;
+            }
+            corpus.push_back({file, bpm});
+        }
+        return corpus;
+    }
+
+    bool ParameterSweep::WriteResults(const std::filesystem::path& outputFile,
+                                      const std::vector<SweepCombinationResult>& results)
+    {
+        std::ofstream out(outputFile);
+        if (!out.is_open())
+        {
+            return false;
+        }
+
+        out << "low_cutoff,high_cutoff,window_seconds,peak_threshold,accuracy,mean_absolute_error,correct,recordings\n";
+        for (const auto& result : results)
+        {
+            out << result.config.bandPassLowCutoff << ','
+                << result.config.bandPassHighCutoff << ','
+                << result.config.slidingWindowSizeSeconds << ','
+                << result.config.peakThreshold << ','
+                << result.accuracy << ','
+                << result.meanAbsoluteError << ','
+                << result.correctCount << ','
+                << result.bpm.size() << '\n';
+        }
+
+        return out.good();
+    }
+}
@@ -0,0 +1,95 @@
+//
+// Created by Robert on 2025-10-31.
+//
+
+#pragma once
+#include <filesystem>
+#include <memory>
+#include <utility>
+#include <vector>
+#include "dsp/time_domain_onset_detection/TimeDomainOnsetDetectionConfig.h"
+#include "spdlog/logger.h"
+
+namespace bpmfinder::app
+{
+    struct LabelledRecording
+    {
+        std::filesystem::path file; // Any format analyze reads, see AudioFileLoader
+        float bpm; // Ground truth
+    };
+
+    // Every combination of the values is evaluated. Parameters that are not swept (sample rate, chunk size, gain) are
+    // taken from the base config; WAV files and recordings (*.bpmr) are analyzed at their own sample rate.
+    struct ParameterGrid
+    {
+        dsp::time_domain_onset_detection::TimeDomainOnsetDetectionConfig base;
+        std::vector<std::pair<int, int>> bandPassCutoffs; // (low, high)
+        std::vector<int> slidingWindowSizeSeconds;
+        std::vector<float> peakThresholds;
+
+        [[nodiscard]] std::vector<dsp::time_domain_onset_detection::TimeDomainOnsetDetectionConfig>
+        GetConfigurations() const;
+    };
+
+    struct SweepCombinationResult
+    {
+        dsp::time_domain_onset_detection::TimeDomainOnsetDetectionConfig config;
+        std::vector<float> bpm; // Per recording, in corpus order
+        size_t correctCount = 0;
+        double accuracy = 0.0; // Fraction of recordings within the tolerance
+        double meanAbsoluteError = 0.0; // In BPM
+    };
+
+    struct SweepSummary
+    {
+        size_t recordingCount = 0;
+        size_t failedRecordingCount = 0;
+        size_t combinationCount = 0;
+        size_t upstreamComputations = 0; // Filter + energy + onset runs, one per recording and upstream node
+        size_t downstreamComputations = 0; // Tempo estimations, one per recording and combination
+
+        // Summed over all workers
+        double loadSeconds = 0.0;
+        double upstreamSeconds = 0.0;
+        double downstreamSeconds = 0.0;
+
+        double wallSeconds = 0.0;
+    };
+
+    // Evaluates a parameter grid on a labelled corpus.
+    //
+    // The configurations form a prefix tree along the pipeline: recording -> upstream node (everything that shapes the
+    // onset curve: cutoffs, gain, sample rate, chunk size) -> leaves (window, threshold). Every recording is read once,
+    // every upstream node runs the filter, energy and onset stages once per recording, and all leaves below it only
+    // replay the cheap tempo estimation on the shared onset curve. With C cutoff pairs and D downstream variants the
+    // filter runs C instead of C * D times per recording.
+    //
+    // Work items are (recording, upstream node) pairs, spread across a pool of workers.
+    class ParameterSweep
+    {
+    public:
+        // jobs = 0 uses one worker per hardware thread. A BPM counts as correct within tolerance * label.
+        explicit ParameterSweep(ParameterGrid grid, unsigned jobs = 0, float tolerance = 0.04f);
+
+        // Results are in the order of ParameterGrid::GetConfigurations. All recordings are held in memory while
+        // the sweep runs.
+        [[nodiscard]] std::vector<SweepCombinationResult> Run(const std::vector<LabelledRecording>& corpus);
+
+        [[nodiscard]] const SweepSummary& GetSummary() const { return summary_; }
+
+        // CSV with the columns file,bpm. Relative paths are relative to the labels file.
+        static std::vector<LabelledRecording> LoadLabels(const std::filesystem::path& labelsFile);
+
+        // One CSV row per combination
+        static bool WriteResults(const std::filesystem::path& outputFile,
+                                 const std::vector<SweepCombinationResult>& results);
+
+    private:
+        ParameterGrid grid_;
+        unsigned jobs_;
+        float tolerance_;
+        SweepSummary summary_;
+
+        std::shared_ptr<spdlog::logger> logger_;
+    };
+}
@@ -3,15 +3,37 @@
 //
 
 #include "BinFileAudioSource.h"
-#include <iostream>
-#include <chrono>
-#include <thread>
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include "logging/LoggerFactory.h"
 
 using namespace bpmfinder::audio;
 
-BinFileAudioSource::BinFileAudioSource(const std::string& filename, const size_t chunkSize) :
+namespace
+{
+    // Give consumed pages back to the OS in steps of 4 MB, so the resident set stays flat for files of any size
+    constexpr size_t ReleaseStepSamples = (4 * 1024 * 1024) / sizeof(float);
+
+    // ReadSamples reads input of unknown size (pipes) in blocks of 1 MB
+    constexpr size_t ReadBlockSamples = (1024 * 1024) / sizeof(float);
+
+    // Only regular files: peeking at the header of a pipe would eat its first bytes
+    bool IsRecordingFile(const std::string& filename)
+    {
+        std::error_code error;
+        return std::filesystem::is_regular_file(filename, error) &&
+            bpmfinder::files::recording::RecordingReader::IsRecording(filename);
+    }
+}
+
+BinFileAudioSource::BinFileAudioSource(const std::string& filename, const size_t chunkSize,
+                                       const BinFileReadMode mode, const size_t readAheadChunks) :
     filename_(filename),
-    chunkSize_(chunkSize)
+    chunkSize_(chunkSize),
+    mode_(mode),
+    readAheadChunks_(std::max<size_t>(1, readAheadChunks)),
+    logger_(logging::LoggerFactory::GetLogger("BinFileAudioSource"))
 {
 }
 
@@ -22,62 +44,375 @@ BinFileAudioSource::~BinFileAudioSource()
 
 bool BinFileAudioSource::Initialize()
 {
-    // A second call to Initialize should just rewind to the start of the file, no need to read in the whole file again
-    if (!samples_.empty())
+    finished_ = false;
+
+    if (!recording_ && IsRecordingFile(filename_))
+    {
+        recording_ = std::make_unique<files::recording::RecordingReader>();
+        if (!recording_->Open(filename_))
+        {
+            recording_.reset();
+            return false;
+        }
+        logger_->info("Replaying recording {}: {} Hz, {} channels, {:.1f} s", filename_,
+                      recording_->GetSampleRate(), recording_->GetChannels(), recording_->GetDurationSeconds());
+    }
+
+    // Recordings seek to the start of the range straight away, a second call rewinds to it
+    if (recording_)
+    {
+        recordingCursor_ = recording_->GetFrameAt(replayOptions_.startSeconds);
+        recordingEnd_ = replayOptions_.durationSeconds > 0.0
+                            ? recording_->GetFrameAt(replayOptions_.startSeconds + replayOptions_.durationSeconds)
+                            : recording_->GetFrameCount();
+        return recordingCursor_ < recordingEnd_;
+    }
+
+    // A second call to Initialize should just rewind to the start of the file, no need to map it again
+    if (mode_ == BinFileReadMode::MemoryMapped && mappedFile_.IsOpen())
     {
         cursor_ = 0;
+        return sampleCount_ > 0;
+    }
+
+    if (mode_ == BinFileReadMode::MemoryMapped)
+    {
+        if (mappedFile_.Open(filename_))
+        {
+            cursor_ = 0;
+            sampleCount_ = mappedFile_.GetSize() / sizeof(float);
+            return sampleCount_ > 0;
+        }
+
+        logger_->info("Can not map {}, falling back to streaming", filename_);
+        mode_ = BinFileReadMode::Streaming;
+    }
+
+    // Streaming: (re)open, pipes can only be read once
+    stream_.close();
+    stream_.clear();
+    stream_.open(filename_, std::ios::binary);
+    if (!stream_.is_open())
+    {
+        logger_->error("Failed to open file: {}", filename_);
+        return false;
+    }
+
+    readAhead_.clear();
+    readerDone_ = false;
+    return true;
+}
+
+int BinFileAudioSource::GetChannelCount() const
+{
+    return recording_ ? static_cast<int>(recording_->GetChannels()) : 1;
+}
+
+int BinFileAudioSource::GetSampleRate() const
+{
+    return recording_ ? static_cast<int>(recording_->GetSampleRate()) : replayOptions_.sampleRate;
+}
+
+bool BinFileAudioSource::ReadSamples(const std::string& filename, std::vector<float>& samples, int* sampleRate,
+                                     int* channels)
+{
+    if (IsRecordingFile(filename))
+    {
+        files::recording::RecordingReader reader;
+        if (!reader.Open(filename))
+        {
+            return false;
+        }
+
+        // Up to the first damaged block, if there is one
+        samples.resize(static_cast<size_t>(reader.GetFrameCount()) * reader.GetChannels());
+        const size_t frames = reader.ReadFrames(0, static_cast<size_t>(reader.GetFrameCount()), samples.data());
+        samples.resize(frames * reader.GetChannels());
+        if (sampleRate != nullptr)
+        {
+            *sampleRate = static_cast<int>(reader.GetSampleRate());
+        }
+        if (channels != nullptr)
+        {
+            *channels = static_cast<int>(reader.GetChannels());
+        }
         return true;
     }
 
     // Read raw floats from binary file
-    std::ifstream file(filename_, std::ios::binary);
+    std::ifstream file(filename, std::ios::binary);
     if (!file.is_open())
     {
-        std::cerr << "Failed to open file: " << filename_ << std::endl;
         return false;
     }
 
-    // Get file size
-    file.seekg(0, std::ios::end);
-    size_t fileSize = file.tellg();
-    file.seekg(0, std::ios::beg);
+    // The size is only a hint: pipes have none and can not seek, so we read blocks until the end of the input
+    samples.clear();
+    std::error_code error;
+    if (const auto fileSize = std::filesystem::file_size(filename, error); !error)
+    {
+        samples.reserve(static_cast<size_t>(fileSize) / sizeof(float) + ReadBlockSamples);
+    }
 
-    // Read all floats at once
-    size_t numSamples = fileSize / sizeof(float);
-    samples_.resize(numSamples);
-    file.read(reinterpret_cast<char*>(samples_.data()), fileSize);
+    size_t bytesRead = 0;
+    while (file)
+    {
+        // Bytes go in behind the last read, so a float split between two reads is put together again
+        samples.resize(bytesRead / sizeof(float) + ReadBlockSamples);
+        const size_t space = samples.size() * sizeof(float) - bytesRead;
+        file.read(reinterpret_cast<char*>(samples.data()) + bytesRead, static_cast<std::streamsize>(space));
+        bytesRead += static_cast<size_t>(file.gcount());
+    }
 
-    return !samples_.empty();
+    // The end of the input sets failbit and eofbit, a read error badbit
+    if (file.bad())
+    {
+        samples.clear();
+        return false;
+    }
+    samples.resize(bytesRead / sizeof(float)); // Drop a trailing partial float
+    return true;
 }
 
 void BinFileAudioSource::Start()
 {
+    if (running_)
+    {
+        return;
+    }
+
+    handoff_.reset();
+    if (replayOptions_.mode == BinFileReplayMode::Paced)
+    {
+        handoff_ = std::make_unique<CaptureHandoff>(chunkSize_ * GetChannelCount(), HandoffCapacityChunks,
+                                                    [this](const AudioChunk& chunk) { Notify(chunk); },
+                                                    [this] { EndStream(); });
+        handoff_->Start();
+    }
+
     running_ = true;
+    if (mode_ == BinFileReadMode::Streaming && !recording_)
+    {
+        reader_ = std::thread(&BinFileAudioSource::ReadAheadLoop, this);
+    }
     worker_ = std::thread(&BinFileAudioSource::CaptureLoop, this);
 }
 
 void BinFileAudioSource::CaptureLoop()
 {
-    while (running_ && samples_.size() > 0)
+    const bool paced = replayOptions_.mode == BinFileReplayMode::Paced && GetSampleRate() > 0 &&
+        replayOptions_.speed > 0.0;
+    const double samplesPerSecond = GetSampleRate() * GetChannelCount() * replayOptions_.speed;
+    const auto start = std::chrono::steady_clock::now();
+    size_t samplesSent = 0;
+
+    AudioChunk chunk;
+    while (running_)
     {
-        auto samplesToReturn = GetNextChunk(chunkSize_);
-        Notify(samplesToReturn);
+        if (!GetNextChunk(chunk))
+        {
+            // End of file or stopped, either way there is nothing more to send. At the end of the file the end of
+            // stream follows the last chunk; paced, the dispatcher sends it once it passed that chunk on.
+            if (paced && finished_)
+            {
+                handoff_->Close();
+            }
+            else if (finished_)
+            {
+                EndStream();
+            }
+            return;
+        }
+
+        if (paced)
+        {
+            // Release times are computed from the start, not from the previous chunk, so they never drift
+            samplesSent += chunk.size();
+            const auto releaseTime = start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                std::chrono::duration<double>(static_cast<double>(samplesSent) / samplesPerSecond));
+            if (!WaitForReleaseTime(releaseTime))
+            {
+                return;
+            }
+
+            handoff_->Write(chunk.data(), chunk.size());
+            continue;
+        }
+
+        // In flat-out mode this blocks while a bounded subscriber is full: that is the backpressure
+        Notify(chunk);
     }
 }
 
-std::vector<float> BinFileAudioSource::GetNextChunk(size_t n)
+bool BinFileAudioSource::IsFinished() const
 {
-    const size_t end = std::min(cursor_ + n, samples_.size());
-    std::vector<float> chunk(samples_.begin() + cursor_, samples_.begin() + end);
-    cursor_ = end;
-    return chunk;
+    // A paced replay has finished once the dispatcher passed on the last chunk, not when it was released
+    return finished_ && (!handoff_ || handoff_->IsDrained());
+}
+
+uint64_t BinFileAudioSource::GetOverrunCount() const
+{
+    return handoff_ ? handoff_->GetStatistics().overrunCount : 0;
+}
+
+uint64_t BinFileAudioSource::GetLostSamples() const
+{
+    return handoff_ ? handoff_->GetStatistics().lostSamples : 0;
+}
+
+bool BinFileAudioSource::WaitForReleaseTime(const std::chrono::steady_clock::time_point releaseTime)
+{
+    std::unique_lock lock(pacingMutex_);
+    return !pacingCv_.wait_until(lock, releaseTime, [this] { return !running_; });
+}
+
+bool BinFileAudioSource::GetNextChunk(AudioChunk& chunk)
+{
+    if (recording_)
+    {
+        return GetNextRecordingChunk(chunk);
+    }
+    return mode_ == BinFileReadMode::MemoryMapped ? GetNextMappedChunk(chunk) : GetNextStreamedChunk(chunk);
+}
+
+bool BinFileAudioSource::GetNextMappedChunk(AudioChunk& chunk)
+{
+    if (cursor_ >= sampleCount_)
+    {
+        finished_ = true;
+        return false;
+    }
+
+    const size_t count = std::min(chunkSize_, sampleCount_ - cursor_);
+    chunk.resize(count);
+    std::memcpy(chunk.data(), mappedFile_.GetData() + cursor_ * sizeof(float), count * sizeof(float));
+
+    // Only the pages of one release step stay resident behind the cursor
+    const size_t previousStep = cursor_ / ReleaseStepSamples;
+    cursor_ += count;
+    if (cursor_ / ReleaseStepSamples != previousStep)
+    {
+        mappedFile_.ReleaseBefore(cursor_ / ReleaseStepSamples * ReleaseStepSamples * sizeof(float));
+    }
+
+    return true;
+}
+
+bool BinFileAudioSource::GetNextRecordingChunk(AudioChunk& chunk)
+{
+    if (recordingCursor_ >= recordingEnd_)
+    {
+        finished_ = true;
+        return false;
+    }
+
+    // chunkSize_ frames of all channels, the downmix behind the source makes them chunkSize_ samples again
+    const size_t channels = recording_->GetChannels();
+    const size_t frames = std::min<size_t>(chunkSize_, recordingEnd_ - recordingCursor_);
+    chunk.resize(frames * channels);
+    const size_t read = recording_->ReadFrames(recordingCursor_, frames, chunk.data());
+    if (read < frames)
+    {
+        // A damaged block ends the replay, its samples are never passed on
+        logger_->error("Damaged block in {} at {:.1f} s, ending the replay there", filename_,
+                       static_cast<double>(recordingCursor_ + read) / recording_->GetSampleRate());
+        recordingEnd_ = recordingCursor_ + read;
+        if (read == 0)
+        {
+            finished_ = true;
+            return false;
+        }
+        chunk.resize(read * channels);
+    }
+
+    recordingCursor_ += read;
+    return true;
+}
+
+bool BinFileAudioSource::GetNextStreamedChunk(AudioChunk& chunk)
+{
+    std::unique_lock lock(readAheadMutex_);
+    readAheadCv_.wait(lock, [this] { return !readAhead_.empty() || readerDone_ || !running_; });
+    if (readAhead_.empty())
+    {
+        finished_ = readerDone_;
+        return false;
+    }
+
+    chunk = std::move(readAhead_.front());
+    readAhead_.pop_front();
+    lock.unlock();
+
+    readAheadCv_.notify_all(); // There is room for the reader again
+    return true;
+}
+
+void BinFileAudioSource::ReadAheadLoop()
+{
+    while (true)
+    {
+        {
+            // Bounded: never more than readAheadChunks_ chunks in memory
+            std::unique_lock lock(readAheadMutex_);
+            readAheadCv_.wait(lock, [this] { return readAhead_.size() < readAheadChunks_ || !running_; });
+            if (!running_)
+            {
+                return;
+            }
+        }
+
+        // Read outside the lock, so the capture loop can keep taking chunks while we wait for the disk or the pipe
+        AudioChunk chunk(chunkSize_);
+        stream_.read(reinterpret_cast<char*>(chunk.data()), static_cast<std::streamsize>(chunkSize_ * sizeof(float)));
+        const auto samplesRead = static_cast<size_t>(stream_.gcount()) / sizeof(float); // Drop a trailing partial float
+        chunk.resize(samplesRead);
+
+        {
+            std::lock_guard lock(readAheadMutex_);
+            if (samplesRead > 0)
+            {
+                readAhead_.push_back(std::move(chunk));
+            }
+            if (samplesRead < chunkSize_)
+            {
+                readerDone_ = true;
+            }
+        }
+        readAheadCv_.notify_all();
+
+        if (samplesRead < chunkSize_)
+        {
+            return;
+        }
+    }
 }
 
 void BinFileAudioSource::Stop()
 {
-    running_ = false;
+    {
+        std::lock_guard lock(pacingMutex_);
+        running_ = false;
+    }
+    {
+        // Waiters on the read-ahead queue either wait already or see running_ == false, no wakeup is lost
+        std::lock_guard lock(readAheadMutex_);
+    }
+    pacingCv_.notify_all();
+    readAheadCv_.notify_all();
+
+    // A reader blocked on an idle pipe only returns once the writer sends more data or closes the pipe
+    if (reader_.joinable())
+    {
+        reader_.join();
+    }
     if (worker_.joinable())
     {
         worker_.join();
     }
+
+    // After the worker: the handoff has a single writer and that was it
+    if (handoff_)
+    {
+        handoff_->Stop();
+    }
 }
@@ -3,33 +3,137 @@
 //
 
 #pragma once
+#include "CaptureHandoff.h"
 #include "IAudioSource.h"
+#include "files/MemoryMappedFile.h"
+#include "files/recording/RecordingReader.h"
+#include "spdlog/logger.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
 #include <vector>
 #include <string>
 #include <fstream>
+#include <mutex>
 #include <thread>
 
 namespace bpmfinder::audio
 {
+    enum class BinFileReadMode
+    {
+        // Chunks are copied straight out of a memory mapping of the file. Nothing is read up front, so startup time
+        // and memory do not grow with the file size.
+        MemoryMapped,
+
+        // A reader thread stays up to readAheadChunks chunks ahead of the consumers. Works for anything that can be
+        // read sequentially, including pipes.
+        Streaming
+    };
+
+    enum class BinFileReplayMode
+    {
+        // As fast as the subscribers take the chunks. Give the subscribers a capacity (CopyObserver::SetCapacity),
+        // otherwise their queues grow with the file.
+        FlatOut,
+
+        // Like a live capture: every chunk is released when it would have been recorded completely, at 'speed'
+        // times real time, against a monotonic clock. Released chunks go through a CaptureHandoff like the ones of
+        // a live capture, so a slow subscriber can not delay the clock; what does not fit is dropped as an overrun.
+        Paced
+    };
+
+    struct BinFileReplayOptions
+    {
+        BinFileReplayMode mode = BinFileReplayMode::FlatOut;
+        int sampleRate = 48000; // Only for Paced, a recording (*.bpmr) brings its own
+        double speed = 1.0; // Only for Paced
+
+        // Part of a recording (*.bpmr) to replay: from startSeconds on, durationSeconds long, 0 for up to the end.
+        // Raw files are always replayed as a whole.
+        double startSeconds = 0.0;
+        double durationSeconds = 0.0;
+    };
+
     class BinFileAudioSource final : public IAudioSource
     {
     public:
-        explicit BinFileAudioSource(const std::string& filename, size_t chunkSize = 512);
+        explicit BinFileAudioSource(const std::string& filename, size_t chunkSize = 512,
+                                    BinFileReadMode mode = BinFileReadMode::MemoryMapped,
+                                    size_t readAheadChunks = 16);
         ~BinFileAudioSource() override;
 
+        // Files that can not be mapped (pipes) fall back to streaming. A second call rewinds to the start of the file.
+        // Recordings (*.bpmr, detected by their header) are read through a RecordingReader, in either mode.
         bool Initialize() override;
         void Start() override;
         void Stop() override;
 
+        // Call before Initialize
+        void SetReplayOptions(const BinFileReplayOptions& options) { replayOptions_ = options; }
+
+        // True once every sample of the file has been passed on
+        [[nodiscard]] bool IsFinished() const override;
+
+        // Paced replay only: chunks the subscribers did not take in time
+        [[nodiscard]] uint64_t GetOverrunCount() const override;
+        [[nodiscard]] uint64_t GetLostSamples() const override;
+
+        // Mode actually in use after Initialize
+        [[nodiscard]] BinFileReadMode GetReadMode() const { return mode_; }
+
+        // Recordings know theirs, raw files are 1 channel at replayOptions.sampleRate. Valid after Initialize.
+        [[nodiscard]] int GetChannelCount() const override;
+        [[nodiscard]] int GetSampleRate() const;
+        [[nodiscard]] bool IsRecording() const { return recording_ != nullptr; }
+
+        // Reads a whole file of raw floats, as written by the AudioBinFileSink, or all interleaved frames of a
+        // recording (*.bpmr). sampleRate and channels are only set for recordings.
+        static bool ReadSamples(const std::string& filename, std::vector<float>& samples, int* sampleRate = nullptr,
+                                int* channels = nullptr);
+
     private:
         void CaptureLoop();
-        std::vector<float> GetNextChunk(size_t n);
+        void ReadAheadLoop();
+        bool GetNextChunk(AudioChunk& chunk);
+        bool GetNextMappedChunk(AudioChunk& chunk);
+        bool GetNextStreamedChunk(AudioChunk& chunk);
+        bool GetNextRecordingChunk(AudioChunk& chunk);
+        bool WaitForReleaseTime(std::chrono::steady_clock::time_point releaseTime);
 
         std::string filename_;
         size_t chunkSize_;
-        size_t cursor_ = 0;
-        std::vector<float> samples_;
+        BinFileReadMode mode_;
+        BinFileReplayOptions replayOptions_;
         std::thread worker_;
-        bool running_ = false;
+        std::atomic<bool> running_{false};
+        std::atomic<bool> finished_{false};
+
+        // MemoryMapped
+        files::MemoryMappedFile mappedFile_;
+        size_t cursor_ = 0; // In samples
+        size_t sampleCount_ = 0;
+
+        // Recording, cursor and end in frames
+        std::unique_ptr<files::recording::RecordingReader> recording_;
+        uint64_t recordingCursor_ = 0;
+        uint64_t recordingEnd_ = 0;
+
+        // Streaming
+        std::ifstream stream_;
+        size_t readAheadChunks_;
+        std::deque<AudioChunk> readAhead_;
+        bool readerDone_ = false;
+        std::mutex readAheadMutex_;
+        std::condition_variable readAheadCv_;
+        std::thread reader_;
+
+        // Paced replay, so Stop does not have to wait for the next release time
+        std::mutex pacingMutex_;
+        std::condition_variable pacingCv_;
+        static constexpr size_t HandoffCapacityChunks = 64;
+        std::unique_ptr<CaptureHandoff> handoff_; // Created by Start for paced replays
+
+        std::shared_ptr<spdlog::logger> logger_;
     };
 }
@@ -0,0 +1,137 @@
+//
+// Created by Robert on 2025-11-10.
+//
+
+#include "CaptureHandoff.h"
+#include <algorithm>
+
+using namespace bpmfinder::audio;
+
+CaptureHandoff::CaptureHandoff(const size_t chunkSamples, const size_t capacityChunks, Dispatch dispatch,
+                               Drained onDrained) :
+    chunkSamples_(std::max<size_t>(1, chunkSamples)),
+    dispatch_(std::move(dispatch)),
+    onDrained_(std::move(onDrained)),
+    ring_(chunkSamples_ * std::max<size_t>(2, capacityChunks))
+{
+}
+
+CaptureHandoff::~CaptureHandoff()
+{
+    Stop();
+}
+
+CaptureHandoffStatistics CaptureHandoff::GetStatistics() const
+{
+    CaptureHandoffStatistics statistics;
+    statistics.writtenSamples = writtenSamples_.load(std::memory_order_relaxed);
+    statistics.overrunCount = overrunCount_.load(std::memory_order_relaxed);
+    statistics.lostSamples = lostSamples_.load(std::memory_order_relaxed);
+    statistics.highWaterMark = highWaterMark_.load(std::memory_order_relaxed);
+    return statistics;
+}
+
+void CaptureHandoff::Start()
+{
+    if (running_)
+    {
+        return;
+    }
+
+    closed_ = false;
+    drained_ = false;
+    running_ = true;
+    dispatcher_ = std::thread(&CaptureHandoff::DispatchLoop, this);
+}
+
+void CaptureHandoff::Stop()
+{
+    running_ = false;
+    WakeDispatcher();
+    if (dispatcher_.joinable())
+    {
+        dispatcher_.join();
+    }
+}
+
+bool CaptureHandoff::Write(const float* samples, const size_t count)
+{
+    // Single writer: plain load and store instead of read-modify-write
+    if (!ring_.Write(samples, count))
+    {
+        overrunCount_.store(overrunCount_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        lostSamples_.store(lostSamples_.load(std::memory_order_relaxed) + count, std::memory_order_relaxed);
+        return false;
+    }
+    writtenSamples_.store(writtenSamples_.load(std::memory_order_relaxed) + count, std::memory_order_relaxed);
+
+    const size_t fill = ring_.GetFill();
+    if (fill > highWaterMark_.load(std::memory_order_relaxed))
+    {
+        highWaterMark_.store(fill, std::memory_order_relaxed);
+    }
+
+    if (fill >= chunkSamples_)
+    {
+        WakeDispatcher();
+    }
+    return true;
+}
+
+void CaptureHandoff::Close()
+{
+    closed_.store(true, std::memory_order_release);
+    WakeDispatcher();
+}
+
+void CaptureHandoff::WakeDispatcher()
+{
+    // Pairs with the fence in DispatchLoop: either the dispatcher sees the new samples before it sleeps, or we see
+    // that it sleeps. Only then it costs a futex wake.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (dispatcherWaiting_.load(std::memory_order_relaxed))
+    {
+        wakeSignal_.fetch_add(1, std::memory_order_release);
+        wakeSignal_.notify_one();
+    }
+}
+
+void CaptureHandoff::DispatchLoop()
+{
+    AudioChunk chunk(chunkSamples_);
+    while (running_)
+    {
+        if (ring_.GetReadable() >= chunkSamples_)
+        {
+            ring_.Read(chunk.data(), chunkSamples_);
+            dispatch_(chunk);
+            continue;
+        }
+
+        if (closed_.load(std::memory_order_acquire))
+        {
+            // Close comes after the last write: whatever is readable now is the rest of the stream
+            if (const size_t rest = ring_.GetReadable(); rest > 0)
+            {
+                AudioChunk last(rest);
+                ring_.Read(last.data(), rest);
+                dispatch_(last);
+            }
+            if (onDrained_)
+            {
+                onDrained_();
+            }
+            drained_.store(true, std::memory_order_release);
+            return;
+        }
+
+        const uint32_t signal = wakeSignal_.load(std::memory_order_acquire);
+        dispatcherWaiting_.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (ring_.GetReadable() < chunkSamples_ && !closed_.load(std::memory_order_acquire) && running_)
+        {
+            wakeSignal_.wait(signal, std::memory_order_acquire);
+        }
+        dispatcherWaiting_.store(false, std::memory_order_relaxed);
+    }
+}
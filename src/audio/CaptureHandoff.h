@@ -0,0 +1,85 @@
+//
+// Created by Robert on 2025-11-10.
+//
+
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <thread>
+#include "IAudioSource.h"
+#include "core/SpscRing.h"
+
+namespace bpmfinder::audio
+{
+    struct CaptureHandoffStatistics
+    {
+        uint64_t writtenSamples = 0; // Accepted from the capture thread
+        uint64_t overrunCount = 0; // Writes dropped because the ring was full
+        uint64_t lostSamples = 0; // Samples of those writes
+        size_t highWaterMark = 0; // Highest fill of the ring seen by the capture thread, in samples
+    };
+
+    // Real-time safe boundary between a capture thread and the subscribers of a source. The capture thread only
+    // copies samples into a preallocated SpscRing: no locks, no allocation, no system call unless the dispatcher
+    // sleeps. A dispatcher thread cuts the ring into chunks and passes them on through 'dispatch', usually the
+    // source's Notify, so a slow subscriber or a blocked queue mutex can never stall the capture.
+    // When the ring is full the capture thread drops the write and counts an overrun instead of waiting.
+    class CaptureHandoff
+    {
+    public:
+        using Dispatch = std::function<void(const AudioChunk&)>;
+        using Drained = std::function<void()>;
+
+        // chunkSamples: samples per chunk passed on (chunkSize * channels); the ring holds capacityChunks chunks.
+        // 'onDrained' runs on the dispatcher after the last chunk of a closed stream, usually the source's EndStream.
+        CaptureHandoff(size_t chunkSamples, size_t capacityChunks, Dispatch dispatch, Drained onDrained = {});
+        ~CaptureHandoff();
+
+        CaptureHandoff(const CaptureHandoff&) = delete;
+        CaptureHandoff& operator=(const CaptureHandoff&) = delete;
+
+        // Starts the dispatcher thread
+        void Start();
+
+        // Stops the dispatcher, samples that are still in the ring are discarded. Call after the capture thread
+        // stopped writing.
+        void Stop();
+
+        // Capture thread only. Takes all 'count' samples or none of them, so frames are never split: write whole
+        // frames. Returns false on an overrun.
+        bool Write(const float* samples, size_t count);
+
+        // Capture thread only: end of stream. The dispatcher passes on the rest as a shorter last chunk, calls
+        // 'onDrained', then IsDrained turns true.
+        void Close();
+
+        [[nodiscard]] bool IsDrained() const { return drained_.load(std::memory_order_acquire); }
+
+        [[nodiscard]] CaptureHandoffStatistics GetStatistics() const;
+
+    private:
+        void DispatchLoop();
+        void WakeDispatcher();
+
+        size_t chunkSamples_;
+        Dispatch dispatch_;
+        Drained onDrained_;
+        core::SpscRing<float> ring_;
+        std::thread dispatcher_;
+        std::atomic<bool> running_{false};
+        std::atomic<bool> closed_{false};
+        std::atomic<bool> drained_{false};
+
+        // The dispatcher sleeps on wakeSignal_ and announces it in dispatcherWaiting_, the capture thread only
+        // touches wakeSignal_ then
+        std::atomic<bool> dispatcherWaiting_{false};
+        std::atomic<uint32_t> wakeSignal_{0};
+
+        // Written by the capture thread only
+        std::atomic<uint64_t> writtenSamples_{0};
+        std::atomic<uint64_t> overrunCount_{0};
+        std::atomic<uint64_t> lostSamples_{0};
+        std::atomic<size_t> highWaterMark_{0};
+    };
+}
@@ -0,0 +1,56 @@
+//
+// Created by Robert on 2025-11-06.
+//
+
+#pragma once
+#include <algorithm>
+#include "IAudioSource.h"
+#include "SampleConversion.h"
+#include "core/CopyStage.h"
+#include "logging/LoggerFactory.h"
+
+namespace bpmfinder::audio
+{
+    // Turns chunks of interleaved frames from a multi-channel source into mono chunks, either the mean over all
+    // channels or one selected channel. The chunk is converted in place and passed on with the same buffer, so the
+    // stage adds no allocation. A chunk of N frames comes out as a chunk of N samples.
+    class DownmixStage : public core::CopyStage<AudioChunk, AudioChunk>
+    {
+    public:
+        // Every chunk only depends on itself
+        static constexpr bool IsStateless = true;
+
+        // channel < 0 mixes all channels down, otherwise only that channel is kept
+        explicit DownmixStage(const size_t channels, const int channel = -1)
+            : channels_(std::max<size_t>(1, channels)),
+              channel_(channel < static_cast<int>(channels_) ? channel : -1),
+              logger_(logging::LoggerFactory::GetLogger("DownmixStage"))
+        {
+            if (channel_ < 0)
+            {
+                logger_->info("DownmixStage initialized - mixing {} channels down to mono", channels_);
+            }
+            else
+            {
+                logger_->info("DownmixStage initialized - keeping channel {} of {}", channel_, channels_);
+            }
+        }
+
+    protected:
+        void Process(AudioChunk chunk) override
+        {
+            // A trailing partial frame can not be mixed, it is dropped
+            const size_t frames = chunk.size() / channels_;
+            DownmixInPlace(chunk.data(), frames, channels_, channel_);
+            chunk.resize(frames);
+
+            this->Notify(chunk);
+        }
+
+    private:
+        size_t channels_;
+        int channel_;
+
+        std::shared_ptr<spdlog::logger> logger_;
+    };
+}
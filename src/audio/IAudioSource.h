@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include <atomic>
+#include <cstdint>
 #include <vector>
 #include "core/CopyObservable.h"
 
@@ -16,11 +18,43 @@ namespace bpmfinder::audio
     public:
         virtual ~IAudioSource() = default;
 
+        // Passes a control token to the subscribers, behind the chunks sent so far, so it follows the data through
+        // the graph and reaches every stage exactly once
+        using CopyObservable::NotifyControl;
+
         // Initialize the source (WASAPI, file, etc.)
         virtual bool Initialize() = 0;
 
         // Start/stop capture or playback
         virtual void Start() = 0;
         virtual void Stop() = 0;
+
+        // Interleaved channels per frame in the chunks this source sends, valid after Initialize. Chunks of
+        // multi-channel sources hold chunkSize frames, i.e. chunkSize * channels samples.
+        [[nodiscard]] virtual int GetChannelCount() const { return 1; }
+
+        // End of stream: true once a finite source (e.g. a file) has passed on all of its data. Live sources never
+        // finish.
+        [[nodiscard]] virtual bool IsFinished() const { return false; }
+
+        // Times audio was dropped because it was not taken fast enough (a full capture ring, a producer that lapped
+        // the source), and the samples lost with it. Sources that never drop report 0.
+        [[nodiscard]] virtual uint64_t GetOverrunCount() const { return 0; }
+        [[nodiscard]] virtual uint64_t GetLostSamples() const { return 0; }
+
+        // Times the source sent the end of stream itself, after its last chunk. Whoever stops a source that did not
+        // get that far sends it instead.
+        [[nodiscard]] uint64_t GetEndOfStreamCount() const { return endOfStreamCount_.load(std::memory_order_acquire); }
+
+    protected:
+        // Finite sources call this after their last chunk, on the thread that sent it
+        void EndStream()
+        {
+            NotifyControl(core::ControlToken::EndOfStream);
+            endOfStreamCount_.fetch_add(1, std::memory_order_release);
+        }
+
+    private:
+        std::atomic<uint64_t> endOfStreamCount_{0};
     };
 }
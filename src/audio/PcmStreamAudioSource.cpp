@@ -0,0 +1,265 @@
+//
+// Created by Robert on 2025-11-04.
+//
+
+#include "PcmStreamAudioSource.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include "logging/LoggerFactory.h"
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#include <cstdio>
+#else
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+using namespace bpmfinder::audio;
+
+namespace
+{
+    // How long a read waits for the producer before it checks whether the source was stopped
+    constexpr int PollTimeoutMilliseconds = 100;
+}
+
+PcmStreamAudioSource::PcmStreamAudioSource(std::string path, const PcmStreamFormat& format, const size_t chunkSize,
+                                           const size_t readBufferBytes) :
+    path_(std::move(path)),
+    format_(format),
+    logger_(logging::LoggerFactory::GetLogger("PcmStreamAudioSource")),
+    chunkSize_(std::max<size_t>(1, chunkSize)),
+    readBufferBytes_(readBufferBytes),
+    chunk_(chunkSize_)
+{
+}
+
+PcmStreamAudioSource::~PcmStreamAudioSource()
+{
+    PcmStreamAudioSource::Stop();
+    Close();
+}
+
+bool PcmStreamAudioSource::Initialize()
+{
+    Close();
+    finished_ = false;
+    failed_ = false;
+    sampleCount_ = 0;
+
+    if (path_ == "-")
+    {
+#ifdef _WIN32
+        _setmode(_fileno(stdin), _O_BINARY);
+        fd_ = _fileno(stdin);
+#else
+        fd_ = STDIN_FILENO;
+#endif
+        ownsFd_ = false;
+    }
+    else
+    {
+#ifdef _WIN32
+        fd_ = _open(path_.c_str(), _O_RDONLY | _O_BINARY);
+#else
+        fd_ = open(path_.c_str(), O_RDONLY); // Blocks for a FIFO until the writer opens it
+#endif
+        ownsFd_ = true;
+    }
+
+    if (fd_ < 0)
+    {
+        logger_->error("Failed to open {}: {}", path_, std::strerror(errno));
+        return false;
+    }
+
+    if (!ReadHeader())
+    {
+        Close();
+        return false;
+    }
+
+    // The header may have changed the format
+    format_.channels = std::max(1, format_.channels);
+    frameBytes_ = GetBytesPerSample(format_.sampleFormat) * static_cast<size_t>(format_.channels);
+    readBuffer_.resize(std::max(readBufferBytes_, frameBytes_));
+
+    logger_->info("Reading {} channel {} PCM at {} Hz from {}", format_.channels,
+                  ToString(format_.sampleFormat), format_.sampleRate,
+                  path_ == "-" ? "stdin" : path_);
+    return true;
+}
+
+void PcmStreamAudioSource::Start()
+{
+    if (running_ || fd_ < 0)
+    {
+        return;
+    }
+
+    running_ = true;
+    worker_ = std::thread(&PcmStreamAudioSource::CaptureLoop, this);
+}
+
+void PcmStreamAudioSource::CaptureLoop()
+{
+    size_t pendingBytes = 0; // A partial frame left over from the previous read
+    size_t chunkFill = 0; // Samples already in chunk_
+    uint64_t bytesLeft = dataBytes_;
+    bool endOfInput = false;
+
+    while (running_)
+    {
+        const size_t readSize = static_cast<size_t>(std::min<uint64_t>(readBuffer_.size() - pendingBytes, bytesLeft));
+        const long bytesRead = readSize > 0 ? ReadSome(readBuffer_.data() + pendingBytes, readSize) : 0;
+        if (bytesRead <= 0)
+        {
+            // A read error ends the stream as well, otherwise whoever waits for the end would wait forever
+            failed_ = bytesRead < 0;
+            endOfInput = failed_ || running_;
+            break;
+        }
+        pendingBytes += static_cast<size_t>(bytesRead);
+        if (bytesLeft != Unlimited)
+        {
+            bytesLeft -= static_cast<uint64_t>(bytesRead);
+        }
+
+        // Convert whole frames straight into the chunk buffer, pass it on whenever it is full
+        const std::byte* input = readBuffer_.data();
+        size_t frames = pendingBytes / frameBytes_;
+        while (frames > 0)
+        {
+            const size_t count = std::min(frames, chunkSize_ - chunkFill);
+            ConvertToMonoFloat(input, count, static_cast<size_t>(format_.channels), format_.sampleFormat,
+                               chunk_.data() + chunkFill);
+            chunkFill += count;
+            input += count * frameBytes_;
+            frames -= count;
+
+            if (chunkFill == chunkSize_)
+            {
+                Notify(chunk_); // Observers copy the chunk, so the buffer can be refilled right away
+                sampleCount_ += chunkFill;
+                chunkFill = 0;
+            }
+        }
+
+        pendingBytes -= static_cast<size_t>(input - readBuffer_.data());
+        std::memmove(readBuffer_.data(), input, pendingBytes);
+    }
+
+    if (!endOfInput)
+    {
+        return;
+    }
+
+    if (pendingBytes > 0)
+    {
+        logger_->warn("Input ended with a partial frame of {} bytes, dropped", pendingBytes);
+    }
+    if (chunkFill > 0)
+    {
+        chunk_.resize(chunkFill);
+        Notify(chunk_);
+        sampleCount_ += chunkFill;
+        chunk_.resize(chunkSize_);
+    }
+
+    if (failed_)
+    {
+        logger_->error("Input failed after {} samples, ending the stream", sampleCount_.load());
+    }
+    else
+    {
+        logger_->info("End of input after {} samples", sampleCount_.load());
+    }
+    EndStream();
+    finished_ = true;
+}
+
+long PcmStreamAudioSource::ReadSome(std::byte* buffer, const size_t size)
+{
+#ifdef _WIN32
+    // No poll on pipes here: a reader waiting on an idle pipe only returns once the writer sends or closes it
+    const int bytesRead = _read(fd_, buffer, static_cast<unsigned>(std::min<size_t>(size, INT32_MAX)));
+    if (bytesRead < 0)
+    {
+        logger_->error("Failed to read {}: {}", path_, std::strerror(errno));
+    }
+    return bytesRead;
+#else
+    while (running_)
+    {
+        // Wait with a timeout, so Stop does not hang on a producer that stopped writing without closing the pipe
+        pollfd pollFd{fd_, POLLIN, 0};
+        const int ready = poll(&pollFd, 1, PollTimeoutMilliseconds);
+        if (ready == 0 || (ready < 0 && errno == EINTR))
+        {
+            continue;
+        }
+
+        const ssize_t bytesRead = ready > 0 ? read(fd_, buffer, size) : -1;
+        if (bytesRead < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (bytesRead < 0)
+        {
+            logger_->error("Failed to read {}: {}", path_, std::strerror(errno));
+        }
+        return bytesRead;
+    }
+    return 0;
+#endif
+}
+
+bool PcmStreamAudioSource::ReadExactly(std::byte* buffer, const size_t size)
+{
+    size_t done = 0;
+    while (done < size)
+    {
+#ifdef _WIN32
+        const int bytesRead = _read(fd_, buffer + done, static_cast<unsigned>(size - done));
+#else
+        const ssize_t bytesRead = read(fd_, buffer + done, size - done);
+        if (bytesRead < 0 && errno == EINTR)
+        {
+            continue;
+        }
+#endif
+        if (bytesRead <= 0)
+        {
+            return false;
+        }
+        done += static_cast<size_t>(bytesRead);
+    }
+    return true;
+}
+
+void PcmStreamAudioSource::Stop()
+{
+    running_ = false;
+    if (worker_.joinable())
+    {
+        worker_.join();
+    }
+}
+
+void PcmStreamAudioSource::Close()
+{
+    if (ownsFd_ && fd_ >= 0)
+    {
+#ifdef _WIN32
+        _close(fd_);
+#else
+        close(fd_);
+#endif
+    }
+    fd_ = -1;
+    ownsFd_ = false;
+}
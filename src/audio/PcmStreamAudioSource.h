@@ -0,0 +1,95 @@
+//
+// Created by Robert on 2025-11-04.
+//
+
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "IAudioSource.h"
+#include "SampleConversion.h"
+#include "spdlog/logger.h"
+
+namespace bpmfinder::audio
+{
+    struct PcmStreamFormat
+    {
+        PcmSampleFormat sampleFormat = PcmSampleFormat::Float32;
+        int channels = 1;
+        int sampleRate = 48000; // Not used for reading, the pipeline config has to match it
+    };
+
+    // Reads raw interleaved PCM from stdin ("-"), a FIFO or a file, e.g. from
+    //   ffmpeg -i song.mp3 -f f32le -ac 2 -ar 48000 - | bpm-finder stream --channels 2 -
+    // The input is read in large blocks of whatever the producer has written so far, converted to mono floats straight
+    // into the chunk buffer and passed on in chunks of chunkSize samples, without an allocation per chunk.
+    // At the end of the input the remaining samples are passed on as a shorter last chunk and IsFinished turns true,
+    // as it does when a read fails.
+    class PcmStreamAudioSource : public IAudioSource
+    {
+    public:
+        static constexpr size_t DefaultReadBufferBytes = 256 * 1024;
+
+        explicit PcmStreamAudioSource(std::string path, const PcmStreamFormat& format, size_t chunkSize = 512,
+                                      size_t readBufferBytes = DefaultReadBufferBytes);
+        ~PcmStreamAudioSource() override;
+
+        // Opens the input, a FIFO blocks here until its writer opens it as well
+        bool Initialize() override;
+        void Start() override;
+        void Stop() override;
+
+        [[nodiscard]] bool IsFinished() const override { return finished_; }
+
+        // The stream ended because a read failed, not at the end of the input. Valid once IsFinished.
+        [[nodiscard]] bool HasFailed() const { return failed_; }
+
+        [[nodiscard]] const PcmStreamFormat& GetFormat() const { return format_; }
+
+        // Mono samples passed on so far
+        [[nodiscard]] size_t GetSampleCount() const { return sampleCount_; }
+
+    protected:
+        static constexpr uint64_t Unlimited = std::numeric_limits<uint64_t>::max();
+
+        // Called by Initialize once the input is open, before the first sample is read. Formats with a header parse it
+        // here with ReadExactly and set format_ and dataBytes_.
+        virtual bool ReadHeader() { return true; }
+
+        // Blocks until 'size' bytes are read, false at the end of the input or on errors
+        bool ReadExactly(std::byte* buffer, size_t size);
+
+        std::string path_;
+        PcmStreamFormat format_;
+        uint64_t dataBytes_ = Unlimited; // The input ends after this many bytes, even if there is more
+
+        std::shared_ptr<spdlog::logger> logger_;
+
+    private:
+        void CaptureLoop();
+
+        // Waits for data and reads what is there, 0 at the end of the input or when stopped, -1 on errors
+        long ReadSome(std::byte* buffer, size_t size);
+
+        void Close();
+
+        size_t chunkSize_;
+        size_t readBufferBytes_;
+        size_t frameBytes_ = 0;
+
+        int fd_ = -1;
+        bool ownsFd_ = false;
+        std::vector<std::byte> readBuffer_;
+        AudioChunk chunk_;
+
+        std::thread worker_;
+        std::atomic<bool> running_{false};
+        std::atomic<bool> finished_{false};
+        std::atomic<bool> failed_{false};
+        std::atomic<size_t> sampleCount_{0};
+    };
+}
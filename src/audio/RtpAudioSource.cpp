@@ -0,0 +1,253 @@
+//
+// Created by Robert on 2025-11-09.
+//
+
+#include "RtpAudioSource.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include "logging/LoggerFactory.h"
+
+#ifdef __linux__
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+using namespace bpmfinder::audio;
+
+namespace
+{
+    constexpr size_t RtpHeaderBytes = 12;
+    constexpr int ReceiveBufferBytes = 4 * 1024 * 1024;
+}
+
+RtpAudioSource::RtpAudioSource(const RtpAudioSourceOptions& options, const size_t chunkSize,
+                               std::shared_ptr<net::NetworkIoThread> ioThread) :
+    options_(options),
+    chunkSamples_(std::max<size_t>(1, chunkSize) * static_cast<size_t>(std::max(1, options.channels))),
+    ioThread_(ioThread ? std::move(ioThread) : net::NetworkIoThread::GetShared()),
+    datagrams_(BatchSize),
+    jitterBuffer_(options.jitterBufferDepth),
+    logger_(logging::LoggerFactory::GetLogger("RtpAudioSource"))
+{
+    options_.channels = std::max(1, options_.channels);
+}
+
+RtpAudioSource::~RtpAudioSource()
+{
+    RtpAudioSource::Stop();
+    CloseSocket();
+}
+
+RtpAudioSourceStatistics RtpAudioSource::GetStatistics() const
+{
+    std::lock_guard lock(statisticsMutex_);
+    RtpAudioSourceStatistics statistics;
+    static_cast<net::RtpJitterBufferStatistics&>(statistics) = jitterBuffer_.GetStatistics();
+    statistics.malformedPackets = malformedPackets_;
+    return statistics;
+}
+
+void RtpAudioSource::Start()
+{
+    if (started_ || socket_ < 0)
+    {
+        return;
+    }
+    started_ = ioThread_->Add(socket_, this);
+}
+
+void RtpAudioSource::Stop()
+{
+    if (!started_)
+    {
+        return;
+    }
+    ioThread_->Remove(socket_, this);
+    started_ = false;
+}
+
+void RtpAudioSource::HandleDatagram(const std::byte* data, const size_t size, const bool truncated)
+{
+    const size_t frameBytes = GetBytesPerSample(options_.sampleFormat) * static_cast<size_t>(options_.channels);
+    if (truncated)
+    {
+        ++malformedPackets_;
+        return;
+    }
+
+    if (!options_.rtp)
+    {
+        const size_t samples = size / frameBytes * static_cast<size_t>(options_.channels);
+        const size_t offset = pending_.size();
+        pending_.resize(offset + samples);
+        ConvertBigEndianToFloat(data, samples, options_.sampleFormat, pending_.data() + offset);
+        return;
+    }
+
+    // RFC 3550: version 2, then CSRCs, an optional header extension and optional padding at the end
+    const auto byte = [data](const size_t index) { return static_cast<size_t>(data[index]); };
+    if (size < RtpHeaderBytes || (byte(0) >> 6) != 2)
+    {
+        ++malformedPackets_;
+        return;
+    }
+    const bool hasPadding = (byte(0) & 0x20) != 0;
+    const bool hasExtension = (byte(0) & 0x10) != 0;
+    const size_t csrcCount = byte(0) & 0x0F;
+    const auto payloadType = static_cast<int>(byte(1) & 0x7F);
+    const auto sequenceNumber = static_cast<uint16_t>(byte(2) << 8 | byte(3));
+
+    size_t begin = RtpHeaderBytes + 4 * csrcCount;
+    if (hasExtension)
+    {
+        if (begin + 4 > size)
+        {
+            ++malformedPackets_;
+            return;
+        }
+        begin += 4 + 4 * (byte(begin + 2) << 8 | byte(begin + 3));
+    }
+    size_t end = size;
+    if (hasPadding)
+    {
+        end -= std::min(end, byte(size - 1));
+    }
+    if (begin > end || (options_.payloadType >= 0 && payloadType != options_.payloadType))
+    {
+        ++malformedPackets_;
+        return;
+    }
+
+    const size_t samples = (end - begin) / frameBytes * static_cast<size_t>(options_.channels);
+    converted_.resize(samples);
+    ConvertBigEndianToFloat(data + begin, samples, options_.sampleFormat, converted_.data());
+    jitterBuffer_.Push(sequenceNumber, converted_.data(), samples);
+    jitterBuffer_.Pop(pending_);
+}
+
+void RtpAudioSource::PassOnChunks()
+{
+    size_t offset = 0;
+    while (pending_.size() - offset >= chunkSamples_)
+    {
+        chunk_.assign(pending_.begin() + static_cast<std::ptrdiff_t>(offset),
+                      pending_.begin() + static_cast<std::ptrdiff_t>(offset + chunkSamples_));
+        Notify(chunk_);
+        offset += chunkSamples_;
+    }
+    pending_.erase(pending_.begin(), pending_.begin() + static_cast<std::ptrdiff_t>(offset));
+}
+
+#ifdef __linux__
+bool RtpAudioSource::Initialize()
+{
+    CloseSocket();
+
+    socket_ = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (socket_ < 0)
+    {
+        logger_->error("Failed to create a UDP socket: {}", std::strerror(errno));
+        return false;
+    }
+
+    constexpr int enable = 1;
+    setsockopt(socket_, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+
+    // Room for bursts while the I/O thread serves other sources
+    setsockopt(socket_, SOL_SOCKET, SO_RCVBUF, &ReceiveBufferBytes, sizeof(ReceiveBufferBytes));
+
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(options_.port);
+    if (inet_pton(AF_INET, options_.address.c_str(), &address.sin_addr) != 1)
+    {
+        logger_->error("Invalid address {}", options_.address);
+        CloseSocket();
+        return false;
+    }
+    if (bind(socket_, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0)
+    {
+        logger_->error("Failed to bind to {}:{}: {}", options_.address, options_.port, std::strerror(errno));
+        CloseSocket();
+        return false;
+    }
+
+    socklen_t length = sizeof(address);
+    getsockname(socket_, reinterpret_cast<sockaddr*>(&address), &length);
+    port_ = ntohs(address.sin_port);
+
+    {
+        std::lock_guard lock(statisticsMutex_);
+        jitterBuffer_.Reset();
+    }
+    pending_.clear();
+
+    logger_->info("Receiving {} {} x {} channels at {} Hz on {}:{}", options_.rtp ? "RTP" : "UDP",
+                  ToString(options_.sampleFormat), options_.channels, options_.sampleRate, options_.address, port_);
+    return true;
+}
+
+void RtpAudioSource::OnReadable()
+{
+    std::array<mmsghdr, BatchSize> messages{};
+    std::array<iovec, BatchSize> vectors{};
+    for (size_t i = 0; i < BatchSize; ++i)
+    {
+        vectors[i].iov_base = datagrams_[i].data();
+        vectors[i].iov_len = MaxDatagramBytes;
+        messages[i].msg_hdr.msg_iov = &vectors[i];
+        messages[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    // Drain the socket, one system call for up to BatchSize datagrams
+    while (true)
+    {
+        const int received = recvmmsg(socket_, messages.data(), BatchSize, MSG_DONTWAIT, nullptr);
+        if (received <= 0)
+        {
+            return; // EAGAIN: empty
+        }
+
+        {
+            std::lock_guard lock(statisticsMutex_);
+            for (int i = 0; i < received; ++i)
+            {
+                HandleDatagram(datagrams_[i].data(), messages[i].msg_len,
+                               (messages[i].msg_hdr.msg_flags & MSG_TRUNC) != 0);
+            }
+        }
+        PassOnChunks();
+
+        if (static_cast<size_t>(received) < BatchSize)
+        {
+            return;
+        }
+    }
+}
+
+void RtpAudioSource::CloseSocket()
+{
+    if (socket_ >= 0)
+    {
+        close(socket_);
+        socket_ = -1;
+    }
+}
+#else
+bool RtpAudioSource::Initialize()
+{
+    logger_->error("Network sources need recvmmsg and epoll, which are only available on Linux");
+    return false;
+}
+
+void RtpAudioSource::OnReadable()
+{
+}
+
+void RtpAudioSource::CloseSocket()
+{
+}
+#endif
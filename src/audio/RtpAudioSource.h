@@ -0,0 +1,96 @@
+//
+// Created by Robert on 2025-11-09.
+//
+
+#pragma once
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "IAudioSource.h"
+#include "SampleConversion.h"
+#include "net/NetworkIoThread.h"
+#include "net/RtpJitterBuffer.h"
+#include "spdlog/logger.h"
+
+namespace bpmfinder::audio
+{
+    struct RtpAudioSourceOptions
+    {
+        std::string address = "0.0.0.0"; // Local address to bind to
+        uint16_t port = 5004; // 0 picks a free port, see GetPort
+
+        // Payload: big endian samples (RTP L16/L24, or float), interleaved
+        PcmSampleFormat sampleFormat = PcmSampleFormat::Int16;
+        int channels = 1;
+        int sampleRate = 48000; // Only passed on, the pipeline config has to match it
+
+        // false: plain UDP datagrams that only hold samples, passed on in arrival order
+        bool rtp = true;
+        int payloadType = -1; // Only packets of this payload type, -1 for any
+
+        size_t jitterBufferDepth = 4; // Newer packets to wait for before a missing one counts as lost
+    };
+
+    struct RtpAudioSourceStatistics : net::RtpJitterBufferStatistics
+    {
+        uint64_t malformedPackets = 0; // Too short, wrong version, other payload type or truncated
+    };
+
+    // Receives PCM over UDP or RTP, e.g. from an encoder on the network, and passes it on in chunks of chunkSize
+    // frames. Datagrams are received in batches with recvmmsg on an I/O thread that many sources share
+    // (NetworkIoThread), RTP packets go through a jitter buffer that restores their order and fills lost ones with
+    // silence. Linux only. Like a live capture, the source never finishes.
+    class RtpAudioSource final : public IAudioSource, public net::INetworkHandler
+    {
+    public:
+        // Without an I/O thread the shared one is used
+        explicit RtpAudioSource(const RtpAudioSourceOptions& options, size_t chunkSize = 1024,
+                                std::shared_ptr<net::NetworkIoThread> ioThread = nullptr);
+        ~RtpAudioSource() override;
+
+        // Binds the socket
+        bool Initialize() override;
+        void Start() override;
+        void Stop() override;
+
+        [[nodiscard]] int GetChannelCount() const override { return options_.channels; }
+
+        // Bound port, valid after Initialize
+        [[nodiscard]] uint16_t GetPort() const { return port_; }
+
+        [[nodiscard]] RtpAudioSourceStatistics GetStatistics() const;
+
+        void OnReadable() override;
+
+    private:
+        static constexpr size_t BatchSize = 32; // Datagrams per recvmmsg call
+        static constexpr size_t MaxDatagramBytes = 2048; // Ethernet MTU and then some
+
+        void HandleDatagram(const std::byte* data, size_t size, bool truncated);
+        void PassOnChunks();
+        void CloseSocket();
+
+        RtpAudioSourceOptions options_;
+        size_t chunkSamples_;
+        std::shared_ptr<net::NetworkIoThread> ioThread_;
+        int socket_ = -1;
+        uint16_t port_ = 0;
+        bool started_ = false;
+
+        // Only touched on the I/O thread
+        std::vector<std::array<std::byte, MaxDatagramBytes>> datagrams_;
+        std::vector<float> converted_;
+        std::vector<float> pending_; // Samples in order, not yet passed on as a chunk
+        AudioChunk chunk_;
+
+        // Read by GetStatistics from other threads
+        mutable std::mutex statisticsMutex_;
+        net::RtpJitterBuffer jitterBuffer_;
+        uint64_t malformedPackets_ = 0;
+
+        std::shared_ptr<spdlog::logger> logger_;
+    };
+}
@@ -0,0 +1,295 @@
+//
+// Created by Robert on 2025-11-04.
+//
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace bpmfinder::audio
+{
+    enum class PcmSampleFormat
+    {
+        Float32, // IEEE float, -1..1
+        Int16, // Signed 16 bit little endian
+        Int24, // Signed 24 bit little endian, packed into 3 bytes
+        Int32 // Signed 32 bit little endian
+    };
+
+    inline size_t GetBytesPerSample(const PcmSampleFormat format)
+    {
+        switch (format)
+        {
+        case PcmSampleFormat::Int16:
+            return 2;
+        case PcmSampleFormat::Int24:
+            return 3;
+        default:
+            return 4;
+        }
+    }
+
+    inline const char* ToString(const PcmSampleFormat format)
+    {
+        switch (format)
+        {
+        case PcmSampleFormat::Int16:
+            return "s16";
+        case PcmSampleFormat::Int24:
+            return "s24";
+        case PcmSampleFormat::Int32:
+            return "s32";
+        default:
+            return "f32";
+        }
+    }
+
+    // Interleaved frames -> mono float, the mean over all channels. The loops have no dependencies between frames and
+    // read through restrict pointers, so the compiler vectorizes them (the per channel sums are unrolled for mono and
+    // stereo, the common cases). Input is read with memcpy from the raw byte stream, which does not have to be aligned.
+    namespace detail
+    {
+        // How one sample is read from the byte stream and which value is full scale
+        struct Float32Sample
+        {
+            static constexpr size_t Bytes = 4;
+            static constexpr float FullScale = 1.0f;
+
+            static float Load(const std::byte* input)
+            {
+                float sample;
+                std::memcpy(&sample, input, sizeof(sample));
+                return sample;
+            }
+        };
+
+        struct Int16Sample
+        {
+            static constexpr size_t Bytes = 2;
+            static constexpr float FullScale = 32768.0f;
+
+            static float Load(const std::byte* input)
+            {
+                int16_t sample;
+                std::memcpy(&sample, input, sizeof(sample));
+                return static_cast<float>(sample);
+            }
+        };
+
+        struct Int24Sample
+        {
+            static constexpr size_t Bytes = 3;
+            static constexpr float FullScale = 8388608.0f;
+
+            static float Load(const std::byte* input)
+            {
+                // Into the upper 3 bytes of an int32, the arithmetic shift back sign extends
+                const auto value = static_cast<int32_t>(static_cast<uint32_t>(input[0]) << 8 |
+                    static_cast<uint32_t>(input[1]) << 16 | static_cast<uint32_t>(input[2]) << 24);
+                return static_cast<float>(value >> 8);
+            }
+        };
+
+        struct Int32Sample
+        {
+            static constexpr size_t Bytes = 4;
+            static constexpr float FullScale = 2147483648.0f;
+
+            static float Load(const std::byte* input)
+            {
+                int32_t sample;
+                std::memcpy(&sample, input, sizeof(sample));
+                return static_cast<float>(sample);
+            }
+        };
+
+        // Network byte order, as in RTP payloads (RFC 3551 L16 and L24)
+        struct Int16BigEndianSample
+        {
+            static constexpr size_t Bytes = 2;
+            static constexpr float FullScale = 32768.0f;
+
+            static float Load(const std::byte* input)
+            {
+                const auto value = static_cast<int16_t>(static_cast<uint16_t>(input[0]) << 8 |
+                    static_cast<uint16_t>(input[1]));
+                return static_cast<float>(value);
+            }
+        };
+
+        struct Int24BigEndianSample
+        {
+            static constexpr size_t Bytes = 3;
+            static constexpr float FullScale = 8388608.0f;
+
+            static float Load(const std::byte* input)
+            {
+                const auto value = static_cast<int32_t>(static_cast<uint32_t>(input[0]) << 24 |
+                    static_cast<uint32_t>(input[1]) << 16 | static_cast<uint32_t>(input[2]) << 8);
+                return static_cast<float>(value >> 8);
+            }
+        };
+
+        struct Int32BigEndianSample
+        {
+            static constexpr size_t Bytes = 4;
+            static constexpr float FullScale = 2147483648.0f;
+
+            static float Load(const std::byte* input)
+            {
+                const auto value = static_cast<int32_t>(static_cast<uint32_t>(input[0]) << 24 |
+                    static_cast<uint32_t>(input[1]) << 16 | static_cast<uint32_t>(input[2]) << 8 |
+                    static_cast<uint32_t>(input[3]));
+                return static_cast<float>(value);
+            }
+        };
+
+        struct Float32BigEndianSample
+        {
+            static constexpr size_t Bytes = 4;
+            static constexpr float FullScale = 1.0f;
+
+            static float Load(const std::byte* input)
+            {
+                const uint32_t bits = static_cast<uint32_t>(input[0]) << 24 | static_cast<uint32_t>(input[1]) << 16 |
+                    static_cast<uint32_t>(input[2]) << 8 | static_cast<uint32_t>(input[3]);
+                float sample;
+                std::memcpy(&sample, &bits, sizeof(sample));
+                return sample;
+            }
+        };
+
+        template <typename Sample>
+        void Convert(const std::byte* __restrict input, const size_t samples, float* __restrict output)
+        {
+            constexpr float scale = 1.0f / Sample::FullScale;
+            for (size_t i = 0; i < samples; ++i)
+            {
+                output[i] = Sample::Load(input + i * Sample::Bytes) * scale;
+            }
+        }
+
+        template <typename Sample, size_t Channels>
+        void DownmixFixed(const std::byte* __restrict input, const size_t frames, const float scale,
+                          float* __restrict output)
+        {
+            for (size_t i = 0; i < frames; ++i)
+            {
+                float sum = 0.0f;
+                for (size_t c = 0; c < Channels; ++c)
+                {
+                    sum += Sample::Load(input + (i * Channels + c) * Sample::Bytes);
+                }
+                output[i] = sum * scale;
+            }
+        }
+
+        template <typename Sample>
+        void Downmix(const std::byte* __restrict input, const size_t frames, const size_t channels,
+                     float* __restrict output)
+        {
+            const float scale = 1.0f / (Sample::FullScale * static_cast<float>(channels));
+            switch (channels)
+            {
+            case 1:
+                DownmixFixed<Sample, 1>(input, frames, scale, output);
+                return;
+            case 2:
+                DownmixFixed<Sample, 2>(input, frames, scale, output);
+                return;
+            default:
+                for (size_t i = 0; i < frames; ++i)
+                {
+                    float sum = 0.0f;
+                    for (size_t c = 0; c < channels; ++c)
+                    {
+                        sum += Sample::Load(input + (i * channels + c) * Sample::Bytes);
+                    }
+                    output[i] = sum * scale;
+                }
+            }
+        }
+    }
+
+    // Converts 'frames' interleaved frames of 'channels' samples each into 'frames' mono floats
+    inline void ConvertToMonoFloat(const std::byte* input, const size_t frames, const size_t channels,
+                                   const PcmSampleFormat format, float* output)
+    {
+        switch (format)
+        {
+        case PcmSampleFormat::Float32:
+            if (channels == 1)
+            {
+                std::memcpy(output, input, frames * sizeof(float));
+                return;
+            }
+            detail::Downmix<detail::Float32Sample>(input, frames, channels, output);
+            return;
+        case PcmSampleFormat::Int16:
+            detail::Downmix<detail::Int16Sample>(input, frames, channels, output);
+            return;
+        case PcmSampleFormat::Int24:
+            detail::Downmix<detail::Int24Sample>(input, frames, channels, output);
+            return;
+        case PcmSampleFormat::Int32:
+            detail::Downmix<detail::Int32Sample>(input, frames, channels, output);
+            return;
+        }
+    }
+
+    // Big endian samples -> floats, one to one: interleaved channels stay interleaved
+    inline void ConvertBigEndianToFloat(const std::byte* input, const size_t samples, const PcmSampleFormat format,
+                                        float* output)
+    {
+        switch (format)
+        {
+        case PcmSampleFormat::Float32:
+            detail::Convert<detail::Float32BigEndianSample>(input, samples, output);
+            return;
+        case PcmSampleFormat::Int16:
+            detail::Convert<detail::Int16BigEndianSample>(input, samples, output);
+            return;
+        case PcmSampleFormat::Int24:
+            detail::Convert<detail::Int24BigEndianSample>(input, samples, output);
+            return;
+        case PcmSampleFormat::Int32:
+            detail::Convert<detail::Int32BigEndianSample>(input, samples, output);
+            return;
+        }
+    }
+
+    // Interleaved float frames -> mono, in place: afterwards the first 'frames' floats of 'samples' are the mono signal.
+    // channel < 0 takes the mean over all channels, otherwise only that channel.
+    // Works in blocks through a small stack buffer: a block is converted with the vectorized kernels above (the input
+    // and the stack buffer do not overlap) and then copied to the front. The block is written to [i, i + block) only
+    // after it was read from [i * channels, (i + block) * channels), so no frame is overwritten before it is read.
+    inline void DownmixInPlace(float* samples, const size_t frames, const size_t channels, const int channel = -1)
+    {
+        if (channels <= 1)
+        {
+            return;
+        }
+
+        constexpr size_t BlockFrames = 256;
+        float block[BlockFrames];
+        for (size_t offset = 0; offset < frames; offset += BlockFrames)
+        {
+            const size_t count = frames - offset < BlockFrames ? frames - offset : BlockFrames;
+            const float* __restrict input = samples + offset * channels;
+            if (channel < 0)
+            {
+                ConvertToMonoFloat(reinterpret_cast<const std::byte*>(input), count, channels,
+                                   PcmSampleFormat::Float32, block);
+            }
+            else
+            {
+                for (size_t i = 0; i < count; ++i)
+                {
+                    block[i] = input[i * channels + static_cast<size_t>(channel)];
+                }
+            }
+            std::memcpy(samples + offset, block, count * sizeof(float));
+        }
+    }
+}
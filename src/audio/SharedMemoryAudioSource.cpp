@@ -0,0 +1,157 @@
+//
+// Created by Robert on 2025-11-08.
+//
+
+#include "SharedMemoryAudioSource.h"
+#include <algorithm>
+#include "logging/LoggerFactory.h"
+
+using namespace bpmfinder::audio;
+
+SharedMemoryAudioSource::SharedMemoryAudioSource(std::string name, const size_t chunkSize,
+                                                 const std::chrono::microseconds pollInterval) :
+    name_(std::move(name)),
+    chunkSize_(std::max<size_t>(1, chunkSize)),
+    pollInterval_(pollInterval),
+    logger_(logging::LoggerFactory::GetLogger("SharedMemoryAudioSource"))
+{
+}
+
+SharedMemoryAudioSource::~SharedMemoryAudioSource()
+{
+    SharedMemoryAudioSource::Stop();
+}
+
+std::optional<bpmfinder::ipc::SharedMemoryRingFormat> SharedMemoryAudioSource::ReadFormat(const std::string& name)
+{
+    ipc::SharedMemoryRingReader reader;
+    if (!reader.Open(name))
+    {
+        return std::nullopt;
+    }
+    return reader.GetFormat();
+}
+
+bool SharedMemoryAudioSource::Initialize()
+{
+    if (!reader_.Open(name_))
+    {
+        logger_->error("No shared memory ring {}", name_);
+        return false;
+    }
+
+    format_ = reader_.GetFormat();
+    const auto channels = static_cast<uint64_t>(format_.channels);
+    const uint64_t capacity = reader_.GetCapacity() / channels * channels;
+    const uint64_t writePosition = reader_.GetWritePosition();
+    readPosition_ = writePosition > capacity ? writePosition - capacity : 0;
+
+    overrunCount_ = 0;
+    lostSamples_ = 0;
+    finished_ = false;
+    chunk_.reserve(chunkSize_ * static_cast<size_t>(channels));
+
+    logger_->info("Attached to {}: {} Hz, {} channels, {} samples capacity", name_, format_.sampleRate,
+                  format_.channels, reader_.GetCapacity());
+    return true;
+}
+
+void SharedMemoryAudioSource::Start()
+{
+    if (running_ || !reader_.IsOpen())
+    {
+        return;
+    }
+
+    // The worker of a stream that ended on its own is done, but not joined yet
+    if (worker_.joinable())
+    {
+        worker_.join();
+    }
+
+    running_ = true;
+    worker_ = std::thread(&SharedMemoryAudioSource::ReadLoop, this);
+}
+
+void SharedMemoryAudioSource::Stop()
+{
+    {
+        std::lock_guard lock(pollMutex_);
+        running_ = false;
+    }
+    pollCv_.notify_all();
+
+    if (worker_.joinable())
+    {
+        worker_.join();
+    }
+}
+
+void SharedMemoryAudioSource::ReadLoop()
+{
+    const size_t chunkSamples = chunkSize_ * static_cast<size_t>(format_.channels);
+
+    while (running_)
+    {
+        // Closed first: the write position read afterwards then includes the last write
+        const bool closed = reader_.IsClosed();
+        const uint64_t writePosition = reader_.GetWritePosition();
+        SkipOverwrittenSamples(writePosition);
+
+        const uint64_t available = writePosition - readPosition_;
+        if (available >= chunkSamples || (closed && available > 0))
+        {
+            // The producer only writes whole frames, so the shorter last chunk holds whole frames as well
+            const auto count = static_cast<size_t>(std::min<uint64_t>(available, chunkSamples));
+            chunk_.resize(count);
+            if (!reader_.Read(readPosition_, chunk_.data(), count))
+            {
+                continue; // Overwritten while it was copied, skipped as soon as the producer publishes the write
+            }
+
+            readPosition_ += count;
+            Notify(chunk_);
+            continue;
+        }
+
+        if (closed)
+        {
+            logger_->info("Producer closed {}", name_);
+            // Before the end of stream, so a sink woken by it can initialize and start the source again right away
+            finished_ = true;
+            running_ = false;
+            EndStream();
+            return;
+        }
+
+        if (!WaitForData())
+        {
+            return;
+        }
+    }
+}
+
+void SharedMemoryAudioSource::SkipOverwrittenSamples(const uint64_t writePosition)
+{
+    const auto channels = static_cast<uint64_t>(format_.channels);
+    const uint64_t capacity = reader_.GetCapacity() / channels * channels;
+    if (writePosition - readPosition_ <= capacity)
+    {
+        return;
+    }
+
+    // Continue half a ring behind the producer, right at the oldest sample would be overwritten again immediately
+    const uint64_t skipTo = writePosition - capacity / 2 / channels * channels;
+    const uint64_t lost = skipTo - readPosition_;
+    readPosition_ = skipTo;
+    ++overrunCount_;
+    lostSamples_ += lost;
+    logger_->warn("Overrun on {}: fell behind the producer, skipped {} samples", name_, lost);
+}
+
+bool SharedMemoryAudioSource::WaitForData()
+{
+    // The producer is in another process and does not signal anything, so the ring is polled
+    std::unique_lock lock(pollMutex_);
+    return !pollCv_.wait_for(lock, pollInterval_, [this] { return !running_; });
+}
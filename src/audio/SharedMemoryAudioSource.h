@@ -0,0 +1,76 @@
+//
+// Created by Robert on 2025-11-08.
+//
+
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include "IAudioSource.h"
+#include "ipc/SharedMemoryRing.h"
+#include "spdlog/logger.h"
+
+namespace bpmfinder::audio
+{
+    // Reads from a shared memory ring that a producer in another process writes into with a SharedMemoryRingWriter,
+    // e.g. a decoder or a capture daemon. The samples are copied straight from the shared memory into the chunk
+    // buffer, without a pipe or socket in between. Chunks hold chunkSize frames of the ring's channel layout, the
+    // pipeline mixes them down.
+    // The producer never waits for this source: if the source falls behind by more than the ring capacity, the
+    // samples it missed are skipped and counted as an overrun. The stream ends when the producer closes the ring.
+    class SharedMemoryAudioSource final : public IAudioSource
+    {
+    public:
+        explicit SharedMemoryAudioSource(std::string name, size_t chunkSize = 1024,
+                                         std::chrono::microseconds pollInterval = std::chrono::milliseconds(1));
+        ~SharedMemoryAudioSource() override;
+
+        // Attaches to the ring. Reading starts at the oldest sample that is still in it.
+        bool Initialize() override;
+        void Start() override;
+        void Stop() override;
+
+        [[nodiscard]] int GetChannelCount() const override { return format_.channels; }
+        [[nodiscard]] bool IsFinished() const override { return finished_; }
+
+        // Format of the ring, valid after Initialize
+        [[nodiscard]] const ipc::SharedMemoryRingFormat& GetFormat() const { return format_; }
+
+        // Number of times the source fell behind, and the samples it lost that way
+        [[nodiscard]] uint64_t GetOverrunCount() const override { return overrunCount_; }
+        [[nodiscard]] uint64_t GetLostSamples() const override { return lostSamples_; }
+
+        // Format of a ring without attaching a source to it, std::nullopt if there is none
+        static std::optional<ipc::SharedMemoryRingFormat> ReadFormat(const std::string& name);
+
+    private:
+        void ReadLoop();
+        void SkipOverwrittenSamples(uint64_t writePosition);
+        bool WaitForData();
+
+        std::string name_;
+        size_t chunkSize_;
+        std::chrono::microseconds pollInterval_;
+        ipc::SharedMemoryRingReader reader_;
+        ipc::SharedMemoryRingFormat format_;
+        uint64_t readPosition_ = 0;
+        AudioChunk chunk_;
+
+        std::thread worker_;
+        std::atomic<bool> running_{false};
+        std::atomic<bool> finished_{false};
+        std::atomic<uint64_t> overrunCount_{0};
+        std::atomic<uint64_t> lostSamples_{0};
+
+        // So Stop does not have to wait for the next poll
+        std::mutex pollMutex_;
+        std::condition_variable pollCv_;
+
+        std::shared_ptr<spdlog::logger> logger_;
+    };
+}
@@ -0,0 +1,377 @@
+//
+// Created by Robert on 2025-11-07.
+//
+
+#include "SignalGeneratorAudioSource.h"
+#include <algorithm>
+#include <cmath>
+#include "logging/LoggerFactory.h"
+
+using namespace bpmfinder::audio;
+
+namespace
+{
+    // Samples of noise the gain is measured on, enough for well under 1 % error on the RMS
+    constexpr size_t NoiseCalibrationSamples = 1 << 16;
+
+    constexpr double Pi = 3.14159265358979323846;
+
+    // Seeds for the noise lanes, never 0 (xorshift would stay at 0)
+    uint32_t SplitMix32(uint32_t value)
+    {
+        value += 0x9E3779B9u;
+        value = (value ^ (value >> 16)) * 0x85EBCA6Bu;
+        value = (value ^ (value >> 13)) * 0xC2B2AE35u;
+        value ^= value >> 16;
+        return value != 0 ? value : 1;
+    }
+
+    float GetOnePoleCoefficient(const float cutoff, const int sampleRate)
+    {
+        if (cutoff <= 0.0f || sampleRate <= 0)
+        {
+            return 0.0f;
+        }
+        return static_cast<float>(1.0 - std::exp(-2.0 * Pi * cutoff / sampleRate));
+    }
+}
+
+SignalGenerator::SignalGenerator(const SignalGeneratorOptions& options) :
+    options_(options),
+    length_(options.durationSeconds > 0.0
+                ? static_cast<uint64_t>(std::llround(options.durationSeconds * options.sampleRate))
+                : 0)
+{
+    // One click: a sine burst with an exponential decay to -40 dB, so it starts with a sharp onset and ends quietly
+    const auto clickLength = static_cast<size_t>(std::max(0.0f, options_.clickSeconds) *
+        static_cast<float>(options_.sampleRate));
+    clickTable_.resize(clickLength);
+    for (size_t n = 0; n < clickLength; ++n)
+    {
+        const double position = static_cast<double>(n) / static_cast<double>(clickLength);
+        const double phase = 2.0 * Pi * options_.clickFrequency * static_cast<double>(n) / options_.sampleRate;
+        clickTable_[n] = static_cast<float>(options_.clickAmplitude * std::exp(-4.6 * position) * std::sin(phase));
+    }
+
+    float noiseRms = 0.0f;
+    if (options_.bpm <= 0.0f)
+    {
+        noiseRms = options_.noiseRms;
+    }
+    else if (std::isfinite(options_.snrDb))
+    {
+        noiseRms = options_.clickAmplitude / std::sqrt(2.0f) / std::pow(10.0f, options_.snrDb / 20.0f);
+    }
+
+    lowPassCoefficient_ = GetOnePoleCoefficient(options_.noiseHighCutoff, options_.sampleRate);
+    highPassCoefficient_ = GetOnePoleCoefficient(options_.noiseLowCutoff, options_.sampleRate);
+
+    // The filters take away power depending on the band, measure what is left and scale it back to the wanted level
+    if (noiseRms > 0.0f)
+    {
+        Reset();
+        noiseGain_ = 1.0f;
+        std::vector<float> calibration(NoiseCalibrationSamples);
+        GenerateNoise(calibration.data(), calibration.size());
+
+        double power = 0.0;
+        for (const float sample : calibration)
+        {
+            power += static_cast<double>(sample) * sample;
+        }
+        const double rms = std::sqrt(power / static_cast<double>(calibration.size()));
+        noiseGain_ = rms > 0.0 ? static_cast<float>(noiseRms / rms) : 0.0f;
+    }
+
+    Reset();
+}
+
+void SignalGenerator::Reset()
+{
+    position_ = 0;
+
+    clickPhase_ = clickTable_.size();
+    gridPosition_ = 0.0;
+    beatIndex_ = 0;
+    nextClick_ = options_.bpm > 0.0f && !clickTable_.empty() ? 0 : std::numeric_limits<uint64_t>::max();
+
+    lowPassState_ = 0.0f;
+    highPassState_ = 0.0f;
+    for (size_t lane = 0; lane < NoiseLanes; ++lane)
+    {
+        noiseState_[lane] = SplitMix32(options_.seed * static_cast<uint32_t>(NoiseLanes) +
+            static_cast<uint32_t>(lane));
+    }
+    pendingNoiseIndex_ = NoiseLanes;
+}
+
+void SignalGenerator::Generate(float* output, const size_t count)
+{
+    if (noiseGain_ > 0.0f)
+    {
+        GenerateNoise(output, count);
+    }
+    else
+    {
+        std::fill_n(output, count, 0.0f);
+    }
+
+    AddClicks(output, count);
+    position_ += count;
+}
+
+std::vector<uint64_t> SignalGenerator::GetClickPositions(const uint64_t samples) const
+{
+    // Runs the same schedule as Generate on a copy, so the positions are exactly the ones that are played
+    SignalGenerator schedule = *this;
+    schedule.Reset();
+
+    std::vector<uint64_t> positions;
+    while (schedule.nextClick_ < samples)
+    {
+        positions.push_back(schedule.nextClick_);
+        schedule.ScheduleNextClick();
+    }
+    return positions;
+}
+
+void SignalGenerator::GenerateNoise(float* output, const size_t count)
+{
+    size_t n = 0;
+
+    // Rest of the block from the last call, so the noise does not depend on the chunk size
+    while (n < count && pendingNoiseIndex_ < NoiseLanes)
+    {
+        output[n++] = pendingNoise_[pendingNoiseIndex_++];
+    }
+
+    for (; n + NoiseLanes <= count; n += NoiseLanes)
+    {
+        GenerateNoiseBlock(output + n);
+    }
+
+    if (n < count)
+    {
+        GenerateNoiseBlock(pendingNoise_.data());
+        pendingNoiseIndex_ = 0;
+        while (n < count)
+        {
+            output[n++] = pendingNoise_[pendingNoiseIndex_++];
+        }
+    }
+
+    FilterNoise(output, count);
+}
+
+void SignalGenerator::GenerateNoiseBlock(float* output)
+{
+    // Every lane is an independent xorshift32, the lanes have no dependencies on each other and map onto SIMD lanes
+    constexpr float Scale = 1.0f / 2147483648.0f;
+    for (size_t lane = 0; lane < NoiseLanes; ++lane)
+    {
+        uint32_t state = noiseState_[lane];
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        noiseState_[lane] = state;
+
+        // Uniform in -1..1
+        output[lane] = static_cast<float>(static_cast<int32_t>(state)) * Scale * noiseGain_;
+    }
+}
+
+void SignalGenerator::FilterNoise(float* output, const size_t count)
+{
+    // One pole low and high pass, 6 dB per octave on each side of the band
+    if (lowPassCoefficient_ > 0.0f)
+    {
+        float state = lowPassState_;
+        for (size_t n = 0; n < count; ++n)
+        {
+            state += lowPassCoefficient_ * (output[n] - state);
+            output[n] = state;
+        }
+        lowPassState_ = state;
+    }
+
+    if (highPassCoefficient_ > 0.0f)
+    {
+        float state = highPassState_;
+        for (size_t n = 0; n < count; ++n)
+        {
+            state += highPassCoefficient_ * (output[n] - state);
+            output[n] -= state;
+        }
+        highPassState_ = state;
+    }
+}
+
+void SignalGenerator::AddClicks(float* output, const size_t count)
+{
+    size_t n = 0;
+    while (n < count)
+    {
+        // Samples until the next click starts, the click that sounds plays until then
+        const uint64_t now = position_ + n;
+        const size_t untilNextClick = nextClick_ > now
+                                          ? static_cast<size_t>(std::min<uint64_t>(nextClick_ - now, count - n))
+                                          : 0;
+
+        const size_t play = std::min(untilNextClick, clickTable_.size() - clickPhase_);
+        const float* click = clickTable_.data() + clickPhase_;
+        float* out = output + n;
+        for (size_t i = 0; i < play; ++i)
+        {
+            out[i] += click[i];
+        }
+        clickPhase_ += play;
+        n += untilNextClick;
+
+        if (n < count)
+        {
+            // A click that still sounds is cut off by the next one
+            clickPhase_ = 0;
+            ScheduleNextClick();
+        }
+    }
+}
+
+void SignalGenerator::ScheduleNextClick()
+{
+    const double period = GetBeatPeriod(gridPosition_);
+    gridPosition_ += period;
+    ++beatIndex_;
+
+    const double swing = beatIndex_ % 2 == 1 ? options_.swing * period : 0.0;
+    nextClick_ = std::max(nextClick_ + 1, static_cast<uint64_t>(std::llround(gridPosition_ + swing)));
+}
+
+double SignalGenerator::GetBeatPeriod(const double position) const
+{
+    double bpm = options_.bpm;
+    if (options_.endBpm > 0.0f && options_.rampSeconds > 0.0f)
+    {
+        const double progress = std::min(1.0, position / options_.sampleRate / options_.rampSeconds);
+        bpm += (options_.endBpm - options_.bpm) * progress;
+    }
+    return 60.0 / bpm * options_.sampleRate;
+}
+
+SignalGeneratorAudioSource::SignalGeneratorAudioSource(const SignalGeneratorOptions& options,
+                                                       const size_t chunkSize) :
+    options_(options),
+    chunkSize_(std::max<size_t>(1, chunkSize)),
+    generator_(options),
+    logger_(logging::LoggerFactory::GetLogger("SignalGeneratorAudioSource"))
+{
+}
+
+SignalGeneratorAudioSource::~SignalGeneratorAudioSource()
+{
+    SignalGeneratorAudioSource::Stop();
+}
+
+bool SignalGeneratorAudioSource::Initialize()
+{
+    if (options_.sampleRate <= 0)
+    {
+        logger_->error("Invalid sample rate {}", options_.sampleRate);
+        return false;
+    }
+
+    generator_.Reset();
+    finished_ = false;
+    chunk_.reserve(chunkSize_);
+
+    if (options_.speed > 0.0)
+    {
+        logger_->info("Generating {} BPM at {} Hz, SNR {} dB, at {}x real time", options_.bpm, options_.sampleRate,
+                      options_.snrDb, options_.speed);
+    }
+    else
+    {
+        logger_->info("Generating {} BPM at {} Hz, SNR {} dB, flat-out", options_.bpm, options_.sampleRate,
+                      options_.snrDb);
+    }
+    return true;
+}
+
+void SignalGeneratorAudioSource::Start()
+{
+    if (running_)
+    {
+        return;
+    }
+
+    // The worker of a stream that ended on its own is done, but not joined yet
+    if (worker_.joinable())
+    {
+        worker_.join();
+    }
+
+    running_ = true;
+    worker_ = std::thread(&SignalGeneratorAudioSource::GenerateLoop, this);
+}
+
+void SignalGeneratorAudioSource::Stop()
+{
+    {
+        std::lock_guard lock(pacingMutex_);
+        running_ = false;
+    }
+    pacingCv_.notify_all();
+
+    if (worker_.joinable())
+    {
+        worker_.join();
+    }
+}
+
+void SignalGeneratorAudioSource::GenerateLoop()
+{
+    const bool paced = options_.speed > 0.0;
+    const double samplesPerSecond = options_.sampleRate * options_.speed;
+    const auto start = std::chrono::steady_clock::now();
+    const uint64_t startPosition = generator_.GetPosition();
+
+    while (running_)
+    {
+        if (generator_.IsFinished())
+        {
+            // Before the end of stream, so a sink woken by it can initialize and start the source again right away
+            finished_ = true;
+            running_ = false;
+            EndStream();
+            return;
+        }
+
+        // The last chunk of a finite signal is shorter
+        size_t count = chunkSize_;
+        if (generator_.GetLength() > 0)
+        {
+            count = static_cast<size_t>(std::min<uint64_t>(count, generator_.GetLength() - generator_.GetPosition()));
+        }
+        chunk_.resize(count);
+        generator_.Generate(chunk_.data(), count);
+
+        if (paced)
+        {
+            // Release times are computed from the start, not from the previous chunk, so they never drift
+            const auto samplesSent = static_cast<double>(generator_.GetPosition() - startPosition);
+            const auto releaseTime = start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                std::chrono::duration<double>(samplesSent / samplesPerSecond));
+            if (!WaitForReleaseTime(releaseTime))
+            {
+                return;
+            }
+        }
+
+        Notify(chunk_);
+    }
+}
+
+bool SignalGeneratorAudioSource::WaitForReleaseTime(const std::chrono::steady_clock::time_point releaseTime)
+{
+    std::unique_lock lock(pacingMutex_);
+    return !pacingCv_.wait_until(lock, releaseTime, [this] { return !running_; });
+}
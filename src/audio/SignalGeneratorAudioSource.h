@@ -0,0 +1,143 @@
+//
+// Created by Robert on 2025-11-07.
+//
+
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "IAudioSource.h"
+#include "spdlog/logger.h"
+
+namespace bpmfinder::audio
+{
+    struct SignalGeneratorOptions
+    {
+        int sampleRate = 48000;
+        double durationSeconds = 0.0; // 0 = endless
+
+        // Click track, bpm = 0 for noise only
+        float bpm = 120.0f;
+        float endBpm = 0.0f; // > 0: the tempo ramps linearly from bpm to endBpm over rampSeconds, then stays
+        float rampSeconds = 0.0f;
+        float swing = 0.0f; // Every second click is delayed by this fraction of a beat (0.33 = triplet feel)
+
+        // Every click is the same decaying sine burst
+        float clickFrequency = 200.0f;
+        float clickSeconds = 0.04f;
+        float clickAmplitude = 0.5f;
+
+        // Noise: with clicks, its level follows from the ratio of the click RMS (amplitude / sqrt(2)) to the noise RMS
+        // in dB, infinity = no noise. Without clicks, noiseRms is used.
+        float snrDb = std::numeric_limits<float>::infinity();
+        float noiseRms = 0.1f;
+        float noiseLowCutoff = 0.0f; // Hz, 0 = no high pass
+        float noiseHighCutoff = 0.0f; // Hz, 0 = no low pass
+
+        uint32_t seed = 1;
+
+        // 0 = flat-out, as fast as the subscribers take the chunks. Otherwise paced at this multiple of real time.
+        double speed = 0.0;
+    };
+
+    // Deterministic test material: the same options always produce the same samples, no matter in which block sizes
+    // they are generated. Clicks are copied out of a precomputed table and the noise comes from 16 independent
+    // xorshift generators that run side by side, so both loops vectorize.
+    class SignalGenerator
+    {
+    public:
+        explicit SignalGenerator(const SignalGeneratorOptions& options);
+
+        // Writes the next 'count' samples
+        void Generate(float* output, size_t count);
+
+        // Back to the first sample
+        void Reset();
+
+        // Samples generated so far
+        [[nodiscard]] uint64_t GetPosition() const { return position_; }
+
+        // Samples of the whole signal, 0 if it is endless
+        [[nodiscard]] uint64_t GetLength() const { return length_; }
+
+        [[nodiscard]] bool IsFinished() const { return length_ > 0 && position_ >= length_; }
+
+        // Start of every click in the first 'samples' samples, for checking an analysis against the ground truth
+        [[nodiscard]] std::vector<uint64_t> GetClickPositions(uint64_t samples) const;
+
+    private:
+        static constexpr size_t NoiseLanes = 16;
+
+        void GenerateNoise(float* output, size_t count);
+        void GenerateNoiseBlock(float* output);
+        void FilterNoise(float* output, size_t count);
+        void AddClicks(float* output, size_t count);
+        void ScheduleNextClick();
+        [[nodiscard]] double GetBeatPeriod(double position) const;
+
+        SignalGeneratorOptions options_;
+        uint64_t length_;
+        uint64_t position_ = 0;
+
+        // Clicks
+        std::vector<float> clickTable_;
+        size_t clickPhase_ = 0; // Index into the table of the click that sounds, table size if none does
+        double gridPosition_ = 0.0; // Unswung position of the next beat
+        uint64_t beatIndex_ = 0;
+        uint64_t nextClick_ = 0;
+
+        // Noise
+        float noiseGain_ = 0.0f;
+        float lowPassCoefficient_ = 0.0f; // 0 = off
+        float highPassCoefficient_ = 0.0f; // 0 = off
+        float lowPassState_ = 0.0f;
+        float highPassState_ = 0.0f;
+        std::array<uint32_t, NoiseLanes> noiseState_{};
+        std::array<float, NoiseLanes> pendingNoise_{}; // Rest of a block that did not fit into the last call
+        size_t pendingNoiseIndex_ = NoiseLanes;
+    };
+
+    // Passes the output of a SignalGenerator on in chunks, flat-out or paced like a live capture. Runs without audio
+    // hardware or fixture files, for throughput benchmarks and BPM accuracy tests. A finite signal ends with a shorter
+    // last chunk and IsFinished turns true.
+    class SignalGeneratorAudioSource final : public IAudioSource
+    {
+    public:
+        explicit SignalGeneratorAudioSource(const SignalGeneratorOptions& options, size_t chunkSize = 1024);
+        ~SignalGeneratorAudioSource() override;
+
+        // A second call starts the signal from the beginning again
+        bool Initialize() override;
+        void Start() override;
+        void Stop() override;
+
+        [[nodiscard]] bool IsFinished() const override { return finished_; }
+
+        [[nodiscard]] const SignalGeneratorOptions& GetOptions() const { return options_; }
+
+    private:
+        void GenerateLoop();
+        bool WaitForReleaseTime(std::chrono::steady_clock::time_point releaseTime);
+
+        SignalGeneratorOptions options_;
+        size_t chunkSize_;
+        SignalGenerator generator_;
+        AudioChunk chunk_;
+
+        std::thread worker_;
+        std::atomic<bool> running_{false};
+        std::atomic<bool> finished_{false};
+
+        // Paced, so Stop does not have to wait for the next release time
+        std::mutex pacingMutex_;
+        std::condition_variable pacingCv_;
+
+        std::shared_ptr<spdlog::logger> logger_;
+    };
+}
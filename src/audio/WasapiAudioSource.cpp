@@ -14,7 +14,6 @@ WasapiAudioSource::WasapiAudioSource(size_t chunkSize)
     : waveFormat_(nullptr), eventHandle_(nullptr), capturing_(false), chunkSize_(chunkSize)
 {
     CoInitializeEx(nullptr, COINIT_MULTITHREADED);
-    audioBuffer_.reserve(chunkSize_);
 }
 
 WasapiAudioSource::~WasapiAudioSource()
@@ -53,24 +52,54 @@ bool WasapiAudioSource::Initialize()
     hr = audioClient_->GetService(IID_PPV_ARGS(&captureClient_));
     if (FAILED(hr)) return false;
 
+    // Allocated here, once the channel count is known: the capture loop itself never allocates.
+    // Chunks hold chunkSize_ whole frames, the DownmixStage of the pipeline turns them into mono.
+    handoff_ = std::make_unique<CaptureHandoff>(chunkSize_ * numChannels_, HandoffCapacityChunks,
+                                                [this](const AudioChunk& chunk) { Notify(chunk); });
+
     return true;
 }
 
 void WasapiAudioSource::Start()
 {
+    if (capturing_ || !handoff_)
+    {
+        return;
+    }
+
+    handoff_->Start();
     capturing_ = true;
     audioClient_->Start();
-    std::thread(&WasapiAudioSource::CaptureLoop, this).detach();
+    captureThread_ = std::thread(&WasapiAudioSource::CaptureLoop, this);
 }
 
 void WasapiAudioSource::Stop()
 {
     capturing_ = false;
+    if (captureThread_.joinable())
+    {
+        captureThread_.join();
+    }
 
     if (audioClient_)
     {
         audioClient_->Stop();
     }
+
+    if (handoff_)
+    {
+        handoff_->Stop();
+    }
+}
+
+uint64_t WasapiAudioSource::GetOverrunCount() const
+{
+    return handoff_ ? handoff_->GetStatistics().overrunCount : 0;
+}
+
+uint64_t WasapiAudioSource::GetLostSamples() const
+{
+    return handoff_ ? handoff_->GetStatistics().lostSamples : 0;
 }
 
 void WasapiAudioSource::CaptureLoop()
@@ -89,46 +118,9 @@ void WasapiAudioSource::CaptureLoop()
             hr = captureClient_->GetBuffer(&data, &numFrames, &flags, nullptr, nullptr);
             if (SUCCEEDED(hr))
             {
-                // Calculate the number of actual float samples (frames * channels)
-                // Assuming mono (1 channel) for simplicity; adjust if stereo.
-                size_t numSamples = numFrames; // Assuming mono (1 float per frame)
-                float* samples = reinterpret_cast<float*>(data);
-
-                size_t samplesRemaining = numSamples;
-                size_t offset = 0;
-
-                while (samplesRemaining > 0)
-                {
-                    // Calculate how many samples we need to reach the full chunk size
-                    size_t needed = chunkSize_ - audioBuffer_.size();
-
-                    // Determine how many samples to copy in this step
-                    size_t copyCount = std::min(samplesRemaining, needed);
-
-                    // Append the samples to the buffer
-                    audioBuffer_.insert(audioBuffer_.end(), samples + offset, samples + offset + copyCount);
-
-                    // Update counters
-                    samplesRemaining -= copyCount;
-                    offset += copyCount;
-
-                    // Check if a full chunk is ready
-                    if (audioBuffer_.size() == chunkSize_)
-                    {
-                        // 1. Efficiently move data from the instance buffer to a local, temporary buffer.
-                        // This makes 'audioBuffer_' ready for immediate reuse (O(1) move).
-                        AudioChunk completeChunk = std::move(audioBuffer_);
-
-                        // 2. Notify ALL observers using the local buffer.
-                        // The Notify method will now call PushData(const AudioChunk&),
-                        // which forces a COPY into *each* observer's queue.
-                        this->Notify(completeChunk);
-
-                        // 3. Reset the instance buffer (already done by std::move and clear)
-                        audioBuffer_.clear();
-                        audioBuffer_.reserve(chunkSize_);
-                    }
-                }
+                // The mix format is interleaved float with numChannels_ samples per frame. Wait-free: a full
+                // handoff drops the packet and counts an overrun, the capture never waits for the pipeline.
+                handoff_->Write(reinterpret_cast<const float*>(data), static_cast<size_t>(numFrames) * numChannels_);
 
                 captureClient_->ReleaseBuffer(numFrames);
             }
@@ -6,8 +6,12 @@
 #include <audioclient.h>
 #include <mmdeviceapi.h>
 #include <wrl/client.h> // Microsoft::WRL::ComPtr smart pointers
+#include <atomic>
 #include <fstream>
+#include <memory>
+#include <thread>
 
+#include "CaptureHandoff.h"
 #include "IAudioSource.h"
 
 namespace bpmfinder::audio
@@ -26,6 +30,11 @@ namespace bpmfinder::audio
 
         uint32_t GetSampleRate() const { return waveFormat_ ? waveFormat_->nSamplesPerSec : 0; }
         uint16_t GetNumChannels() const { return waveFormat_ ? waveFormat_->nChannels : 0; }
+        [[nodiscard]] int GetChannelCount() const override { return numChannels_ > 0 ? numChannels_ : 1; }
+
+        // Capture packets dropped because the dispatcher fell behind by more than the handoff ring
+        [[nodiscard]] uint64_t GetOverrunCount() const override;
+        [[nodiscard]] uint64_t GetLostSamples() const override;
 
     private:
         Microsoft::WRL::ComPtr<IMMDeviceEnumerator> deviceEnumerator_;
@@ -33,11 +42,15 @@ namespace bpmfinder::audio
         Microsoft::WRL::ComPtr<IAudioClient> audioClient_;
         Microsoft::WRL::ComPtr<IAudioCaptureClient> captureClient_;
 
-        AudioChunk audioBuffer_;
+        // The capture loop only writes into the handoff, its dispatcher thread calls Notify
+        static constexpr size_t HandoffCapacityChunks = 64;
+        std::unique_ptr<CaptureHandoff> handoff_;
+        std::thread captureThread_;
+
         size_t chunkSize_;
         WAVEFORMATEX* waveFormat_;
         HANDLE eventHandle_;
-        bool capturing_;
+        std::atomic<bool> capturing_;
         uint32_t sampleRate_ = 0;
         uint16_t numChannels_ = 0;
     };
@@ -0,0 +1,259 @@
+//
+// Created by Robert on 2025-11-05.
+//
+
+#include "WavFileAudioSource.h"
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fstream>
+
+using namespace bpmfinder::audio;
+
+namespace
+{
+    constexpr uint16_t WaveFormatPcm = 0x0001;
+    constexpr uint16_t WaveFormatIeeeFloat = 0x0003;
+    constexpr uint16_t WaveFormatExtensible = 0xFFFE;
+
+    // Streamed WAVs (e.g. ffmpeg writing to a pipe) do not know the size of the data chunk and write this instead
+    constexpr uint32_t UnknownSize = 0xFFFFFFFF;
+
+    // Size of the blocks ReadSamples converts at a time
+    constexpr size_t ReadBlockBytes = 256 * 1024;
+
+    uint16_t ReadUInt16(const std::byte* data)
+    {
+        return static_cast<uint16_t>(static_cast<uint16_t>(data[0]) | static_cast<uint16_t>(data[1]) << 8);
+    }
+
+    uint32_t ReadUInt32(const std::byte* data)
+    {
+        return static_cast<uint32_t>(data[0]) | static_cast<uint32_t>(data[1]) << 8 |
+            static_cast<uint32_t>(data[2]) << 16 | static_cast<uint32_t>(data[3]) << 24;
+    }
+
+    bool HasId(const std::byte* data, const char* id)
+    {
+        return std::memcmp(data, id, 4) == 0;
+    }
+
+    std::optional<PcmSampleFormat> ToSampleFormat(const uint16_t formatTag, const uint16_t bitsPerSample)
+    {
+        if (formatTag == WaveFormatIeeeFloat && bitsPerSample == 32)
+        {
+            return PcmSampleFormat::Float32;
+        }
+        if (formatTag == WaveFormatPcm)
+        {
+            switch (bitsPerSample)
+            {
+            case 16:
+                return PcmSampleFormat::Int16;
+            case 24:
+                return PcmSampleFormat::Int24;
+            case 32:
+                return PcmSampleFormat::Int32;
+            default:
+                break;
+            }
+        }
+        return std::nullopt;
+    }
+}
+
+WavFileAudioSource::WavFileAudioSource(std::string path, const size_t chunkSize, const size_t readBufferBytes,
+                                       const int expectedSampleRate) :
+    PcmStreamAudioSource(std::move(path), {}, chunkSize, readBufferBytes),
+    expectedSampleRate_(expectedSampleRate)
+{
+}
+
+std::optional<WavHeader> WavFileAudioSource::ParseHeader(const ReadFunction& read, std::string* error)
+{
+    const auto fail = [error](const std::string& message) -> std::optional<WavHeader>
+    {
+        if (error)
+        {
+            *error = message;
+        }
+        return std::nullopt;
+    };
+
+    std::array<std::byte, 12> riff{};
+    if (!read(riff.data(), riff.size()) || !HasId(riff.data(), "RIFF") || !HasId(riff.data() + 8, "WAVE"))
+    {
+        return fail("not a RIFF/WAVE file");
+    }
+
+    WavHeader header;
+    bool hasFormat = false;
+    while (true)
+    {
+        std::array<std::byte, 8> chunkHeader{};
+        if (!read(chunkHeader.data(), chunkHeader.size()))
+        {
+            return fail("no data chunk");
+        }
+        const uint32_t chunkSize = ReadUInt32(chunkHeader.data() + 4);
+
+        if (HasId(chunkHeader.data(), "data"))
+        {
+            if (!hasFormat)
+            {
+                return fail("data chunk before the fmt chunk");
+            }
+            header.dataBytes = chunkSize == UnknownSize ? 0 : chunkSize;
+            return header;
+        }
+
+        // Chunks are padded to an even size
+        const uint64_t paddedSize = static_cast<uint64_t>(chunkSize) + (chunkSize & 1);
+        if (!HasId(chunkHeader.data(), "fmt "))
+        {
+            // LIST, fact, bext, ... carry nothing we need. They can be large (embedded cover art), skip in pieces.
+            std::array<std::byte, 4096> skipped{};
+            for (uint64_t left = paddedSize; left > 0;)
+            {
+                const auto size = static_cast<size_t>(std::min<uint64_t>(left, skipped.size()));
+                if (!read(skipped.data(), size))
+                {
+                    return fail("truncated chunk");
+                }
+                left -= size;
+            }
+            continue;
+        }
+
+        std::vector<std::byte> body(paddedSize);
+        if (!read(body.data(), body.size()))
+        {
+            return fail("truncated fmt chunk");
+        }
+        if (chunkSize < 16)
+        {
+            return fail("fmt chunk too short");
+        }
+        uint16_t formatTag = ReadUInt16(body.data());
+        const uint16_t channels = ReadUInt16(body.data() + 2);
+        const uint32_t sampleRate = ReadUInt32(body.data() + 4);
+        const uint16_t blockAlign = ReadUInt16(body.data() + 12);
+        const uint16_t bitsPerSample = ReadUInt16(body.data() + 14);
+
+        // WAVE_FORMAT_EXTENSIBLE: the actual format tag is in the first two bytes of the sub format GUID
+        if (formatTag == WaveFormatExtensible)
+        {
+            if (chunkSize < 40)
+            {
+                return fail("extensible fmt chunk too short");
+            }
+            formatTag = ReadUInt16(body.data() + 24);
+        }
+
+        const auto sampleFormat = ToSampleFormat(formatTag, bitsPerSample);
+        if (!sampleFormat)
+        {
+            return fail("unsupported format " + std::to_string(formatTag) + " with " + std::to_string(bitsPerSample) +
+                " bits per sample");
+        }
+        if (channels == 0 || sampleRate == 0 || blockAlign != channels * GetBytesPerSample(*sampleFormat))
+        {
+            return fail("inconsistent fmt chunk");
+        }
+
+        header.format.sampleFormat = *sampleFormat;
+        header.format.channels = channels;
+        header.format.sampleRate = static_cast<int>(sampleRate);
+        hasFormat = true;
+    }
+}
+
+std::optional<WavHeader> WavFileAudioSource::ReadFileHeader(const std::string& filename)
+{
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open())
+    {
+        return std::nullopt;
+    }
+
+    return ParseHeader([&file](std::byte* buffer, const size_t size)
+    {
+        return static_cast<bool>(file.read(reinterpret_cast<char*>(buffer), static_cast<std::streamsize>(size)));
+    });
+}
+
+bool WavFileAudioSource::ReadSamples(const std::string& filename, std::vector<float>& samples, WavHeader& header)
+{
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open())
+    {
+        return false;
+    }
+
+    const auto parsed = ParseHeader([&file](std::byte* buffer, const size_t size)
+    {
+        return static_cast<bool>(file.read(reinterpret_cast<char*>(buffer), static_cast<std::streamsize>(size)));
+    });
+    if (!parsed)
+    {
+        return false;
+    }
+    header = *parsed;
+
+    const size_t frameBytes = GetBytesPerSample(header.format.sampleFormat) *
+        static_cast<size_t>(header.format.channels);
+    uint64_t bytesLeft = header.dataBytes > 0 ? header.dataBytes : Unlimited;
+
+    samples.clear();
+    if (header.dataBytes > 0)
+    {
+        samples.reserve(static_cast<size_t>(header.dataBytes / frameBytes));
+    }
+
+    // Whole frames only, a block never splits a frame
+    std::vector<std::byte> block(std::max<size_t>(1, ReadBlockBytes / frameBytes) * frameBytes);
+    while (bytesLeft > 0 && file)
+    {
+        file.read(reinterpret_cast<char*>(block.data()),
+                  static_cast<std::streamsize>(std::min<uint64_t>(block.size(), bytesLeft)));
+        const auto bytesRead = static_cast<size_t>(file.gcount());
+        const size_t frames = bytesRead / frameBytes;
+
+        const size_t offset = samples.size();
+        samples.resize(offset + frames);
+        ConvertToMonoFloat(block.data(), frames, static_cast<size_t>(header.format.channels),
+                           header.format.sampleFormat, samples.data() + offset);
+
+        if (bytesLeft != Unlimited)
+        {
+            bytesLeft -= bytesRead;
+        }
+    }
+
+    return true;
+}
+
+bool WavFileAudioSource::ReadHeader()
+{
+    std::string error;
+    const auto header = ParseHeader([this](std::byte* buffer, const size_t size)
+    {
+        return ReadExactly(buffer, size);
+    }, &error);
+
+    if (!header)
+    {
+        logger_->error("{} is not a supported WAV file: {}", path_, error);
+        return false;
+    }
+    if (expectedSampleRate_ > 0 && header->format.sampleRate != expectedSampleRate_)
+    {
+        logger_->error("{} has a sample rate of {} Hz, but the analysis runs at {} Hz (--rate)",
+                       path_ == "-" ? "stdin" : path_, header->format.sampleRate, expectedSampleRate_);
+        return false;
+    }
+
+    format_ = header->format;
+    dataBytes_ = header->dataBytes > 0 ? header->dataBytes : Unlimited;
+    return true;
+}
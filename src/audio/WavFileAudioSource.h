@@ -0,0 +1,51 @@
+//
+// Created by Robert on 2025-11-05.
+//
+
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <vector>
+#include "PcmStreamAudioSource.h"
+
+namespace bpmfinder::audio
+{
+    struct WavHeader
+    {
+        PcmStreamFormat format;
+        uint64_t dataBytes = 0; // Size of the data chunk, 0 if the writer did not know it (streamed WAV)
+    };
+
+    // Streams a WAV file (or a WAV on stdin / a FIFO) into the pipeline: the RIFF header is parsed on Initialize, then
+    // the data chunk is read and converted like raw PCM by the PcmStreamAudioSource. Supports PCM 16/24/32 bit and
+    // 32 bit float, plain or WAVE_FORMAT_EXTENSIBLE, with any number of channels (mixed down to mono).
+    // The format passed to the constructor is replaced by the one in the header.
+    // An expectedSampleRate > 0 makes Initialize fail for a header with another rate: a piped WAV can only be read
+    // once, so the pipeline config is built before its header is known and must not silently run at the wrong rate.
+    class WavFileAudioSource final : public PcmStreamAudioSource
+    {
+    public:
+        explicit WavFileAudioSource(std::string path, size_t chunkSize = 512,
+                                    size_t readBufferBytes = DefaultReadBufferBytes, int expectedSampleRate = 0);
+
+        // Reads 'size' bytes, false at the end of the input
+        using ReadFunction = std::function<bool(std::byte* buffer, size_t size)>;
+
+        // Parses everything up to the start of the sample data, std::nullopt for anything that is not a supported WAV
+        static std::optional<WavHeader> ParseHeader(const ReadFunction& read, std::string* error = nullptr);
+
+        // Header of a WAV file, without reading the samples
+        static std::optional<WavHeader> ReadFileHeader(const std::string& filename);
+
+        // Reads and converts a whole WAV file to mono floats, block by block
+        static bool ReadSamples(const std::string& filename, std::vector<float>& samples, WavHeader& header);
+
+    protected:
+        bool ReadHeader() override;
+
+    private:
+        int expectedSampleRate_;
+    };
+}
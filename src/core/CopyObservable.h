@@ -34,6 +34,15 @@ namespace bpmfinder::core
             }
         }
 
+        void NotifyControl(const ControlToken token)
+        {
+            std::lock_guard lock(mtx_);
+            for (auto* obs : observers_)
+            {
+                obs->PushControl(token);
+            }
+        }
+
         size_t GetObserversCount()
         {
             std::lock_guard lock(mtx_);
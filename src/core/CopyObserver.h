@@ -7,9 +7,37 @@
 #include <mutex>
 #include <condition_variable>
 #include <atomic>
+#include <utility>
 
 namespace bpmfinder::core
 {
+    enum class ExecutionMode
+    {
+        // Every sink processes its queue on its own worker thread (default)
+        Threaded,
+
+        // No thread and no queue: PushData processes the item right away on the thread that pushes it. A graph of
+        // inline sinks runs depth first on the thread of whoever publishes into it, deterministic and without any
+        // synchronization. For tests and offline runs.
+        Inline
+    };
+
+    // In-band control messages. They travel through the queues in order with the data: a sink handles a token after
+    // every item that was pushed before it and before every item pushed after it, a stage passes it on then.
+    enum class ControlToken
+    {
+        // No more data follows. Once the sinks at the end of a graph have it, everything before it went through.
+        EndOfStream,
+
+        // Pass on whatever is held back, keep the state: a barrier, e.g. before reading results
+        Flush,
+
+        // Forget what was seen so far, e.g. at the boundary between two files that go through the same stages
+        Reset
+    };
+
+    inline constexpr size_t ControlTokenCount = 3;
+
     // CRTP Style CopyObserver - Only pushes data to a queue, processing has to be done by other means, e.g. by implementing a WorkerThread
     template <typename DataType>
     class CopyObserver
@@ -21,18 +49,108 @@ namespace bpmfinder::core
         std::atomic<size_t> queued_count_{0}; // Total items pushed to queue
         std::atomic<size_t> processed_count_{0}; // Total items processed
 
+        // Backpressure: with a capacity, PushData blocks the producer while the queue is full and a consumer is
+        // running to empty it
+        std::condition_variable space_cv_;
+        size_t capacity_ = 0; // 0 = unbounded
+        bool consumer_running_ = false;
+
+        // Must be called with mtx_ held
+        void WaitForSpace(std::unique_lock<std::mutex>& lock)
+        {
+            space_cv_.wait(lock, [this]
+            {
+                return capacity_ == 0 || queue_.size() < capacity_ || !consumer_running_;
+            });
+        }
+
+        // For consumers: call after taking items out of the queue
+        void NotifySpaceAvailable()
+        {
+            space_cv_.notify_all();
+        }
+
+        // For consumers that run inline (see ExecutionMode): set while PushData hands items to ProcessInline instead
+        // of queuing them. Only changed while nobody pushes.
+        bool inline_ = false;
+
+        virtual void ProcessInline(DataType)
+        {
+        }
+
+        // For consumers: without a running consumer nobody would ever make room, so producers must not block
+        void SetConsumerRunning(const bool running)
+        {
+            {
+                std::lock_guard lock(mtx_);
+                consumer_running_ = running;
+            }
+            space_cv_.notify_all();
+        }
+
     public:
+        virtual ~CopyObserver() = default;
+
         void PushData(const DataType& data)
         {
+            if (inline_)
+            {
+                queued_count_++;
+                ProcessInline(data); // The one copy the queue would make
+                return;
+            }
+
             // Lock only for the duration of putting new data into the queue
             {
                 std::unique_lock lock(mtx_);
+                WaitForSpace(lock);
                 queue_.push(data); // ⚠️ COPIES data into the queue!
                 queued_count_++;
             } // Release lock before notifying
             cv_.notify_one();
         }
 
+        // Overload for producers that own the data and can hand it over without a copy
+        void PushData(DataType&& data)
+        {
+            if (inline_)
+            {
+                queued_count_++;
+                ProcessInline(std::move(data));
+                return;
+            }
+
+            {
+                std::unique_lock lock(mtx_);
+                WaitForSpace(lock);
+                queue_.push(std::move(data));
+                queued_count_++;
+            }
+            cv_.notify_one();
+        }
+
+        // Sinks queue the token behind the data pushed so far. Plain observers have no consumer to keep the order
+        // for, they drop it.
+        virtual void PushControl(ControlToken)
+        {
+        }
+
+        // Maximum number of queued items, 0 = unbounded (default). Set it before data starts flowing.
+        void SetCapacity(const size_t capacity)
+        {
+            {
+                std::lock_guard lock(mtx_);
+                capacity_ = capacity;
+            }
+            space_cv_.notify_all();
+        }
+
+        [[nodiscard]] size_t GetCapacity()
+        {
+            std::lock_guard lock(mtx_);
+            return capacity_;
+        }
+
         [[nodiscard]] size_t GetQueuedCount() const { return queued_count_.load(); }
         [[nodiscard]] size_t GetProcessedCount() const { return processed_count_.load(); }
     };
@@ -4,6 +4,8 @@
 
 #pragma once
 #include "CopyObserver.h"
+#include <array>
+#include <deque>
 #include <thread>
 #include <atomic>
 #include <future>
@@ -22,11 +24,36 @@ namespace bpmfinder::core
             Stop();
         }
 
-        void Start()
+        // Threaded starts the worker thread. Inline processes what was pushed before Start right away, on this
+        // thread, and every later item when it is pushed, on the pushing thread.
+        void Start(const ExecutionMode mode = ExecutionMode::Threaded)
         {
             if (running_) return; // Avoid starting twice
 
+            if (mode == ExecutionMode::Inline)
+            {
+                running_ = true;
+                while (!this->queue_.empty() || !controls_.empty())
+                {
+                    if (IsControlNext())
+                    {
+                        const ControlToken token = controls_.front().second;
+                        controls_.pop_front();
+                        HandleControl(token);
+                        continue;
+                    }
+                    DataType data = std::move(this->queue_.front());
+                    this->queue_.pop();
+                    ++dequeued_count_;
+                    Process(std::move(data));
+                    ++this->processed_count_;
+                }
+                this->inline_ = true;
+                return;
+            }
+
             running_ = true;
+            this->SetConsumerRunning(true);
             std::promise<void> thread_ready;
             std::future<void> ready_future = thread_ready.get_future();
 
@@ -45,18 +72,28 @@ namespace bpmfinder::core
                     // when there is data OR when we are stopping.
                     this->cv_.wait(lock, [this]
                     {
-                        return !this->queue_.empty() || !this->running_;
+                        return !this->queue_.empty() || !controls_.empty() || !this->running_;
                     });
 
                     // Check again in case we woke up because 'running_' became false
-                    if (!this->running_ && this->queue_.empty())
+                    if (!this->running_ && this->queue_.empty() && controls_.empty())
                     {
                         break;
                     }
 
-                    // Process all data currently in the queue
-                    while (!this->queue_.empty())
+                    // Process all data and control tokens currently in the queue
+                    while (!this->queue_.empty() || !controls_.empty())
                     {
+                        if (IsControlNext())
+                        {
+                            const ControlToken token = controls_.front().second;
+                            controls_.pop_front();
+                            lock.unlock();
+                            HandleControl(token);
+                            lock.lock();
+                            continue;
+                        }
+
                         // 1. Get the data
                         // Move the front element from the queue into local variable 'data'
                         // - `this->queue_.front()` returns a **reference** to the element at the front of the queue
@@ -66,10 +103,12 @@ namespace bpmfinder::core
                         // - After the move, the queue element is in a "valid but unspecified state" (typically empty)
                         // - - `queue_.pop()` removes the now-moved-from element from the queue
                         this->queue_.pop();
+                        ++dequeued_count_;
 
                         // MUST release the lock before processing to avoid blocking
                         // the PushData call on the other thread while we process.
                         lock.unlock();
+                        this->NotifySpaceAvailable(); // Wake up a producer that waits for room in a bounded queue
 
                         // 2. Process the data by calling the virtual method
                         // - Even though we already moved `data` from the queue, the local variable itself is an **lvalue** (it has a name and persists in scope).
@@ -93,8 +132,22 @@ namespace bpmfinder::core
 
         void Stop()
         {
-            running_ = false;
+            if (this->inline_)
+            {
+                // Nothing queued, nothing to join: every item was processed when it was pushed
+                this->inline_ = false;
+                running_ = false;
+                return;
+            }
+
+            {
+                // Flip the flag under the queue lock: otherwise the worker can check it right before we flip it,
+                // miss the notification below and wait forever
+                std::lock_guard lock(this->mtx_);
+                running_ = false;
+            }
             this->cv_.notify_one(); // ← CRITICAL: Wake up the worker thread!
+            this->SetConsumerRunning(false); // Producers blocked on a full queue must not wait for us anymore
             if (thread_.joinable())
                 thread_.join();
         }
@@ -123,8 +176,9 @@ namespace bpmfinder::core
         {
             auto start = std::chrono::steady_clock::now();
 
-            // Wait for predecessor to finish processing (queue empty and not running)
-            while (predecessor.IsRunning() || !predecessor.IsQueueEmpty())
+            // Wait for predecessor to finish processing (queue empty and not running). Inline, whatever it passed on
+            // has been processed already.
+            while (!this->inline_ && (predecessor.IsRunning() || !predecessor.IsQueueEmpty()))
             {
                 if (std::chrono::steady_clock::now() - start > timeout)
                 {
@@ -139,14 +193,95 @@ namespace bpmfinder::core
 
         [[nodiscard]] bool IsRunning() const { return running_; }
 
+        [[nodiscard]] bool IsInline() const { return this->inline_; }
+
+        // Queues the token behind everything pushed so far; inline it is handled right away
+        void PushControl(const ControlToken token) override
+        {
+            if (this->inline_)
+            {
+                HandleControl(token);
+                return;
+            }
+            {
+                std::lock_guard lock(this->mtx_);
+                controls_.emplace_back(this->queued_count_.load(), token);
+            }
+            this->cv_.notify_one();
+        }
+
+        // Tokens of this kind handled so far
+        [[nodiscard]] size_t GetControlCount(const ControlToken token)
+        {
+            std::lock_guard lock(control_mtx_);
+            return control_counts_[static_cast<size_t>(token)];
+        }
+
+        // Until 'count' tokens of this kind have been handled. False on timeout.
+        bool WaitForControl(const ControlToken token, const size_t count, const std::chrono::milliseconds timeout)
+        {
+            std::unique_lock lock(control_mtx_);
+            return control_cv_.wait_for(lock, timeout, [&]
+            {
+                return control_counts_[static_cast<size_t>(token)] >= count;
+            });
+        }
+
+    protected:
+        void ProcessInline(DataType data) override
+        {
+            ++dequeued_count_;
+            Process(std::move(data));
+            ++this->processed_count_;
+        }
+
+        // A control token, on the thread that processes the data, after the items pushed before it. Override to
+        // finish or clear the state of the sink.
+        virtual void OnControl(ControlToken)
+        {
+        }
+
+        // Stages pass the token on to their subscribers
+        virtual void ForwardControl(ControlToken)
+        {
+        }
+
+    public:
+
         [[nodiscard]] bool IsQueueEmpty()
         {
             std::lock_guard lock(this->mtx_);
-            return this->queue_.empty();
+            return this->queue_.empty() && controls_.empty();
         }
 
     private :
+        // Must be called with mtx_ held (or inline), with something queued: a token is due once every item pushed
+        // before it has been taken out of the queue
+        [[nodiscard]] bool IsControlNext() const
+        {
+            return !controls_.empty() && (controls_.front().first <= dequeued_count_ || this->queue_.empty());
+        }
+
+        void HandleControl(const ControlToken token)
+        {
+            OnControl(token);
+            ForwardControl(token);
+            {
+                std::lock_guard lock(control_mtx_);
+                ++control_counts_[static_cast<size_t>(token)];
+            }
+            control_cv_.notify_all();
+        }
+
         std::thread thread_;
         std::atomic<bool> running_{false};
+
+        // Control tokens with the number of items pushed before them, and the number of items taken out of the queue
+        std::deque<std::pair<size_t, ControlToken>> controls_;
+        size_t dequeued_count_ = 0;
+
+        std::mutex control_mtx_;
+        std::condition_variable control_cv_;
+        std::array<size_t, ControlTokenCount> control_counts_{};
     };
 }
@@ -14,5 +14,21 @@ namespace bpmfinder::core
     {
         // Funny enough, the sink implementation already does everything we need, so we just need to inherit from
         // CopyObservable and notify the observers there after applying whatever dsp algorithm is applied in this stage
+
+    public:
+        using Input = InputType;
+        using Output = OutputType;
+
+        // A stage is stateless if its output for one item does not depend on any item it has seen before.
+        // Stateless stages can be replicated and run in parallel by a ParallelCopyStage, stages that keep history
+        // between items (filters, sliding windows, ...) must leave this false.
+        static constexpr bool IsStateless = false;
+
+    protected:
+        // After OnControl, in order with the output
+        void ForwardControl(const ControlToken token) override
+        {
+            this->NotifyControl(token);
+        }
     };
 }
@@ -0,0 +1,232 @@
+//
+// Created by Robert on 2025-10-26.
+//
+
+#pragma once
+#include <algorithm>
+#include <deque>
+#include <map>
+#include <memory>
+#include <vector>
+#include "CopyStage.h"
+
+namespace bpmfinder::core
+{
+    // Default sequence number for the reorder buffer: the chunk index that every pipeline result carries
+    struct ChunkIndexSequence
+    {
+        template <typename DataType>
+        size_t operator()(const DataType& data) const { return data.chunkIndex; }
+    };
+
+    // Runs N replicas of a stateless stage in parallel, each replica on its own worker thread.
+    // Incoming items are dealt round-robin to the replicas, their outputs are put back into sequence order by a
+    // reorder buffer and only then emitted, so the next (stateful) stage sees exactly the same order as without
+    // replication.
+    // Requirements on the replicated stage:
+    // - It must be marked stateless (IsStateless = true)
+    // - It must emit exactly one output per input, otherwise the reorder buffer waits forever for the missing item
+    // - Sequence numbers must start at 0 and have no gaps
+    // Control tokens skip the replicas (they are stateless): the reorder buffer emits a token once it has emitted every
+    // item that was dealt out before it.
+    template <typename StageType, typename SequenceOf = ChunkIndexSequence>
+    class ParallelCopyStage : public CopyStage<typename StageType::Input, typename StageType::Output>
+    {
+        static_assert(StageType::IsStateless, "Only stateless stages can be replicated by a ParallelCopyStage");
+
+        using InputType = typename StageType::Input;
+        using OutputType = typename StageType::Output;
+        using BaseStage = CopyStage<InputType, OutputType>;
+
+    public:
+        // All replicas are constructed with the same arguments
+        template <typename... StageArgs>
+        explicit ParallelCopyStage(const size_t replicaCount, const StageArgs&... stageArgs) : reorderSink_(*this)
+        {
+            const size_t count = std::max<size_t>(replicaCount, 1);
+            replicas_.reserve(count);
+            for (size_t i = 0; i < count; ++i)
+            {
+                replicas_.push_back(std::make_unique<StageType>(stageArgs...));
+                replicas_.back()->Subscribe(&reorderSink_);
+            }
+        }
+
+        ~ParallelCopyStage() override
+        {
+            Stop();
+        }
+
+        // Start from the back to the front, so nobody pushes into a queue that is not being worked on yet.
+        // Inline, the replicas take turns on the pushing thread: the same output, without the parallelism.
+        void Start(const ExecutionMode mode = ExecutionMode::Threaded)
+        {
+            reorderSink_.Start(mode);
+            for (const auto& replica : replicas_)
+            {
+                replica->Start(mode);
+            }
+            BaseStage::Start(mode);
+        }
+
+        // Stop from the front to the back, every Stop() processes whatever is still queued before it returns,
+        // so after this call every item pushed into this stage has been emitted
+        void Stop()
+        {
+            BaseStage::Stop();
+            for (const auto& replica : replicas_)
+            {
+                replica->Stop();
+            }
+            reorderSink_.Stop();
+        }
+
+        void StopAndDrain(std::chrono::milliseconds timeout = std::chrono::milliseconds(5000))
+        {
+            const auto start = std::chrono::steady_clock::now();
+
+            while (!IsQueueEmpty())
+            {
+                if (std::chrono::steady_clock::now() - start > timeout)
+                {
+                    std::cerr << "Warning: StopAndDrain timeout reached, queue not empty!" << std::endl;
+                    break;
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
+
+            Stop();
+        }
+
+        // Bounds the dispatcher queue, every replica queue and the reorder buffer queue (0 = unbounded), so a full
+        // next stage still blocks the one in front of this stage
+        void SetCapacity(const size_t capacity)
+        {
+            BaseStage::SetCapacity(capacity);
+            for (const auto& replica : replicas_)
+            {
+                replica->SetCapacity(capacity);
+            }
+            reorderSink_.SetCapacity(capacity);
+        }
+
+        // Empty only if neither the dispatcher, nor a replica, nor the reorder buffer still holds items or tokens
+        [[nodiscard]] bool IsQueueEmpty()
+        {
+            if (!BaseStage::IsQueueEmpty() || !reorderSink_.IsQueueEmpty() || reorderSink_.GetPendingCount() > 0)
+            {
+                return false;
+            }
+
+            return std::all_of(replicas_.begin(), replicas_.end(), [](const auto& replica)
+            {
+                return replica->IsQueueEmpty();
+            });
+        }
+
+        [[nodiscard]] size_t GetReplicaCount() const { return replicas_.size(); }
+
+    protected:
+        // Runs on the dispatcher thread, only hands the item over to the next replica
+        void Process(InputType data) override
+        {
+            replicas_[nextReplica_]->PushData(std::move(data));
+            nextReplica_ = (nextReplica_ + 1) % replicas_.size();
+            ++dealtCount_;
+        }
+
+        // Also on the dispatcher thread, after every item before the token has been dealt out
+        void ForwardControl(const ControlToken token) override
+        {
+            reorderSink_.PushControlAfter(dealtCount_, token);
+        }
+
+    private:
+        // Collects the outputs of all replicas and emits them in sequence order
+        class ReorderSink : public CopySink<OutputType>
+        {
+        public:
+            explicit ReorderSink(ParallelCopyStage& owner) : owner_(owner)
+            {
+            }
+
+            ~ReorderSink() override
+            {
+                this->Stop();
+            }
+
+            [[nodiscard]] size_t GetPendingCount()
+            {
+                std::lock_guard lock(pendingMtx_);
+                return pending_.size() + pendingControls_.size();
+            }
+
+            // Emits the token once the items with sequence numbers below 'sequence' have been emitted
+            void PushControlAfter(const size_t sequence, const ControlToken token)
+            {
+                std::lock_guard lock(pendingMtx_);
+                pendingControls_.emplace_back(sequence, token);
+                EmitDueControls();
+            }
+
+        protected:
+            void Process(OutputType data) override
+            {
+                std::lock_guard lock(pendingMtx_);
+
+                // Items that arrive early wait until all their predecessors have been emitted
+                if (const size_t sequence = SequenceOf{}(data); sequence != nextSequence_)
+                {
+                    pending_.emplace(sequence, std::move(data));
+                    return;
+                }
+
+                owner_.Emit(data);
+                ++nextSequence_;
+                EmitDueControls();
+
+                // The item we just emitted may have unblocked a run of buffered successors
+                auto it = pending_.begin();
+                while (it != pending_.end() && it->first == nextSequence_)
+                {
+                    owner_.Emit(it->second);
+                    ++nextSequence_;
+                    it = pending_.erase(it);
+                    EmitDueControls();
+                }
+            }
+
+        private:
+            // Must be called with pendingMtx_ held
+            void EmitDueControls()
+            {
+                while (!pendingControls_.empty() && pendingControls_.front().first <= nextSequence_)
+                {
+                    owner_.EmitControl(pendingControls_.front().second);
+                    pendingControls_.pop_front();
+                }
+            }
+
+            ParallelCopyStage& owner_;
+            std::map<size_t, OutputType> pending_;
+            std::deque<std::pair<size_t, ControlToken>> pendingControls_;
+            std::mutex pendingMtx_;
+            size_t nextSequence_ = 0;
+        };
+
+        void Emit(const OutputType& data)
+        {
+            this->Notify(data);
+        }
+
+        void EmitControl(const ControlToken token)
+        {
+            this->NotifyControl(token);
+        }
+
+        ReorderSink reorderSink_;
+        std::vector<std::unique_ptr<StageType>> replicas_;
+        size_t nextReplica_ = 0;
+        size_t dealtCount_ = 0; // Items dealt out to the replicas, the sequence number of the next one
+    };
+}
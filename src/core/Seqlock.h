@@ -0,0 +1,75 @@
+//
+// Created by Robert on 2025-11-16.
+//
+
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace bpmfinder::core
+{
+    // A value with exactly one writer and any number of readers that never block it. Store never waits and never
+    // fails; a reader copies the value and retries only if a Store ran at the same time, so a reader sees either the
+    // old or the new value, never a mix. Standard layout and without pointers, so it also works in shared memory,
+    // with the writer and the readers in different processes.
+    template <typename T>
+    class Seqlock
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "The value is copied with memcpy");
+        static_assert(std::atomic<uint64_t>::is_always_lock_free, "Readers in other processes must not need a lock");
+
+    public:
+        Seqlock() = default;
+        explicit Seqlock(const T& value) : value_(value)
+        {
+        }
+
+        Seqlock(const Seqlock&) = delete;
+        Seqlock& operator=(const Seqlock&) = delete;
+
+        // Writer only
+        void Store(const T& value)
+        {
+            // Odd while the value changes: announce, change, publish
+            const uint64_t sequence = sequence_.load(std::memory_order_relaxed);
+            sequence_.store(sequence + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            std::memcpy(&value_, &value, sizeof(T));
+            sequence_.store(sequence + 2, std::memory_order_release);
+        }
+
+        // One attempt, false if a Store was in progress: for readers that would rather skip a frame than spin
+        bool TryLoad(T& value) const
+        {
+            const uint64_t before = sequence_.load(std::memory_order_acquire);
+            if (before & 1)
+            {
+                return false;
+            }
+            std::memcpy(&value, &value_, sizeof(T));
+            std::atomic_thread_fence(std::memory_order_acquire);
+            return sequence_.load(std::memory_order_relaxed) == before;
+        }
+
+        [[nodiscard]] T Load() const
+        {
+            T value;
+            while (!TryLoad(value))
+            {
+            }
+            return value;
+        }
+
+        // Number of Stores so far. Cheaper than Load to find out whether there is anything new.
+        [[nodiscard]] uint64_t GetVersion() const
+        {
+            return sequence_.load(std::memory_order_acquire) / 2;
+        }
+
+    private:
+        std::atomic<uint64_t> sequence_{0};
+        T value_{};
+    };
+}
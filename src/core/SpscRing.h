@@ -0,0 +1,98 @@
+//
+// Created by Robert on 2025-11-10.
+//
+
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+namespace bpmfinder::core
+{
+    // Wait-free ring for exactly one producer thread and one consumer thread. The storage is allocated in the
+    // constructor; Write and Read never lock, allocate or loop on a CAS, so the producer can be a real-time thread.
+    // Positions are sequence numbers: elements written since construction, the slot of a position is
+    // position & (capacity - 1). Each position sits on its own cache line.
+    template <typename T>
+    class SpscRing
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "Elements are copied with memcpy");
+
+    public:
+        // Rounded up to a power of two
+        explicit SpscRing(const size_t capacity) :
+            buffer_(std::bit_ceil(std::max<size_t>(1, capacity))),
+            mask_(buffer_.size() - 1)
+        {
+        }
+
+        SpscRing(const SpscRing&) = delete;
+        SpscRing& operator=(const SpscRing&) = delete;
+
+        [[nodiscard]] size_t GetCapacity() const { return buffer_.size(); }
+
+        // Producer: all or nothing, false if there is not enough room for all 'count' elements
+        bool Write(const T* data, const size_t count)
+        {
+            const uint64_t write = writePosition_.load(std::memory_order_relaxed);
+            const uint64_t read = readPosition_.load(std::memory_order_acquire);
+            if (count > buffer_.size() - static_cast<size_t>(write - read))
+            {
+                return false;
+            }
+
+            Copy(data, write, count);
+            writePosition_.store(write + count, std::memory_order_release);
+            return true;
+        }
+
+        // Consumer: elements that can be read right now
+        [[nodiscard]] size_t GetReadable() const
+        {
+            return static_cast<size_t>(writePosition_.load(std::memory_order_acquire) -
+                readPosition_.load(std::memory_order_relaxed));
+        }
+
+        // Producer or any other thread: an estimate, exact only on the two threads themselves
+        [[nodiscard]] size_t GetFill() const
+        {
+            return static_cast<size_t>(writePosition_.load(std::memory_order_acquire) -
+                readPosition_.load(std::memory_order_acquire));
+        }
+
+        // Consumer: copies up to 'count' elements out, returns how many
+        size_t Read(T* data, const size_t count)
+        {
+            const uint64_t read = readPosition_.load(std::memory_order_relaxed);
+            const size_t readable = std::min(count, static_cast<size_t>(
+                writePosition_.load(std::memory_order_acquire) - read));
+
+            const size_t slot = static_cast<size_t>(read) & mask_;
+            const size_t first = std::min(readable, buffer_.size() - slot);
+            std::memcpy(data, buffer_.data() + slot, first * sizeof(T));
+            std::memcpy(data + first, buffer_.data(), (readable - first) * sizeof(T));
+
+            readPosition_.store(read + readable, std::memory_order_release);
+            return readable;
+        }
+
+    private:
+        void Copy(const T* data, const uint64_t position, const size_t count)
+        {
+            const size_t slot = static_cast<size_t>(position) & mask_;
+            const size_t first = std::min(count, buffer_.size() - slot);
+            std::memcpy(buffer_.data() + slot, data, first * sizeof(T));
+            std::memcpy(buffer_.data(), data + first, (count - first) * sizeof(T));
+        }
+
+        std::vector<T> buffer_;
+        size_t mask_;
+        alignas(64) std::atomic<uint64_t> writePosition_{0};
+        alignas(64) std::atomic<uint64_t> readPosition_{0};
+    };
+}
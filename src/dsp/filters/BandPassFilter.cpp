@@ -6,6 +6,7 @@
 #include "audio/IAudioSource.h"
 #include <cmath>
 #include <algorithm> // For std::clamp if you want to bound inputs
+#include <limits>
 
 namespace bpmfinder::dsp::filters
 {
@@ -69,6 +70,45 @@ namespace bpmfinder::dsp::filters
         a2_ = a2_raw / a0_raw;
     }
 
+    size_t BandPassFilter::GetSettlingSamples(const float tolerance) const
+    {
+        // The poles are the roots of z^2 + a1*z + a2 = 0, the one with the largest magnitude dominates the decay
+        const double discriminant = static_cast<double>(a1_) * a1_ - 4.0 * a2_;
+        double poleRadius;
+        if (discriminant < 0.0)
+        {
+            // Complex conjugate pair, both have the magnitude sqrt(a2)
+            poleRadius = std::sqrt(static_cast<double>(a2_));
+        }
+        else
+        {
+            // Two real poles (happens for wide bands with Q < 0.5)
+            const double root = std::sqrt(discriminant);
+            poleRadius = std::max(std::abs((-a1_ + root) / 2.0), std::abs((-a1_ - root) / 2.0));
+        }
+
+        if (poleRadius <= 0.0 || tolerance <= 0.0f || tolerance >= 1.0f)
+        {
+            return 0;
+        }
+
+        if (poleRadius >= 1.0)
+        {
+            return std::numeric_limits<size_t>::max(); // Unstable, the state never decays
+        }
+
+        // poleRadius^n <= tolerance  =>  n >= log(tolerance) / log(poleRadius)
+        return static_cast<size_t>(std::ceil(std::log(static_cast<double>(tolerance)) / std::log(poleRadius)));
+    }
+
+    void BandPassFilter::Reset()
+    {
+        x1_ = 0.0f;
+        x2_ = 0.0f;
+        y1_ = 0.0f;
+        y2_ = 0.0f;
+    }
+
     float BandPassFilter::Process(float sample)
     {
         // The Difference Equation:
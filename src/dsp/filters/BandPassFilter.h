@@ -3,10 +3,21 @@
 //
 
 #pragma once
+#include <cstddef>
 #include <vector>
 
 namespace bpmfinder::dsp::filters
 {
+    // Normalized coefficients of the difference equation, see BandPassFilter::Process
+    struct BiquadCoefficients
+    {
+        float b0;
+        float b1;
+        float b2;
+        float a1;
+        float a2;
+    };
+
     class BandPassFilter
     {
     public:
@@ -17,6 +28,15 @@ namespace bpmfinder::dsp::filters
 
         void UpdateParameters(int cutoff_low, int cutoff_high, int sample_rate);
 
+        // Back to silence before the first sample, the coefficients stay
+        void Reset();
+
+        // Number of samples after which the filter has forgotten its initial state, i.e. the slowest decaying pole
+        // has shrunk below the given fraction of its starting value
+        [[nodiscard]] size_t GetSettlingSamples(float tolerance) const;
+
+        [[nodiscard]] BiquadCoefficients GetCoefficients() const { return {b0_, b1_, b2_, a1_, a2_}; }
+
     private:
         void CalculateCoefficients();
 
@@ -0,0 +1,77 @@
+//
+// Created by Robert on 2025-10-27.
+//
+
+#include "SegmentedBandPassFilter.h"
+#include <algorithm>
+#include <thread>
+
+namespace bpmfinder::dsp::filters
+{
+    SegmentedBandPassFilter::SegmentedBandPassFilter(const int cutoff_low, const int cutoff_high,
+                                                     const int sample_rate, const float gain,
+                                                     const size_t segmentCount, const float tolerance) :
+        f1_cutoff_low_(cutoff_low),
+        f2_cutoff_high_(cutoff_high),
+        fs_sample_rate_(sample_rate),
+        g_gain_(gain),
+        segmentCount_(segmentCount > 0 ? segmentCount : std::max(1u, std::thread::hardware_concurrency())),
+        warmUpSamples_(BandPassFilter(cutoff_low, cutoff_high, sample_rate, gain).GetSettlingSamples(tolerance))
+    {
+    }
+
+    std::vector<float> SegmentedBandPassFilter::Process(const std::vector<float>& input) const
+    {
+        std::vector<float> output(input.size());
+
+        // Splitting only pays off if a segment is a lot longer than its warm-up, otherwise most of the work is
+        // spent on samples that are thrown away again
+        const size_t segments = warmUpSamples_ > input.size() / 4
+                                    ? 1
+                                    : std::clamp<size_t>(input.size() / (4 * std::max<size_t>(warmUpSamples_, 1)), 1,
+                                                         segmentCount_);
+
+        if (segments == 1)
+        {
+            ProcessSegment(input, output, 0, input.size());
+            return output;
+        }
+
+        const size_t segmentLength = (input.size() + segments - 1) / segments;
+
+        std::vector<std::thread> workers;
+        workers.reserve(segments);
+        for (size_t begin = 0; begin < input.size(); begin += segmentLength)
+        {
+            const size_t end = std::min(begin + segmentLength, input.size());
+            // Every segment writes a disjoint range of the output, so no synchronization is needed
+            workers.emplace_back(&SegmentedBandPassFilter::ProcessSegment, this, std::cref(input), std::ref(output),
+                                 begin, end);
+        }
+
+        for (auto& worker : workers)
+        {
+            worker.join();
+        }
+
+        return output;
+    }
+
+    void SegmentedBandPassFilter::ProcessSegment(const std::vector<float>& input, std::vector<float>& output,
+                                                 const size_t begin, const size_t end) const
+    {
+        BandPassFilter filter(f1_cutoff_low_, f2_cutoff_high_, fs_sample_rate_, g_gain_);
+
+        // Pre-roll: bring the filter state to (almost) where the serial filter would be at 'begin'.
+        // The first segment starts from silence just like the serial filter, so it needs no warm-up.
+        for (size_t i = begin - std::min(begin, warmUpSamples_); i < begin; ++i)
+        {
+            filter.Process(input[i]);
+        }
+
+        for (size_t i = begin; i < end; ++i)
+        {
+            output[i] = filter.Process(input[i]);
+        }
+    }
+}
@@ -0,0 +1,40 @@
+//
+// Created by Robert on 2025-10-27.
+//
+
+#pragma once
+#include <vector>
+#include "BandPassFilter.h"
+
+namespace bpmfinder::dsp::filters
+{
+    // Offline version of the BandPassFilter for whole recordings that are already in memory.
+    // The IIR filter is inherently serial, so the input is cut into segments that are filtered in parallel. Every
+    // segment starts with a fresh filter that is pre-rolled over the samples right before the segment, until the
+    // impulse response of the missing history has decayed below the tolerance. The warm-up output is thrown away and
+    // only the segment itself is written, so the stitched result matches the serial filter within the tolerance.
+    class SegmentedBandPassFilter
+    {
+    public:
+        // segmentCount = 0 uses one segment per hardware thread
+        SegmentedBandPassFilter(int cutoff_low, int cutoff_high, int sample_rate, float gain = 1.0f,
+                                size_t segmentCount = 0, float tolerance = 1e-7f);
+
+        [[nodiscard]] std::vector<float> Process(const std::vector<float>& input) const;
+
+        // Number of samples each segment is pre-rolled with
+        [[nodiscard]] size_t GetWarmUpSamples() const { return warmUpSamples_; }
+        [[nodiscard]] size_t GetSegmentCount() const { return segmentCount_; }
+
+    private:
+        void ProcessSegment(const std::vector<float>& input, std::vector<float>& output, size_t begin,
+                            size_t end) const;
+
+        int f1_cutoff_low_;
+        int f2_cutoff_high_;
+        int fs_sample_rate_;
+        float g_gain_;
+        size_t segmentCount_;
+        size_t warmUpSamples_;
+    };
+}
@@ -7,6 +7,7 @@
 #include "audio/IAudioSource.h"
 #include "core/CopyStage.h"
 #include "dsp/filters/BandPassFilter.h"
+#include "logging/Log.h"
 #include "logging/LoggerFactory.h"
 
 namespace bpmfinder::dsp::time_domain_onset_detection
@@ -25,10 +26,10 @@ namespace bpmfinder::dsp::time_domain_onset_detection
     protected:
         void Process(TimeDomainOnsetDetectionResult data) override
         {
-            logger_->debug("[BandPassFilterStage] Processing chunk {}/{} with index {}", this->GetProcessedCount(),
-                           this->GetQueuedCount(), data.chunkIndex);
+            BPM_LOG_DEBUG(logger_, "[BandPassFilterStage] Processing chunk {}/{} with index {}",
+                          this->GetProcessedCount(), this->GetQueuedCount(), data.chunkIndex);
 
-            filter_.UpdateParameters(data.bandPassLowCutoff, data.bandPassHighCutoff, data.bandPassGain);
+            filter_.UpdateParameters(data.bandPassLowCutoff, data.bandPassHighCutoff, data.sampleRate);
 
             audio::AudioChunk filteredData;
             filteredData.reserve(data.chunkSize);
@@ -43,6 +44,15 @@ namespace bpmfinder::dsp::time_domain_onset_detection
             this->Notify(data);
         }
 
+        // The next file does not start with the ringing of the last one
+        void OnControl(const core::ControlToken token) override
+        {
+            if (token == core::ControlToken::Reset)
+            {
+                filter_.Reset();
+            }
+        }
+
     private:
         filters::BandPassFilter filter_;
         std::shared_ptr<spdlog::logger> logger_;
@@ -4,8 +4,14 @@
 //
 
 #pragma once
+#include "BpmSnapshot.h"
+#include "TempoEstimation.h"
 #include "core/CopyStage.h"
+#include "core/Seqlock.h"
+#include "logging/Log.h"
 #include "logging/LoggerFactory.h"
+#include <chrono>
+#include <functional>
 #include <vector>
 
 namespace bpmfinder::dsp::time_domain_onset_detection
@@ -19,41 +25,84 @@ namespace bpmfinder::dsp::time_domain_onset_detection
             logger_->info("BpmCalculationStage initialized");
         }
 
+        // Latest estimate, with its confidence and time. Wait-free for the stage, safe to call from any thread.
+        [[nodiscard]] BpmSnapshot GetSnapshot() const { return snapshot_.Load(); }
+
+        // Latest BPM, 0 until the first tempo has been found
+        [[nodiscard]] float GetCurrentBpm() const { return snapshot_.Load().bpm; }
+
+        // Called on the stage thread with every new estimate and after a reset, must not block (see
+        // BpmResultPublisher). Set it before Start.
+        void SetListener(std::function<void(const BpmSnapshot&)> listener) { listener_ = std::move(listener); }
+
     protected:
         void Process(TimeDomainOnsetDetectionResult data) override
         {
-            // 4. Convert interval from "onset buffer indices" to seconds: each index in onsetBuffer represents one chunk
-            const float chunksPerSecond = static_cast<float>(data.sampleRate) / static_cast<float>(data.chunkSize);
-
             if (!data.dominantInterval.has_value())
             {
-                data.bpm = currentBpm_;
-                this->Notify(data);
+                PassOn(data);
                 return;
             }
 
-            // 5. Convert to BPM: BPM = 60 / period_in_seconds
-            if (const float intervalInSeconds = data.dominantInterval.value() / chunksPerSecond; intervalInSeconds >
-                0.0f)
+            // Convert interval from "onset buffer indices" to seconds (each index in onsetBuffer represents one chunk),
+            // then to BPM: BPM = 60 / period_in_seconds
+            // Every result is passed on, subscribers like the feature log see every chunk; only changes are logged
+            if (const float bpm = CalculateBpm(data.dominantInterval.value(), data.sampleRate, data.chunkSize);
+                bpm > 0.0f)
             {
-                float bpm = 60.0f / intervalInSeconds;
-
-                if (bpm == currentBpm_)
+                if (bpm != currentBpm_)
                 {
-                    return;
+                    currentBpm_ = bpm;
+                    BPM_LOG_INFO(logger_, "BPM: {:.1f}", bpm);
                 }
 
-                currentBpm_ = bpm;
-                data.bpm = bpm;
-
-                logger_->warn("BPM: {:.1f}", bpm);
+                BpmSnapshot snapshot;
+                snapshot.bpm = bpm;
+                snapshot.confidence = data.interOnsetIntervals.has_value()
+                                          ? CalculateTempoConfidence(data.interOnsetIntervals.value(),
+                                                                     data.dominantInterval.value())
+                                          : 0.0f;
+                snapshot.chunkIndex = data.chunkIndex;
+                Publish(snapshot);
+            }
+            PassOn(data);
+        }
 
-                this->Notify(data);
+        void OnControl(const core::ControlToken token) override
+        {
+            if (token == core::ControlToken::Reset)
+            {
+                currentBpm_ = 0.0f;
+                Publish(BpmSnapshot{});
             }
         }
 
     private:
-        float currentBpm_ = 0.0f;
+        // With the latest BPM; before the first tempo (and after a reset) bpm stays empty, so the feature log can
+        // tell "no estimate yet" from an estimate
+        void PassOn(TimeDomainOnsetDetectionResult& data)
+        {
+            if (currentBpm_ > 0.0f)
+            {
+                data.bpm = currentBpm_;
+            }
+            this->Notify(data);
+        }
+
+        void Publish(BpmSnapshot snapshot)
+        {
+            snapshot.timestampNanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+            snapshot_.Store(snapshot);
+            if (listener_)
+            {
+                listener_(snapshot);
+            }
+        }
+
+        float currentBpm_ = 0.0f; // Stage thread only, readers use the snapshot
+        core::Seqlock<BpmSnapshot> snapshot_;
+        std::function<void(const BpmSnapshot&)> listener_;
 
         std::shared_ptr<spdlog::logger> logger_;
     };
@@ -0,0 +1,94 @@
+//
+// Created by Robert on 2025-11-16.
+//
+
+#include "BpmResultPublisher.h"
+
+namespace bpmfinder::dsp::time_domain_onset_detection
+{
+    BpmResultPublisher::~BpmResultPublisher()
+    {
+        {
+            std::lock_guard lock(mtx_);
+            running_ = false;
+        }
+        cv_.notify_one();
+        if (thread_.joinable())
+        {
+            thread_.join();
+        }
+    }
+
+    size_t BpmResultPublisher::AddCallback(Callback callback)
+    {
+        size_t id;
+        {
+            std::lock_guard lock(callbacksMtx_);
+            id = nextId_++;
+            callbacks_.emplace_back(id, std::move(callback));
+        }
+
+        std::lock_guard lock(mtx_);
+        if (!running_)
+        {
+            running_ = true;
+            thread_ = std::thread(&BpmResultPublisher::Run, this);
+        }
+        hasCallbacks_.store(true, std::memory_order_release);
+        return id;
+    }
+
+    void BpmResultPublisher::RemoveCallback(const size_t id)
+    {
+        std::lock_guard lock(callbacksMtx_);
+        std::erase_if(callbacks_, [id](const auto& entry) { return entry.first == id; });
+    }
+
+    bool BpmResultPublisher::OpenResultBlock(const std::string& name)
+    {
+        return resultBlock_.Create(name);
+    }
+
+    void BpmResultPublisher::Publish(const BpmSnapshot& snapshot)
+    {
+        resultBlock_.Publish(snapshot);
+        latest_.Store(snapshot);
+
+        if (!hasCallbacks_.load(std::memory_order_acquire))
+        {
+            return;
+        }
+        {
+            std::lock_guard lock(mtx_);
+            pending_ = true;
+        }
+        cv_.notify_one();
+    }
+
+    void BpmResultPublisher::Run()
+    {
+        std::unique_lock lock(mtx_);
+        while (true)
+        {
+            cv_.wait(lock, [this] { return pending_ || !running_; });
+            if (!running_)
+            {
+                break;
+            }
+            pending_ = false;
+            lock.unlock();
+
+            // Estimates that came in meanwhile only set the flag again: the callbacks get the latest one
+            const BpmSnapshot snapshot = latest_.Load();
+            {
+                std::lock_guard callbacksLock(callbacksMtx_);
+                for (const auto& [id, callback] : callbacks_)
+                {
+                    callback(snapshot);
+                }
+            }
+
+            lock.lock();
+        }
+    }
+}
@@ -0,0 +1,70 @@
+//
+// Created by Robert on 2025-11-16.
+//
+
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "BpmSnapshot.h"
+#include "core/Seqlock.h"
+#include "ipc/SharedResultBlock.h"
+
+namespace bpmfinder::dsp::time_domain_onset_detection
+{
+    // Hands the estimates of the BpmCalculationStage to whoever wants them, without ever making the stage wait:
+    // - Callbacks run on a thread of the publisher, woken by every estimate. The latency is one wake-up; a callback
+    //   that takes longer than the time between two estimates gets the latest one next, never a backlog.
+    // - A shared memory result block (ipc/SharedResultBlock.h) that a front end in another process polls.
+    // The pipeline calls Publish from the stage thread, it does not own the publisher.
+    class BpmResultPublisher
+    {
+    public:
+        using Callback = std::function<void(const BpmSnapshot&)>;
+
+        BpmResultPublisher() = default;
+        ~BpmResultPublisher();
+
+        BpmResultPublisher(const BpmResultPublisher&) = delete;
+        BpmResultPublisher& operator=(const BpmResultPublisher&) = delete;
+
+        // The first callback starts the thread. Returns the id for RemoveCallback.
+        size_t AddCallback(Callback callback);
+
+        // Once it returns, the callback does not run anymore. Not from within a callback.
+        void RemoveCallback(size_t id);
+
+        // Creates the shared memory block 'name', see ipc::SharedResultBlockWriter::Create. Call before the analysis
+        // starts.
+        bool OpenResultBlock(const std::string& name);
+
+        // Tells the readers of the block that the analysis has ended
+        void CloseResultBlock() { resultBlock_.Close(); }
+
+        // From one thread at a time: stores the estimate and wakes the callback thread, never waits for it
+        void Publish(const BpmSnapshot& snapshot);
+
+    private:
+        void Run();
+
+        core::Seqlock<BpmSnapshot> latest_;
+        ipc::SharedResultBlockWriter resultBlock_;
+
+        // Held by Publish only to set the flag, never while a callback runs
+        std::mutex mtx_;
+        std::condition_variable cv_;
+        bool pending_ = false;
+        bool running_ = false;
+        std::thread thread_;
+        std::atomic<bool> hasCallbacks_{false};
+
+        std::mutex callbacksMtx_; // Held while the callbacks run
+        std::vector<std::pair<size_t, Callback>> callbacks_;
+        size_t nextId_ = 0;
+    };
+}
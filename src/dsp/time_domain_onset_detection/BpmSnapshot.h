@@ -0,0 +1,31 @@
+//
+// Created by Robert on 2025-11-16.
+//
+
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <type_traits>
+
+namespace bpmfinder::dsp::time_domain_onset_detection
+{
+    // The latest tempo estimate. Fixed size fields only: it is also the payload of the shared memory result block
+    // (ipc/SharedResultBlock.h) that other processes read.
+    struct BpmSnapshot
+    {
+        float bpm = 0.0f; // 0 until a tempo has been found, and again after a reset
+        float confidence = 0.0f; // Share of the inter onset intervals that agree with the dominant one, 0..1
+        uint64_t chunkIndex = 0; // Last chunk of the sliding window the estimate is based on
+
+        // When the estimate was made, std::chrono::steady_clock. On Linux that is CLOCK_MONOTONIC, the same clock in
+        // every process, so a reader can tell how old the estimate is.
+        int64_t timestampNanoseconds = 0;
+
+        [[nodiscard]] std::chrono::steady_clock::time_point GetTimestamp() const
+        {
+            return std::chrono::steady_clock::time_point(std::chrono::nanoseconds(timestampNanoseconds));
+        }
+    };
+
+    static_assert(std::is_trivially_copyable_v<BpmSnapshot> && sizeof(BpmSnapshot) == 24);
+}
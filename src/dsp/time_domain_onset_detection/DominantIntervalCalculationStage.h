@@ -4,6 +4,7 @@
 
 #pragma once
 #include <vector>
+#include "TempoEstimation.h"
 #include "core/CopyStage.h"
 #include "logging/LoggerFactory.h"
 #include "spdlog/logger.h"
@@ -26,11 +27,7 @@ namespace bpmfinder::dsp::time_domain_onset_detection
             if (data.interOnsetIntervals.has_value())
             {
                 // Method 1: Use median interval (simple and robust to outliers)
-                std::vector<float> sortedIntervals = data.interOnsetIntervals.value();
-                std::sort(sortedIntervals.begin(), sortedIntervals.end());
-
-                const size_t medianIdx = sortedIntervals.size() / 2;
-                data.dominantInterval = sortedIntervals[medianIdx];
+                data.dominantInterval = CalculateDominantInterval(data.interOnsetIntervals.value());
 
                 // Method 2 (Alternative): Use autocorrelation to find periodicity
                 // This is more sophisticated but also more computationally expensive
@@ -5,6 +5,7 @@
 #pragma once
 #include "audio/IAudioSource.h"
 #include "core/CopyStage.h"
+#include "logging/Log.h"
 
 namespace bpmfinder::dsp::time_domain_onset_detection
 {
@@ -12,6 +13,9 @@ namespace bpmfinder::dsp::time_domain_onset_detection
             TimeDomainOnsetDetectionResult, TimeDomainOnsetDetectionResult>
     {
     public:
+        // The energy of a chunk only depends on the chunk itself
+        static constexpr bool IsStateless = true;
+
         explicit EnergyCalculationStage() : logger_(logging::LoggerFactory::GetLogger("EnergyCalculationStage"))
         {
         }
@@ -19,8 +23,8 @@ namespace bpmfinder::dsp::time_domain_onset_detection
     protected:
         void Process(TimeDomainOnsetDetectionResult data) override
         {
-            logger_->debug("[EnergyCalculationStage] Processing chunk {}/{} with index {}", this->GetProcessedCount(),
-                           this->GetQueuedCount(), data.chunkIndex);
+            BPM_LOG_DEBUG(logger_, "[EnergyCalculationStage] Processing chunk {}/{} with index {}",
+                          this->GetProcessedCount(), this->GetQueuedCount(), data.chunkIndex);
 
             // Calculate energy: E = sum(s[n]^2) for n=0 to N-1
             float energy = 0.0f;
@@ -4,6 +4,7 @@
 
 #pragma once
 #include <vector>
+#include "TempoEstimation.h"
 #include "core/CopyStage.h"
 #include "logging/LoggerFactory.h"
 #include "spdlog/logger.h"
@@ -27,16 +28,7 @@ namespace bpmfinder::dsp::time_domain_onset_detection
             if (data.peakIndices.has_value() && data.peakIndices.value().size() > 2)
             {
                 // Calculate inter-onset intervals (IOI) in samples
-                std::vector<float> intervals;
-                intervals.reserve(data.peakIndices.value().size() - 1);
-
-                for (size_t i = 1; i < data.peakIndices.value().size(); ++i)
-                {
-                    float interval = static_cast<float>(data.peakIndices.value()[i] - data.peakIndices.value()[i - 1]);
-                    intervals.push_back(interval);
-                }
-
-                data.interOnsetIntervals = intervals;
+                data.interOnsetIntervals = CalculateInterOnsetIntervals(data.peakIndices.value());
             }
 
             this->Notify(data);
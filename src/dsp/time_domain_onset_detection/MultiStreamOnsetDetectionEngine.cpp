@@ -0,0 +1,192 @@
+//
+// Created by Robert on 2025-10-28.
+//
+
+#include "MultiStreamOnsetDetectionEngine.h"
+#include <algorithm>
+#include "OnsetKernels.h"
+#include "TempoEstimation.h"
+
+namespace bpmfinder::dsp::time_domain_onset_detection
+{
+    namespace
+    {
+        // The tempo estimation lanes, the upstream ones are shared with the onset series (OnsetKernels.h)
+        void MaxKernel(const float* __restrict row, float* __restrict maximum, const size_t lanes)
+        {
+            for (size_t s = 0; s < lanes; ++s)
+            {
+                maximum[s] = row[s] > maximum[s] ? row[s] : maximum[s];
+            }
+        }
+
+        void PeakMaskKernel(const float* __restrict previous, const float* __restrict current,
+                            const float* __restrict next, const float* __restrict threshold,
+                            uint8_t* __restrict mask, const size_t lanes)
+        {
+            for (size_t s = 0; s < lanes; ++s)
+            {
+                mask[s] = static_cast<uint8_t>((current[s] > threshold[s]) & (current[s] > previous[s]) &
+                    (current[s] > next[s]));
+            }
+        }
+    }
+
+    MultiStreamOnsetDetectionEngine::MultiStreamOnsetDetectionEngine(std::vector<int> streamIds,
+                                                                     const TimeDomainOnsetDetectionConfig& config)
+        : config_(config),
+          streamIds_(std::move(streamIds)),
+          streamCount_(streamIds_.size()),
+          x1_(streamCount_, 0.0f),
+          x2_(streamCount_, 0.0f),
+          y1_(streamCount_, 0.0f),
+          y2_(streamCount_, 0.0f),
+          energy_(streamCount_, 0.0f),
+          previousEnergy_(streamCount_, 0.0f),
+          onsetStrength_(streamCount_, 0.0f),
+          currentBpm_(streamCount_, 0.0f),
+          onsetBufferSize_(CalculateOnsetBufferSize(config.sampleRate, config.chunkSize,
+                                                    config.slidingWindowSizeSeconds)),
+          onsetRing_(onsetBufferSize_ * streamCount_, 0.0f),
+          windowMax_(streamCount_),
+          peakMask_(streamCount_),
+          lastPeak_(streamCount_),
+          peakCount_(streamCount_),
+          intervals_(onsetBufferSize_ * streamCount_)
+    {
+        // Take the coefficients from the real filter, so every lane computes exactly what the BandPassFilterStage does
+        coefficients_ = filters::BandPassFilter(config.bandPassLowCutoff, config.bandPassHighCutoff,
+                                                config.sampleRate, config.bandPassGain).GetCoefficients();
+    }
+
+    void MultiStreamOnsetDetectionEngine::ProcessChunk(const float* frames)
+    {
+        FilterAndAccumulateEnergy(frames);
+        DetectOnsets();
+        PushOnsets();
+        EstimateTempo();
+        ++processedChunks_;
+    }
+
+    std::vector<StreamBpm> MultiStreamOnsetDetectionEngine::GetResults() const
+    {
+        std::vector<StreamBpm> results;
+        results.reserve(streamCount_);
+        for (size_t s = 0; s < streamCount_; ++s)
+        {
+            results.push_back({streamIds_[s], currentBpm_[s]});
+        }
+        return results;
+    }
+
+    void MultiStreamOnsetDetectionEngine::FilterAndAccumulateEnergy(const float* frames)
+    {
+        std::fill(energy_.begin(), energy_.end(), 0.0f);
+
+        // The filtered signal is never stored, every frame goes straight into the energy accumulators
+        for (int n = 0; n < config_.chunkSize; ++n)
+        {
+            BiquadEnergyKernel(frames + static_cast<size_t>(n) * streamCount_, x1_.data(), x2_.data(), y1_.data(),
+                               y2_.data(), energy_.data(), streamCount_, coefficients_);
+        }
+    }
+
+    void MultiStreamOnsetDetectionEngine::DetectOnsets()
+    {
+        OnsetKernel(energy_.data(), previousEnergy_.data(), onsetStrength_.data(), streamCount_);
+    }
+
+    void MultiStreamOnsetDetectionEngine::PushOnsets()
+    {
+        if (onsetBufferSize_ == 0)
+        {
+            return;
+        }
+
+        // Fill the ring first, then overwrite the oldest row
+        size_t row;
+        if (ringCount_ < onsetBufferSize_)
+        {
+            row = (ringHead_ + ringCount_) % onsetBufferSize_;
+            ++ringCount_;
+        }
+        else
+        {
+            row = ringHead_;
+            ringHead_ = (ringHead_ + 1) % onsetBufferSize_;
+        }
+
+        std::copy(onsetStrength_.begin(), onsetStrength_.end(), onsetRing_.begin() + row * streamCount_);
+    }
+
+    void MultiStreamOnsetDetectionEngine::EstimateTempo()
+    {
+        // Same as PeakIndexDetectionStage: only estimate once the sliding window is full
+        if (ringCount_ < onsetBufferSize_ || onsetBufferSize_ < 3)
+        {
+            return;
+        }
+
+        const auto rowAt = [this](const size_t logicalIndex)
+        {
+            return onsetRing_.data() + ((ringHead_ + logicalIndex) % onsetBufferSize_) * streamCount_;
+        };
+
+        // 1. Threshold per lane: peakThreshold * max over the window
+        float* threshold = windowMax_.data();
+        std::copy_n(rowAt(0), streamCount_, threshold);
+        for (size_t j = 1; j < onsetBufferSize_; ++j)
+        {
+            MaxKernel(rowAt(j), threshold, streamCount_);
+        }
+        for (size_t s = 0; s < streamCount_; ++s)
+        {
+            threshold[s] *= config_.peakThreshold;
+        }
+
+        // 2. Peaks: local maxima above the threshold. The comparisons run over all lanes at once, only the (rare)
+        // peaks are then booked per stream as intervals to the previous peak.
+        std::fill(lastPeak_.begin(), lastPeak_.end(), -1);
+        std::fill(peakCount_.begin(), peakCount_.end(), 0);
+        const uint8_t* mask = peakMask_.data();
+
+        for (size_t j = 1; j + 1 < onsetBufferSize_; ++j)
+        {
+            PeakMaskKernel(rowAt(j - 1), rowAt(j), rowAt(j + 1), threshold, peakMask_.data(), streamCount_);
+
+            for (size_t s = 0; s < streamCount_; ++s)
+            {
+                if (!mask[s])
+                {
+                    continue;
+                }
+
+                if (peakCount_[s] > 0)
+                {
+                    intervals_[s * onsetBufferSize_ + peakCount_[s] - 1] = static_cast<float>(
+                        static_cast<int64_t>(j) - lastPeak_[s]);
+                }
+                lastPeak_[s] = static_cast<int64_t>(j);
+                ++peakCount_[s];
+            }
+        }
+
+        // 3. Dominant interval and BPM per stream. Like the InterOnsetIntervalCalculationStage, intervals are only
+        // trusted with more than 2 peaks
+        for (size_t s = 0; s < streamCount_; ++s)
+        {
+            if (peakCount_[s] <= 2)
+            {
+                continue;
+            }
+
+            // The median reorders the stream's slice of the scratch buffer, step 2 rewrites it on the next chunk
+            float* first = intervals_.data() + s * onsetBufferSize_;
+            if (const float bpm = CalculateBpm(CalculateDominantInterval(first, first + peakCount_[s] - 1),
+                                               config_.sampleRate, config_.chunkSize); bpm > 0.0f)
+            {
+                currentBpm_[s] = bpm;
+            }
+        }
+    }
+}
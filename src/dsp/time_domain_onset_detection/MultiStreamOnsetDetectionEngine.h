@@ -0,0 +1,83 @@
+//
+// Created by Robert on 2025-10-28.
+//
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "TimeDomainOnsetDetectionConfig.h"
+#include "dsp/filters/BandPassFilter.h"
+
+namespace bpmfinder::dsp::time_domain_onset_detection
+{
+    struct StreamBpm
+    {
+        int streamId;
+        float bpm; // 0 until the first tempo has been found
+    };
+
+    // Runs the time domain onset detection for many streams at once on the calling thread.
+    // Instead of one pipeline (one thread per stage, one queue per stage) per stream, all per stream state is laid out
+    // as structure-of-arrays with one lane per stream: filter history, energy accumulators, previous energies and the
+    // onset ring buffer. The hot loops iterate over the streams in the innermost loop, so the compiler processes as
+    // many streams per SIMD instruction as the target allows.
+    // All streams share one configuration (sample rate, chunk size, cutoffs, window, threshold), because the filter
+    // coefficients have to be the same in every lane.
+    // Results match a TimeDomainOnsetDetectionDspPipeline per stream.
+    class MultiStreamOnsetDetectionEngine
+    {
+    public:
+        MultiStreamOnsetDetectionEngine(std::vector<int> streamIds, const TimeDomainOnsetDetectionConfig& config);
+
+        // Processes one chunk of every stream. 'frames' holds chunkSize frames with one sample per stream each,
+        // frame-major: frames[n * streamCount + streamIndex]
+        void ProcessChunk(const float* frames);
+
+        [[nodiscard]] size_t GetStreamCount() const { return streamIds_.size(); }
+        [[nodiscard]] size_t GetProcessedChunkCount() const { return processedChunks_; }
+
+        // Results of the last processed chunk, by stream index
+        [[nodiscard]] float GetEnergy(size_t streamIndex) const { return energy_[streamIndex]; }
+        [[nodiscard]] float GetOnsetStrength(size_t streamIndex) const { return onsetStrength_[streamIndex]; }
+        [[nodiscard]] float GetBpm(size_t streamIndex) const { return currentBpm_[streamIndex]; }
+
+        // Current BPM of every stream, by stream id
+        [[nodiscard]] std::vector<StreamBpm> GetResults() const;
+
+    private:
+        void FilterAndAccumulateEnergy(const float* frames);
+        void DetectOnsets();
+        void PushOnsets();
+        void EstimateTempo();
+
+        TimeDomainOnsetDetectionConfig config_;
+        std::vector<int> streamIds_;
+        size_t streamCount_;
+
+        // Band pass coefficients, shared by all lanes
+        filters::BiquadCoefficients coefficients_{};
+
+        // Per stream lanes
+        std::vector<float> x1_, x2_, y1_, y2_; // Filter history
+        std::vector<float> energy_;
+        std::vector<float> previousEnergy_;
+        std::vector<float> onsetStrength_;
+        std::vector<float> currentBpm_;
+
+        // Sliding window of onset values: a ring of onsetBufferSize_ rows, one lane per stream in every row
+        size_t onsetBufferSize_;
+        std::vector<float> onsetRing_;
+        size_t ringHead_ = 0; // Row of the oldest value
+        size_t ringCount_ = 0;
+
+        // Scratch buffers for the tempo estimation, allocated once
+        std::vector<float> windowMax_;
+        std::vector<uint8_t> peakMask_;
+        std::vector<int64_t> lastPeak_;
+        std::vector<uint32_t> peakCount_;
+        std::vector<float> intervals_; // onsetBufferSize_ slots per stream
+
+        size_t processedChunks_ = 0;
+    };
+}
@@ -4,6 +4,7 @@
 
 #pragma once
 #include "core/CopyStage.h"
+#include "logging/Log.h"
 #include <iostream>
 #include <algorithm>
 
@@ -20,8 +21,8 @@ namespace bpmfinder::dsp::time_domain_onset_detection
     protected:
         void Process(TimeDomainOnsetDetectionResult data) override
         {
-            logger_->debug("[OnsetDetectionStage] Processing chunk {}/{} with index {}", this->GetProcessedCount(),
-                           this->GetQueuedCount(), data.chunkIndex);
+            BPM_LOG_DEBUG(logger_, "[OnsetDetectionStage] Processing chunk {}/{} with index {}",
+                          this->GetProcessedCount(), this->GetQueuedCount(), data.chunkIndex);
 
             // Calculate onset strength signal (OSS)
             // OSS[k] = max(0, E_current - E_previous)
@@ -35,6 +36,14 @@ namespace bpmfinder::dsp::time_domain_onset_detection
             this->Notify(data);
         }
 
+        void OnControl(const core::ControlToken token) override
+        {
+            if (token == core::ControlToken::Reset)
+            {
+                previousEnergy_ = 0.0f;
+            }
+        }
+
     private:
         float previousEnergy_;
         std::shared_ptr<spdlog::logger> logger_;
@@ -0,0 +1,45 @@
+//
+// Created by Robert on 2025-11-16.
+//
+
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include "dsp/filters/BandPassFilter.h"
+
+namespace bpmfinder::dsp::time_domain_onset_detection
+{
+    // The upstream math of the onset detection (band pass filter -> energy -> onset strength) on lanes of independent
+    // streams, shared by the MultiStreamOnsetDetectionEngine and the offline onset series. The kernels take restrict
+    // pointers as parameters: that is what tells the compiler the lanes do not alias, which allows it to process as
+    // many streams per instruction as the SIMD width allows. A single stream is one lane.
+
+    // Band pass filter and energy fused for one frame of all lanes, same operation order as
+    // BandPassFilter::Process and EnergyCalculationStage
+    inline void BiquadEnergyKernel(const float* __restrict input, float* __restrict x1, float* __restrict x2,
+                                   float* __restrict y1, float* __restrict y2, float* __restrict energy,
+                                   const size_t lanes, const filters::BiquadCoefficients c)
+    {
+        for (size_t s = 0; s < lanes; ++s)
+        {
+            const float x = input[s];
+            const float y = c.b0 * x + c.b1 * x1[s] + c.b2 * x2[s] - c.a1 * y1[s] - c.a2 * y2[s];
+            x2[s] = x1[s];
+            x1[s] = x;
+            y2[s] = y1[s];
+            y1[s] = y;
+            energy[s] += y * y;
+        }
+    }
+
+    // OSS[k] = max(0, E_current - E_previous)
+    inline void OnsetKernel(const float* __restrict energy, float* __restrict previousEnergy,
+                            float* __restrict onsetStrength, const size_t lanes)
+    {
+        for (size_t s = 0; s < lanes; ++s)
+        {
+            onsetStrength[s] = std::max(0.0f, energy[s] - previousEnergy[s]);
+            previousEnergy[s] = energy[s];
+        }
+    }
+}
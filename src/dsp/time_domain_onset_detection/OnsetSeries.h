@@ -0,0 +1,53 @@
+//
+// Created by Robert on 2025-10-31.
+//
+
+#pragma once
+#include <vector>
+#include "OnsetKernels.h"
+#include "TimeDomainOnsetDetectionConfig.h"
+#include "dsp/filters/BandPassFilter.h"
+
+namespace bpmfinder::dsp::time_domain_onset_detection
+{
+    // Output of the upstream stages for a whole recording, one value per chunk
+    struct OnsetSeries
+    {
+        std::vector<float> energy;
+        std::vector<float> onsetStrength;
+    };
+
+    // Band pass filter -> energy -> onset detection over a complete mono recording, with the kernels of the
+    // MultiStreamOnsetDetectionEngine on a single lane, so it computes the same values as the stages. Only the
+    // upstream parameters of the config are used (sample rate, chunk size, cutoffs, gain), the tempo estimation on top
+    // is EstimateTempoFromOnsetSeries. Like the live pipeline only full chunks are used.
+    inline OnsetSeries CalculateOnsetSeries(const float* samples, const size_t sampleCount,
+                                            const TimeDomainOnsetDetectionConfig& config)
+    {
+        const auto coefficients = filters::BandPassFilter(config.bandPassLowCutoff, config.bandPassHighCutoff,
+                                                          config.sampleRate, config.bandPassGain).GetCoefficients();
+        const auto chunkSize = static_cast<size_t>(config.chunkSize);
+
+        OnsetSeries series;
+        series.energy.reserve(sampleCount / chunkSize);
+        series.onsetStrength.reserve(sampleCount / chunkSize);
+
+        float x1 = 0.0f, x2 = 0.0f, y1 = 0.0f, y2 = 0.0f;
+        float previousEnergy = 0.0f;
+        for (size_t offset = 0; offset + chunkSize <= sampleCount; offset += chunkSize)
+        {
+            float energy = 0.0f;
+            for (size_t n = offset; n < offset + chunkSize; ++n)
+            {
+                BiquadEnergyKernel(samples + n, &x1, &x2, &y1, &y2, &energy, 1, coefficients);
+            }
+
+            float onsetStrength;
+            OnsetKernel(&energy, &previousEnergy, &onsetStrength, 1);
+            series.energy.push_back(energy);
+            series.onsetStrength.push_back(onsetStrength);
+        }
+
+        return series;
+    }
+}
@@ -4,6 +4,7 @@
 
 #pragma once
 #include <vector>
+#include "TempoEstimation.h"
 #include "core/CopyStage.h"
 #include "logging/LoggerFactory.h"
 #include "spdlog/logger.h"
@@ -31,8 +32,7 @@ namespace bpmfinder::dsp::time_domain_onset_detection
             // Calculate how many onset values we need to buffer
             // Each chunk produces one onset value
             // Chunks per second = sampleRate / chunkSize
-            const float chunksPerSecond = static_cast<float>(data.sampleRate) / static_cast<float>(data.chunkSize);
-            maxBufferSize_ = static_cast<size_t>(chunksPerSecond * slidingWindowSizeSeconds_);
+            maxBufferSize_ = CalculateOnsetBufferSize(data.sampleRate, data.chunkSize, slidingWindowSizeSeconds_);
 
             // Add onset strength to buffer
             onsetBuffer_.push_back(data.onsetStrength);
@@ -46,22 +46,8 @@ namespace bpmfinder::dsp::time_domain_onset_detection
             // Only calculate Peaks once we have enough data
             if (onsetBuffer_.size() >= maxBufferSize_)
             {
-                std::vector<size_t> peaks;
-
-                // Calculate dynamic threshold based on buffer statistics
-                const float maxValue = *std::max_element(onsetBuffer_.begin(), onsetBuffer_.end());
-                const float threshold = maxValue * peakThreshold_;
-
-                // Simple peak detection: local maximum that exceeds threshold
-                for (size_t i = 1; i < onsetBuffer_.size() - 1; ++i)
-                {
-                    if (onsetBuffer_[i] > threshold &&
-                        onsetBuffer_[i] > onsetBuffer_[i - 1] &&
-                        onsetBuffer_[i] > onsetBuffer_[i + 1])
-                    {
-                        peaks.push_back(i);
-                    }
-                }
+                // Local maxima that exceed a threshold relative to the buffer maximum
+                std::vector<size_t> peaks = DetectPeakIndices(onsetBuffer_, peakThreshold_);
 
                 // Further processing only makes sense for 2 or more peaks
                 if (peaks.size() >= 2)
@@ -73,6 +59,15 @@ namespace bpmfinder::dsp::time_domain_onset_detection
             this->Notify(data);
         }
 
+        // The sliding window starts empty again, no peaks until it is full
+        void OnControl(const core::ControlToken token) override
+        {
+            if (token == core::ControlToken::Reset)
+            {
+                onsetBuffer_.clear();
+            }
+        }
+
     private:
         int slidingWindowSizeSeconds_;
         float peakThreshold_;
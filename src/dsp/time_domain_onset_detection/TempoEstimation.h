@@ -0,0 +1,143 @@
+//
+// Created by Robert on 2025-10-28.
+//
+
+#pragma once
+#include <algorithm>
+#include <vector>
+#include "TimeDomainOnsetDetectionConfig.h"
+
+namespace bpmfinder::dsp::time_domain_onset_detection
+{
+    // The algorithms of the tempo estimation stages (peak detection -> inter onset intervals -> dominant interval ->
+    // bpm) as plain functions, so that the stages and the engines that do not run one stage per thread compute
+    // exactly the same thing.
+
+    // Each chunk produces one onset value, so the onset signal runs at sampleRate / chunkSize values per second
+    inline float CalculateChunksPerSecond(const int sampleRate, const int chunkSize)
+    {
+        return static_cast<float>(sampleRate) / static_cast<float>(chunkSize);
+    }
+
+    // Number of onset values that cover the sliding window
+    inline size_t CalculateOnsetBufferSize(const int sampleRate, const int chunkSize,
+                                           const int slidingWindowSizeSeconds)
+    {
+        return static_cast<size_t>(CalculateChunksPerSecond(sampleRate, chunkSize) * slidingWindowSizeSeconds);
+    }
+
+    // Local maxima that exceed peakThreshold * max(onsetBuffer)
+    inline std::vector<size_t> DetectPeakIndices(const std::vector<float>& onsetBuffer, const float peakThreshold)
+    {
+        std::vector<size_t> peaks;
+        if (onsetBuffer.size() < 3)
+        {
+            return peaks;
+        }
+
+        // Calculate dynamic threshold based on buffer statistics
+        const float maxValue = *std::max_element(onsetBuffer.begin(), onsetBuffer.end());
+        const float threshold = maxValue * peakThreshold;
+
+        // Simple peak detection: local maximum that exceeds threshold
+        for (size_t i = 1; i < onsetBuffer.size() - 1; ++i)
+        {
+            if (onsetBuffer[i] > threshold &&
+                onsetBuffer[i] > onsetBuffer[i - 1] &&
+                onsetBuffer[i] > onsetBuffer[i + 1])
+            {
+                peaks.push_back(i);
+            }
+        }
+
+        return peaks;
+    }
+
+    // Distances between consecutive peaks, in onset buffer indices
+    inline std::vector<float> CalculateInterOnsetIntervals(const std::vector<size_t>& peakIndices)
+    {
+        std::vector<float> intervals;
+        if (peakIndices.size() < 2)
+        {
+            return intervals;
+        }
+
+        intervals.reserve(peakIndices.size() - 1);
+        for (size_t i = 1; i < peakIndices.size(); ++i)
+        {
+            intervals.push_back(static_cast<float>(peakIndices[i] - peakIndices[i - 1]));
+        }
+
+        return intervals;
+    }
+
+    // Median interval (simple and robust to missed or spurious peaks) of [first, last), which must not be empty.
+    // Reorders the range instead of copying it, for callers that compute the intervals into a scratch buffer.
+    inline float CalculateDominantInterval(float* first, float* last)
+    {
+        float* median = first + (last - first) / 2;
+        std::nth_element(first, median, last);
+        return *median;
+    }
+
+    inline float CalculateDominantInterval(std::vector<float> intervals)
+    {
+        return CalculateDominantInterval(intervals.data(), intervals.data() + intervals.size());
+    }
+
+    // Share of the intervals within one onset value of the dominant one: 1 for a steady beat, low when the peaks are
+    // spread over several tempi or mostly noise
+    inline float CalculateTempoConfidence(const std::vector<float>& intervals, const float dominantInterval)
+    {
+        if (intervals.empty())
+        {
+            return 0.0f;
+        }
+
+        const auto agreeing = std::count_if(intervals.begin(), intervals.end(), [dominantInterval](const float interval)
+        {
+            return interval >= dominantInterval - 1.0f && interval <= dominantInterval + 1.0f;
+        });
+        return static_cast<float>(agreeing) / static_cast<float>(intervals.size());
+    }
+
+    // BPM = 60 / period_in_seconds, returns 0 for intervals that do not describe a period
+    inline float CalculateBpm(const float dominantInterval, const int sampleRate, const int chunkSize)
+    {
+        const float intervalInSeconds = dominantInterval / CalculateChunksPerSecond(sampleRate, chunkSize);
+        return intervalInSeconds > 0.0f ? 60.0f / intervalInSeconds : 0.0f;
+    }
+
+    // Replays the tempo estimation over a complete onset strength series (one value per chunk) and returns the BPM the
+    // pipeline reports after the last chunk, 0 if no tempo was found. Only the downstream parameters of the config are
+    // used (sample rate, chunk size, window and threshold), the onset series already contains everything upstream.
+    inline float EstimateTempoFromOnsetSeries(const std::vector<float>& onsetStrength,
+                                              const TimeDomainOnsetDetectionConfig& config)
+    {
+        const size_t bufferSize = CalculateOnsetBufferSize(config.sampleRate, config.chunkSize,
+                                                           config.slidingWindowSizeSeconds);
+        float bpm = 0.0f;
+        if (bufferSize == 0)
+        {
+            return bpm;
+        }
+
+        // Same as the stages: estimate on every chunk once the sliding window is full, with more than 2 peaks
+        for (size_t end = bufferSize; end <= onsetStrength.size(); ++end)
+        {
+            const std::vector<float> window(onsetStrength.begin() + static_cast<std::ptrdiff_t>(end - bufferSize),
+                                            onsetStrength.begin() + static_cast<std::ptrdiff_t>(end));
+
+            if (const auto peaks = DetectPeakIndices(window, config.peakThreshold); peaks.size() > 2)
+            {
+                const float interval = CalculateDominantInterval(CalculateInterOnsetIntervals(peaks));
+                if (const float newBpm = CalculateBpm(interval, config.sampleRate, config.chunkSize); newBpm > 0.0f)
+                {
+                    bpm = newBpm;
+                }
+            }
+        }
+
+        return bpm;
+    }
+}
@@ -0,0 +1,31 @@
+//
+// Created by Robert on 2025-10-28.
+//
+
+#pragma once
+
+namespace bpmfinder::dsp::time_domain_onset_detection
+{
+    // All parameters of the time domain onset detection, with the defaults the app runs with
+    struct TimeDomainOnsetDetectionConfig
+    {
+        int sampleRate = 48000;
+        int chunkSize = 1024;
+
+        // Multi-channel sources: -1 mixes all channels down to mono, otherwise only this channel is analyzed
+        int inputChannel = -1;
+
+        // Band pass filter
+        int bandPassLowCutoff = 40;
+        int bandPassHighCutoff = 800;
+        float bandPassGain = 1.0f;
+
+        // Peak index detection
+        int slidingWindowSizeSeconds = 15;
+        float peakThreshold = 0.6f;
+
+        // Replicas of the energy calculation (a stateless stage) that run in parallel, each on its own thread, behind
+        // a core::ParallelCopyStage. 1 runs the plain stage.
+        int energyCalculationReplicas = 1;
+    };
+}
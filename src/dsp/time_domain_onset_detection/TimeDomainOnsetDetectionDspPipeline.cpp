@@ -3,41 +3,148 @@
 //
 
 #include "TimeDomainOnsetDetectionDspPipeline.h"
+#include <algorithm>
+#include <filesystem>
 #include <iostream>
-#include "audio/WasapiAudioSource.h"
+#include <thread>
 
 namespace bpmfinder::dsp::time_domain_onset_detection
 {
+    namespace
+    {
+        // The sink sits behind the downmix, it always records mono
+        std::unique_ptr<files::bin::BinFileSink<audio::AudioChunk>> CreateSink(const std::string& filename,
+                                                                               const int sampleRate)
+        {
+            if (filename.empty())
+            {
+                return nullptr;
+            }
+            if (std::filesystem::path(filename).extension() == ".bpmr")
+            {
+                files::recording::RecordingOptions options;
+                options.sampleRate = static_cast<uint32_t>(sampleRate);
+                options.channels = 1;
+                return std::make_unique<files::bin::RecordingFileSink>(filename, options);
+            }
+            return std::make_unique<files::bin::AudioBinFileSink>(filename);
+        }
+    }
+
     TimeDomainOnsetDetectionDspPipeline::TimeDomainOnsetDetectionDspPipeline(
-        const int chunkSize, const int sampleRate, const int bandPassLowCutoff,
-        const int bandPassHighCutoff, const float bandPassGain)
+        audio::IAudioSource& source, const TimeDomainOnsetDetectionConfig& config, const size_t queueCapacity,
+        const std::string& recordingFilename, const std::string& featureLogFilename,
+        files::recording::FlightRecorder* flightRecorder, BpmResultPublisher* publisher)
         :
-        chunkSize(chunkSize),
-        sampleRate(sampleRate),
-        bandPassLowCutoff(bandPassLowCutoff),
-        bandPassHighCutoff(bandPassHighCutoff),
-        bandPassGain(bandPassGain),
-        source(chunkSize),
-        initializationStage(sampleRate, chunkSize, bandPassLowCutoff, bandPassHighCutoff, bandPassGain),
-        bandPassFilterStage(bandPassLowCutoff, bandPassHighCutoff, bandPassGain, sampleRate),
-        sink("waveform.bin"),
+        config(config),
+        source(source),
+        initializationStage(config.sampleRate, config.chunkSize, config.bandPassLowCutoff, config.bandPassHighCutoff,
+                            config.bandPassGain),
+        bandPassFilterStage(config.bandPassLowCutoff, config.bandPassHighCutoff, config.bandPassGain,
+                            config.sampleRate),
+        parallelEnergyCalculationStage(config.energyCalculationReplicas > 1
+                                           ? std::make_unique<core::ParallelCopyStage<EnergyCalculationStage>>(
+                                               static_cast<size_t>(config.energyCalculationReplicas))
+                                           : nullptr),
+        peakIndexDetectionStage(config.slidingWindowSizeSeconds, config.peakThreshold),
+        sink(CreateSink(recordingFilename, config.sampleRate)),
+        featureLog(featureLogFilename.empty()
+                       ? nullptr
+                       : std::make_unique<files::bin::FeatureLogFileSink>(
+                           featureLogFilename, files::features::FeatureLogOptions{
+                               static_cast<uint32_t>(config.sampleRate), static_cast<uint32_t>(config.chunkSize)
+                           })),
+        flightRecorderAudio(flightRecorder ? std::make_unique<files::recording::FlightRecorderAudioSink>(*flightRecorder)
+                                           : nullptr),
+        flightRecorderFeatures(flightRecorder
+                                   ? std::make_unique<files::recording::FlightRecorderFeatureSink>(*flightRecorder)
+                                   : nullptr),
         logger_(logging::LoggerFactory::GetLogger("TimeDomainOnsetDetectionDspPipeline"))
     {
         // In the ctor we only assemble the dsp chain, start reading audio data and processing it via Start()
+        if (publisher)
+        {
+            bpmCalculationStage.SetListener([publisher](const BpmSnapshot& snapshot) { publisher->Publish(snapshot); });
+        }
+
         if (!source.Initialize())
         {
-            logger_->error("Failed to init WASAPI source");
+            logger_->error("Failed to initialize audio source");
             return;
         }
+        initialized_ = true;
 
-        source.Subscribe(&sink); // Write raw input data to file
-        source.Subscribe(&initializationStage); // Pass raw input data to initialization stage
+        // Multi-channel sources send interleaved frames, everything after the downmix stage works on mono
+        if (const int channels = source.GetChannelCount(); channels > 1)
+        {
+            downmixStage = std::make_unique<audio::DownmixStage>(channels, config.inputChannel);
+            source.Subscribe(downmixStage.get());
+        }
+        core::CopyObservable<audio::AudioChunk>& input = downmixStage
+                                                            ? static_cast<core::CopyObservable<audio::AudioChunk>&>(
+                                                                *downmixStage)
+                                                            : source;
 
-        initializationStage.Subscribe(&bandPassFilterStage); // Pass raw input data to bandpass filter stage
+        if (queueCapacity > 0)
+        {
+            if (downmixStage)
+            {
+                downmixStage->SetCapacity(queueCapacity);
+            }
+            initializationStage.SetCapacity(queueCapacity);
+            bandPassFilterStage.SetCapacity(queueCapacity);
+            if (parallelEnergyCalculationStage)
+            {
+                parallelEnergyCalculationStage->SetCapacity(queueCapacity);
+            }
+            else
+            {
+                energyCalculationStage.SetCapacity(queueCapacity);
+            }
+            onsetDetectionStage.SetCapacity(queueCapacity);
+            peakIndexDetectionStage.SetCapacity(queueCapacity);
+            interOnsetIntervalCalculationStage.SetCapacity(queueCapacity);
+            dominantIntervalCalculationStage.SetCapacity(queueCapacity);
+            bpmCalculationStage.SetCapacity(queueCapacity);
+            if (sink)
+            {
+                sink->SetCapacity(queueCapacity);
+            }
+            if (featureLog)
+            {
+                featureLog->SetCapacity(queueCapacity);
+            }
+            if (flightRecorderAudio)
+            {
+                flightRecorderAudio->SetCapacity(queueCapacity);
+                flightRecorderFeatures->SetCapacity(queueCapacity);
+            }
+        }
 
-        bandPassFilterStage.Subscribe(&energyCalculationStage); // Pass bandpass filtered data to energy calc stage
+        if (sink)
+        {
+            input.Subscribe(sink.get()); // Write raw input data to file
+        }
+        if (flightRecorderAudio)
+        {
+            input.Subscribe(flightRecorderAudio.get()); // Keep the last minutes of input
+        }
+        input.Subscribe(&initializationStage); // Pass raw input data to initialization stage
 
-        energyCalculationStage.Subscribe(&onsetDetectionStage); // Pass energy data to onset detection stage
+        initializationStage.Subscribe(&bandPassFilterStage); // Pass raw input data to bandpass filter stage
+
+        // Pass bandpass filtered data to energy calc stage, and energy data to onset detection stage. The replicas
+        // emit in chunk order again, the onset detection sees the same sequence either way.
+        if (parallelEnergyCalculationStage)
+        {
+            bandPassFilterStage.Subscribe(parallelEnergyCalculationStage.get());
+            parallelEnergyCalculationStage->Subscribe(&onsetDetectionStage);
+        }
+        else
+        {
+            bandPassFilterStage.Subscribe(&energyCalculationStage);
+            energyCalculationStage.Subscribe(&onsetDetectionStage);
+        }
 
         onsetDetectionStage.Subscribe(&peakIndexDetectionStage); // Pass onset data to peak index detection stage
 
@@ -49,50 +156,109 @@ namespace bpmfinder::dsp::time_domain_onset_detection
 
         dominantIntervalCalculationStage.Subscribe(&bpmCalculationStage);
         // Pass dominant interval data to bpm calc stage
+
+        if (featureLog)
+        {
+            bpmCalculationStage.Subscribe(featureLog.get()); // Log the features of every chunk
+        }
+        if (flightRecorderFeatures)
+        {
+            bpmCalculationStage.Subscribe(flightRecorderFeatures.get()); // And their features
+        }
     }
 
-    void TimeDomainOnsetDetectionDspPipeline::Start()
+    void TimeDomainOnsetDetectionDspPipeline::Start(const core::ExecutionMode mode)
     {
+        if (running_ || !initialized_)
+        {
+            return;
+        }
+        running_ = true;
+        ++sentControls_[static_cast<size_t>(core::ControlToken::EndOfStream)];
+        sourceEndOfStreams_ = source.GetEndOfStreamCount();
+
         // Start the pipeline's worker threads BEFORE starting the audio source
-        sink.Start();
-        initializationStage.Start();
-        bandPassFilterStage.Start();
-        energyCalculationStage.Start();
-        onsetDetectionStage.Start();
-        peakIndexDetectionStage.Start();
-        interOnsetIntervalCalculationStage.Start();
-        dominantIntervalCalculationStage.Start();
-        bpmCalculationStage.Start();
+        if (sink)
+        {
+            sink->Start(mode);
+        }
+        if (featureLog)
+        {
+            featureLog->Start(mode);
+        }
+        if (flightRecorderAudio)
+        {
+            flightRecorderAudio->Start(mode);
+            flightRecorderFeatures->Start(mode);
+        }
+        if (downmixStage)
+        {
+            downmixStage->Start(mode);
+        }
+        initializationStage.Start(mode);
+        bandPassFilterStage.Start(mode);
+        if (parallelEnergyCalculationStage)
+        {
+            parallelEnergyCalculationStage->Start(mode);
+        }
+        else
+        {
+            energyCalculationStage.Start(mode);
+        }
+        onsetDetectionStage.Start(mode);
+        peakIndexDetectionStage.Start(mode);
+        interOnsetIntervalCalculationStage.Start(mode);
+        dominantIntervalCalculationStage.Start(mode);
+        bpmCalculationStage.Start(mode);
 
         source.Start();
     }
 
     void TimeDomainOnsetDetectionDspPipeline::Stop()
     {
+        if (!running_)
+        {
+            return;
+        }
+        running_ = false;
+
         // First stop the data flow from the audio source and then the rest of the pipeline
         source.Stop();
 
-        // Then stop the pipeline stages in REVERSE order to allow them to drain their queues
-        // Stop sinks last to ensure all processed data is written
-        initializationStage.StopAndDrain();
-        bandPassFilterStage.StopAndDrain();
-        energyCalculationStage.StopAndDrain();
-        onsetDetectionStage.StopAndDrain();
-        peakIndexDetectionStage.StopAndDrain();
-        interOnsetIntervalCalculationStage.StopAndDrain();
-        dominantIntervalCalculationStage.StopAndDrain();
-        bpmCalculationStage.StopAndDrain();
-
-        sink.StopAndDrain();
+        // The end of stream travels behind the last chunk: once every stage and sink has handled it, all queues are
+        // empty and nothing is emitted anymore, the workers can go. A finite source that got to its end sent it
+        // already; a live source, or one stopped early, gets it from here.
+        if (source.GetEndOfStreamCount() == sourceEndOfStreams_)
+        {
+            source.NotifyControl(core::ControlToken::EndOfStream);
+        }
+        if (!WaitForControl(core::ControlToken::EndOfStream, std::chrono::seconds(5)))
+        {
+            logger_->warn("End of stream did not reach every stage within 5 s, stopping anyway");
+        }
+        ForEachSink([](auto& stage) { stage.Stop(); });
 
         // Print statistics
         logger_->info("\n");
         logger_->info("=== Pipeline Statistics ===");
-        logger_->info("Sink: {}/{}", sink.GetProcessedCount(), sink.GetQueuedCount());
+        if (sink)
+        {
+            logger_->info("Sink: {}/{}", sink->GetProcessedCount(), sink->GetQueuedCount());
+        }
         logger_->info("BandPassFilterStage: {}/{}",
                       bandPassFilterStage.GetProcessedCount(), bandPassFilterStage.GetQueuedCount());
-        logger_->info("EnergyCalculationStage: {}/{}",
-                      energyCalculationStage.GetProcessedCount(), energyCalculationStage.GetQueuedCount());
+        if (parallelEnergyCalculationStage)
+        {
+            logger_->info("EnergyCalculationStage ({} replicas): {}/{}",
+                          parallelEnergyCalculationStage->GetReplicaCount(),
+                          parallelEnergyCalculationStage->GetProcessedCount(),
+                          parallelEnergyCalculationStage->GetQueuedCount());
+        }
+        else
+        {
+            logger_->info("EnergyCalculationStage: {}/{}",
+                          energyCalculationStage.GetProcessedCount(), energyCalculationStage.GetQueuedCount());
+        }
         logger_->info("OnsetDetectionStage: {}/{}",
                       onsetDetectionStage.GetProcessedCount(), onsetDetectionStage.GetQueuedCount());
         logger_->info("PeakIndexDetectionStage: {}/{}", peakIndexDetectionStage.GetProcessedCount(),
@@ -104,7 +270,117 @@ namespace bpmfinder::dsp::time_domain_onset_detection
                       dominantIntervalCalculationStage.GetQueuedCount());
         logger_->info("BpmCalculationStage: {}/{}", bpmCalculationStage.GetProcessedCount(),
                       bpmCalculationStage.GetQueuedCount());
-        logger_->info("Waveform entries written: {}", sink.GetWrittenCount());
+        if (sink)
+        {
+            logger_->info("Waveform entries written: {}", sink->GetWrittenCount());
+        }
+        if (featureLog)
+        {
+            logger_->info("Feature log rows written: {}", featureLog->GetWrittenCount());
+        }
         logger_->info("===========================\n");
     }
+
+    bool TimeDomainOnsetDetectionDspPipeline::Flush(const std::chrono::milliseconds timeout)
+    {
+        return running_ && SendControl(core::ControlToken::Flush, timeout);
+    }
+
+    bool TimeDomainOnsetDetectionDspPipeline::Reset(const std::chrono::milliseconds timeout)
+    {
+        return running_ && SendControl(core::ControlToken::Reset, timeout);
+    }
+
+    bool TimeDomainOnsetDetectionDspPipeline::SendControl(const core::ControlToken token,
+                                                          const std::chrono::milliseconds timeout)
+    {
+        ++sentControls_[static_cast<size_t>(token)];
+
+        // From the source, like a chunk: the downmix, the stages and the sinks each get it once
+        source.NotifyControl(token);
+        return WaitForControl(token, timeout);
+    }
+
+    bool TimeDomainOnsetDetectionDspPipeline::WaitForControl(const core::ControlToken token,
+                                                             const std::chrono::milliseconds timeout)
+    {
+        const size_t count = sentControls_[static_cast<size_t>(token)];
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+        bool handled = true;
+        ForEachSink([&](auto& stage)
+        {
+            const auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+                deadline - std::chrono::steady_clock::now());
+            handled = stage.WaitForControl(token, count, std::max(remaining, std::chrono::milliseconds(0))) &&
+                handled;
+        });
+        return handled;
+    }
+
+    // Every stage and sink, from the input to the end of the graph
+    template <typename Function>
+    void TimeDomainOnsetDetectionDspPipeline::ForEachSink(Function function)
+    {
+        if (downmixStage)
+        {
+            function(*downmixStage);
+        }
+        function(initializationStage);
+        function(bandPassFilterStage);
+        if (parallelEnergyCalculationStage)
+        {
+            function(*parallelEnergyCalculationStage);
+        }
+        else
+        {
+            function(energyCalculationStage);
+        }
+        function(onsetDetectionStage);
+        function(peakIndexDetectionStage);
+        function(interOnsetIntervalCalculationStage);
+        function(dominantIntervalCalculationStage);
+        function(bpmCalculationStage);
+        if (sink)
+        {
+            function(*sink);
+        }
+        if (featureLog)
+        {
+            function(*featureLog);
+        }
+        if (flightRecorderAudio)
+        {
+            function(*flightRecorderAudio);
+            function(*flightRecorderFeatures);
+        }
+    }
+
+    std::vector<size_t> TimeDomainOnsetDetectionDspPipeline::GetControlCounts(const core::ControlToken token)
+    {
+        std::vector<size_t> counts;
+        ForEachSink([&](auto& stage) { counts.push_back(stage.GetControlCount(token)); });
+        return counts;
+    }
+
+    bool TimeDomainOnsetDetectionDspPipeline::WaitForEndOfStream(const std::chrono::milliseconds timeout)
+    {
+        // The last stage of the analysis: once it has the token, so has everything in front of it
+        return bpmCalculationStage.WaitForControl(core::ControlToken::EndOfStream,
+                                                  sentControls_[static_cast<size_t>(core::ControlToken::EndOfStream)],
+                                                  timeout);
+    }
+
+    bool TimeDomainOnsetDetectionDspPipeline::WaitUntilFinished(const std::chrono::milliseconds timeout)
+    {
+        if (!WaitForEndOfStream(timeout))
+        {
+            logger_->warn("Source did not finish within {} ms", timeout.count());
+            return false;
+        }
+
+        // Stop waits until the sinks have the end of stream too
+        logger_->info("End of stream reached, stopping the pipeline");
+        Stop();
+        return true;
+    }
 }
@@ -4,46 +4,118 @@
 
 #pragma once
 
+#include <array>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
 #include "BandPassFilterStage.h"
 #include "BpmCalculationStage.h"
+#include "BpmResultPublisher.h"
 #include "DominantIntervalCalculationStage.h"
 #include "EnergyCalculationStage.h"
 #include "InterOnsetIntervalCalculationStage.h"
 #include "OnsetDetectionStage.h"
 #include "PeakIndexDetectionStage.h"
 #include "PipelineResultInitializationStage.h"
-#include "audio/WasapiAudioSource.h"
+#include "TimeDomainOnsetDetectionConfig.h"
+#include "audio/DownmixStage.h"
+#include "audio/IAudioSource.h"
+#include "core/ParallelCopyStage.h"
 #include "../../files/bin/AudioBinFileSink.h"
+#include "../../files/bin/FeatureLogFileSink.h"
+#include "../../files/bin/RecordingFileSink.h"
+#include "../../files/recording/FlightRecorderSinks.h"
 
 namespace bpmfinder::dsp::time_domain_onset_detection
 {
     class TimeDomainOnsetDetectionDspPipeline
     {
     public:
-        explicit TimeDomainOnsetDetectionDspPipeline(int chunkSize, int sampleRate,
-                                                     int bandPassLowCutoff, int bandPassHighCutoff,
-                                                     float bandPassGain);
-        int chunkSize;
-        int sampleRate;
-        int bandPassLowCutoff;
-        int bandPassHighCutoff;
-        float bandPassGain;
-
-        void Start();
+        // The source is not owned and must outlive the pipeline.
+        // queueCapacity bounds the queue of every stage (0 = unbounded): a full stage blocks the one before it, all
+        // the way back to the source. That is what keeps a flat-out file replay from piling up chunks in memory.
+        // An empty recordingFilename disables writing the raw input to a file. A name ending in .bpmr gets a
+        // self-describing, indexed recording (RecordingFileSink), anything else raw floats.
+        // A featureLogFilename logs the features of every chunk after the last stage (FeatureLogFileSink).
+        // A flightRecorder (not owned, open, outliving the pipeline) keeps the last minutes of input and features.
+        // A publisher (not owned, outliving the pipeline) gets every tempo estimate, for callbacks and other processes.
+        explicit TimeDomainOnsetDetectionDspPipeline(audio::IAudioSource& source,
+                                                     const TimeDomainOnsetDetectionConfig& config,
+                                                     size_t queueCapacity = 0,
+                                                     const std::string& recordingFilename = "waveform.bin",
+                                                     const std::string& featureLogFilename = "",
+                                                     files::recording::FlightRecorder* flightRecorder = nullptr,
+                                                     BpmResultPublisher* publisher = nullptr);
+
+        const TimeDomainOnsetDetectionConfig config;
+
+        // False if the source failed to initialize, Start does nothing then
+        [[nodiscard]] bool IsInitialized() const { return initialized_; }
+
+        // Inline runs every stage and sink on the thread the source publishes from, one chunk after the other
+        // through the whole graph (see core::ExecutionMode): no stage threads, no queues, the same results.
+        void Start(core::ExecutionMode mode = core::ExecutionMode::Threaded);
         void Stop();
 
+        // Until the end of stream a finite source sends behind its last chunk has gone through every stage, i.e.
+        // every chunk the source sent has been analyzed. False on timeout, or for a source that does not end.
+        bool WaitForEndOfStream(std::chrono::milliseconds timeout);
+
+        // WaitForEndOfStream, then Stop, which also waits for the sinks. Returns false on timeout, the pipeline keeps
+        // running then.
+        bool WaitUntilFinished(std::chrono::milliseconds timeout = std::chrono::hours(24));
+
+        // Send a control token (core::ControlToken) behind the chunks the source has sent so far and wait until every
+        // stage and sink has handled it. After Flush those chunks went through the whole pipeline. Reset also makes
+        // the stages forget them: what comes next is analyzed like a new stream, e.g. the next file; chunk indices
+        // go on. False on timeout.
+        bool Flush(std::chrono::milliseconds timeout = std::chrono::seconds(5));
+        bool Reset(std::chrono::milliseconds timeout = std::chrono::seconds(5));
+
+        // Tokens of this kind that every stage and sink has handled, from the input to the end of the graph
+        [[nodiscard]] std::vector<size_t> GetControlCounts(core::ControlToken token);
+
+        [[nodiscard]] float GetCurrentBpm() const { return bpmCalculationStage.GetCurrentBpm(); }
+
+        // Latest estimate with confidence and time, wait-free for the analysis, from any thread
+        [[nodiscard]] BpmSnapshot GetBpmSnapshot() const { return bpmCalculationStage.GetSnapshot(); }
+
+        // Chunks that went through all stages
+        [[nodiscard]] size_t GetProcessedChunkCount() const { return bpmCalculationStage.GetProcessedCount(); }
+
     private:
-        audio::WasapiAudioSource source;
+        bool SendControl(core::ControlToken token, std::chrono::milliseconds timeout);
+
+        // Until every stage and sink has handled all tokens of this kind sent so far
+        bool WaitForControl(core::ControlToken token, std::chrono::milliseconds timeout);
+
+        template <typename Function>
+        void ForEachSink(Function function);
+
+        audio::IAudioSource& source;
+        std::unique_ptr<audio::DownmixStage> downmixStage; // Only for multi-channel sources
         PipelineResultInitializationStage initializationStage;
         BandPassFilterStage bandPassFilterStage;
         EnergyCalculationStage energyCalculationStage;
+        // Replaces energyCalculationStage for config.energyCalculationReplicas > 1
+        std::unique_ptr<core::ParallelCopyStage<EnergyCalculationStage>> parallelEnergyCalculationStage;
         OnsetDetectionStage onsetDetectionStage;
         PeakIndexDetectionStage peakIndexDetectionStage;
         InterOnsetIntervalCalculationStage interOnsetIntervalCalculationStage;
         DominantIntervalCalculationStage dominantIntervalCalculationStage;
         BpmCalculationStage bpmCalculationStage;
 
-        files::bin::AudioBinFileSink sink;
+        std::unique_ptr<files::bin::BinFileSink<audio::AudioChunk>> sink;
+        std::unique_ptr<files::bin::FeatureLogFileSink> featureLog;
+        std::unique_ptr<files::recording::FlightRecorderAudioSink> flightRecorderAudio;
+        std::unique_ptr<files::recording::FlightRecorderFeatureSink> flightRecorderFeatures;
+
+        bool initialized_ = false;
+        bool running_ = false;
+        // Tokens sent into the pipeline; one end of stream per run, from the source or from Stop
+        std::array<size_t, core::ControlTokenCount> sentControls_{};
+        uint64_t sourceEndOfStreams_ = 0; // The source's GetEndOfStreamCount when the run started
 
         std::shared_ptr<spdlog::logger> logger_;
     };
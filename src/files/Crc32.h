@@ -0,0 +1,42 @@
+//
+// Created by Robert on 2025-11-12.
+//
+
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace bpmfinder::files
+{
+    namespace detail
+    {
+        constexpr std::array<uint32_t, 256> CreateCrc32Table()
+        {
+            std::array<uint32_t, 256> table{};
+            for (uint32_t i = 0; i < 256; ++i)
+            {
+                uint32_t value = i;
+                for (int bit = 0; bit < 8; ++bit)
+                {
+                    value = (value & 1) != 0 ? 0xEDB88320u ^ (value >> 1) : value >> 1;
+                }
+                table[i] = value;
+            }
+            return table;
+        }
+
+        inline constexpr auto Crc32Table = CreateCrc32Table();
+    }
+
+    // CRC-32 as in zlib, PNG and Ethernet. Pass the previous result as 'crc' to continue over several pieces.
+    inline uint32_t Crc32(const std::byte* data, const size_t size, uint32_t crc = 0)
+    {
+        crc = ~crc;
+        for (size_t i = 0; i < size; ++i)
+        {
+            crc = detail::Crc32Table[(crc ^ static_cast<uint32_t>(data[i])) & 0xFF] ^ (crc >> 8);
+        }
+        return ~crc;
+    }
+}
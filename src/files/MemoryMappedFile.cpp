@@ -0,0 +1,195 @@
+//
+// Created by Robert on 2025-11-01.
+//
+
+#include "MemoryMappedFile.h"
+#include <algorithm>
+#include <filesystem>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace bpmfinder::files
+{
+    MemoryMappedFile::~MemoryMappedFile()
+    {
+        Close();
+    }
+
+#ifdef _WIN32
+    bool MemoryMappedFile::Open(const std::string& filename)
+    {
+        Close();
+
+        // Check before opening: opening and closing a pipe again would throw away whatever the writer sent so far
+        std::error_code error;
+        if (!std::filesystem::is_regular_file(filename, error))
+        {
+            return false;
+        }
+
+        // Sequential scan: the cache manager reads ahead aggressively and drops pages behind the reader early
+        HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                  FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            return false;
+        }
+
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(file, &fileSize) || GetFileType(file) != FILE_TYPE_DISK)
+        {
+            CloseHandle(file);
+            return false;
+        }
+
+        fileHandle_ = file;
+        size_ = static_cast<size_t>(fileSize.QuadPart);
+        isOpen_ = true;
+
+        // Empty files can not be mapped, but they are valid files
+        if (size_ == 0)
+        {
+            return true;
+        }
+
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping == nullptr)
+        {
+            Close();
+            return false;
+        }
+        mappingHandle_ = mapping;
+
+        data_ = static_cast<const std::byte*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        if (data_ == nullptr)
+        {
+            Close();
+            return false;
+        }
+
+        return true;
+    }
+
+    void MemoryMappedFile::Close()
+    {
+        if (data_ != nullptr)
+        {
+            UnmapViewOfFile(data_);
+        }
+        if (mappingHandle_ != nullptr)
+        {
+            CloseHandle(mappingHandle_);
+        }
+        if (fileHandle_ != nullptr)
+        {
+            CloseHandle(fileHandle_);
+        }
+
+        data_ = nullptr;
+        mappingHandle_ = nullptr;
+        fileHandle_ = nullptr;
+        size_ = 0;
+        releasedUpTo_ = 0;
+        isOpen_ = false;
+    }
+
+    void MemoryMappedFile::ReleaseBefore(const size_t offset)
+    {
+        // Nothing to do: with FILE_FLAG_SEQUENTIAL_SCAN the memory manager already trims the pages behind the reader
+        releasedUpTo_ = offset;
+    }
+#else
+    bool MemoryMappedFile::Open(const std::string& filename)
+    {
+        Close();
+
+        // Check before opening: opening and closing a pipe again would throw away whatever the writer sent so far
+        std::error_code error;
+        if (!std::filesystem::is_regular_file(filename, error))
+        {
+            return false;
+        }
+
+        const int fd = ::open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+        {
+            return false;
+        }
+
+        struct stat status{};
+        if (::fstat(fd, &status) != 0 || !S_ISREG(status.st_mode))
+        {
+            ::close(fd);
+            return false;
+        }
+
+        fileDescriptor_ = fd;
+        size_ = static_cast<size_t>(status.st_size);
+        isOpen_ = true;
+
+        // Empty files can not be mapped, but they are valid files
+        if (size_ == 0)
+        {
+            return true;
+        }
+
+        void* mapping = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping == MAP_FAILED)
+        {
+            Close();
+            return false;
+        }
+        data_ = static_cast<const std::byte*>(mapping);
+
+        // Read ahead aggressively, pages behind the reader are dropped early
+        ::madvise(mapping, size_, MADV_SEQUENTIAL);
+        ::posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+        return true;
+    }
+
+    void MemoryMappedFile::Close()
+    {
+        if (data_ != nullptr)
+        {
+            ::munmap(const_cast<std::byte*>(data_), size_);
+        }
+        if (fileDescriptor_ >= 0)
+        {
+            ::close(fileDescriptor_);
+        }
+
+        data_ = nullptr;
+        fileDescriptor_ = -1;
+        size_ = 0;
+        releasedUpTo_ = 0;
+        isOpen_ = false;
+    }
+
+    void MemoryMappedFile::ReleaseBefore(const size_t offset)
+    {
+        if (data_ == nullptr)
+        {
+            return;
+        }
+
+        // madvise works on whole pages, only release pages that have been consumed completely
+        const auto pageSize = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+        const size_t end = std::min(offset, size_) / pageSize * pageSize;
+        if (end <= releasedUpTo_)
+        {
+            return;
+        }
+
+        ::madvise(const_cast<std::byte*>(data_) + releasedUpTo_, end - releasedUpTo_, MADV_DONTNEED);
+        releasedUpTo_ = end;
+    }
+#endif
+}
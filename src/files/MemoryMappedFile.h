@@ -0,0 +1,47 @@
+//
+// Created by Robert on 2025-11-01.
+//
+
+#pragma once
+#include <cstddef>
+#include <string>
+
+namespace bpmfinder::files
+{
+    // Read-only view of a whole file, mapped into memory and tuned for reading it once from start to end.
+    // Pages are loaded by the OS when they are first touched, so opening is constant time regardless of the file size.
+    class MemoryMappedFile
+    {
+    public:
+        MemoryMappedFile() = default;
+        ~MemoryMappedFile();
+
+        MemoryMappedFile(const MemoryMappedFile&) = delete;
+        MemoryMappedFile& operator=(const MemoryMappedFile&) = delete;
+
+        // Fails for anything that can not be mapped, e.g. pipes
+        bool Open(const std::string& filename);
+        void Close();
+
+        [[nodiscard]] bool IsOpen() const { return isOpen_; }
+        [[nodiscard]] const std::byte* GetData() const { return data_; }
+        [[nodiscard]] size_t GetSize() const { return size_; }
+
+        // Everything before 'offset' has been consumed: the OS may drop those pages now instead of keeping them in
+        // the resident set until memory gets tight. Reading them again later is still valid, it just hits the disk.
+        void ReleaseBefore(size_t offset);
+
+    private:
+        const std::byte* data_ = nullptr;
+        size_t size_ = 0;
+        size_t releasedUpTo_ = 0;
+        bool isOpen_ = false;
+
+#ifdef _WIN32
+        void* fileHandle_ = nullptr;
+        void* mappingHandle_ = nullptr;
+#else
+        int fileDescriptor_ = -1;
+#endif
+    };
+}
@@ -0,0 +1,332 @@
+//
+// Created by Robert on 2025-11-11.
+//
+
+#include "WriteBehindFile.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <new>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace bpmfinder::files
+{
+    WriteBehindFile::~WriteBehindFile()
+    {
+        Close();
+    }
+
+    bool WriteBehindFile::Open(const std::string& filename, const WriteBehindOptions& options)
+    {
+        Close();
+
+        options_ = options;
+        capacity_ = (std::max(options.bufferBytes, Alignment) + Alignment - 1) / Alignment * Alignment;
+        if (!OpenFile(filename, options.directIo))
+        {
+            return false;
+        }
+
+        for (auto& buffer : buffers_)
+        {
+            buffer.data = static_cast<std::byte*>(::operator new(capacity_, std::align_val_t{Alignment}));
+            buffer.size = 0;
+        }
+        active_ = 0;
+        fill_ = 0;
+        pending_ = -1;
+        closing_ = false;
+        failed_ = false;
+        appendedBytes_ = 0;
+        isOpen_ = true;
+
+        writer_ = std::thread(&WriteBehindFile::WriterLoop, this);
+        return true;
+    }
+
+    void WriteBehindFile::Append(const void* data, size_t bytes)
+    {
+        auto source = static_cast<const std::byte*>(data);
+        appendedBytes_ += bytes;
+        while (bytes > 0)
+        {
+            const size_t count = std::min(bytes, capacity_ - fill_);
+            std::memcpy(buffers_[active_].data + fill_, source, count);
+            fill_ += count;
+            source += count;
+            bytes -= count;
+            if (fill_ == capacity_)
+            {
+                Submit();
+            }
+        }
+    }
+
+    void WriteBehindFile::Submit()
+    {
+        {
+            // Only waits while the writer thread is still busy with the other buffer
+            std::unique_lock lock(mutex_);
+            cv_.wait(lock, [this] { return pending_ < 0; });
+            buffers_[active_].size = fill_;
+            pending_ = active_;
+        }
+        cv_.notify_all();
+
+        active_ ^= 1;
+        fill_ = 0;
+    }
+
+    bool WriteBehindFile::Flush()
+    {
+        if (!isOpen_)
+        {
+            return false;
+        }
+
+        if (fill_ > 0)
+        {
+            Submit();
+        }
+        std::unique_lock lock(mutex_);
+        cv_.wait(lock, [this] { return pending_ < 0; });
+
+        // Nothing is pending, the writer thread does not touch the file until the next Submit
+        if (options_.fsync != FsyncPolicy::Never && !Sync())
+        {
+            failed_ = true;
+        }
+        return !failed_;
+    }
+
+    bool WriteBehindFile::Close()
+    {
+        if (!isOpen_)
+        {
+            return true;
+        }
+
+        if (fill_ > 0)
+        {
+            Submit();
+        }
+        {
+            std::lock_guard lock(mutex_);
+            closing_ = true;
+        }
+        cv_.notify_all();
+        writer_.join();
+
+        if (options_.fsync != FsyncPolicy::Never && !Sync())
+        {
+            failed_ = true;
+        }
+        CloseFile();
+        FreeBuffers();
+        isOpen_ = false;
+        return !failed_;
+    }
+
+    void WriteBehindFile::WriterLoop()
+    {
+        const bool periodic = options_.fsync == FsyncPolicy::Periodic;
+        auto nextSync = std::chrono::steady_clock::now() + options_.fsyncInterval;
+        bool unsynced = false;
+
+        std::unique_lock lock(mutex_);
+        while (true)
+        {
+            const auto ready = [this] { return pending_ >= 0 || closing_; };
+            if (periodic && unsynced)
+            {
+                cv_.wait_until(lock, nextSync, ready);
+            }
+            else
+            {
+                cv_.wait(lock, ready);
+            }
+
+            if (pending_ >= 0)
+            {
+                const Buffer buffer = buffers_[pending_];
+                lock.unlock();
+                // A failed sync means the data may never reach the disk, e.g. writeback hit EIO: a failed write
+                const bool written = WriteBuffer(buffer) &&
+                    (options_.fsync != FsyncPolicy::EveryBuffer || Sync());
+                lock.lock();
+
+                failed_ = failed_ || !written;
+                pending_ = -1;
+                unsynced = true;
+                cv_.notify_all();
+            }
+            else if (closing_)
+            {
+                return; // Close syncs after the last buffer
+            }
+
+            if (periodic && unsynced && std::chrono::steady_clock::now() >= nextSync)
+            {
+                lock.unlock();
+                const bool synced = Sync();
+                lock.lock();
+                failed_ = failed_ || !synced;
+                unsynced = false;
+                nextSync = std::chrono::steady_clock::now() + options_.fsyncInterval;
+            }
+        }
+    }
+
+    void WriteBehindFile::FreeBuffers()
+    {
+        for (auto& buffer : buffers_)
+        {
+            ::operator delete(buffer.data, std::align_val_t{Alignment});
+            buffer.data = nullptr;
+        }
+    }
+
+#ifdef _WIN32
+    bool WriteBehindFile::OpenFile(const std::string& filename, bool)
+    {
+        // FILE_FLAG_NO_BUFFERING would need an aligned size for the last write too, so writes always go through the
+        // cache manager here
+        directIo_ = false;
+        HANDLE file = CreateFileA(filename.c_str(), GENERIC_WRITE, FILE_SHARE_READ, nullptr, CREATE_ALWAYS,
+                                  FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            return false;
+        }
+        fileHandle_ = file;
+        return true;
+    }
+
+    void WriteBehindFile::CloseFile()
+    {
+        if (fileHandle_ != nullptr)
+        {
+            CloseHandle(fileHandle_);
+            fileHandle_ = nullptr;
+        }
+    }
+
+    bool WriteBehindFile::WriteBuffer(const Buffer& buffer)
+    {
+        return WriteAll(buffer.data, buffer.size);
+    }
+
+    bool WriteBehindFile::WriteAll(const std::byte* data, size_t bytes)
+    {
+        while (bytes > 0)
+        {
+            DWORD written = 0;
+            const auto count = static_cast<DWORD>(std::min<size_t>(bytes, 1u << 30));
+            if (!WriteFile(fileHandle_, data, count, &written, nullptr))
+            {
+                return false;
+            }
+            data += written;
+            bytes -= written;
+        }
+        return true;
+    }
+
+    bool WriteBehindFile::Sync()
+    {
+        return FlushFileBuffers(fileHandle_) != 0;
+    }
+#else
+    bool WriteBehindFile::OpenFile(const std::string& filename, const bool directIo)
+    {
+        constexpr int flags = O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC;
+        directIo_ = false;
+#ifdef O_DIRECT
+        if (directIo)
+        {
+            // tmpfs and some other file systems refuse O_DIRECT, they get buffered writes
+            fileDescriptor_ = ::open(filename.c_str(), flags | O_DIRECT, 0644);
+            if (fileDescriptor_ >= 0)
+            {
+                directIo_ = true;
+                return true;
+            }
+        }
+#endif
+        fileDescriptor_ = ::open(filename.c_str(), flags, 0644);
+        return fileDescriptor_ >= 0;
+    }
+
+    void WriteBehindFile::CloseFile()
+    {
+        if (fileDescriptor_ >= 0)
+        {
+            ::close(fileDescriptor_);
+            fileDescriptor_ = -1;
+        }
+    }
+
+    bool WriteBehindFile::WriteBuffer(const Buffer& buffer)
+    {
+        // Direct I/O only takes whole blocks: the last, partial buffer of the file goes through the page cache
+        const size_t aligned = directIo_ ? buffer.size / Alignment * Alignment : buffer.size;
+        if (!WriteAll(buffer.data, aligned))
+        {
+            return false;
+        }
+        if (aligned == buffer.size)
+        {
+            return true;
+        }
+
+#ifdef O_DIRECT
+        ::fcntl(fileDescriptor_, F_SETFL, ::fcntl(fileDescriptor_, F_GETFL) & ~O_DIRECT);
+#endif
+        directIo_ = false;
+        return WriteAll(buffer.data + aligned, buffer.size - aligned);
+    }
+
+    bool WriteBehindFile::WriteAll(const std::byte* data, size_t bytes)
+    {
+        while (bytes > 0)
+        {
+            const ssize_t written = ::write(fileDescriptor_, data, bytes);
+            if (written < 0)
+            {
+#ifdef O_DIRECT
+                // Opened with O_DIRECT, but the file system refuses the write: continue buffered
+                if (errno == EINVAL && directIo_)
+                {
+                    ::fcntl(fileDescriptor_, F_SETFL, ::fcntl(fileDescriptor_, F_GETFL) & ~O_DIRECT);
+                    directIo_ = false;
+                    continue;
+                }
+#endif
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                return false;
+            }
+            data += written;
+            bytes -= static_cast<size_t>(written);
+        }
+        return true;
+    }
+
+    bool WriteBehindFile::Sync()
+    {
+#ifdef __linux__
+        return ::fdatasync(fileDescriptor_) == 0;
+#else
+        return ::fsync(fileDescriptor_) == 0;
+#endif
+    }
+#endif
+}
@@ -0,0 +1,110 @@
+//
+// Created by Robert on 2025-11-11.
+//
+
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace bpmfinder::files
+{
+    enum class FsyncPolicy
+    {
+        Never, // Leave it to the OS, only the page cache holds the data until it writes it back
+        EveryBuffer, // After every buffer the writer thread hands to the file
+        Periodic // At most every WriteBehindOptions::fsyncInterval, and once when the file is closed
+    };
+
+    struct WriteBehindOptions
+    {
+        size_t bufferBytes = 1024 * 1024; // Per buffer, rounded up to WriteBehindFile::Alignment; there are two
+
+        // Bypass the page cache (O_DIRECT). Falls back to buffered writes where the file system does not support it.
+        bool directIo = false;
+
+        FsyncPolicy fsync = FsyncPolicy::Never;
+        std::chrono::milliseconds fsyncInterval{1000};
+    };
+
+    // Sequential writer that keeps the system calls off the calling thread. Appends are copied into the active one of
+    // two aligned buffers; a full buffer goes to a writer thread, which writes it while the caller fills the other
+    // one. The caller only waits when both buffers are full, i.e. when the disk is slower than the data.
+    // One thread appends, Open and Close are not thread safe.
+    class WriteBehindFile
+    {
+    public:
+        static constexpr size_t Alignment = 4096; // Buffer address and size, what O_DIRECT needs on common devices
+
+        WriteBehindFile() = default;
+        ~WriteBehindFile();
+
+        WriteBehindFile(const WriteBehindFile&) = delete;
+        WriteBehindFile& operator=(const WriteBehindFile&) = delete;
+
+        // Creates or truncates the file and starts the writer thread
+        bool Open(const std::string& filename, const WriteBehindOptions& options = {});
+
+        void Append(const void* data, size_t bytes);
+
+        // Writes what was appended so far and waits for it, syncs unless the policy is Never. False if any write or
+        // sync failed. Appends that follow go on behind it; with direct I/O a partial buffer ends direct I/O for the rest
+        // of the file, as the last buffer does.
+        bool Flush();
+
+        // Writes what is left, syncs unless the policy is Never, closes the file. False if any write or sync failed.
+        bool Close();
+
+        [[nodiscard]] bool IsOpen() const { return isOpen_; }
+
+        // Direct I/O actually in use after Open
+        [[nodiscard]] bool IsDirectIo() const { return directIo_; }
+
+        [[nodiscard]] uint64_t GetAppendedBytes() const { return appendedBytes_; }
+
+    private:
+        struct Buffer
+        {
+            std::byte* data = nullptr;
+            size_t size = 0; // Bytes to write, set when the buffer is handed to the writer thread
+        };
+
+        void Submit(); // Hands the active buffer to the writer thread
+        void WriterLoop();
+        bool WriteBuffer(const Buffer& buffer);
+        bool WriteAll(const std::byte* data, size_t bytes);
+        bool Sync(); // False if the data may not have reached the disk
+        bool OpenFile(const std::string& filename, bool directIo);
+        void CloseFile();
+        void FreeBuffers();
+
+        WriteBehindOptions options_;
+        bool isOpen_ = false;
+        std::atomic<bool> directIo_{false}; // Turned off by the writer thread where the file system refuses it
+        uint64_t appendedBytes_ = 0;
+
+        Buffer buffers_[2];
+        size_t capacity_ = 0;
+        int active_ = 0; // Buffer the caller appends to
+        size_t fill_ = 0;
+
+        // Hand-over to the writer thread
+        std::mutex mutex_;
+        std::condition_variable cv_;
+        int pending_ = -1; // Buffer the writer thread owns, -1 for none
+        bool closing_ = false;
+        bool failed_ = false;
+        std::thread writer_;
+
+#ifdef _WIN32
+        void* fileHandle_ = nullptr;
+#else
+        int fileDescriptor_ = -1;
+#endif
+    };
+}
@@ -5,7 +5,6 @@
 #pragma once
 #include "../../audio/IAudioSource.h"
 #include "core/CopySink.h"
-#include <fstream>
 #include "BinFileSink.h"
 #include "logging/LoggerFactory.h"
 
@@ -14,18 +13,21 @@ namespace bpmfinder::files::bin
     class AudioBinFileSink : public BinFileSink<audio::AudioChunk>
     {
     public:
-        explicit AudioBinFileSink(const std::string& filename) : BinFileSink(
-            filename, logging::LoggerFactory::GetLogger("AudioBinFileSink"))
+        explicit AudioBinFileSink(const std::string& filename, const WriteBehindOptions& options = {}) : BinFileSink(
+            filename, logging::LoggerFactory::GetLogger("AudioBinFileSink"), options)
         {
         }
 
+        ~AudioBinFileSink() override
+        {
+            // The worker calls our Process, it has to be gone before this part of the object is
+            this->Stop();
+        }
+
     protected:
         void Process(const audio::AudioChunk data) override
         {
-            file_.write(reinterpret_cast<const char*>(data.data()), data.size() * sizeof(float));
-            ++write_count_;
-            logger_->debug("File {} size: {} after {} entries", filename_, static_cast<std::streamoff>(file_.tellp()),
-                           GetWrittenCount());
+            Write(data.data(), data.size() * sizeof(float));
         }
     };
 }
@@ -4,42 +4,68 @@
 
 #pragma once
 #include <atomic>
-#include <iosfwd>
-#include <fstream>
 #include <stdexcept>
 #include <string>
 #include "core/CopySink.h"
+#include "files/WriteBehindFile.h"
 #include <spdlog/spdlog.h>
 
 
 namespace bpmfinder::files::bin
 {
+    // Writes what it receives into a raw binary file. The file is written behind: Process only copies into a large
+    // buffer, a writer thread of the WriteBehindFile does the system calls, so recording does not add I/O latency to
+    // the sink thread, let alone to the DSP stages in front of it.
+    // Every derived sink stops the worker in its own destructor: by the time this one runs, the derived part that
+    // implements Process is destroyed already.
     template <typename T>
     class BinFileSink : public core::CopySink<T>
     {
     protected:
         std::string filename_;
-        std::ofstream file_; // RAII: The file handle is managed here!
+        WriteBehindFile file_;
         std::atomic<size_t> write_count_{0}; // Total items written to the file
         std::shared_ptr<spdlog::logger> logger_;
 
+        void Write(const void* data, const size_t bytes)
+        {
+            file_.Append(data, bytes);
+            ++write_count_;
+        }
+
+        // Flush: what was written so far goes to the file before the token is passed on
+        void OnControl(const core::ControlToken token) override
+        {
+            if (token == core::ControlToken::Flush && !file_.Flush())
+            {
+                logger_->error("Failed to write {}", filename_);
+            }
+        }
+
     public:
-        // 1. Constructor: Acquire Resource (Open File)
-        explicit BinFileSink(const std::string& filename, std::shared_ptr<spdlog::logger> logger) : filename_(filename),
+        // Opening the file is the initialization, the destructor writes the rest and closes it
+        explicit BinFileSink(const std::string& filename, std::shared_ptr<spdlog::logger> logger,
+                             const WriteBehindOptions& options = {}) :
+            filename_(filename),
             logger_(std::move(logger))
         {
-            // Opening the file here is the "Initialization"
-            file_.open(filename, std::ios::binary | std::ios::trunc);
-            if (!file_.is_open())
+            if (!file_.Open(filename, options))
             {
                 throw std::runtime_error("Failed to open file: " + filename);
             }
         }
 
-        // 2. Destructor: Resource is Automatically Released
-        // When FileSink is destroyed, its member file_ is destroyed,
-        // and std::ofstream's destructor automatically calls file_.close().
-        // You do NOT need a separate Shutdown method.
+        ~BinFileSink() override
+        {
+            // Normally stopped already by the derived destructor, see above
+            this->Stop();
+            if (!file_.Close())
+            {
+                logger_->error("Failed to write {}", filename_);
+            }
+            logger_->debug("File {} size: {} after {} entries", filename_, file_.GetAppendedBytes(),
+                           GetWrittenCount());
+        }
 
         [[nodiscard]] size_t GetWrittenCount() const { return write_count_.load(); }
     };
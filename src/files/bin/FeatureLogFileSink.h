@@ -0,0 +1,63 @@
+//
+// Created by Robert on 2025-11-13.
+//
+
+#pragma once
+#include "BinFileSink.h"
+#include "dsp/time_domain_onset_detection/TimeDomainOnsetDetectionResult.h"
+#include "files/features/FeatureLogWriter.h"
+#include "logging/LoggerFactory.h"
+
+namespace bpmfinder::files::bin
+{
+    // Logs the features of every result it receives into a columnar feature log (see
+    // files/features/FeatureLogFormat.h), without the audio. Rows are encoded a block at a time on the sink thread,
+    // the file is written behind.
+    class FeatureLogFileSink : public BinFileSink<dsp::time_domain_onset_detection::TimeDomainOnsetDetectionResult>
+    {
+    public:
+        explicit FeatureLogFileSink(const std::string& filename, const features::FeatureLogOptions& options) :
+            BinFileSink(filename, logging::LoggerFactory::GetLogger("FeatureLogFileSink")),
+            writer_(file_, options)
+        {
+        }
+
+        ~FeatureLogFileSink() override
+        {
+            // The last block goes in after the last result, before BinFileSink closes the file
+            this->Stop();
+            writer_.Finish();
+        }
+
+    protected:
+        void Process(const dsp::time_domain_onset_detection::TimeDomainOnsetDetectionResult data) override
+        {
+            features::FeatureRow row;
+            row.chunkIndex = data.chunkIndex;
+            row.energy = data.energy;
+            row.onsetStrength = data.onsetStrength;
+            if (data.peakIndices)
+            {
+                row.peakIndices.emplace(data.peakIndices->begin(), data.peakIndices->end());
+            }
+            row.interOnsetIntervals = data.interOnsetIntervals;
+            row.dominantInterval = data.dominantInterval;
+            row.bpm = data.bpm;
+            writer_.Append(std::move(row));
+            ++write_count_;
+        }
+
+        void OnControl(const core::ControlToken token) override
+        {
+            // The rows of the open block first, they are only in memory so far
+            if (token == core::ControlToken::Flush)
+            {
+                writer_.Flush();
+            }
+            BinFileSink::OnControl(token);
+        }
+
+    private:
+        features::FeatureLogWriter writer_;
+    };
+}
@@ -5,7 +5,8 @@
 #pragma once
 #include "../../audio/IAudioSource.h"
 #include "core/CopySink.h"
-#include <fstream>
+#include "BinFileSink.h"
+#include "logging/LoggerFactory.h"
 
 namespace bpmfinder::files::bin
 {
@@ -17,13 +18,16 @@ namespace bpmfinder::files::bin
         {
         }
 
+        ~FloatBinFileSink() override
+        {
+            // The worker calls our Process, it has to be gone before this part of the object is
+            this->Stop();
+        }
+
     protected:
         void Process(float data) override
         {
-            file_.write(reinterpret_cast<const char*>(&data), sizeof(float));
-            ++write_count_;
-            logger_->debug("File {} size: {} after {} entries", filename_, static_cast<std::streamoff>(file_.tellp())
-                           , GetWrittenCount());
+            Write(&data, sizeof(float));
         }
     };
 }
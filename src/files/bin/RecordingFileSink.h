@@ -0,0 +1,46 @@
+//
+// Created by Robert on 2025-11-12.
+//
+
+#pragma once
+#include "../../audio/IAudioSource.h"
+#include <algorithm>
+#include "BinFileSink.h"
+#include "files/recording/RecordingWriter.h"
+#include "logging/LoggerFactory.h"
+
+namespace bpmfinder::files::bin
+{
+    // Like the AudioBinFileSink, but writes a self-describing recording (see files/recording/RecordingFormat.h):
+    // sample rate and channel count travel with the samples, and readers can seek to any time without reading the
+    // file up to there. Chunks are interleaved frames of options.channels channels.
+    class RecordingFileSink : public BinFileSink<audio::AudioChunk>
+    {
+    public:
+        explicit RecordingFileSink(const std::string& filename, const recording::RecordingOptions& options,
+                                   const WriteBehindOptions& fileOptions = {}) :
+            BinFileSink(filename, logging::LoggerFactory::GetLogger("RecordingFileSink"), fileOptions),
+            writer_(file_, options),
+            channels_(std::max<uint32_t>(1, options.channels))
+        {
+        }
+
+        ~RecordingFileSink() override
+        {
+            // The last block and the index go in after the last chunk, before BinFileSink closes the file
+            this->Stop();
+            writer_.Finish();
+        }
+
+    protected:
+        void Process(const audio::AudioChunk data) override
+        {
+            writer_.Write(data.data(), data.size() / channels_);
+            ++write_count_;
+        }
+
+    private:
+        recording::RecordingWriter writer_;
+        uint32_t channels_;
+    };
+}
@@ -0,0 +1,465 @@
+//
+// Created by Robert on 2025-11-13.
+//
+
+#include "FeatureLogFormat.h"
+#include <cstring>
+
+namespace bpmfinder::files::features
+{
+    namespace
+    {
+        class ColumnWriter
+        {
+        public:
+            std::vector<std::byte> bytes;
+
+            void PutVarint(uint64_t value)
+            {
+                while (value >= 0x80)
+                {
+                    bytes.push_back(static_cast<std::byte>(value | 0x80));
+                    value >>= 7;
+                }
+                bytes.push_back(static_cast<std::byte>(value));
+            }
+
+            void PutZigzag(const int64_t value)
+            {
+                PutVarint((static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+            }
+
+            void PutFloat(const float value)
+            {
+                const auto* data = reinterpret_cast<const std::byte*>(&value);
+                bytes.insert(bytes.end(), data, data + sizeof(value));
+            }
+        };
+
+        // Every read checks the end of the column; after the first failure everything reads as 0 and ok is false
+        class ColumnReader
+        {
+        public:
+            ColumnReader(const std::byte* data, const size_t size) : position_(data), end_(data + size)
+            {
+            }
+
+            bool ok = true;
+
+            uint64_t GetVarint()
+            {
+                uint64_t value = 0;
+                for (int shift = 0; shift < 64; shift += 7)
+                {
+                    if (position_ == end_)
+                    {
+                        break;
+                    }
+                    const auto byte = static_cast<uint64_t>(*position_++);
+                    value |= (byte & 0x7F) << shift;
+                    if ((byte & 0x80) == 0)
+                    {
+                        return value;
+                    }
+                }
+                ok = false;
+                return 0;
+            }
+
+            int64_t GetZigzag()
+            {
+                const uint64_t value = GetVarint();
+                return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+            }
+
+            float GetFloat()
+            {
+                float value = 0.0f;
+                if (static_cast<size_t>(end_ - position_) < sizeof(value))
+                {
+                    ok = false;
+                    return value;
+                }
+                std::memcpy(&value, position_, sizeof(value));
+                position_ += sizeof(value);
+                return value;
+            }
+
+            [[nodiscard]] bool IsComplete() const { return ok && position_ == end_; }
+
+        private:
+            const std::byte* position_;
+            const std::byte* end_;
+        };
+
+        template <typename IsPresent>
+        void PutPresence(ColumnWriter& column, const std::vector<FeatureRow>& rows, IsPresent isPresent)
+        {
+            std::vector<uint64_t> runs;
+            bool present = false;
+            uint64_t run = 0;
+            for (const auto& row : rows)
+            {
+                if (isPresent(row) != present)
+                {
+                    runs.push_back(run);
+                    run = 0;
+                    present = !present;
+                }
+                ++run;
+            }
+            runs.push_back(run);
+
+            column.PutVarint(runs.size());
+            for (const uint64_t length : runs)
+            {
+                column.PutVarint(length);
+            }
+        }
+
+        bool GetPresence(ColumnReader& column, const size_t rowCount, std::vector<bool>& present)
+        {
+            present.clear();
+            const uint64_t runCount = column.GetVarint();
+            if (runCount > rowCount + 1)
+            {
+                return false;
+            }
+
+            bool state = false;
+            for (uint64_t i = 0; i < runCount && column.ok; ++i)
+            {
+                const uint64_t length = column.GetVarint();
+                if (length > rowCount - present.size())
+                {
+                    return false;
+                }
+                present.insert(present.end(), length, state);
+                state = !state;
+            }
+            return column.ok && present.size() == rowCount;
+        }
+
+        void PutChunkIndices(ColumnWriter& column, const std::vector<FeatureRow>& rows)
+        {
+            // Consecutive chunks are one run with delta 1
+            uint64_t previous = 0;
+            size_t i = 0;
+            while (i < rows.size())
+            {
+                const auto delta = static_cast<int64_t>(rows[i].chunkIndex - previous);
+                size_t end = i + 1;
+                while (end < rows.size() && static_cast<int64_t>(rows[end].chunkIndex - rows[end - 1].chunkIndex) ==
+                    delta)
+                {
+                    ++end;
+                }
+                column.PutVarint(end - i);
+                column.PutZigzag(delta);
+                previous = rows[end - 1].chunkIndex;
+                i = end;
+            }
+        }
+
+        bool GetChunkIndices(ColumnReader& column, FeatureRow* rows, const size_t rowCount)
+        {
+            uint64_t value = 0;
+            size_t i = 0;
+            while (i < rowCount && column.ok)
+            {
+                const uint64_t run = column.GetVarint();
+                const int64_t delta = column.GetZigzag();
+                if (run == 0 || run > rowCount - i)
+                {
+                    return false;
+                }
+                for (uint64_t r = 0; r < run; ++r)
+                {
+                    value += static_cast<uint64_t>(delta);
+                    rows[i++].chunkIndex = value;
+                }
+            }
+            return column.IsComplete() && i == rowCount;
+        }
+
+        void PutBpm(ColumnWriter& column, const std::vector<FeatureRow>& rows)
+        {
+            // The BPM changes rarely, runs of the same value are stored once
+            PutPresence(column, rows, [](const FeatureRow& row) { return row.bpm.has_value(); });
+            size_t i = 0;
+            while (i < rows.size())
+            {
+                if (!rows[i].bpm)
+                {
+                    ++i;
+                    continue;
+                }
+                const auto bits = std::bit_cast<uint32_t>(*rows[i].bpm);
+                size_t end = i + 1;
+                uint64_t run = 1;
+                while (end < rows.size() && (!rows[end].bpm || std::bit_cast<uint32_t>(*rows[end].bpm) == bits))
+                {
+                    run += rows[end].bpm ? 1 : 0;
+                    ++end;
+                }
+                column.PutVarint(run);
+                column.PutFloat(*rows[i].bpm);
+                i = end;
+            }
+        }
+
+        bool GetBpm(ColumnReader& column, FeatureRow* rows, const size_t rowCount)
+        {
+            std::vector<bool> present;
+            if (!GetPresence(column, rowCount, present))
+            {
+                return false;
+            }
+            uint64_t run = 0;
+            float value = 0.0f;
+            for (size_t i = 0; i < rowCount; ++i)
+            {
+                if (!present[i])
+                {
+                    continue;
+                }
+                if (run == 0)
+                {
+                    run = column.GetVarint();
+                    value = column.GetFloat();
+                    if (run == 0 || !column.ok)
+                    {
+                        return false;
+                    }
+                }
+                rows[i].bpm = value;
+                --run;
+            }
+            return column.IsComplete() && run == 0;
+        }
+
+        void AppendColumn(std::vector<std::byte>& output, const ColumnWriter& column)
+        {
+            const auto size = static_cast<uint32_t>(column.bytes.size());
+            const auto* sizeBytes = reinterpret_cast<const std::byte*>(&size);
+            output.insert(output.end(), sizeBytes, sizeBytes + sizeof(size));
+            output.insert(output.end(), column.bytes.begin(), column.bytes.end());
+        }
+
+        // The next column of a payload, empty and not ok if the payload ends early
+        ColumnReader NextColumn(const std::byte*& input, const std::byte* end)
+        {
+            uint32_t size = 0;
+            if (end - input < static_cast<std::ptrdiff_t>(sizeof(size)))
+            {
+                ColumnReader column(input, 0);
+                column.ok = false;
+                return column;
+            }
+            std::memcpy(&size, input, sizeof(size));
+            input += sizeof(size);
+            if (static_cast<size_t>(end - input) < size)
+            {
+                ColumnReader column(input, 0);
+                column.ok = false;
+                return column;
+            }
+            ColumnReader column(input, size);
+            input += size;
+            return column;
+        }
+    }
+
+    void EncodeFeatureBlock(const std::vector<FeatureRow>& rows, std::vector<std::byte>& output)
+    {
+        output.clear();
+        ColumnWriter column;
+
+        PutChunkIndices(column, rows);
+        AppendColumn(output, column);
+
+        column.bytes.clear();
+        for (const auto& row : rows)
+        {
+            column.PutFloat(row.energy);
+        }
+        AppendColumn(output, column);
+
+        column.bytes.clear();
+        for (const auto& row : rows)
+        {
+            column.PutFloat(row.onsetStrength);
+        }
+        AppendColumn(output, column);
+
+        column.bytes.clear();
+        PutPresence(column, rows, [](const FeatureRow& row) { return row.peakIndices.has_value(); });
+        for (const auto& row : rows)
+        {
+            if (row.peakIndices)
+            {
+                column.PutVarint(row.peakIndices->size());
+                uint64_t previous = 0;
+                for (const uint64_t peak : *row.peakIndices)
+                {
+                    column.PutZigzag(static_cast<int64_t>(peak - previous));
+                    previous = peak;
+                }
+            }
+        }
+        AppendColumn(output, column);
+
+        column.bytes.clear();
+        PutPresence(column, rows, [](const FeatureRow& row) { return row.interOnsetIntervals.has_value(); });
+        for (const auto& row : rows)
+        {
+            if (row.interOnsetIntervals)
+            {
+                column.PutVarint(row.interOnsetIntervals->size());
+                for (const float interval : *row.interOnsetIntervals)
+                {
+                    column.PutFloat(interval);
+                }
+            }
+        }
+        AppendColumn(output, column);
+
+        column.bytes.clear();
+        PutPresence(column, rows, [](const FeatureRow& row) { return row.dominantInterval.has_value(); });
+        for (const auto& row : rows)
+        {
+            if (row.dominantInterval)
+            {
+                column.PutFloat(*row.dominantInterval);
+            }
+        }
+        AppendColumn(output, column);
+
+        column.bytes.clear();
+        PutBpm(column, rows);
+        AppendColumn(output, column);
+    }
+
+    bool DecodeFeatureBlock(const std::byte* input, const size_t bytes, const size_t rowCount,
+                            std::vector<FeatureRow>& rows)
+    {
+        // Energy and onset strength take 8 bytes per row, more rows can not be in there
+        if (rowCount > bytes / (2 * sizeof(float)))
+        {
+            return false;
+        }
+
+        const std::byte* end = input + bytes;
+        const size_t first = rows.size();
+        rows.resize(first + rowCount);
+        FeatureRow* block = rows.data() + first;
+        std::vector<bool> present;
+
+        const auto fail = [&rows, first]
+        {
+            rows.resize(first);
+            return false;
+        };
+
+        if (auto column = NextColumn(input, end); !GetChunkIndices(column, block, rowCount))
+        {
+            return fail();
+        }
+
+        auto energy = NextColumn(input, end);
+        for (size_t i = 0; i < rowCount; ++i)
+        {
+            block[i].energy = energy.GetFloat();
+        }
+        auto onsetStrength = NextColumn(input, end);
+        for (size_t i = 0; i < rowCount; ++i)
+        {
+            block[i].onsetStrength = onsetStrength.GetFloat();
+        }
+        if (!energy.IsComplete() || !onsetStrength.IsComplete())
+        {
+            return fail();
+        }
+
+        auto peaks = NextColumn(input, end);
+        if (!GetPresence(peaks, rowCount, present))
+        {
+            return fail();
+        }
+        for (size_t i = 0; i < rowCount && peaks.ok; ++i)
+        {
+            if (!present[i])
+            {
+                continue;
+            }
+            const uint64_t count = peaks.GetVarint();
+            if (count > bytes)
+            {
+                return fail(); // Every peak takes at least a byte
+            }
+            auto& indices = block[i].peakIndices.emplace();
+            indices.reserve(count);
+            uint64_t value = 0;
+            for (uint64_t p = 0; p < count; ++p)
+            {
+                value += static_cast<uint64_t>(peaks.GetZigzag());
+                indices.push_back(value);
+            }
+        }
+        if (!peaks.IsComplete())
+        {
+            return fail();
+        }
+
+        auto intervals = NextColumn(input, end);
+        if (!GetPresence(intervals, rowCount, present))
+        {
+            return fail();
+        }
+        for (size_t i = 0; i < rowCount && intervals.ok; ++i)
+        {
+            if (!present[i])
+            {
+                continue;
+            }
+            const uint64_t count = intervals.GetVarint();
+            if (count > bytes / sizeof(float))
+            {
+                return fail();
+            }
+            auto& values = block[i].interOnsetIntervals.emplace();
+            values.reserve(count);
+            for (uint64_t v = 0; v < count; ++v)
+            {
+                values.push_back(intervals.GetFloat());
+            }
+        }
+        if (!intervals.IsComplete())
+        {
+            return fail();
+        }
+
+        auto dominant = NextColumn(input, end);
+        if (!GetPresence(dominant, rowCount, present))
+        {
+            return fail();
+        }
+        for (size_t i = 0; i < rowCount; ++i)
+        {
+            if (present[i])
+            {
+                block[i].dominantInterval = dominant.GetFloat();
+            }
+        }
+        if (!dominant.IsComplete())
+        {
+            return fail();
+        }
+
+        if (auto column = NextColumn(input, end); !GetBpm(column, block, rowCount) || input != end)
+        {
+            return fail();
+        }
+        return true;
+    }
+}
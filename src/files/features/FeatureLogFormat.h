@@ -0,0 +1,76 @@
+//
+// Created by Robert on 2025-11-13.
+//
+
+#pragma once
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace bpmfinder::files::features
+{
+    // What the pipeline knows about one chunk after the last stage, without the audio
+    struct FeatureRow
+    {
+        uint64_t chunkIndex = 0;
+        float energy = 0.0f;
+        float onsetStrength = 0.0f;
+        std::optional<std::vector<uint64_t>> peakIndices;
+        std::optional<std::vector<float>> interOnsetIntervals;
+        std::optional<float> dominantInterval;
+        std::optional<float> bpm;
+
+        bool operator==(const FeatureRow&) const = default;
+    };
+
+    // Feature log file (*.bpmf), little endian:
+    //
+    //   FeatureLogHeader                      sample rate and chunk size of the analysis
+    //   FeatureBlockHeader, payload           up to rowsPerBlock rows each
+    //   ...
+    //
+    // A payload holds the rows of its block column by column, every column prefixed with its size in bytes:
+    //
+    //   chunkIndex          runs of equal deltas: (run length, zigzag delta) varint pairs
+    //   energy              float per row
+    //   onsetStrength       float per row
+    //   peakIndices         presence runs; per present row the count and zigzag deltas, varints
+    //   interOnsetIntervals presence runs; per present row the count (varint) and floats
+    //   dominantInterval    presence runs; float per present row
+    //   bpm                 presence runs; runs of equal values: (run length varint, float) pairs
+    //
+    // Presence runs are the number of runs, then their lengths, alternating between absent and present, starting
+    // with absent: the aggregated fields are only set for some chunks, that costs a few bytes per block.
+
+    static_assert(std::endian::native == std::endian::little, "Feature logs are read and written in host byte order");
+
+    inline constexpr char FeatureLogMagic[8] = {'B', 'P', 'M', 'F', 'E', 'A', 'T', '\n'};
+    inline constexpr uint32_t FeatureBlockMagic = 0x4B4C4246; // "FBLK"
+    inline constexpr uint32_t FeatureLogVersion = 1;
+
+    struct FeatureLogHeader
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t sampleRate;
+        uint32_t chunkSize;
+        uint8_t reserved[12];
+    };
+
+    struct FeatureBlockHeader
+    {
+        uint32_t magic;
+        uint32_t rowCount;
+        uint32_t payloadBytes;
+        uint32_t checksum; // CRC-32 of the payload
+    };
+
+    static_assert(sizeof(FeatureLogHeader) == 32 && sizeof(FeatureBlockHeader) == 16);
+
+    void EncodeFeatureBlock(const std::vector<FeatureRow>& rows, std::vector<std::byte>& output);
+
+    // Appends the rows of one payload. False if it does not decode to exactly rowCount rows.
+    bool DecodeFeatureBlock(const std::byte* input, size_t bytes, size_t rowCount, std::vector<FeatureRow>& rows);
+}
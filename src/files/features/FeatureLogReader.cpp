@@ -0,0 +1,102 @@
+//
+// Created by Robert on 2025-11-13.
+//
+
+#include "FeatureLogReader.h"
+#include <cstring>
+#include "files/Crc32.h"
+#include "logging/LoggerFactory.h"
+
+namespace bpmfinder::files::features
+{
+    FeatureLogReader::FeatureLogReader() :
+        logger_(logging::LoggerFactory::GetLogger("FeatureLogReader"))
+    {
+    }
+
+    bool FeatureLogReader::Open(const std::string& filename)
+    {
+        Close();
+        if (!file_.Open(filename))
+        {
+            logger_->error("Failed to open feature log: {}", filename);
+            return false;
+        }
+
+        const size_t size = file_.GetSize();
+        if (size < sizeof(FeatureLogHeader))
+        {
+            logger_->error("{} is too short for a feature log", filename);
+            Close();
+            return false;
+        }
+        std::memcpy(&header_, file_.GetData(), sizeof(header_));
+        if (std::memcmp(header_.magic, FeatureLogMagic, sizeof(FeatureLogMagic)) != 0 ||
+            header_.version != FeatureLogVersion)
+        {
+            logger_->error("{} is not a feature log of version {}", filename, FeatureLogVersion);
+            Close();
+            return false;
+        }
+
+        size_t offset = sizeof(FeatureLogHeader);
+        while (offset + sizeof(FeatureBlockHeader) <= size)
+        {
+            FeatureBlockHeader block;
+            std::memcpy(&block, file_.GetData() + offset, sizeof(block));
+            if (block.magic != FeatureBlockMagic || block.payloadBytes > size - offset - sizeof(block) ||
+                block.rowCount > block.payloadBytes / (2 * sizeof(float)))
+            {
+                break;
+            }
+            blocks_.push_back(offset);
+            rowCount_ += block.rowCount;
+            offset += sizeof(block) + block.payloadBytes;
+        }
+        if (offset != size)
+        {
+            logger_->warn("{} ends with {} bytes that are not a complete block", filename, size - offset);
+        }
+        return true;
+    }
+
+    void FeatureLogReader::Close()
+    {
+        file_.Close();
+        header_ = {};
+        blocks_.clear();
+        rowCount_ = 0;
+    }
+
+    bool FeatureLogReader::ReadBlock(const size_t block, std::vector<FeatureRow>& rows) const
+    {
+        if (block >= blocks_.size())
+        {
+            return false;
+        }
+
+        FeatureBlockHeader header;
+        std::memcpy(&header, file_.GetData() + blocks_[block], sizeof(header));
+        const std::byte* payload = file_.GetData() + blocks_[block] + sizeof(header);
+        if (Crc32(payload, header.payloadBytes) != header.checksum ||
+            !DecodeFeatureBlock(payload, header.payloadBytes, header.rowCount, rows))
+        {
+            logger_->error("Feature block {} at offset {} is damaged", block, blocks_[block]);
+            return false;
+        }
+        return true;
+    }
+
+    bool FeatureLogReader::ReadAll(std::vector<FeatureRow>& rows) const
+    {
+        rows.reserve(rows.size() + rowCount_);
+        for (size_t block = 0; block < blocks_.size(); ++block)
+        {
+            if (!ReadBlock(block, rows))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+}
@@ -0,0 +1,47 @@
+//
+// Created by Robert on 2025-11-13.
+//
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "FeatureLogFormat.h"
+#include "files/MemoryMappedFile.h"
+#include "spdlog/logger.h"
+
+namespace bpmfinder::files::features
+{
+    // Reads a feature log (see FeatureLogFormat.h). Open maps the file and walks the block headers; blocks are only
+    // decoded when they are read. A log whose writer died ends with its last complete block.
+    class FeatureLogReader
+    {
+    public:
+        FeatureLogReader();
+
+        bool Open(const std::string& filename);
+        void Close();
+
+        [[nodiscard]] bool IsOpen() const { return file_.IsOpen(); }
+        [[nodiscard]] uint32_t GetSampleRate() const { return header_.sampleRate; }
+        [[nodiscard]] uint32_t GetChunkSize() const { return header_.chunkSize; }
+        [[nodiscard]] size_t GetBlockCount() const { return blocks_.size(); }
+        [[nodiscard]] uint64_t GetRowCount() const { return rowCount_; }
+
+        // Appends the rows of one block. False if the block is damaged, nothing is appended then.
+        bool ReadBlock(size_t block, std::vector<FeatureRow>& rows) const;
+
+        // All rows of all blocks up to the first damaged one
+        bool ReadAll(std::vector<FeatureRow>& rows) const;
+
+    private:
+        MemoryMappedFile file_;
+        FeatureLogHeader header_{};
+        std::vector<size_t> blocks_; // Offsets of the block headers
+        uint64_t rowCount_ = 0;
+
+        std::shared_ptr<spdlog::logger> logger_;
+    };
+}
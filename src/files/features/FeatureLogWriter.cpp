@@ -0,0 +1,72 @@
+//
+// Created by Robert on 2025-11-13.
+//
+
+#include "FeatureLogWriter.h"
+#include <algorithm>
+#include <cstring>
+#include "files/Crc32.h"
+
+namespace bpmfinder::files::features
+{
+    FeatureLogWriter::FeatureLogWriter(WriteBehindFile& file, const FeatureLogOptions& options) :
+        file_(file),
+        options_(options)
+    {
+        options_.rowsPerBlock = std::max<uint32_t>(1, options_.rowsPerBlock);
+        rows_.reserve(options_.rowsPerBlock);
+
+        FeatureLogHeader header{};
+        std::memcpy(header.magic, FeatureLogMagic, sizeof(header.magic));
+        header.version = FeatureLogVersion;
+        header.sampleRate = options_.sampleRate;
+        header.chunkSize = options_.chunkSize;
+        file_.Append(&header, sizeof(header));
+    }
+
+    void FeatureLogWriter::Append(FeatureRow row)
+    {
+        rows_.push_back(std::move(row));
+        ++rowCount_;
+        if (rows_.size() == options_.rowsPerBlock)
+        {
+            WriteBlock();
+        }
+    }
+
+    void FeatureLogWriter::Flush()
+    {
+        if (!finished_ && !rows_.empty())
+        {
+            WriteBlock();
+        }
+    }
+
+    void FeatureLogWriter::Finish()
+    {
+        if (finished_)
+        {
+            return;
+        }
+        finished_ = true;
+        if (!rows_.empty())
+        {
+            WriteBlock();
+        }
+    }
+
+    void FeatureLogWriter::WriteBlock()
+    {
+        EncodeFeatureBlock(rows_, encoded_);
+
+        FeatureBlockHeader header{};
+        header.magic = FeatureBlockMagic;
+        header.rowCount = static_cast<uint32_t>(rows_.size());
+        header.payloadBytes = static_cast<uint32_t>(encoded_.size());
+        header.checksum = Crc32(encoded_.data(), encoded_.size());
+        file_.Append(&header, sizeof(header));
+        file_.Append(encoded_.data(), encoded_.size());
+
+        rows_.clear();
+    }
+}
@@ -0,0 +1,48 @@
+//
+// Created by Robert on 2025-11-13.
+//
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "FeatureLogFormat.h"
+#include "files/WriteBehindFile.h"
+
+namespace bpmfinder::files::features
+{
+    struct FeatureLogOptions
+    {
+        uint32_t sampleRate = 48000;
+        uint32_t chunkSize = 512;
+        uint32_t rowsPerBlock = 1024;
+    };
+
+    // Writes a feature log (see FeatureLogFormat.h) into an open WriteBehindFile. Rows are collected until a block is
+    // full, then encoded column by column and appended as one piece.
+    class FeatureLogWriter
+    {
+    public:
+        FeatureLogWriter(WriteBehindFile& file, const FeatureLogOptions& options);
+
+        void Append(FeatureRow row);
+
+        // Writes the rows collected so far as a shorter block, so the file holds them once it is flushed
+        void Flush();
+
+        // Writes the last, shorter block. Called once, before the file is closed.
+        void Finish();
+
+        [[nodiscard]] uint64_t GetRowCount() const { return rowCount_; }
+
+    private:
+        void WriteBlock();
+
+        WriteBehindFile& file_;
+        FeatureLogOptions options_;
+        std::vector<FeatureRow> rows_;
+        std::vector<std::byte> encoded_;
+        uint64_t rowCount_ = 0;
+        bool finished_ = false;
+    };
+}
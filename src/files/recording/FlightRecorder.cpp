@@ -0,0 +1,357 @@
+//
+// Created by Robert on 2025-11-14.
+//
+
+#include "FlightRecorder.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <vector>
+#include "RecordingWriter.h"
+#include "files/WriteBehindFile.h"
+#include "files/features/FeatureLogWriter.h"
+#include "logging/LoggerFactory.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace bpmfinder::files::recording
+{
+    namespace
+    {
+        constexpr char FlightRecorderMagic[8] = {'B', 'P', 'M', 'F', 'L', 'T', 'R', '\n'};
+        constexpr uint32_t FlightRecorderVersion = 1;
+        constexpr size_t PageSize = 4096;
+
+        // Features arrive after the audio they belong to, the pipeline is in between: room for a few more chunks
+        constexpr uint64_t ExtraRecords = 64;
+
+        constexpr size_t RoundUpToPage(const size_t bytes)
+        {
+            return (bytes + PageSize - 1) / PageSize * PageSize;
+        }
+
+        // Single writer. 'reserved' announces what is about to be overwritten before the data changes, 'written'
+        // publishes it afterwards, like the two halves of a seqlock.
+        template <typename T>
+        void WriteRing(T* ring, const uint64_t capacity, uint64_t& reservedField, uint64_t& writtenField,
+                       const T* items, size_t count)
+        {
+            std::atomic_ref reserved(reservedField);
+            std::atomic_ref written(writtenField);
+            const uint64_t end = written.load(std::memory_order_relaxed) + count;
+
+            // Of a write longer than the ring only its end survives
+            if (count > capacity)
+            {
+                items += count - capacity;
+                count = static_cast<size_t>(capacity);
+            }
+
+            reserved.store(end, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+
+            const auto position = static_cast<size_t>((end - count) % capacity);
+            const size_t first = std::min<size_t>(count, static_cast<size_t>(capacity) - position);
+            std::memcpy(ring + position, items, first * sizeof(T));
+            std::memcpy(ring, items + first, (count - first) * sizeof(T));
+
+            written.store(end, std::memory_order_release);
+        }
+
+        // Copies what is in the ring and returns the stream position of its first item. Items the writer may have
+        // overwritten while they were copied are dropped from the front.
+        template <typename T>
+        uint64_t CopyRing(const T* ring, const uint64_t capacity, uint64_t& reservedField, uint64_t& writtenField,
+                          std::vector<T>& items)
+        {
+            std::atomic_ref reserved(reservedField);
+            std::atomic_ref written(writtenField);
+
+            const uint64_t end = written.load(std::memory_order_acquire);
+            const uint64_t start = end > capacity ? end - capacity : 0;
+            const auto count = static_cast<size_t>(end - start);
+            const auto position = static_cast<size_t>(start % capacity);
+            const size_t first = std::min<size_t>(count, static_cast<size_t>(capacity) - position);
+            items.resize(count);
+            std::memcpy(items.data(), ring + position, first * sizeof(T));
+            std::memcpy(items.data() + first, ring, (count - first) * sizeof(T));
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            const uint64_t reservedEnd = reserved.load(std::memory_order_relaxed);
+            const uint64_t valid = reservedEnd > capacity ? reservedEnd - capacity : 0;
+            if (valid <= start)
+            {
+                return start;
+            }
+            const auto overwritten = static_cast<size_t>(std::min<uint64_t>(valid - start, count));
+            items.erase(items.begin(), items.begin() + static_cast<std::ptrdiff_t>(overwritten));
+            return start + overwritten;
+        }
+    }
+
+    struct FlightRecorder::Header
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t sampleRate;
+        uint32_t chunkSize;
+        uint32_t reserved;
+        uint64_t capacityFrames;
+        uint64_t capacityRecords;
+
+        // Positions in the streams, readable by other processes mapping the file
+        alignas(64) uint64_t reservedFrames;
+        uint64_t writtenFrames;
+        alignas(64) uint64_t reservedRecords;
+        uint64_t writtenRecords;
+    };
+
+    FlightRecorder::FlightRecorder() :
+        logger_(logging::LoggerFactory::GetLogger("FlightRecorder"))
+    {
+    }
+
+    FlightRecorder::~FlightRecorder()
+    {
+        Close();
+    }
+
+    FlightRecorder::Header& FlightRecorder::GetHeader() const
+    {
+        static_assert(sizeof(Header) <= PageSize);
+        return *reinterpret_cast<Header*>(data_);
+    }
+
+    bool FlightRecorder::Open(const std::string& filename, const FlightRecorderOptions& options)
+    {
+        Close();
+
+        options_ = options;
+        options_.chunkSize = std::max<uint32_t>(1, options_.chunkSize);
+        const auto chunks = std::max<uint64_t>(
+            1, static_cast<uint64_t>(std::ceil(options_.seconds * options_.sampleRate / options_.chunkSize)));
+        capacityFrames_ = chunks * options_.chunkSize;
+        capacityRecords_ = chunks + ExtraRecords;
+
+        const size_t audioBytes = RoundUpToPage(static_cast<size_t>(capacityFrames_) * sizeof(float));
+        const size_t recordBytes = RoundUpToPage(static_cast<size_t>(capacityRecords_) * sizeof(FlightRecord));
+        if (!Map(filename, PageSize + audioBytes + recordBytes))
+        {
+            logger_->error("Failed to map flight recorder file {}", filename);
+            return false;
+        }
+
+        // Touch every page now, so the writers never take a page fault for a fresh page
+        std::memset(data_, 0, size_);
+
+        auto& header = GetHeader();
+        std::memcpy(header.magic, FlightRecorderMagic, sizeof(header.magic));
+        header.version = FlightRecorderVersion;
+        header.sampleRate = options_.sampleRate;
+        header.chunkSize = options_.chunkSize;
+        header.capacityFrames = capacityFrames_;
+        header.capacityRecords = capacityRecords_;
+        audio_ = reinterpret_cast<float*>(data_ + PageSize);
+        records_ = reinterpret_cast<FlightRecord*>(data_ + PageSize + audioBytes);
+
+        logger_->info("Flight recorder {}: last {:.0f} s of audio, {} MB", filename,
+                      static_cast<double>(capacityFrames_) / options_.sampleRate, size_ / (1024 * 1024));
+        return true;
+    }
+
+    void FlightRecorder::Close()
+    {
+        Unmap();
+        audio_ = nullptr;
+        records_ = nullptr;
+    }
+
+    void FlightRecorder::WriteAudio(const float* samples, const size_t count)
+    {
+        auto& header = GetHeader();
+        WriteRing(audio_, capacityFrames_, header.reservedFrames, header.writtenFrames, samples, count);
+    }
+
+    void FlightRecorder::WriteFeatures(const FlightRecord& record)
+    {
+        auto& header = GetHeader();
+        WriteRing(records_, capacityRecords_, header.reservedRecords, header.writtenRecords, &record, 1);
+    }
+
+    uint64_t FlightRecorder::GetWrittenFrames() const
+    {
+        return std::atomic_ref(GetHeader().writtenFrames).load(std::memory_order_acquire);
+    }
+
+    double FlightRecorder::Snapshot(const std::string& prefix) const
+    {
+        if (!IsOpen())
+        {
+            return -1.0;
+        }
+
+        // Copy first, so the writers are only raced for as long as two memcpy take; the files are written afterwards
+        auto& header = GetHeader();
+        std::vector<float> audio;
+        std::vector<FlightRecord> records;
+        uint64_t firstFrame = CopyRing(audio_, capacityFrames_, header.reservedFrames, header.writtenFrames, audio);
+        CopyRing(records_, capacityRecords_, header.reservedRecords, header.writtenRecords, records);
+
+        // Start at a chunk boundary, so the features line up with the chunks of the recording
+        const uint64_t skip = std::min<uint64_t>((options_.chunkSize - firstFrame % options_.chunkSize) %
+                                                 options_.chunkSize, audio.size());
+        firstFrame += skip;
+        const uint64_t firstChunk = firstFrame / options_.chunkSize;
+        const uint64_t frames = audio.size() - skip;
+
+        WriteBehindFile audioFile;
+        WriteBehindFile featureFile;
+        if (!audioFile.Open(prefix + ".bpmr") || !featureFile.Open(prefix + ".bpmf"))
+        {
+            logger_->error("Failed to create snapshot files {}.bpmr/.bpmf", prefix);
+            return -1.0;
+        }
+
+        RecordingOptions recordingOptions;
+        recordingOptions.sampleRate = options_.sampleRate;
+        recordingOptions.channels = 1;
+        RecordingWriter recording(audioFile, recordingOptions);
+        recording.Write(audio.data() + skip, static_cast<size_t>(frames));
+        recording.Finish();
+
+        features::FeatureLogWriter featureLog(featureFile, {options_.sampleRate, options_.chunkSize});
+        for (const auto& record : records)
+        {
+            if (record.chunkIndex < firstChunk || (record.chunkIndex - firstChunk) * options_.chunkSize >= frames)
+            {
+                continue;
+            }
+            features::FeatureRow row;
+            row.chunkIndex = record.chunkIndex - firstChunk;
+            row.energy = record.energy;
+            row.onsetStrength = record.onsetStrength;
+            if ((record.flags & FlightRecord::HasDominantInterval) != 0)
+            {
+                row.dominantInterval = record.dominantInterval;
+            }
+            if ((record.flags & FlightRecord::HasBpm) != 0)
+            {
+                row.bpm = record.bpm;
+            }
+            featureLog.Append(std::move(row));
+        }
+        featureLog.Finish();
+
+        if (!audioFile.Close() || !featureFile.Close())
+        {
+            logger_->error("Failed to write snapshot files {}.bpmr/.bpmf", prefix);
+            return -1.0;
+        }
+
+        const double seconds = static_cast<double>(frames) / options_.sampleRate;
+        logger_->info("Snapshot {}.bpmr: {:.1f} s of audio from {:.1f} s on, {} feature rows", prefix, seconds,
+                      static_cast<double>(firstFrame) / options_.sampleRate, featureLog.GetRowCount());
+        return seconds;
+    }
+
+#ifdef _WIN32
+    bool FlightRecorder::Map(const std::string& filename, const size_t size)
+    {
+        HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr,
+                                  CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            return false;
+        }
+        fileHandle_ = file;
+
+        // The mapping sizes the file
+        const auto size64 = static_cast<uint64_t>(size);
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READWRITE, static_cast<DWORD>(size64 >> 32),
+                                           static_cast<DWORD>(size64 & 0xFFFFFFFF), nullptr);
+        if (mapping == nullptr)
+        {
+            Unmap();
+            return false;
+        }
+        mappingHandle_ = mapping;
+
+        data_ = static_cast<std::byte*>(MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size));
+        if (data_ == nullptr)
+        {
+            Unmap();
+            return false;
+        }
+        size_ = size;
+        return true;
+    }
+
+    void FlightRecorder::Unmap()
+    {
+        if (data_ != nullptr)
+        {
+            UnmapViewOfFile(data_);
+        }
+        if (mappingHandle_ != nullptr)
+        {
+            CloseHandle(mappingHandle_);
+        }
+        if (fileHandle_ != nullptr)
+        {
+            CloseHandle(fileHandle_);
+        }
+        data_ = nullptr;
+        mappingHandle_ = nullptr;
+        fileHandle_ = nullptr;
+        size_ = 0;
+    }
+#else
+    bool FlightRecorder::Map(const std::string& filename, const size_t size)
+    {
+        const int fd = ::open(filename.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd < 0)
+        {
+            return false;
+        }
+        fileDescriptor_ = fd;
+
+        if (::ftruncate(fd, static_cast<off_t>(size)) != 0)
+        {
+            Unmap();
+            return false;
+        }
+
+        void* mapping = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (mapping == MAP_FAILED)
+        {
+            Unmap();
+            return false;
+        }
+        data_ = static_cast<std::byte*>(mapping);
+        size_ = size;
+        return true;
+    }
+
+    void FlightRecorder::Unmap()
+    {
+        if (data_ != nullptr)
+        {
+            ::munmap(data_, size_);
+        }
+        if (fileDescriptor_ >= 0)
+        {
+            ::close(fileDescriptor_);
+        }
+        data_ = nullptr;
+        fileDescriptor_ = -1;
+        size_ = 0;
+    }
+#endif
+}
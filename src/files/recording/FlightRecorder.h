@@ -0,0 +1,98 @@
+//
+// Created by Robert on 2025-11-14.
+//
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include "spdlog/logger.h"
+
+namespace bpmfinder::files::recording
+{
+    struct FlightRecorderOptions
+    {
+        uint32_t sampleRate = 48000;
+        uint32_t chunkSize = 1024; // Frames per chunk, chunk indices of the features refer to it
+        double seconds = 300.0; // Audio kept, features for as many chunks
+    };
+
+    // Features of one chunk as the flight recorder keeps them: fixed size, so they fit into a ring
+    struct FlightRecord
+    {
+        uint64_t chunkIndex = 0;
+        float energy = 0.0f;
+        float onsetStrength = 0.0f;
+        float dominantInterval = 0.0f; // Only with HasDominantInterval
+        float bpm = 0.0f; // Only with HasBpm
+        uint32_t peakCount = 0;
+        uint32_t flags = 0;
+
+        static constexpr uint32_t HasDominantInterval = 1u << 0;
+        static constexpr uint32_t HasBpm = 1u << 1;
+    };
+
+    static_assert(sizeof(FlightRecord) == 32);
+
+    // Keeps the last N seconds of mono audio and the features of its chunks in two rings in a memory-mapped file of
+    // fixed size. Writing is a memcpy and two atomic stores, no allocation and no system call: the pages are touched
+    // once in Open. The OS writes dirty pages back in the background; put the file on tmpfs (/dev/shm) to keep it in
+    // memory only. A file on disk also keeps the last minutes across a crash.
+    //
+    // Snapshot copies both rings out while the writers keep going and writes them as a standalone recording and
+    // feature log. It never blocks the writers: samples a writer overwrote during the copy are cut off the front.
+    // One thread writes audio, one writes features, any thread takes snapshots.
+    class FlightRecorder
+    {
+    public:
+        FlightRecorder();
+        ~FlightRecorder();
+
+        FlightRecorder(const FlightRecorder&) = delete;
+        FlightRecorder& operator=(const FlightRecorder&) = delete;
+
+        // Creates or truncates the file, sizes and maps it
+        bool Open(const std::string& filename, const FlightRecorderOptions& options);
+        void Close();
+
+        [[nodiscard]] bool IsOpen() const { return data_ != nullptr; }
+        [[nodiscard]] const FlightRecorderOptions& GetOptions() const { return options_; }
+
+        void WriteAudio(const float* samples, size_t count);
+        void WriteFeatures(const FlightRecord& record);
+
+        // Audio frames written since Open, also those no longer in the ring
+        [[nodiscard]] uint64_t GetWrittenFrames() const;
+
+        // Writes prefix.bpmr (RecordingFormat.h) with the audio in the ring, starting at a chunk boundary, and
+        // prefix.bpmf (FeatureLogFormat.h) with the features of those chunks, chunk 0 being the first chunk of the
+        // recording. Peak indices are not kept, only their number. Returns the seconds of audio written, negative
+        // if the files could not be written.
+        double Snapshot(const std::string& prefix) const;
+
+    private:
+        struct Header;
+
+        [[nodiscard]] Header& GetHeader() const;
+        bool Map(const std::string& filename, size_t size);
+        void Unmap();
+
+        FlightRecorderOptions options_;
+        uint64_t capacityFrames_ = 0;
+        uint64_t capacityRecords_ = 0;
+        std::byte* data_ = nullptr;
+        size_t size_ = 0;
+        float* audio_ = nullptr;
+        FlightRecord* records_ = nullptr;
+
+#ifdef _WIN32
+        void* fileHandle_ = nullptr;
+        void* mappingHandle_ = nullptr;
+#else
+        int fileDescriptor_ = -1;
+#endif
+
+        std::shared_ptr<spdlog::logger> logger_;
+    };
+}
@@ -0,0 +1,76 @@
+//
+// Created by Robert on 2025-11-14.
+//
+
+#pragma once
+#include "FlightRecorder.h"
+#include "audio/IAudioSource.h"
+#include "core/CopySink.h"
+#include "dsp/time_domain_onset_detection/TimeDomainOnsetDetectionResult.h"
+
+namespace bpmfinder::files::recording
+{
+    // Feeds the mono input of the pipeline into a FlightRecorder. The recorder is not owned.
+    class FlightRecorderAudioSink : public core::CopySink<audio::AudioChunk>
+    {
+    public:
+        explicit FlightRecorderAudioSink(FlightRecorder& recorder) :
+            recorder_(recorder)
+        {
+        }
+
+        ~FlightRecorderAudioSink() override
+        {
+            Stop();
+        }
+
+    protected:
+        void Process(const audio::AudioChunk data) override
+        {
+            recorder_.WriteAudio(data.data(), data.size());
+        }
+
+    private:
+        FlightRecorder& recorder_;
+    };
+
+    // Feeds the features of every result into a FlightRecorder. The recorder is not owned.
+    class FlightRecorderFeatureSink
+        : public core::CopySink<dsp::time_domain_onset_detection::TimeDomainOnsetDetectionResult>
+    {
+    public:
+        explicit FlightRecorderFeatureSink(FlightRecorder& recorder) :
+            recorder_(recorder)
+        {
+        }
+
+        ~FlightRecorderFeatureSink() override
+        {
+            Stop();
+        }
+
+    protected:
+        void Process(const dsp::time_domain_onset_detection::TimeDomainOnsetDetectionResult data) override
+        {
+            FlightRecord record;
+            record.chunkIndex = data.chunkIndex;
+            record.energy = data.energy;
+            record.onsetStrength = data.onsetStrength;
+            record.peakCount = data.peakIndices ? static_cast<uint32_t>(data.peakIndices->size()) : 0;
+            if (data.dominantInterval)
+            {
+                record.dominantInterval = *data.dominantInterval;
+                record.flags |= FlightRecord::HasDominantInterval;
+            }
+            if (data.bpm)
+            {
+                record.bpm = *data.bpm;
+                record.flags |= FlightRecord::HasBpm;
+            }
+            recorder_.WriteFeatures(record);
+        }
+
+    private:
+        FlightRecorder& recorder_;
+    };
+}
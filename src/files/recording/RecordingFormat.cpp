@@ -0,0 +1,126 @@
+//
+// Created by Robert on 2025-11-12.
+//
+
+#include "RecordingFormat.h"
+#include <algorithm>
+#include <iterator>
+
+namespace bpmfinder::files::recording
+{
+    namespace
+    {
+        // The 4 bit code of a sample: which bytes of the XOR delta are stored. Code 0 is a delta of 0, the others
+        // are 'length' bytes starting 'shift' bytes above the lowest one, every window that fits into 4 bytes.
+        struct ByteWindow
+        {
+            uint32_t shift;
+            uint32_t length;
+        };
+
+        constexpr ByteWindow ByteWindows[] = {
+            {0, 0},
+            {0, 1}, {1, 1}, {2, 1}, {3, 1},
+            {0, 2}, {1, 2}, {2, 2},
+            {0, 3}, {1, 3},
+            {0, 4}
+        };
+
+        constexpr uint32_t CodeOf(const uint32_t shift, const uint32_t length)
+        {
+            for (uint32_t code = 0; code < std::size(ByteWindows); ++code)
+            {
+                if (ByteWindows[code].shift == shift && ByteWindows[code].length == length)
+                {
+                    return code;
+                }
+            }
+            return 0;
+        }
+
+        // Audio samples close to each other share sign, exponent and top of the mantissa: the high bytes of the
+        // delta are zero. Samples from 16 or 24 bit sources leave the low bytes of the mantissa unused: so are the
+        // low bytes of the delta.
+        ByteWindow WindowOf(const uint32_t delta)
+        {
+            if (delta == 0)
+            {
+                return {0, 0};
+            }
+            const auto shift = static_cast<uint32_t>(std::countr_zero(delta)) / 8;
+            const auto top = static_cast<uint32_t>(std::countl_zero(delta)) / 8;
+            return {shift, 4 - shift - top};
+        }
+    }
+
+    void EncodeXorBytes(const float* samples, const size_t frames, const size_t channels,
+                        std::vector<std::byte>& output)
+    {
+        const size_t count = frames * channels;
+        output.clear();
+        output.reserve(count * sizeof(float) + (count + 1) / 2);
+
+        std::vector<uint32_t> previous(channels, 0);
+        for (size_t i = 0; i < count; i += 2)
+        {
+            const size_t controlPosition = output.size();
+            output.push_back(std::byte{0});
+
+            const size_t pairEnd = std::min(i + 2, count);
+            for (size_t j = i; j < pairEnd; ++j)
+            {
+                const size_t channel = j % channels;
+                const auto bits = std::bit_cast<uint32_t>(samples[j]);
+                const uint32_t delta = bits ^ previous[channel];
+                previous[channel] = bits;
+
+                const ByteWindow window = WindowOf(delta);
+                output[controlPosition] |= static_cast<std::byte>(CodeOf(window.shift, window.length) << ((j - i) * 4));
+                for (uint32_t b = 0; b < window.length; ++b)
+                {
+                    output.push_back(static_cast<std::byte>(delta >> ((window.shift + b) * 8)));
+                }
+            }
+        }
+    }
+
+    bool DecodeXorBytes(const std::byte* input, const size_t bytes, const size_t frames, const size_t channels,
+                        float* output)
+    {
+        const size_t count = frames * channels;
+        const std::byte* end = input + bytes;
+
+        std::vector<uint32_t> previous(channels, 0);
+        for (size_t i = 0; i < count; i += 2)
+        {
+            if (input == end)
+            {
+                return false;
+            }
+            const auto control = static_cast<uint32_t>(*input++);
+
+            const size_t pairEnd = std::min(i + 2, count);
+            for (size_t j = i; j < pairEnd; ++j)
+            {
+                const uint32_t code = (control >> ((j - i) * 4)) & 0x0F;
+                if (code >= std::size(ByteWindows) || static_cast<size_t>(end - input) < ByteWindows[code].length)
+                {
+                    return false;
+                }
+
+                const ByteWindow window = ByteWindows[code];
+                uint32_t delta = 0;
+                for (uint32_t b = 0; b < window.length; ++b)
+                {
+                    delta |= static_cast<uint32_t>(input[b]) << ((window.shift + b) * 8);
+                }
+                input += window.length;
+
+                const size_t channel = j % channels;
+                previous[channel] ^= delta;
+                output[j] = std::bit_cast<float>(previous[channel]);
+            }
+        }
+        return input == end;
+    }
+}
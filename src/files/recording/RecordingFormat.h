@@ -0,0 +1,87 @@
+//
+// Created by Robert on 2025-11-12.
+//
+
+#pragma once
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace bpmfinder::files::recording
+{
+    // Recording file (*.bpmr), little endian:
+    //
+    //   RecordingHeader                      sample rate, channels, frames per block
+    //   BlockHeader, payload                 blockFrames frames each, the last block may be shorter
+    //   ...
+    //   uint64_t offset[blockCount]          of every BlockHeader, the index
+    //   RecordingFooter                      where the index starts, number of blocks and frames
+    //
+    // Blocks are independent of each other, so any frame can be read by decoding one block. The footer is written
+    // last; a file without one (the writer died) can still be read by walking the block headers.
+
+    static_assert(std::endian::native == std::endian::little, "Recordings are read and written in host byte order");
+
+    inline constexpr char RecordingMagic[8] = {'B', 'P', 'M', 'R', 'E', 'C', '\r', '\n'};
+    inline constexpr char FooterMagic[8] = {'B', 'P', 'M', 'R', 'I', 'D', 'X', '\n'};
+    inline constexpr uint32_t BlockMagic = 0x4B4C4230; // "0BLK"
+    inline constexpr uint32_t RecordingVersion = 1;
+
+    // Limits a reader accepts, so a corrupt header cannot make it allocate an arbitrary decode buffer
+    inline constexpr uint32_t MaxRecordingChannels = 1024;
+    inline constexpr uint32_t MaxRecordingBlockFrames = 1u << 20;
+
+    enum RecordingFlags : uint32_t
+    {
+        Checksums = 1u << 0, // Every block carries the CRC-32 of its payload
+        Compression = 1u << 1 // Blocks may be XorBytes encoded
+    };
+
+    enum class BlockEncoding : uint32_t
+    {
+        Raw = 0, // Interleaved floats
+        XorBytes = 1 // See EncodeXorBytes
+    };
+
+    struct RecordingHeader
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t sampleRate;
+        uint32_t channels;
+        uint32_t blockFrames;
+        uint32_t flags;
+        uint8_t reserved[36];
+    };
+
+    struct BlockHeader
+    {
+        uint32_t magic;
+        uint32_t frames;
+        uint32_t payloadBytes;
+        uint32_t checksum; // CRC-32 of the payload, 0 without RecordingFlags::Checksums
+        BlockEncoding encoding;
+        uint32_t reserved;
+    };
+
+    struct RecordingFooter
+    {
+        uint64_t indexOffset;
+        uint64_t blockCount;
+        uint64_t frameCount;
+        char magic[8];
+    };
+
+    static_assert(sizeof(RecordingHeader) == 64 && sizeof(BlockHeader) == 24 && sizeof(RecordingFooter) == 32);
+
+    // Lossless compression of interleaved float frames. Every sample is XORed with the previous sample of its channel:
+    // neighbouring samples of audio share sign, exponent and the top of the mantissa, so the high bytes of the result
+    // are mostly zero, and samples from 16 or 24 bit sources leave its low bytes zero too. Only the bytes in between
+    // are stored, which ones in a 4 bit code, two codes per control byte in front of the two samples. Silence takes
+    // half a byte per sample, full-scale noise 4.5.
+    void EncodeXorBytes(const float* samples, size_t frames, size_t channels, std::vector<std::byte>& output);
+
+    // False if the payload ends early or has bytes left over
+    bool DecodeXorBytes(const std::byte* input, size_t bytes, size_t frames, size_t channels, float* output);
+}
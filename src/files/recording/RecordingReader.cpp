@@ -0,0 +1,270 @@
+//
+// Created by Robert on 2025-11-12.
+//
+
+#include "RecordingReader.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include "files/Crc32.h"
+#include "logging/LoggerFactory.h"
+
+namespace bpmfinder::files::recording
+{
+    RecordingReader::RecordingReader() :
+        logger_(logging::LoggerFactory::GetLogger("RecordingReader"))
+    {
+    }
+
+    bool RecordingReader::IsRecording(const std::string& filename)
+    {
+        std::ifstream file(filename, std::ios::binary);
+        char magic[sizeof(RecordingMagic)] = {};
+        file.read(magic, sizeof(magic));
+        return file.gcount() == sizeof(magic) && std::memcmp(magic, RecordingMagic, sizeof(magic)) == 0;
+    }
+
+    bool RecordingReader::Open(const std::string& filename)
+    {
+        Close();
+        if (!file_.Open(filename))
+        {
+            logger_->error("Failed to open recording: {}", filename);
+            return false;
+        }
+
+        if (file_.GetSize() < sizeof(RecordingHeader))
+        {
+            logger_->error("{} is too short for a recording", filename);
+            Close();
+            return false;
+        }
+
+        std::memcpy(&header_, file_.GetData(), sizeof(header_));
+        if (std::memcmp(header_.magic, RecordingMagic, sizeof(RecordingMagic)) != 0 ||
+            header_.version != RecordingVersion)
+        {
+            logger_->error("{} is not a recording of version {}", filename, RecordingVersion);
+            Close();
+            return false;
+        }
+
+        if (header_.channels == 0 || header_.channels > MaxRecordingChannels || header_.blockFrames == 0 ||
+            header_.blockFrames > MaxRecordingBlockFrames)
+        {
+            logger_->error("{} has an invalid header: {} channels, blocks of {} frames", filename, header_.channels,
+                           header_.blockFrames);
+            Close();
+            return false;
+        }
+
+        if (!ReadIndexFromFooter())
+        {
+            RebuildIndex();
+            logger_->warn("{} has no index, recovered {} blocks with {} frames", filename, blockCount_, frameCount_);
+        }
+
+        // No block has more frames than the recording, and every sample takes at least half a byte of the file
+        const uint64_t blockSamples = std::min<uint64_t>(header_.blockFrames, frameCount_) * header_.channels;
+        if (blockSamples / 2 > file_.GetSize())
+        {
+            logger_->error("{} is too short for blocks of {} frames with {} channels", filename, header_.blockFrames,
+                           header_.channels);
+            Close();
+            return false;
+        }
+
+        decoded_.resize(static_cast<size_t>(blockSamples));
+        return true;
+    }
+
+    void RecordingReader::Close()
+    {
+        file_.Close();
+        header_ = {};
+        blockCount_ = 0;
+        frameCount_ = 0;
+        blocksEnd_ = 0;
+        index_ = nullptr;
+        recoveredIndex_.clear();
+        recovered_ = false;
+        damagedBlocks_ = 0;
+        decodedBlock_ = std::numeric_limits<size_t>::max();
+    }
+
+    bool RecordingReader::ReadIndexFromFooter()
+    {
+        const size_t size = file_.GetSize();
+        if (size < sizeof(RecordingHeader) + sizeof(RecordingFooter))
+        {
+            return false;
+        }
+
+        RecordingFooter footer;
+        std::memcpy(&footer, file_.GetData() + size - sizeof(footer), sizeof(footer));
+        if (std::memcmp(footer.magic, FooterMagic, sizeof(FooterMagic)) != 0 ||
+            footer.indexOffset < sizeof(RecordingHeader) ||
+            footer.blockCount > (size - sizeof(footer)) / sizeof(uint64_t) ||
+            footer.indexOffset + footer.blockCount * sizeof(uint64_t) + sizeof(footer) != size ||
+            footer.frameCount > footer.blockCount * header_.blockFrames ||
+            (footer.blockCount > 0 && footer.frameCount <= (footer.blockCount - 1) * header_.blockFrames))
+        {
+            return false;
+        }
+
+        blockCount_ = static_cast<size_t>(footer.blockCount);
+        frameCount_ = footer.frameCount;
+        blocksEnd_ = footer.indexOffset;
+        index_ = file_.GetData() + footer.indexOffset;
+        return true;
+    }
+
+    void RecordingReader::RebuildIndex()
+    {
+        // Every block but the last is full; anything that does not look like a block ends the recording
+        recovered_ = true;
+        const size_t size = file_.GetSize();
+        uint64_t offset = sizeof(RecordingHeader);
+        while (offset + sizeof(BlockHeader) <= size)
+        {
+            BlockHeader block;
+            std::memcpy(&block, file_.GetData() + offset, sizeof(block));
+            if (block.magic != BlockMagic || block.frames == 0 || block.frames > header_.blockFrames ||
+                block.payloadBytes > size - offset - sizeof(block))
+            {
+                break;
+            }
+
+            recoveredIndex_.push_back(offset);
+            frameCount_ += block.frames;
+            offset += sizeof(block) + block.payloadBytes;
+            if (block.frames < header_.blockFrames)
+            {
+                break;
+            }
+        }
+
+        blockCount_ = recoveredIndex_.size();
+        blocksEnd_ = offset;
+        index_ = reinterpret_cast<const std::byte*>(recoveredIndex_.data());
+    }
+
+    double RecordingReader::GetDurationSeconds() const
+    {
+        return header_.sampleRate > 0 ? static_cast<double>(frameCount_) / header_.sampleRate : 0.0;
+    }
+
+    uint64_t RecordingReader::GetFrameAt(const double seconds) const
+    {
+        if (seconds <= 0.0 || header_.sampleRate == 0)
+        {
+            return 0;
+        }
+        const double frame = std::ceil(seconds * header_.sampleRate);
+        return frame >= static_cast<double>(frameCount_) ? frameCount_ : static_cast<uint64_t>(frame);
+    }
+
+    uint64_t RecordingReader::GetBlockOffset(const size_t block) const
+    {
+        // The index follows payloads of any length, it is not necessarily aligned
+        uint64_t offset;
+        std::memcpy(&offset, index_ + block * sizeof(uint64_t), sizeof(offset));
+        return offset;
+    }
+
+    bool RecordingReader::DecodeBlock(const size_t block)
+    {
+        if (block == decodedBlock_)
+        {
+            return true;
+        }
+
+        const uint64_t offset = GetBlockOffset(block);
+        BlockHeader header;
+        if (offset < sizeof(RecordingHeader) || offset + sizeof(header) > blocksEnd_)
+        {
+            ++damagedBlocks_;
+            return false;
+        }
+        std::memcpy(&header, file_.GetData() + offset, sizeof(header));
+
+        // Every block but the last is full, the last one ends with the recording
+        const uint64_t firstFrame = static_cast<uint64_t>(block) * header_.blockFrames;
+        const uint64_t expectedFrames = std::min<uint64_t>(header_.blockFrames, frameCount_ - firstFrame);
+        const std::byte* payload = file_.GetData() + offset + sizeof(header);
+        bool valid = header.magic == BlockMagic && header.frames == expectedFrames &&
+            header.payloadBytes <= blocksEnd_ - offset - sizeof(header);
+        if (valid && (header_.flags & Checksums) != 0)
+        {
+            valid = Crc32(payload, header.payloadBytes) == header.checksum;
+        }
+
+        if (valid)
+        {
+            const size_t samples = static_cast<size_t>(header.frames) * header_.channels;
+            switch (header.encoding)
+            {
+            case BlockEncoding::Raw:
+                valid = header.payloadBytes == samples * sizeof(float);
+                if (valid)
+                {
+                    std::memcpy(decoded_.data(), payload, header.payloadBytes);
+                }
+                break;
+            case BlockEncoding::XorBytes:
+                valid = DecodeXorBytes(payload, header.payloadBytes, header.frames, header_.channels,
+                                       decoded_.data());
+                break;
+            default:
+                valid = false;
+                break;
+            }
+        }
+
+        if (!valid)
+        {
+            ++damagedBlocks_;
+            decodedBlock_ = std::numeric_limits<size_t>::max();
+            logger_->error("Block {} at offset {} is damaged", block, offset);
+            return false;
+        }
+
+        decodedBlock_ = block;
+        return true;
+    }
+
+    size_t RecordingReader::ReadFrames(uint64_t firstFrame, size_t frames, float* output)
+    {
+        const size_t channels = header_.channels;
+        size_t copied = 0;
+        while (copied < frames && firstFrame < frameCount_)
+        {
+            const auto block = static_cast<size_t>(firstFrame / header_.blockFrames);
+            if (!DecodeBlock(block))
+            {
+                break;
+            }
+
+            const auto offsetInBlock = static_cast<size_t>(firstFrame % header_.blockFrames);
+            const uint64_t blockEnd = std::min<uint64_t>((block + 1) * static_cast<uint64_t>(header_.blockFrames),
+                                                         frameCount_);
+            const size_t count = std::min<size_t>(frames - copied, static_cast<size_t>(blockEnd - firstFrame));
+            std::memcpy(output + copied * channels, decoded_.data() + offsetInBlock * channels,
+                        count * channels * sizeof(float));
+            copied += count;
+            firstFrame += count;
+        }
+        return copied;
+    }
+
+    bool RecordingReader::Verify()
+    {
+        bool valid = true;
+        for (size_t block = 0; block < blockCount_; ++block)
+        {
+            valid = DecodeBlock(block) && valid;
+        }
+        return valid;
+    }
+}
@@ -0,0 +1,79 @@
+//
+// Created by Robert on 2025-11-12.
+//
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+#include "RecordingFormat.h"
+#include "files/MemoryMappedFile.h"
+#include "spdlog/logger.h"
+
+namespace bpmfinder::files::recording
+{
+    // Random access to a recording (see RecordingFormat.h). Open maps the file and reads header and footer, so it
+    // takes the same time for an hour as for a second; ReadFrames decodes only the blocks it needs.
+    // Not thread safe: for parallel analysis of several segments, give every thread a reader of its own. They share
+    // the pages of the file through the OS.
+    class RecordingReader
+    {
+    public:
+        RecordingReader();
+
+        // Files without footer, i.e. whose writer did not finish, are opened by walking the block headers instead
+        bool Open(const std::string& filename);
+        void Close();
+
+        // True if the file starts like a recording, without opening it as one
+        static bool IsRecording(const std::string& filename);
+
+        [[nodiscard]] bool IsOpen() const { return file_.IsOpen(); }
+        [[nodiscard]] uint32_t GetSampleRate() const { return header_.sampleRate; }
+        [[nodiscard]] uint32_t GetChannels() const { return header_.channels; }
+        [[nodiscard]] uint32_t GetBlockFrames() const { return header_.blockFrames; }
+        [[nodiscard]] uint64_t GetFrameCount() const { return frameCount_; }
+        [[nodiscard]] size_t GetBlockCount() const { return blockCount_; }
+        [[nodiscard]] double GetDurationSeconds() const;
+
+        // Opened without footer
+        [[nodiscard]] bool IsRecovered() const { return recovered_; }
+
+        // Blocks whose checksum or encoding was wrong so far
+        [[nodiscard]] uint64_t GetDamagedBlockCount() const { return damagedBlocks_; }
+
+        // First frame at or after 'seconds', clamped to the end of the recording
+        [[nodiscard]] uint64_t GetFrameAt(double seconds) const;
+
+        // Copies up to 'frames' interleaved frames from 'firstFrame' on into 'output'. Returns the frames copied:
+        // fewer at the end of the recording, and up to a damaged block, which is never passed on.
+        size_t ReadFrames(uint64_t firstFrame, size_t frames, float* output);
+
+        // Decodes and checks every block. False if any is damaged.
+        bool Verify();
+
+    private:
+        bool ReadIndexFromFooter();
+        void RebuildIndex();
+        [[nodiscard]] uint64_t GetBlockOffset(size_t block) const;
+        bool DecodeBlock(size_t block);
+
+        MemoryMappedFile file_;
+        RecordingHeader header_{};
+        size_t blockCount_ = 0;
+        uint64_t frameCount_ = 0;
+        uint64_t blocksEnd_ = 0; // Where the index starts, blocks must end before
+        const std::byte* index_ = nullptr; // In the mapping, or recoveredIndex_
+        std::vector<uint64_t> recoveredIndex_;
+        bool recovered_ = false;
+        uint64_t damagedBlocks_ = 0;
+
+        std::vector<float> decoded_;
+        size_t decodedBlock_ = std::numeric_limits<size_t>::max();
+
+        std::shared_ptr<spdlog::logger> logger_;
+    };
+}
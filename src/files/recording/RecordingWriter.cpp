@@ -0,0 +1,101 @@
+//
+// Created by Robert on 2025-11-12.
+//
+
+#include "RecordingWriter.h"
+#include <algorithm>
+#include <cstring>
+#include "files/Crc32.h"
+
+namespace bpmfinder::files::recording
+{
+    RecordingWriter::RecordingWriter(WriteBehindFile& file, const RecordingOptions& options) :
+        file_(file),
+        options_(options)
+    {
+        options_.channels = std::max<uint32_t>(1, options_.channels);
+        options_.blockFrames = std::clamp<uint32_t>(options_.blockFrames, 1, MaxRecordingBlockFrames);
+        block_.resize(static_cast<size_t>(options_.blockFrames) * options_.channels);
+
+        RecordingHeader header{};
+        std::memcpy(header.magic, RecordingMagic, sizeof(header.magic));
+        header.version = RecordingVersion;
+        header.sampleRate = options_.sampleRate;
+        header.channels = options_.channels;
+        header.blockFrames = options_.blockFrames;
+        header.flags = (options_.checksums ? Checksums : 0u) | (options_.compression ? Compression : 0u);
+        file_.Append(&header, sizeof(header));
+    }
+
+    void RecordingWriter::Write(const float* samples, const size_t frames)
+    {
+        size_t remaining = frames * options_.channels;
+        while (remaining > 0)
+        {
+            const size_t count = std::min(remaining, block_.size() - blockFill_);
+            std::memcpy(block_.data() + blockFill_, samples, count * sizeof(float));
+            blockFill_ += count;
+            samples += count;
+            remaining -= count;
+            if (blockFill_ == block_.size())
+            {
+                WriteBlock();
+            }
+        }
+    }
+
+    void RecordingWriter::Finish()
+    {
+        if (finished_)
+        {
+            return;
+        }
+        finished_ = true;
+
+        // A partial frame at the very end can not be played back, it is dropped
+        blockFill_ -= blockFill_ % options_.channels;
+        if (blockFill_ > 0)
+        {
+            WriteBlock();
+        }
+
+        RecordingFooter footer{};
+        footer.indexOffset = file_.GetAppendedBytes();
+        footer.blockCount = index_.size();
+        footer.frameCount = frameCount_;
+        std::memcpy(footer.magic, FooterMagic, sizeof(footer.magic));
+        file_.Append(index_.data(), index_.size() * sizeof(uint64_t));
+        file_.Append(&footer, sizeof(footer));
+    }
+
+    void RecordingWriter::WriteBlock()
+    {
+        const size_t frames = blockFill_ / options_.channels;
+        const auto* payload = reinterpret_cast<const std::byte*>(block_.data());
+        size_t payloadBytes = blockFill_ * sizeof(float);
+
+        BlockHeader header{};
+        header.magic = BlockMagic;
+        header.frames = static_cast<uint32_t>(frames);
+        header.encoding = BlockEncoding::Raw;
+        if (options_.compression)
+        {
+            EncodeXorBytes(block_.data(), frames, options_.channels, encoded_);
+            if (encoded_.size() < payloadBytes)
+            {
+                payload = encoded_.data();
+                payloadBytes = encoded_.size();
+                header.encoding = BlockEncoding::XorBytes;
+            }
+        }
+        header.payloadBytes = static_cast<uint32_t>(payloadBytes);
+        header.checksum = options_.checksums ? Crc32(payload, payloadBytes) : 0;
+
+        index_.push_back(file_.GetAppendedBytes());
+        file_.Append(&header, sizeof(header));
+        file_.Append(payload, payloadBytes);
+
+        frameCount_ += frames;
+        blockFill_ = 0;
+    }
+}
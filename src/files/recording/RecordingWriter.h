@@ -0,0 +1,52 @@
+//
+// Created by Robert on 2025-11-12.
+//
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "RecordingFormat.h"
+#include "files/WriteBehindFile.h"
+
+namespace bpmfinder::files::recording
+{
+    struct RecordingOptions
+    {
+        uint32_t sampleRate = 48000;
+        uint32_t channels = 1;
+        uint32_t blockFrames = 4096; // Granularity of random access, and what a reader decodes at once
+        bool checksums = true;
+        bool compression = true; // XorBytes blocks, a block that would not get smaller is stored raw
+    };
+
+    // Writes a recording (see RecordingFormat.h) into an open WriteBehindFile: the header right away, a block
+    // whenever blockFrames frames are together, the index and footer in Finish. Only appends, so the file keeps
+    // its write-behind path; nothing is ever patched in place.
+    class RecordingWriter
+    {
+    public:
+        RecordingWriter(WriteBehindFile& file, const RecordingOptions& options);
+
+        // Interleaved frames, any count per call
+        void Write(const float* samples, size_t frames);
+
+        // Writes the last, shorter block and the index. Called once, before the file is closed.
+        void Finish();
+
+        [[nodiscard]] uint64_t GetFrameCount() const { return frameCount_; }
+        [[nodiscard]] uint64_t GetBlockCount() const { return index_.size(); }
+
+    private:
+        void WriteBlock();
+
+        WriteBehindFile& file_;
+        RecordingOptions options_;
+        std::vector<float> block_;
+        size_t blockFill_ = 0; // In samples
+        std::vector<std::byte> encoded_;
+        std::vector<uint64_t> index_;
+        uint64_t frameCount_ = 0;
+        bool finished_ = false;
+    };
+}
@@ -0,0 +1,142 @@
+//
+// Created by Robert on 2025-11-16.
+//
+
+#include "SharedMemoryMapping.h"
+#include <cstdint>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace bpmfinder::ipc
+{
+    bool CreateSharedMapping(const std::string& name, const size_t size, void*& view, void*& handle)
+    {
+#ifdef _WIN32
+        const auto mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+                                                static_cast<DWORD>(static_cast<uint64_t>(size) >> 32),
+                                                static_cast<DWORD>(size & 0xFFFFFFFF), name.c_str());
+        if (mapping == nullptr)
+        {
+            return false;
+        }
+        view = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+        if (view == nullptr)
+        {
+            CloseHandle(mapping);
+            return false;
+        }
+        handle = mapping;
+        return true;
+#else
+        // A leftover of a producer that crashed would have the wrong size and stale content
+        shm_unlink(name.c_str());
+        const int descriptor = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        if (descriptor < 0)
+        {
+            return false;
+        }
+        if (ftruncate(descriptor, static_cast<off_t>(size)) != 0)
+        {
+            close(descriptor);
+            shm_unlink(name.c_str());
+            return false;
+        }
+        view = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0);
+        close(descriptor); // The mapping keeps the object alive
+        if (view == MAP_FAILED)
+        {
+            view = nullptr;
+            shm_unlink(name.c_str());
+            return false;
+        }
+        handle = nullptr;
+        return true;
+#endif
+    }
+
+    bool OpenSharedMapping(const std::string& name, const size_t minimumSize, void*& view, size_t& size,
+                           void*& handle)
+    {
+#ifdef _WIN32
+        const auto mapping = OpenFileMappingA(FILE_MAP_READ, FALSE, name.c_str());
+        if (mapping == nullptr)
+        {
+            return false;
+        }
+        view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        MEMORY_BASIC_INFORMATION info{};
+        if (view == nullptr || VirtualQuery(view, &info, sizeof(info)) == 0 || info.RegionSize < minimumSize)
+        {
+            if (view != nullptr)
+            {
+                UnmapViewOfFile(view);
+            }
+            CloseHandle(mapping);
+            return false;
+        }
+        size = info.RegionSize;
+        handle = mapping;
+        return true;
+#else
+        const int descriptor = shm_open(name.c_str(), O_RDONLY, 0);
+        if (descriptor < 0)
+        {
+            return false;
+        }
+        struct stat status{};
+        if (fstat(descriptor, &status) != 0 || status.st_size < static_cast<off_t>(minimumSize))
+        {
+            close(descriptor);
+            return false;
+        }
+        size = static_cast<size_t>(status.st_size);
+        view = mmap(nullptr, size, PROT_READ, MAP_SHARED, descriptor, 0);
+        close(descriptor);
+        if (view == MAP_FAILED)
+        {
+            view = nullptr;
+            return false;
+        }
+        handle = nullptr;
+        return true;
+#endif
+    }
+
+    void CloseSharedMapping(void*& view, const size_t size, void*& handle)
+    {
+#ifdef _WIN32
+        (void)size;
+        if (view != nullptr)
+        {
+            UnmapViewOfFile(view);
+        }
+        if (handle != nullptr)
+        {
+            CloseHandle(handle);
+        }
+#else
+        if (view != nullptr)
+        {
+            munmap(view, size);
+        }
+#endif
+        view = nullptr;
+        handle = nullptr;
+    }
+
+    void RemoveSharedMapping(const std::string& name)
+    {
+#ifdef _WIN32
+        (void)name;
+#else
+        shm_unlink(name.c_str());
+#endif
+    }
+}
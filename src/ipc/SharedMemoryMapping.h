@@ -0,0 +1,24 @@
+//
+// Created by Robert on 2025-11-16.
+//
+
+#pragma once
+#include <cstddef>
+#include <string>
+
+namespace bpmfinder::ipc
+{
+    // The platform part of the shared memory objects: POSIX shm_open/mmap, file mappings on Windows. 'handle' is the
+    // mapping handle on Windows and unused elsewhere.
+
+    // Maps a new read-write object of 'size' bytes, zero filled, replacing a leftover of the same name
+    bool CreateSharedMapping(const std::string& name, size_t size, void*& view, void*& handle);
+
+    // Maps an existing object read-only, as a whole. False if there is none or it is smaller than minimumSize.
+    bool OpenSharedMapping(const std::string& name, size_t minimumSize, void*& view, size_t& size, void*& handle);
+
+    void CloseSharedMapping(void*& view, size_t size, void*& handle);
+
+    // Removes the name, mappings that exist keep working. Windows removes the object with its last handle.
+    void RemoveSharedMapping(const std::string& name);
+}
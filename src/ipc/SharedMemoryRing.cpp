@@ -0,0 +1,186 @@
+//
+// Created by Robert on 2025-11-08.
+//
+
+#include "SharedMemoryRing.h"
+#include "SharedMemoryMapping.h"
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <new>
+
+namespace bpmfinder::ipc
+{
+    // ============================================================================
+    // Writer
+    // ============================================================================
+
+    SharedMemoryRingWriter::~SharedMemoryRingWriter()
+    {
+        Destroy();
+    }
+
+    bool SharedMemoryRingWriter::Create(const std::string& name, const SharedMemoryRingFormat& format,
+                                        const size_t capacitySamples)
+    {
+        Destroy();
+        if (format.channels <= 0 || format.sampleRate <= 0)
+        {
+            return false;
+        }
+
+        // At least one frame, so a write of whole frames always fits
+        const uint64_t capacity = std::bit_ceil(std::max<uint64_t>(capacitySamples,
+                                                                   static_cast<uint64_t>(format.channels)));
+        const size_t size = SamplesOffset + static_cast<size_t>(capacity) * sizeof(float);
+        if (!CreateSharedMapping(name, size, mapping_, mappingHandle_))
+        {
+            return false;
+        }
+
+        name_ = name;
+        mappingSize_ = size;
+        header_ = new(mapping_) SharedMemoryRingHeader{};
+        header_->version = SharedMemoryRingHeader::Version;
+        header_->sampleRate = static_cast<uint32_t>(format.sampleRate);
+        header_->channels = static_cast<uint32_t>(format.channels);
+        header_->capacity = capacity;
+        header_->writeLimit.store(0, std::memory_order_relaxed);
+        header_->writePosition.store(0, std::memory_order_relaxed);
+        header_->closed.store(0, std::memory_order_relaxed);
+
+        header_->magic.store(SharedMemoryRingHeader::Magic, std::memory_order_release);
+
+        samples_ = reinterpret_cast<float*>(static_cast<std::byte*>(mapping_) + SamplesOffset);
+        mask_ = capacity - 1;
+        position_ = 0;
+        return true;
+    }
+
+    void SharedMemoryRingWriter::Destroy()
+    {
+        if (!header_)
+        {
+            return;
+        }
+
+        CloseSharedMapping(mapping_, mappingSize_, mappingHandle_);
+        RemoveSharedMapping(name_);
+        header_ = nullptr;
+        samples_ = nullptr;
+    }
+
+    void SharedMemoryRingWriter::Write(const float* frames, const size_t frameCount)
+    {
+        size_t count = frameCount * header_->channels;
+        const uint64_t capacity = mask_ + 1;
+
+        // More than fits: only the newest whole frames survive anyway
+        if (count > capacity)
+        {
+            const size_t skipped = count - static_cast<size_t>(capacity) / header_->channels * header_->channels;
+            frames += skipped;
+            position_ += skipped;
+            count -= skipped;
+        }
+
+        // Seqlock order: announce which slots are about to change, then change them, then publish them
+        header_->writeLimit.store(position_ + count, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        const size_t slot = static_cast<size_t>(position_ & mask_);
+        const size_t first = std::min(count, static_cast<size_t>(capacity) - slot);
+        std::memcpy(samples_ + slot, frames, first * sizeof(float));
+        std::memcpy(samples_, frames + first, (count - first) * sizeof(float));
+
+        position_ += count;
+        header_->writePosition.store(position_, std::memory_order_release);
+    }
+
+    void SharedMemoryRingWriter::Close()
+    {
+        if (header_)
+        {
+            header_->closed.store(1, std::memory_order_release);
+        }
+    }
+
+    // ============================================================================
+    // Reader
+    // ============================================================================
+
+    SharedMemoryRingReader::~SharedMemoryRingReader()
+    {
+        Close();
+    }
+
+    bool SharedMemoryRingReader::Open(const std::string& name)
+    {
+        Close();
+        if (!OpenSharedMapping(name, SamplesOffset, mapping_, mappingSize_, mappingHandle_))
+        {
+            return false;
+        }
+
+        const auto* header = static_cast<const SharedMemoryRingHeader*>(mapping_);
+        const bool valid =
+            header->magic.load(std::memory_order_acquire) == SharedMemoryRingHeader::Magic &&
+            header->version == SharedMemoryRingHeader::Version &&
+            header->channels > 0 &&
+            std::has_single_bit(header->capacity) &&
+            SamplesOffset + header->capacity * sizeof(float) <= mappingSize_;
+        if (!valid)
+        {
+            Close();
+            return false;
+        }
+
+        header_ = header;
+        samples_ = reinterpret_cast<const float*>(static_cast<const std::byte*>(mapping_) + SamplesOffset);
+        capacity_ = header->capacity;
+        return true;
+    }
+
+    void SharedMemoryRingReader::Close()
+    {
+        CloseSharedMapping(mapping_, mappingSize_, mappingHandle_);
+        header_ = nullptr;
+        samples_ = nullptr;
+        capacity_ = 0;
+    }
+
+    SharedMemoryRingFormat SharedMemoryRingReader::GetFormat() const
+    {
+        SharedMemoryRingFormat format;
+        format.sampleRate = static_cast<int>(header_->sampleRate);
+        format.channels = static_cast<int>(header_->channels);
+        return format;
+    }
+
+    uint64_t SharedMemoryRingReader::GetWritePosition() const
+    {
+        return header_->writePosition.load(std::memory_order_acquire);
+    }
+
+    bool SharedMemoryRingReader::IsClosed() const
+    {
+        return header_->closed.load(std::memory_order_acquire) != 0;
+    }
+
+    bool SharedMemoryRingReader::Read(const uint64_t position, float* output, const size_t count) const
+    {
+        if (header_->writeLimit.load(std::memory_order_acquire) > position + capacity_)
+        {
+            return false; // Overwritten already
+        }
+
+        const size_t slot = static_cast<size_t>(position & (capacity_ - 1));
+        const size_t first = std::min(count, static_cast<size_t>(capacity_) - slot);
+        std::memcpy(output, samples_ + slot, first * sizeof(float));
+        std::memcpy(output + first, samples_, (count - first) * sizeof(float));
+
+        // Seqlock check: if the producer did not start to overwrite them by now, the copied samples are intact
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return header_->writeLimit.load(std::memory_order_relaxed) <= position + capacity_;
+    }
+}
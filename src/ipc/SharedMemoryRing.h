@@ -0,0 +1,125 @@
+//
+// Created by Robert on 2025-11-08.
+//
+
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace bpmfinder::ipc
+{
+    struct SharedMemoryRingFormat
+    {
+        int sampleRate = 48000;
+        int channels = 1; // Interleaved float samples per frame
+    };
+
+    // Layout at the start of the shared memory object, the samples follow at SamplesOffset.
+    // Positions are sequence numbers: the number of samples written since the ring was created. They only grow, the
+    // slot of a position is position & (capacity - 1).
+    struct SharedMemoryRingHeader
+    {
+        static constexpr uint32_t Magic = 0x52504D42; // "BMPR"
+        static constexpr uint32_t Version = 1;
+
+        std::atomic<uint32_t> magic; // Stored last by the producer, a reader that sees it sees the whole header
+        uint32_t version;
+        uint32_t sampleRate;
+        uint32_t channels;
+        uint64_t capacity; // In samples, a power of two
+
+        // End of the write in progress, published before the samples are touched. A reader whose samples are below
+        // writeLimit - capacity may have copied half overwritten data.
+        alignas(64) std::atomic<uint64_t> writeLimit;
+
+        // End of the completed writes, published after the samples
+        alignas(64) std::atomic<uint64_t> writePosition;
+
+        // Set by the producer at the end of the stream, after the last write
+        alignas(64) std::atomic<uint32_t> closed;
+    };
+
+    static_assert(std::atomic<uint64_t>::is_always_lock_free && std::atomic<uint32_t>::is_always_lock_free,
+                  "The ring is shared between processes, its atomics must not need a lock");
+
+    constexpr size_t SamplesOffset = (sizeof(SharedMemoryRingHeader) + 63) / 64 * 64;
+
+    // Producer side: creates the shared memory object and writes interleaved float frames into it. There is only one
+    // producer, and it never waits for consumers: a consumer that falls behind by more than the capacity loses the
+    // oldest samples and notices it from the positions. Does not log and does not allocate after Create, so it can be
+    // used from a capture callback or a forked process.
+    class SharedMemoryRingWriter
+    {
+    public:
+        SharedMemoryRingWriter() = default;
+        ~SharedMemoryRingWriter();
+
+        SharedMemoryRingWriter(const SharedMemoryRingWriter&) = delete;
+        SharedMemoryRingWriter& operator=(const SharedMemoryRingWriter&) = delete;
+
+        // Creates the object 'name' (POSIX shm name, e.g. "/bpm-finder"), replacing an old one of the same name.
+        // The capacity is rounded up to a power of two samples. False on failure, errno tells why.
+        bool Create(const std::string& name, const SharedMemoryRingFormat& format, size_t capacitySamples);
+
+        // Unmaps and removes the object, consumers that have it mapped keep reading what is left
+        void Destroy();
+
+        // Appends whole frames, frameCount * channels samples
+        void Write(const float* frames, size_t frameCount);
+
+        // End of the stream: consumers pass the rest on and finish
+        void Close();
+
+        [[nodiscard]] bool IsOpen() const { return header_ != nullptr; }
+        [[nodiscard]] uint64_t GetWritePosition() const { return position_; }
+
+    private:
+        std::string name_;
+        void* mapping_ = nullptr;
+        size_t mappingSize_ = 0;
+        void* mappingHandle_ = nullptr; // Windows only
+        SharedMemoryRingHeader* header_ = nullptr;
+        float* samples_ = nullptr;
+        uint64_t mask_ = 0;
+        uint64_t position_ = 0;
+    };
+
+    // Consumer side: maps an existing ring and copies samples out of it. Any number of readers can attach.
+    class SharedMemoryRingReader
+    {
+    public:
+        SharedMemoryRingReader() = default;
+        ~SharedMemoryRingReader();
+
+        SharedMemoryRingReader(const SharedMemoryRingReader&) = delete;
+        SharedMemoryRingReader& operator=(const SharedMemoryRingReader&) = delete;
+
+        // False if there is no ring of that name or it is not one of ours
+        bool Open(const std::string& name);
+        void Close();
+
+        [[nodiscard]] bool IsOpen() const { return header_ != nullptr; }
+        [[nodiscard]] SharedMemoryRingFormat GetFormat() const;
+        [[nodiscard]] uint64_t GetCapacity() const { return capacity_; }
+
+        // Everything below this position has been written completely
+        [[nodiscard]] uint64_t GetWritePosition() const;
+
+        // True once the producer has closed the stream. Read the write position after this, to see all samples.
+        [[nodiscard]] bool IsClosed() const;
+
+        // Copies the samples [position, position + count). False if the producer overwrote any of them before or
+        // while they were copied: the output is garbage then and the consumer has to skip ahead.
+        bool Read(uint64_t position, float* output, size_t count) const;
+
+    private:
+        void* mapping_ = nullptr;
+        size_t mappingSize_ = 0;
+        void* mappingHandle_ = nullptr; // Windows only
+        const SharedMemoryRingHeader* header_ = nullptr;
+        const float* samples_ = nullptr;
+        uint64_t capacity_ = 0;
+    };
+}
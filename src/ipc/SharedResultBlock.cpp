@@ -0,0 +1,128 @@
+//
+// Created by Robert on 2025-11-16.
+//
+
+#include "SharedResultBlock.h"
+#include "SharedMemoryMapping.h"
+#include <new>
+
+namespace bpmfinder::ipc
+{
+    // ============================================================================
+    // Writer
+    // ============================================================================
+
+    SharedResultBlockWriter::~SharedResultBlockWriter()
+    {
+        Destroy();
+    }
+
+    bool SharedResultBlockWriter::Create(const std::string& name)
+    {
+        Destroy();
+        if (!CreateSharedMapping(name, sizeof(SharedResultBlockHeader), mapping_, mappingHandle_))
+        {
+            return false;
+        }
+
+        name_ = name;
+        header_ = new(mapping_) SharedResultBlockHeader{};
+        header_->version = SharedResultBlockHeader::Version;
+        header_->closed.store(0, std::memory_order_relaxed);
+
+        header_->magic.store(SharedResultBlockHeader::Magic, std::memory_order_release);
+        return true;
+    }
+
+    void SharedResultBlockWriter::Destroy()
+    {
+        if (!header_)
+        {
+            return;
+        }
+
+        CloseSharedMapping(mapping_, sizeof(SharedResultBlockHeader), mappingHandle_);
+        RemoveSharedMapping(name_);
+        header_ = nullptr;
+    }
+
+    void SharedResultBlockWriter::Publish(const dsp::time_domain_onset_detection::BpmSnapshot& snapshot)
+    {
+        if (header_)
+        {
+            header_->result.Store(snapshot);
+        }
+    }
+
+    void SharedResultBlockWriter::Close()
+    {
+        if (header_)
+        {
+            header_->closed.store(1, std::memory_order_release);
+        }
+    }
+
+    // ============================================================================
+    // Reader
+    // ============================================================================
+
+    SharedResultBlockReader::~SharedResultBlockReader()
+    {
+        Close();
+    }
+
+    bool SharedResultBlockReader::Open(const std::string& name)
+    {
+        Close();
+        if (!OpenSharedMapping(name, sizeof(SharedResultBlockHeader), mapping_, mappingSize_, mappingHandle_))
+        {
+            return false;
+        }
+
+        const auto* header = static_cast<const SharedResultBlockHeader*>(mapping_);
+        if (header->magic.load(std::memory_order_acquire) != SharedResultBlockHeader::Magic ||
+            header->version != SharedResultBlockHeader::Version)
+        {
+            Close();
+            return false;
+        }
+
+        header_ = header;
+        return true;
+    }
+
+    void SharedResultBlockReader::Close()
+    {
+        CloseSharedMapping(mapping_, mappingSize_, mappingHandle_);
+        header_ = nullptr;
+    }
+
+    uint64_t SharedResultBlockReader::GetVersion() const
+    {
+        return header_->result.GetVersion();
+    }
+
+    std::optional<dsp::time_domain_onset_detection::BpmSnapshot> SharedResultBlockReader::Read() const
+    {
+        // Not Seqlock::Load, which would spin forever on a block whose writer died while it was publishing
+        dsp::time_domain_onset_detection::BpmSnapshot snapshot;
+        for (int attempt = 0; attempt < ReadAttempts; ++attempt)
+        {
+            if (header_->result.TryLoad(snapshot))
+            {
+                return snapshot;
+            }
+        }
+        return std::nullopt;
+    }
+
+    bool SharedResultBlockReader::TryRead(dsp::time_domain_onset_detection::BpmSnapshot& snapshot) const
+    {
+        return header_->result.TryLoad(snapshot);
+    }
+
+    bool SharedResultBlockReader::IsClosed() const
+    {
+        return header_->closed.load(std::memory_order_acquire) != 0;
+    }
+}
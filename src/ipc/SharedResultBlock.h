@@ -0,0 +1,106 @@
+//
+// Created by Robert on 2025-11-16.
+//
+
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include "core/Seqlock.h"
+#include "dsp/time_domain_onset_detection/BpmSnapshot.h"
+
+namespace bpmfinder::ipc
+{
+    // The whole shared memory object: a small header and the latest estimate behind a seqlock. The analysis stores
+    // into it, a front end in another process maps it read-only and polls it, e.g. once per frame. Neither side ever
+    // makes a system call or waits for the other after the mapping exists.
+    struct SharedResultBlockHeader
+    {
+        static constexpr uint32_t Magic = 0x53504D42; // "BMPS"
+        static constexpr uint32_t Version = 1;
+
+        std::atomic<uint32_t> magic; // Stored last by the writer, a reader that sees it sees the whole header
+        uint32_t version;
+
+        // Set by the writer when the analysis has ended, the last estimate stays readable
+        std::atomic<uint32_t> closed;
+
+        alignas(64) core::Seqlock<dsp::time_domain_onset_detection::BpmSnapshot> result;
+    };
+
+    static_assert(std::atomic<uint32_t>::is_always_lock_free,
+                  "The block is shared between processes, its atomics must not need a lock");
+
+    // Writer side, in the analysis: creates the object and publishes every estimate into it. Publish does not log,
+    // allocate or lock, it can run on a stage thread.
+    class SharedResultBlockWriter
+    {
+    public:
+        SharedResultBlockWriter() = default;
+        ~SharedResultBlockWriter();
+
+        SharedResultBlockWriter(const SharedResultBlockWriter&) = delete;
+        SharedResultBlockWriter& operator=(const SharedResultBlockWriter&) = delete;
+
+        // Creates the object 'name' (POSIX shm name, e.g. "/bpm-finder-result"), replacing an old one of the same
+        // name. False on failure, errno tells why.
+        bool Create(const std::string& name);
+
+        // Unmaps and removes the object, readers that have it mapped keep the last estimate
+        void Destroy();
+
+        // Only one thread at a time
+        void Publish(const dsp::time_domain_onset_detection::BpmSnapshot& snapshot);
+
+        // The analysis has ended
+        void Close();
+
+        [[nodiscard]] bool IsOpen() const { return header_ != nullptr; }
+
+    private:
+        std::string name_;
+        void* mapping_ = nullptr;
+        void* mappingHandle_ = nullptr; // Windows only
+        SharedResultBlockHeader* header_ = nullptr;
+    };
+
+    // Reader side, e.g. in the GUI: any number of readers can attach
+    class SharedResultBlockReader
+    {
+    public:
+        static constexpr int ReadAttempts = 100000;
+
+        SharedResultBlockReader() = default;
+        ~SharedResultBlockReader();
+
+        SharedResultBlockReader(const SharedResultBlockReader&) = delete;
+        SharedResultBlockReader& operator=(const SharedResultBlockReader&) = delete;
+
+        // False if there is no block of that name or it is not one of ours
+        bool Open(const std::string& name);
+        void Close();
+
+        [[nodiscard]] bool IsOpen() const { return header_ != nullptr; }
+
+        // Number of estimates published so far, 0 = none yet: a poll that finds the same number as last time can
+        // skip Read
+        [[nodiscard]] uint64_t GetVersion() const;
+
+        // The latest estimate, never half written. Retries at most ReadAttempts times while the writer is publishing,
+        // then returns nothing: the writer is in another process and may have died in the middle of a Publish, which
+        // leaves the block like that for good. A writer that was only preempted is read on the next poll.
+        [[nodiscard]] std::optional<dsp::time_domain_onset_detection::BpmSnapshot> Read() const;
+
+        // One attempt, false if the writer was publishing at that moment
+        bool TryRead(dsp::time_domain_onset_detection::BpmSnapshot& snapshot) const;
+
+        [[nodiscard]] bool IsClosed() const;
+
+    private:
+        void* mapping_ = nullptr;
+        size_t mappingSize_ = 0;
+        void* mappingHandle_ = nullptr; // Windows only
+        const SharedResultBlockHeader* header_ = nullptr;
+    };
+}
@@ -0,0 +1,67 @@
+//
+// Created by Robert on 2025-11-15.
+//
+
+#pragma once
+#include <spdlog/spdlog.h>
+
+// Log macros for code that runs per chunk. A call below BPM_LOG_ACTIVE_LEVEL compiles to nothing, arguments
+// included. The other calls check the logger's level before they evaluate their arguments, unlike logger->debug(...),
+// which computes them even when the message is dropped.
+//
+//   BPM_LOG_DEBUG(logger_, "Processing chunk {}", data.chunkIndex);
+
+#define BPM_LOG_LEVEL_TRACE 0
+#define BPM_LOG_LEVEL_DEBUG 1
+#define BPM_LOG_LEVEL_INFO 2
+#define BPM_LOG_LEVEL_WARN 3
+#define BPM_LOG_LEVEL_ERROR 4
+#define BPM_LOG_LEVEL_OFF 6
+
+// Set by CMake (BPM_LOG_ACTIVE_LEVEL); without it release builds keep info and above, debug builds everything
+#ifndef BPM_LOG_ACTIVE_LEVEL
+#ifdef NDEBUG
+#define BPM_LOG_ACTIVE_LEVEL BPM_LOG_LEVEL_INFO
+#else
+#define BPM_LOG_ACTIVE_LEVEL BPM_LOG_LEVEL_TRACE
+#endif
+#endif
+
+#define BPM_LOG_CALL(logger, level, ...) \
+    do \
+    { \
+        if ((logger)->should_log(level)) \
+        { \
+            (logger)->log(level, __VA_ARGS__); \
+        } \
+    } while (false)
+
+#if BPM_LOG_ACTIVE_LEVEL <= BPM_LOG_LEVEL_TRACE
+#define BPM_LOG_TRACE(logger, ...) BPM_LOG_CALL(logger, spdlog::level::trace, __VA_ARGS__)
+#else
+#define BPM_LOG_TRACE(logger, ...) (void)0
+#endif
+
+#if BPM_LOG_ACTIVE_LEVEL <= BPM_LOG_LEVEL_DEBUG
+#define BPM_LOG_DEBUG(logger, ...) BPM_LOG_CALL(logger, spdlog::level::debug, __VA_ARGS__)
+#else
+#define BPM_LOG_DEBUG(logger, ...) (void)0
+#endif
+
+#if BPM_LOG_ACTIVE_LEVEL <= BPM_LOG_LEVEL_INFO
+#define BPM_LOG_INFO(logger, ...) BPM_LOG_CALL(logger, spdlog::level::info, __VA_ARGS__)
+#else
+#define BPM_LOG_INFO(logger, ...) (void)0
+#endif
+
+#if BPM_LOG_ACTIVE_LEVEL <= BPM_LOG_LEVEL_WARN
+#define BPM_LOG_WARN(logger, ...) BPM_LOG_CALL(logger, spdlog::level::warn, __VA_ARGS__)
+#else
+#define BPM_LOG_WARN(logger, ...) (void)0
+#endif
+
+#if BPM_LOG_ACTIVE_LEVEL <= BPM_LOG_LEVEL_ERROR
+#define BPM_LOG_ERROR(logger, ...) BPM_LOG_CALL(logger, spdlog::level::err, __VA_ARGS__)
+#else
+#define BPM_LOG_ERROR(logger, ...) (void)0
+#endif
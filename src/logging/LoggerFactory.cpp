@@ -5,12 +5,45 @@
 #include "LoggerFactory.h"
 #include <spdlog/sinks/stdout_color_sinks.h>
 #include <spdlog/sinks/basic_file_sink.h>
+#include <spdlog/async.h>
 
 namespace bpmfinder::logging
 {
     bool LoggerFactory::initialized_ = false;
+    bool LoggerFactory::async_ = false;
+    AsyncLoggingOptions LoggerFactory::asyncOptions_;
+    spdlog::level::level_enum LoggerFactory::level_ = spdlog::level::info;
     std::vector<spdlog::sink_ptr> LoggerFactory::sinks_;
 
+    std::shared_ptr<spdlog::logger> LoggerFactory::CreateLogger(const std::string& name)
+    {
+        if (async_)
+        {
+            return std::make_shared<spdlog::async_logger>(
+                name, sinks_.begin(), sinks_.end(), spdlog::thread_pool(),
+                asyncOptions_.blockWhenFull ? spdlog::async_overflow_policy::block
+                                            : spdlog::async_overflow_policy::overrun_oldest);
+        }
+        return std::make_shared<spdlog::logger>(name, sinks_.begin(), sinks_.end());
+    }
+
+    void LoggerFactory::InitializeAsync(const spdlog::level::level_enum defaultLevel,
+                                        const AsyncLoggingOptions& options)
+    {
+        if (initialized_)
+        {
+            spdlog::warn("LoggerFactory already initialized");
+            return;
+        }
+
+        // One thread keeps the messages in order
+        spdlog::init_thread_pool(options.queueSize, 1);
+        asyncOptions_ = options;
+        async_ = true;
+        Initialize(defaultLevel);
+        spdlog::flush_every(options.flushInterval);
+    }
+
     void LoggerFactory::Initialize(spdlog::level::level_enum defaultLevel)
     {
         if (initialized_)
@@ -25,9 +58,10 @@ namespace bpmfinder::logging
         console_sink->set_pattern("[%Y-%m-%d %H:%M:%S.%e] [%n] [%^%l%$] %v");
 
         sinks_.push_back(console_sink);
+        level_ = defaultLevel;
 
         // Set the default logger
-        auto default_logger = std::make_shared<spdlog::logger>("default", sinks_.begin(), sinks_.end());
+        auto default_logger = CreateLogger("default");
         default_logger->set_level(defaultLevel);
         spdlog::set_default_logger(default_logger);
 
@@ -57,10 +91,11 @@ namespace bpmfinder::logging
 
         sinks_.push_back(console_sink);
         sinks_.push_back(file_sink);
+        level_ = std::min(consoleLevel, fileLevel);
 
         // Set the default logger
-        const auto default_logger = std::make_shared<spdlog::logger>("default", sinks_.begin(), sinks_.end());
-        default_logger->set_level(std::min(consoleLevel, fileLevel));
+        const auto default_logger = CreateLogger("default");
+        default_logger->set_level(level_);
         spdlog::set_default_logger(default_logger);
 
         initialized_ = true;
@@ -82,8 +117,9 @@ namespace bpmfinder::logging
         }
 
         // Create new logger with shared sinks
-        logger = std::make_shared<spdlog::logger>(name, sinks_.begin(), sinks_.end());
-        logger->set_level(spdlog::level::trace); // Individual loggers log everything; sinks filter
+        // At the level of the sinks, not below: a message no sink passes is dropped before it is formatted
+        logger = CreateLogger(name);
+        logger->set_level(level_);
         spdlog::register_logger(logger);
 
         return logger;
@@ -99,6 +135,7 @@ namespace bpmfinder::logging
 
     void LoggerFactory::SetGlobalLogLevel(spdlog::level::level_enum level)
     {
+        level_ = level;
         spdlog::set_level(level);
         for (const auto& sink : sinks_)
         {
@@ -109,8 +146,9 @@ namespace bpmfinder::logging
     void LoggerFactory::Shutdown()
     {
         spdlog::info("Shutting down logging system");
-        spdlog::shutdown();
+        spdlog::shutdown(); // Writes what the async queue still holds
         sinks_.clear();
         initialized_ = false;
+        async_ = false;
     }
 }
@@ -7,17 +7,31 @@
 #include <spdlog/spdlog.h>
 #include <spdlog/sinks/stdout_color_sinks.h>
 #include <spdlog/sinks/basic_file_sink.h>
+#include <chrono>
 #include <memory>
 #include <string>
 
 namespace bpmfinder::logging
 {
+    struct AsyncLoggingOptions
+    {
+        size_t queueSize = 8192; // Messages, allocated up front
+        bool blockWhenFull = false; // Otherwise the oldest message is dropped, a stage never waits for the console
+        std::chrono::seconds flushInterval{1};
+    };
+
     class LoggerFactory
     {
     public:
         // Initialize the logging system with default configuration
         static void Initialize(spdlog::level::level_enum defaultLevel = spdlog::level::info);
 
+        // Like Initialize, but loggers queue their messages. The message text is still formatted on the calling
+        // thread; a background thread applies the sink patterns, writes the lines and flushes the sinks every
+        // options.flushInterval. Call before the first GetLogger, which would initialize synchronous logging.
+        static void InitializeAsync(spdlog::level::level_enum defaultLevel = spdlog::level::info,
+                                    const AsyncLoggingOptions& options = {});
+
         // Initialize with custom configuration
         static void Initialize(const std::string& logFilePath,
                                spdlog::level::level_enum consoleLevel,
@@ -35,8 +49,15 @@ namespace bpmfinder::logging
         // Shutdown logging system (flush all loggers)
         static void Shutdown();
 
+        [[nodiscard]] static bool IsAsync() { return async_; }
+
     private:
+        static std::shared_ptr<spdlog::logger> CreateLogger(const std::string& name);
+
         static bool initialized_;
+        static bool async_;
+        static AsyncLoggingOptions asyncOptions_;
+        static spdlog::level::level_enum level_; // Of new loggers: the lowest level any sink passes
         static std::vector<spdlog::sink_ptr> sinks_;
 
         LoggerFactory() = default; // Prevent instantiation
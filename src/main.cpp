@@ -2,9 +2,16 @@
 // Created by Robert on 2025-09-08.
 //
 
+#include <algorithm>
 #include <iostream>
 #include <csignal>
 #include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 #include "app/BpmFinderApp.h"
 #include "app/BpmFinderAppFactory.h"
@@ -25,14 +32,778 @@ void signalHandler(const int signum)
     }
 }
 
-int main()
+// --flight-recorder FILE [--flight-seconds S], taken by every command that runs the live pipeline
+struct FlightRecorderArgs
 {
+    std::string filename;
+    double seconds = 300.0;
+};
+
+FlightRecorderArgs g_flightRecorder;
+
+// --result-block NAME, the same commands publish every estimate into a shared memory block
+std::string g_resultBlock;
+
+void snapshotSignalHandler(int)
+{
+    if (g_app)
+    {
+        g_app->RequestSnapshot(); // Only sets a flag, the app writes the snapshot
+    }
+}
+
+// Converts the whole value of an option to T. False, with a message that names the option, if the value is not a
+// number or out of the range of T.
+template <typename T>
+bool parseValue(const std::string& option, const std::string& value, T& target)
+{
+    size_t end = 0;
+    try
+    {
+        if constexpr (std::is_same_v<T, float>)
+        {
+            target = std::stof(value, &end);
+        }
+        else if constexpr (std::is_floating_point_v<T>)
+        {
+            target = std::stod(value, &end);
+        }
+        else
+        {
+            const long long parsed = std::stoll(value, &end);
+            if (!std::in_range<T>(parsed))
+            {
+                throw std::out_of_range(value);
+            }
+            target = static_cast<T>(parsed);
+        }
+    }
+    catch (const std::logic_error&) // std::invalid_argument and std::out_of_range
+    {
+        end = 0;
+    }
+
+    if (end == 0 || end != value.size())
+    {
+        std::cerr << "Invalid value for " << option << ": " << value << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Removes the flight recorder and result block options from args, false if one of their values is invalid
+bool extractFlightRecorderArgs(std::vector<std::string>& args)
+{
+    std::vector<std::string> rest;
+    for (size_t i = 0; i < args.size(); ++i)
+    {
+        if (args[i] == "--flight-recorder" && i + 1 < args.size())
+        {
+            g_flightRecorder.filename = args[++i];
+        }
+        else if (args[i] == "--flight-seconds" && i + 1 < args.size())
+        {
+            if (!parseValue("--flight-seconds", args[++i], g_flightRecorder.seconds))
+            {
+                return false;
+            }
+        }
+        else if (args[i] == "--result-block" && i + 1 < args.size())
+        {
+            g_resultBlock = args[++i];
+        }
+        else
+        {
+            rest.push_back(args[i]);
+        }
+    }
+    args = std::move(rest);
+    return true;
+}
+
+// Runs g_app until it stops, with the flight recorder and the result block if they were asked for. False if the
+// source could not be initialized.
+bool runApp()
+{
+    if (!g_resultBlock.empty() && !g_app->EnableResultBlock(g_resultBlock))
+    {
+        std::cerr << "Failed to create the result block " << g_resultBlock << std::endl;
+    }
+    if (!g_flightRecorder.filename.empty())
+    {
+        if (!g_app->EnableFlightRecorder(g_flightRecorder.filename, g_flightRecorder.seconds))
+        {
+            std::cerr << "Failed to create the flight recorder " << g_flightRecorder.filename << std::endl;
+        }
+#ifdef SIGUSR1
+        std::signal(SIGUSR1, snapshotSignalHandler);
+#endif
+    }
+    return g_app->Run();
+}
+
+void printUsage()
+{
+    std::cout << "Usage:\n"
+        << "  bpm-finder                                               live analysis of the audio output\n"
+        << "  bpm-finder replay [--speed N] [--start S] [--duration S] [--feature-log FILE] FILE\n"
+        << "                                                           replay a recording through the live pipeline\n"
+        << "\n"
+        << "  --speed    multiple of real time, 0 = flat-out with backpressure (default: 1)\n"
+        << "  --start    *.bpmr only: seconds into the recording to start at (default: 0)\n"
+        << "  --duration *.bpmr only: seconds to replay, 0 = up to the end (default: 0)\n"
+        << "  --feature-log  write the features of every chunk to FILE (*.bpmf), see FeatureLogToCsv\n"
+        << "\n"
+        << "  bpm-finder stream [--format f32|s16|s24|s32|wav] [--channels N] [--rate HZ] [INPUT]\n"
+        << "                                                           analyze raw PCM or a WAV from a pipe or file\n"
+        << "\n"
+        << "  INPUT      FIFO or file, - for stdin (default: -), *.wav files are read as WAV\n"
+        << "  --format   interleaved little endian samples, or wav to read the format from the header (default: f32)\n"
+        << "  --channels channels per frame, mixed down to mono (default: 1, WAV: from the header)\n"
+        << "  --rate     sample rate in Hz (default: 48000, WAV files: from the header)\n"
+        << "\n"
+        << "  bpm-finder shm NAME                                      analyze what a producer writes into a shared\n"
+        << "                                                           memory ring (e.g. SharedMemoryProducer)\n"
+        << "\n"
+        << "  bpm-finder rtp [--address IP] [--port N] [--format s16|s24|s32|f32] [--channels N] [--rate HZ]\n"
+        << "                 [--payload-type N] [--raw]                analyze PCM received over RTP or UDP\n"
+        << "\n"
+        << "  --address  local address to bind to (default: 0.0.0.0)\n"
+        << "  --port     UDP port (default: 5004)\n"
+        << "  --format   interleaved big endian samples, s16 = L16, s24 = L24 (default: s16)\n"
+        << "  --channels channels per frame, mixed down to mono (default: 1)\n"
+        << "  --rate     sample rate in Hz (default: 48000)\n"
+        << "  --payload-type  only accept RTP packets of this payload type (default: any)\n"
+        << "  --raw      plain UDP datagrams of samples without RTP headers\n"
+        << "\n"
+        << "  bpm-finder generate [--bpm N] [--end-bpm N --ramp S] [--swing F] [--snr DB] [--seconds S] [--speed N]\n"
+        << "                                                           analyze a synthetic click track\n"
+        << "\n"
+        << "  --bpm      tempo of the clicks (default: 120)\n"
+        << "  --end-bpm  tempo at the end of a linear ramp over --ramp seconds (default: no ramp)\n"
+        << "  --swing    delay of every second click as a fraction of a beat (default: 0)\n"
+        << "  --snr      click to noise ratio in dB (default: no noise)\n"
+        << "  --seconds  length of the signal (default: 30)\n"
+        << "  --speed    multiple of real time, 0 = flat-out with backpressure (default: 0)\n"
+        << "\n"
+        << "  bpm-finder analyze [--jobs N] [--output FILE] [--cache DIR] PATH...\n"
+        << "                                                           offline analysis of recordings\n"
+        << "\n"
+        << "  PATH       waveform.bin recording, WAV file or directory of *.bin and *.wav files\n"
+        << "  --jobs     number of files analyzed in parallel (default: one per hardware thread)\n"
+        << "  --output   results file (default: bpm-results.csv)\n"
+        << "  --cache    directory of the result cache, skips files that were analyzed before (default: no cache)\n"
+        << "\n"
+        << "  bpm-finder sweep --labels FILE [--jobs N] [--output FILE] [--tolerance T]\n"
+        << "                   [--cutoffs LOW-HIGH,...] [--windows S,...] [--thresholds T,...]\n"
+        << "                                                           evaluate a parameter grid on labelled recordings\n"
+        << "\n"
+        << "  --labels      CSV with the columns file,bpm\n"
+        << "  --output      results file (default: sweep-results.csv)\n"
+        << "  --tolerance   relative BPM error that still counts as correct (default: 0.04)\n"
+        << "  --cutoffs     band pass cutoff pairs in Hz (default: 40-800)\n"
+        << "  --windows     sliding window sizes in seconds (default: 15)\n"
+        << "  --thresholds  peak thresholds (default: 0.6)\n"
+        << "\n"
+        << "  Live analysis, replay, stream, shm, rtp and generate also take\n"
+        << "  --flight-recorder FILE  keep the last minutes of input and features in FILE, a memory-mapped ring;\n"
+        << "                          SIGUSR1 writes them to FILE-snapshot-<time>.bpmr/.bpmf\n"
+        << "  --flight-seconds S      seconds kept by the flight recorder (default: 300)\n"
+        << "  --result-block NAME     publish every estimate into the shared memory block NAME, e.g.\n"
+        << "                          /bpm-finder-result, for a front end to poll (see SharedResultMonitor)\n";
+}
+
+// Splits "a,b,c" and converts every item with convert(item, value). False as soon as one does not convert, or if
+// there is no item at all: an empty list would leave nothing to run.
+template <typename T, typename Convert>
+bool parseList(const std::string& option, const std::string& text, std::vector<T>& values, Convert convert)
+{
+    values.clear();
+    size_t start = 0;
+    while (start <= text.size())
+    {
+        const size_t end = std::min(text.find(',', start), text.size());
+        if (end > start)
+        {
+            T value{};
+            if (!convert(text.substr(start, end - start), value))
+            {
+                return false;
+            }
+            values.push_back(value);
+        }
+        start = end + 1;
+    }
+
+    if (values.empty())
+    {
+        std::cerr << "Invalid value for " << option << ": " << text << " is an empty list" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+int runBatchAnalysis(const std::vector<std::string>& args)
+{
+    unsigned jobs = 0;
+    std::string outputFile = "bpm-results.csv";
+    std::string cacheDirectory;
+    std::vector<std::string> paths;
+
+    for (size_t i = 0; i < args.size(); ++i)
+    {
+        if (args[i] == "--jobs" && i + 1 < args.size())
+        {
+            if (!parseValue("--jobs", args[++i], jobs))
+            {
+                return 1;
+            }
+        }
+        else if (args[i] == "--output" && i + 1 < args.size())
+        {
+            outputFile = args[++i];
+        }
+        else if (args[i] == "--cache" && i + 1 < args.size())
+        {
+            cacheDirectory = args[++i];
+        }
+        else
+        {
+            paths.push_back(args[i]);
+        }
+    }
+
+    const auto files = BatchAnalyzer::CollectInputFiles(paths);
+    if (files.empty())
+    {
+        printUsage();
+        return 1;
+    }
+
+    const auto analyzer = BpmFinderAppFactory::CreateBatchAnalyzer(jobs, cacheDirectory);
+    const auto results = analyzer->Analyze(files);
+
+    if (!BatchAnalyzer::WriteResults(outputFile, results))
+    {
+        std::cerr << "Failed to write results to " << outputFile << std::endl;
+        return 1;
+    }
+
+    const auto& summary = analyzer->GetSummary();
+    std::cout << "Analyzed " << summary.fileCount << " files (" << summary.failedCount << " failed), "
+        << summary.audioSeconds << " s of audio in " << summary.wallSeconds << " s: "
+        << summary.realtimeFactor << "x realtime. Results written to " << outputFile << std::endl;
+
+    bpmfinder::logging::LoggerFactory::Shutdown();
+
+    return summary.failedCount == 0 ? 0 : 1;
+}
+
+int runParameterSweep(const std::vector<std::string>& args)
+{
+    ParameterGrid grid;
+    grid.bandPassCutoffs = {{grid.base.bandPassLowCutoff, grid.base.bandPassHighCutoff}};
+    grid.slidingWindowSizeSeconds = {grid.base.slidingWindowSizeSeconds};
+    grid.peakThresholds = {grid.base.peakThreshold};
+
+    unsigned jobs = 0;
+    float tolerance = 0.04f;
+    std::string labelsFile;
+    std::string outputFile = "sweep-results.csv";
+
+    // Options only, each with its value
+    if (args.size() % 2 != 0)
+    {
+        printUsage();
+        return 1;
+    }
+
+    for (size_t i = 0; i + 1 < args.size(); i += 2)
+    {
+        const auto& option = args[i];
+        const auto& value = args[i + 1];
+        if (option == "--labels")
+        {
+            labelsFile = value;
+        }
+        else if (option == "--jobs")
+        {
+            if (!parseValue(option, value, jobs))
+            {
+                return 1;
+            }
+        }
+        else if (option == "--output")
+        {
+            outputFile = value;
+        }
+        else if (option == "--tolerance")
+        {
+            if (!parseValue(option, value, tolerance))
+            {
+                return 1;
+            }
+        }
+        else if (option == "--cutoffs")
+        {
+            const bool parsed = parseList(option, value, grid.bandPassCutoffs, [&](const std::string& item, auto& cutoffs)
+            {
+                const auto dash = item.find('-');
+                if (dash == std::string::npos)
+                {
+                    std::cerr << "Invalid value for " << option << ": " << item << " is not LOW-HIGH" << std::endl;
+                    return false;
+                }
+                return parseValue(option, item.substr(0, dash), cutoffs.first) &&
+                    parseValue(option, item.substr(dash + 1), cutoffs.second);
+            });
+            if (!parsed)
+            {
+                return 1;
+            }
+        }
+        else if (option == "--windows")
+        {
+            if (!parseList(option, value, grid.slidingWindowSizeSeconds, [&](const std::string& item, int& seconds)
+            {
+                return parseValue(option, item, seconds);
+            }))
+            {
+                return 1;
+            }
+        }
+        else if (option == "--thresholds")
+        {
+            if (!parseList(option, value, grid.peakThresholds, [&](const std::string& item, float& threshold)
+            {
+                return parseValue(option, item, threshold);
+            }))
+            {
+                return 1;
+            }
+        }
+        else
+        {
+            printUsage();
+            return 1;
+        }
+    }
+
+    const auto corpus = labelsFile.empty()
+                            ? std::vector<LabelledRecording>{}
+                            : ParameterSweep::LoadLabels(labelsFile);
+    if (corpus.empty())
+    {
+        printUsage();
+        return 1;
+    }
+
+    const auto sweep = BpmFinderAppFactory::CreateParameterSweep(grid, jobs, tolerance);
+    const auto results = sweep->Run(corpus);
+    if (results.empty())
+    {
+        std::cerr << "No parameter combination was evaluated" << std::endl;
+        return 1;
+    }
+
+    if (!ParameterSweep::WriteResults(outputFile, results))
+    {
+        std::cerr << "Failed to write results to " << outputFile << std::endl;
+        return 1;
+    }
+
+    const auto best = std::max_element(results.begin(), results.end(), [](const auto& a, const auto& b)
+    {
+        return a.accuracy < b.accuracy || (a.accuracy == b.accuracy && a.meanAbsoluteError > b.meanAbsoluteError);
+    });
+    const auto& summary = sweep->GetSummary();
+    std::cout << "Evaluated " << summary.combinationCount << " combinations on " << summary.recordingCount
+        << " recordings in " << summary.wallSeconds << " s (" << summary.upstreamComputations
+        << " filter runs shared by " << summary.downstreamComputations << " tempo estimations)\n"
+        << "Best: " << best->config.bandPassLowCutoff << "-" << best->config.bandPassHighCutoff << " Hz, window "
+        << best->config.slidingWindowSizeSeconds << " s, threshold " << best->config.peakThreshold << ": accuracy "
+        << best->accuracy << ", mean absolute error " << best->meanAbsoluteError << " BPM\n"
+        << "Results written to " << outputFile << std::endl;
+
+    bpmfinder::logging::LoggerFactory::Shutdown();
+
+    return 0;
+}
+
+int runReplay(const std::vector<std::string>& args)
+{
+    double speed = 1.0;
+    double startSeconds = 0.0;
+    double durationSeconds = 0.0;
+    std::string featureLog;
+    std::string filename;
+    for (size_t i = 0; i < args.size(); ++i)
+    {
+        if (args[i] == "--speed" && i + 1 < args.size())
+        {
+            if (!parseValue("--speed", args[++i], speed))
+            {
+                return 1;
+            }
+        }
+        else if (args[i] == "--start" && i + 1 < args.size())
+        {
+            if (!parseValue("--start", args[++i], startSeconds))
+            {
+                return 1;
+            }
+        }
+        else if (args[i] == "--duration" && i + 1 < args.size())
+        {
+            if (!parseValue("--duration", args[++i], durationSeconds))
+            {
+                return 1;
+            }
+        }
+        else if (args[i] == "--feature-log" && i + 1 < args.size())
+        {
+            featureLog = args[++i];
+        }
+        else
+        {
+            filename = args[i];
+        }
+    }
+
+    if (filename.empty())
+    {
+        printUsage();
+        return 1;
+    }
+
+    g_app = BpmFinderAppFactory::CreateReplayApp(filename, speed, startSeconds, durationSeconds, featureLog);
+    if (!runApp()) // blocks until the end of the recording or until stopped
+    {
+        bpmfinder::logging::LoggerFactory::Shutdown();
+        return 1;
+    }
+
+    std::cout << "BPM: " << g_app->GetLastBpm() << std::endl;
+
+    bpmfinder::logging::LoggerFactory::Shutdown();
+
+    return 0;
+}
+
+std::optional<bpmfinder::audio::PcmSampleFormat> parseSampleFormat(const std::string& name)
+{
+    using bpmfinder::audio::PcmSampleFormat;
+    for (const auto format : {PcmSampleFormat::Float32, PcmSampleFormat::Int16, PcmSampleFormat::Int24,
+                              PcmSampleFormat::Int32})
+    {
+        if (name == bpmfinder::audio::ToString(format))
+        {
+            return format;
+        }
+    }
+    return std::nullopt;
+}
+
+int runStream(const std::vector<std::string>& args)
+{
+    bpmfinder::audio::PcmStreamFormat format;
+    std::string input = "-";
+    bool isWav = false;
+    for (size_t i = 0; i < args.size(); ++i)
+    {
+        if (args[i] == "--format" && i + 1 < args.size())
+        {
+            const auto& name = args[++i];
+            if (name == "wav")
+            {
+                isWav = true;
+            }
+            else if (const auto sampleFormat = parseSampleFormat(name))
+            {
+                format.sampleFormat = *sampleFormat;
+            }
+            else
+            {
+                printUsage();
+                return 1;
+            }
+        }
+        else if (args[i] == "--channels" && i + 1 < args.size())
+        {
+            if (!parseValue("--channels", args[++i], format.channels))
+            {
+                return 1;
+            }
+        }
+        else if (args[i] == "--rate" && i + 1 < args.size())
+        {
+            if (!parseValue("--rate", args[++i], format.sampleRate))
+            {
+                return 1;
+            }
+        }
+        else
+        {
+            input = args[i];
+        }
+    }
+
+    isWav = isWav || (input.size() > 4 && input.compare(input.size() - 4, 4, ".wav") == 0);
+    g_app = isWav
+                ? BpmFinderAppFactory::CreateWavApp(input, format.sampleRate)
+                : BpmFinderAppFactory::CreateStreamApp(input, format);
+    if (!runApp()) // blocks until the input ends or until stopped
+    {
+        bpmfinder::logging::LoggerFactory::Shutdown();
+        return 1;
+    }
+
+    std::cout << "BPM: " << g_app->GetLastBpm() << std::endl;
+
+    bpmfinder::logging::LoggerFactory::Shutdown();
+
+    return 0;
+}
+
+int runGenerator(const std::vector<std::string>& args)
+{
+    bpmfinder::audio::SignalGeneratorOptions options;
+    options.durationSeconds = 30.0;
+    for (size_t i = 0; i + 1 < args.size(); i += 2)
+    {
+        const auto& option = args[i];
+        const auto& value = args[i + 1];
+        if (option == "--bpm")
+        {
+            if (!parseValue(option, value, options.bpm))
+            {
+                return 1;
+            }
+        }
+        else if (option == "--end-bpm")
+        {
+            if (!parseValue(option, value, options.endBpm))
+            {
+                return 1;
+            }
+        }
+        else if (option == "--ramp")
+        {
+            if (!parseValue(option, value, options.rampSeconds))
+            {
+                return 1;
+            }
+        }
+        else if (option == "--swing")
+        {
+            if (!parseValue(option, value, options.swing))
+            {
+                return 1;
+            }
+        }
+        else if (option == "--snr")
+        {
+            if (!parseValue(option, value, options.snrDb))
+            {
+                return 1;
+            }
+        }
+        else if (option == "--seconds")
+        {
+            if (!parseValue(option, value, options.durationSeconds))
+            {
+                return 1;
+            }
+        }
+        else if (option == "--speed")
+        {
+            if (!parseValue(option, value, options.speed))
+            {
+                return 1;
+            }
+        }
+        else
+        {
+            printUsage();
+            return 1;
+        }
+    }
+
+    g_app = BpmFinderAppFactory::CreateGeneratorApp(options);
+    if (!runApp()) // blocks until the end of the signal or until stopped
+    {
+        bpmfinder::logging::LoggerFactory::Shutdown();
+        return 1;
+    }
+
+    std::cout << "BPM: " << g_app->GetLastBpm() << std::endl;
+
+    bpmfinder::logging::LoggerFactory::Shutdown();
+
+    return 0;
+}
+
+int runRtp(const std::vector<std::string>& args)
+{
+    bpmfinder::audio::RtpAudioSourceOptions options;
+    for (size_t i = 0; i < args.size(); ++i)
+    {
+        const bool hasValue = i + 1 < args.size();
+        if (args[i] == "--raw")
+        {
+            options.rtp = false;
+        }
+        else if (args[i] == "--address" && hasValue)
+        {
+            options.address = args[++i];
+        }
+        else if (args[i] == "--port" && hasValue)
+        {
+            if (!parseValue("--port", args[++i], options.port))
+            {
+                return 1;
+            }
+        }
+        else if (args[i] == "--format" && hasValue)
+        {
+            const auto sampleFormat = parseSampleFormat(args[++i]);
+            if (!sampleFormat)
+            {
+                printUsage();
+                return 1;
+            }
+            options.sampleFormat = *sampleFormat;
+        }
+        else if (args[i] == "--channels" && hasValue)
+        {
+            if (!parseValue("--channels", args[++i], options.channels))
+            {
+                return 1;
+            }
+        }
+        else if (args[i] == "--rate" && hasValue)
+        {
+            if (!parseValue("--rate", args[++i], options.sampleRate))
+            {
+                return 1;
+            }
+        }
+        else if (args[i] == "--payload-type" && hasValue)
+        {
+            if (!parseValue("--payload-type", args[++i], options.payloadType))
+            {
+                return 1;
+            }
+        }
+        else
+        {
+            printUsage();
+            return 1;
+        }
+    }
+
+    g_app = BpmFinderAppFactory::CreateRtpApp(options);
+    if (!runApp()) // blocks until stopped
+    {
+        bpmfinder::logging::LoggerFactory::Shutdown();
+        return 1;
+    }
+
+    std::cout << "BPM: " << g_app->GetLastBpm() << std::endl;
+
+    bpmfinder::logging::LoggerFactory::Shutdown();
+
+    return 0;
+}
+
+int runSharedMemory(const std::vector<std::string>& args)
+{
+    if (args.size() != 1)
+    {
+        printUsage();
+        return 1;
+    }
+
+    g_app = BpmFinderAppFactory::CreateSharedMemoryApp(args[0]);
+    if (!runApp()) // blocks until the producer closes the ring or until stopped
+    {
+        bpmfinder::logging::LoggerFactory::Shutdown();
+        return 1;
+    }
+
+    std::cout << "BPM: " << g_app->GetLastBpm() << std::endl;
+
+    bpmfinder::logging::LoggerFactory::Shutdown();
+
+    return 0;
+}
+
+int main(const int argc, char* argv[])
+{
+    std::vector<std::string> args(argv + 1, argv + argc);
+    if (!extractFlightRecorderArgs(args))
+    {
+        return 1;
+    }
+
+    if (!args.empty())
+    {
+        const std::string command = args.front();
+        args.erase(args.begin());
+
+        if (command == "analyze")
+        {
+            return runBatchAnalysis(args);
+        }
+        else if (command == "replay")
+        {
+            std::signal(SIGINT, signalHandler);
+            std::signal(SIGTERM, signalHandler);
+            return runReplay(args);
+        }
+        else if (command == "stream")
+        {
+            std::signal(SIGINT, signalHandler);
+            std::signal(SIGTERM, signalHandler);
+            return runStream(args);
+        }
+        else if (command == "shm")
+        {
+            std::signal(SIGINT, signalHandler);
+            std::signal(SIGTERM, signalHandler);
+            return runSharedMemory(args);
+        }
+        else if (command == "rtp")
+        {
+            std::signal(SIGINT, signalHandler);
+            std::signal(SIGTERM, signalHandler);
+            return runRtp(args);
+        }
+        else if (command == "generate")
+        {
+            std::signal(SIGINT, signalHandler);
+            std::signal(SIGTERM, signalHandler);
+            return runGenerator(args);
+        }
+        else if (command == "sweep")
+        {
+            return runParameterSweep(args);
+        }
+
+        printUsage();
+        return 1;
+    }
+
     // Register signal handlers for graceful shutdown
     std::signal(SIGINT, signalHandler);
     std::signal(SIGTERM, signalHandler);
 
     g_app = BpmFinderAppFactory::CreateProductionApp();
-    g_app->Run(); // blocks until stopped
+    if (!runApp()) // blocks until stopped
+    {
+        bpmfinder::logging::LoggerFactory::Shutdown();
+        return 1;
+    }
 
     std::cout << "Application stopped gracefully." << std::endl;
 
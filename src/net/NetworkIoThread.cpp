@@ -0,0 +1,163 @@
+//
+// Created by Robert on 2025-11-09.
+//
+
+#include "NetworkIoThread.h"
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include "logging/LoggerFactory.h"
+
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#endif
+
+namespace bpmfinder::net
+{
+    std::shared_ptr<NetworkIoThread> NetworkIoThread::GetShared()
+    {
+        static std::mutex mutex;
+        static std::weak_ptr<NetworkIoThread> shared;
+
+        std::lock_guard lock(mutex);
+        auto thread = shared.lock();
+        if (!thread)
+        {
+            thread = std::make_shared<NetworkIoThread>();
+            shared = thread;
+        }
+        return thread;
+    }
+
+    size_t NetworkIoThread::GetHandlerCount() const
+    {
+        std::lock_guard lock(handlersMutex_);
+        return handlers_.size();
+    }
+
+#ifdef __linux__
+    NetworkIoThread::NetworkIoThread() :
+        logger_(logging::LoggerFactory::GetLogger("NetworkIoThread"))
+    {
+        epollFd_ = epoll_create1(EPOLL_CLOEXEC);
+        wakeFd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (epollFd_ < 0 || wakeFd_ < 0)
+        {
+            logger_->error("Failed to create the epoll instance: {}", std::strerror(errno));
+            return;
+        }
+
+        // The wake up event has no handler
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.ptr = nullptr;
+        epoll_ctl(epollFd_, EPOLL_CTL_ADD, wakeFd_, &event);
+
+        running_ = true;
+        thread_ = std::thread(&NetworkIoThread::Run, this);
+    }
+
+    NetworkIoThread::~NetworkIoThread()
+    {
+        running_ = false;
+        if (wakeFd_ >= 0)
+        {
+            constexpr uint64_t one = 1;
+            [[maybe_unused]] const auto written = write(wakeFd_, &one, sizeof(one));
+        }
+        if (thread_.joinable())
+        {
+            thread_.join();
+        }
+
+        if (wakeFd_ >= 0)
+        {
+            close(wakeFd_);
+        }
+        if (epollFd_ >= 0)
+        {
+            close(epollFd_);
+        }
+    }
+
+    bool NetworkIoThread::Add(const int fd, INetworkHandler* handler)
+    {
+        if (!running_)
+        {
+            return false;
+        }
+
+        std::lock_guard lock(handlersMutex_);
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.ptr = handler;
+        if (epoll_ctl(epollFd_, EPOLL_CTL_ADD, fd, &event) != 0)
+        {
+            logger_->error("Failed to watch socket {}: {}", fd, std::strerror(errno));
+            return false;
+        }
+        handlers_.insert(handler);
+        return true;
+    }
+
+    void NetworkIoThread::Remove(const int fd, INetworkHandler* handler)
+    {
+        std::lock_guard lock(handlersMutex_);
+        epoll_ctl(epollFd_, EPOLL_CTL_DEL, fd, nullptr);
+        handlers_.erase(handler);
+    }
+
+    void NetworkIoThread::Run()
+    {
+        std::array<epoll_event, 64> events{};
+        while (running_)
+        {
+            const int count = epoll_wait(epollFd_, events.data(), static_cast<int>(events.size()), -1);
+            if (count < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                logger_->error("epoll_wait failed: {}", std::strerror(errno));
+                return;
+            }
+
+            std::lock_guard lock(handlersMutex_);
+            for (int i = 0; i < count; ++i)
+            {
+                auto* handler = static_cast<INetworkHandler*>(events[i].data.ptr);
+
+                // Removed between epoll_wait and here: its object may be gone already
+                if (handler != nullptr && handlers_.contains(handler))
+                {
+                    handler->OnReadable();
+                }
+            }
+        }
+    }
+#else
+    NetworkIoThread::NetworkIoThread() :
+        logger_(logging::LoggerFactory::GetLogger("NetworkIoThread"))
+    {
+    }
+
+    NetworkIoThread::~NetworkIoThread() = default;
+
+    bool NetworkIoThread::Add(int, INetworkHandler*)
+    {
+        logger_->error("Network sources need epoll, which is only available on Linux");
+        return false;
+    }
+
+    void NetworkIoThread::Remove(int, INetworkHandler*)
+    {
+    }
+
+    void NetworkIoThread::Run()
+    {
+    }
+#endif
+}
@@ -0,0 +1,63 @@
+//
+// Created by Robert on 2025-11-09.
+//
+
+#pragma once
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+#include "spdlog/logger.h"
+
+namespace bpmfinder::net
+{
+    // Something that reads from a non-blocking socket when it becomes readable
+    class INetworkHandler
+    {
+    public:
+        virtual ~INetworkHandler() = default;
+
+        // Called on the I/O thread, read until the socket would block
+        virtual void OnReadable() = 0;
+    };
+
+    // One epoll loop for many sockets: every network source registers its socket here instead of running a receive
+    // thread of its own. Handlers run one after the other on this thread, so they must not block.
+    // Linux only, elsewhere Add fails.
+    class NetworkIoThread
+    {
+    public:
+        NetworkIoThread();
+        ~NetworkIoThread();
+
+        NetworkIoThread(const NetworkIoThread&) = delete;
+        NetworkIoThread& operator=(const NetworkIoThread&) = delete;
+
+        // The thread all sources share unless they are given one, created on first use and stopped when the last
+        // user releases it
+        static std::shared_ptr<NetworkIoThread> GetShared();
+
+        // Calls handler->OnReadable whenever 'fd' is readable
+        bool Add(int fd, INetworkHandler* handler);
+
+        // After Remove returns, the handler is not called anymore and not running either. Not from a handler.
+        void Remove(int fd, INetworkHandler* handler);
+
+        [[nodiscard]] size_t GetHandlerCount() const;
+
+    private:
+        void Run();
+
+        int epollFd_ = -1;
+        int wakeFd_ = -1;
+        std::atomic<bool> running_{false};
+        std::thread thread_;
+
+        // Held while handlers run: Remove waits for a running handler and events of removed handlers are dropped
+        mutable std::mutex handlersMutex_;
+        std::unordered_set<INetworkHandler*> handlers_;
+
+        std::shared_ptr<spdlog::logger> logger_;
+    };
+}
@@ -0,0 +1,137 @@
+//
+// Created by Robert on 2025-11-09.
+//
+
+#include "RtpJitterBuffer.h"
+#include <algorithm>
+
+namespace bpmfinder::net
+{
+    RtpJitterBuffer::RtpJitterBuffer(const size_t depth, const size_t capacity) :
+        depth_(std::max<size_t>(1, depth)),
+        slots_(std::max(capacity, depth_ + 1))
+    {
+    }
+
+    void RtpJitterBuffer::Reset()
+    {
+        for (auto& slot : slots_)
+        {
+            slot.sequence = -1;
+        }
+        started_ = false;
+        next_ = 0;
+        highest_ = 0;
+        lastPacketSamples_ = 0;
+        backwardJumpNext_ = -1;
+    }
+
+    void RtpJitterBuffer::Resync(const int64_t sequence)
+    {
+        for (auto& slot : slots_)
+        {
+            slot.sequence = -1;
+        }
+        ++statistics_.resyncs;
+        next_ = sequence;
+        highest_ = sequence;
+    }
+
+    void RtpJitterBuffer::Push(const uint16_t sequenceNumber, const float* samples, const size_t count)
+    {
+        ++statistics_.receivedPackets;
+
+        // Extend to 64 bit relative to the highest one so far: the nearest value with these lower 16 bits
+        int64_t sequence = sequenceNumber;
+        if (started_)
+        {
+            const auto delta = static_cast<int16_t>(static_cast<uint16_t>(sequenceNumber -
+                static_cast<uint16_t>(highest_)));
+            sequence = highest_ + delta;
+        }
+        else
+        {
+            // Far from 0, so extended numbers before the first packet stay positive
+            sequence += int64_t{1} << 32;
+            started_ = true;
+            next_ = sequence;
+            highest_ = sequence;
+        }
+
+        // Too far back to be a late packet, its slot has been reused since: a sender that restarted with lower
+        // sequence numbers. A single stray packet must not throw the stream back, so like the probation in RFC 3550
+        // the jump only counts once the next packet follows it in order; the first one is dropped as late.
+        if (next_ - sequence >= static_cast<int64_t>(slots_.size()))
+        {
+            if (sequence != backwardJumpNext_)
+            {
+                backwardJumpNext_ = sequence + 1;
+                ++statistics_.latePackets;
+                return;
+            }
+            Resync(sequence);
+        }
+        backwardJumpNext_ = -1;
+
+        if (sequence < next_)
+        {
+            // Passed on already. Slots keep the sequence number of the packet passed on last, so a packet that was
+            // received is a duplicate, one that was concealed arrived too late.
+            if (GetSlot(sequence).sequence == sequence)
+            {
+                ++statistics_.duplicatePackets;
+            }
+            else
+            {
+                ++statistics_.latePackets;
+            }
+            return;
+        }
+
+        // Too far ahead to be filled: the sender restarted or a long outage, continue from here without filling
+        if (sequence - next_ >= static_cast<int64_t>(slots_.size()))
+        {
+            Resync(sequence);
+        }
+
+        auto& slot = GetSlot(sequence);
+        if (slot.sequence == sequence)
+        {
+            ++statistics_.duplicatePackets;
+            return;
+        }
+
+        slot.sequence = sequence;
+        slot.samples.assign(samples, samples + count);
+        highest_ = std::max(highest_, sequence);
+    }
+
+    void RtpJitterBuffer::Pop(std::vector<float>& output)
+    {
+        if (!started_)
+        {
+            return;
+        }
+
+        while (next_ <= highest_)
+        {
+            if (auto& slot = GetSlot(next_); slot.sequence == next_)
+            {
+                output.insert(output.end(), slot.samples.begin(), slot.samples.end());
+                lastPacketSamples_ = slot.samples.size();
+            }
+            else if (highest_ - next_ >= static_cast<int64_t>(depth_))
+            {
+                // Waited long enough, the packet is lost: silence of the same length keeps the timing
+                output.insert(output.end(), lastPacketSamples_, 0.0f);
+                ++statistics_.lostPackets;
+                statistics_.concealedSamples += lastPacketSamples_;
+            }
+            else
+            {
+                return;
+            }
+            ++next_;
+        }
+    }
+}
@@ -0,0 +1,66 @@
+//
+// Created by Robert on 2025-11-09.
+//
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace bpmfinder::net
+{
+    struct RtpJitterBufferStatistics
+    {
+        uint64_t receivedPackets = 0;
+        uint64_t lostPackets = 0; // Never arrived in time, replaced by silence
+        uint64_t latePackets = 0; // Arrived after their place in the stream was passed on already, dropped
+        uint64_t duplicatePackets = 0;
+        uint64_t concealedSamples = 0; // Zeros in place of the lost packets
+        uint64_t resyncs = 0; // Jumps in the sequence numbers too large to fill or to be late, e.g. a restarted sender
+    };
+
+    // Puts RTP packets back into sequence number order. A packet is passed on as soon as all packets before it have
+    // been; a missing packet is waited for until 'depth' newer packets have arrived, then it is counted as lost and
+    // replaced by as many zeros as the packet before it had. 16 bit sequence numbers wrap around. A jump by at least
+    // the capacity resyncs, forward at once, backward once two packets in a row confirm it.
+    // Single threaded: the receiving thread pushes and pops.
+    class RtpJitterBuffer
+    {
+    public:
+        explicit RtpJitterBuffer(size_t depth = 4, size_t capacity = 64);
+
+        // Samples of one packet, already converted to float. Late and duplicate packets are dropped and counted.
+        void Push(uint16_t sequenceNumber, const float* samples, size_t count);
+
+        // Appends every packet that is due, in order, to 'output'
+        void Pop(std::vector<float>& output);
+
+        // Back to the state before the first packet
+        void Reset();
+
+        [[nodiscard]] const RtpJitterBufferStatistics& GetStatistics() const { return statistics_; }
+
+    private:
+        struct Slot
+        {
+            int64_t sequence = -1; // Extended sequence number of the packet held or passed on last, -1 for none
+            std::vector<float> samples;
+        };
+
+        Slot& GetSlot(int64_t sequence) { return slots_[static_cast<size_t>(sequence) % slots_.size()]; }
+
+        // Drops everything held and continues the stream at 'sequence'
+        void Resync(int64_t sequence);
+
+        size_t depth_;
+        std::vector<Slot> slots_;
+
+        bool started_ = false;
+        int64_t next_ = 0; // Extended sequence number of the next packet to pass on
+        int64_t highest_ = 0; // Highest extended sequence number received
+        size_t lastPacketSamples_ = 0;
+        int64_t backwardJumpNext_ = -1; // After a packet far behind the stream: the sequence that confirms the jump
+
+        RtpJitterBufferStatistics statistics_;
+    };
+}
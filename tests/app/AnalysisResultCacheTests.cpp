@@ -0,0 +1,110 @@
+//
+// Created by Robert on 2025-10-30.
+//
+
+#include <gtest/gtest.h>
+#include "../../src/app/AnalysisResultCache.h"
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+using namespace bpmfinder::app;
+using namespace bpmfinder::dsp::time_domain_onset_detection;
+
+// ============================================================================
+// Test Fixture
+// ============================================================================
+
+class AnalysisResultCacheTests : public ::testing::Test
+{
+protected:
+    std::filesystem::path directory_ = std::filesystem::temp_directory_path() / "bpm_finder_result_cache_tests";
+
+    void SetUp() override
+    {
+        std::filesystem::remove_all(directory_);
+    }
+
+    void TearDown() override
+    {
+        std::filesystem::remove_all(directory_);
+    }
+};
+
+TEST_F(AnalysisResultCacheTests, WhenOneSampleChanges_ThenHashChanges)
+{
+    // -------------------- Arrange --------------------
+    std::vector<float> samples(1001);
+    for (size_t i = 0; i < samples.size(); ++i)
+    {
+        samples[i] = static_cast<float>(i) * 0.001f;
+    }
+    auto changed = samples;
+    changed[500] = std::nextafter(changed[500], 1.0f);
+
+    // -------------------- Act ------------------------
+    const auto hash = AnalysisResultCache::HashSamples(samples.data(), samples.size());
+    const auto changedHash = AnalysisResultCache::HashSamples(changed.data(), changed.size());
+    const auto shorterHash = AnalysisResultCache::HashSamples(samples.data(), samples.size() - 1);
+
+    // -------------------- Assert ---------------------
+    EXPECT_EQ(hash, AnalysisResultCache::HashSamples(samples.data(), samples.size()));
+    EXPECT_NE(hash, changedHash);
+    EXPECT_NE(hash, shorterHash);
+}
+
+TEST_F(AnalysisResultCacheTests, WhenDownstreamParameterChanges_ThenOnlyResultKeyChanges)
+{
+    // -------------------- Arrange --------------------
+    const TimeDomainOnsetDetectionConfig config;
+    auto thresholdChanged = config;
+    thresholdChanged.peakThreshold = 0.5f;
+    auto gainChanged = config;
+    gainChanged.bandPassGain = 2.0f;
+
+    // -------------------- Act ------------------------
+    const auto upstreamKey = AnalysisResultCache::GetUpstreamKey(42, config);
+
+    // -------------------- Assert ---------------------
+    EXPECT_EQ(AnalysisResultCache::GetUpstreamKey(42, thresholdChanged), upstreamKey);
+    EXPECT_NE(AnalysisResultCache::GetResultKey(upstreamKey, thresholdChanged),
+              AnalysisResultCache::GetResultKey(upstreamKey, config));
+    EXPECT_NE(AnalysisResultCache::GetUpstreamKey(42, gainChanged), upstreamKey);
+    EXPECT_NE(AnalysisResultCache::GetUpstreamKey(43, config), upstreamKey);
+}
+
+TEST_F(AnalysisResultCacheTests, WhenEntriesAreStored_ThenTheyAreLoadedBack)
+{
+    // -------------------- Arrange --------------------
+    const AnalysisResultCache cache(directory_);
+    const CachedOnsetSeries series{4096, {1.0f, 2.0f, 3.0f, 4.0f}, {0.0f, 1.0f, 1.0f, 1.0f}};
+
+    // -------------------- Act ------------------------
+    ASSERT_TRUE(cache.StoreBpm(1, 123.5f));
+    ASSERT_TRUE(cache.StoreOnsetSeries(2, series));
+
+    // -------------------- Assert ---------------------
+    EXPECT_EQ(cache.LoadBpm(1), 123.5f);
+    EXPECT_FALSE(cache.LoadBpm(2).has_value());
+
+    const auto loaded = cache.LoadOnsetSeries(2);
+    ASSERT_TRUE(loaded.has_value());
+    EXPECT_EQ(loaded->sampleCount, series.sampleCount);
+    EXPECT_EQ(loaded->energy, series.energy);
+    EXPECT_EQ(loaded->onsetStrength, series.onsetStrength);
+}
+
+TEST_F(AnalysisResultCacheTests, WhenEntryIsTruncated_ThenItIsIgnored)
+{
+    // -------------------- Arrange --------------------
+    const AnalysisResultCache cache(directory_);
+    ASSERT_TRUE(cache.StoreOnsetSeries(7, {4096, {1.0f, 2.0f, 3.0f, 4.0f}, {0.0f, 1.0f, 1.0f, 1.0f}}));
+
+    const auto entry = directory_ / "0000000000000007.onset";
+    ASSERT_TRUE(std::filesystem::exists(entry));
+    std::filesystem::resize_file(entry, std::filesystem::file_size(entry) - 3);
+
+    // -------------------- Act & Assert ---------------
+    EXPECT_FALSE(cache.LoadOnsetSeries(7).has_value());
+}
@@ -0,0 +1,332 @@
+//
+// Created by Robert on 2025-10-29.
+//
+
+#include <gtest/gtest.h>
+#include "../../src/app/BatchAnalyzer.h"
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <sstream>
+#include <thread>
+#include <vector>
+#ifndef _WIN32
+#include <sys/stat.h>
+#endif
+
+using namespace bpmfinder::app;
+using namespace bpmfinder::dsp::time_domain_onset_detection;
+
+// ============================================================================
+// Test Fixture
+// ============================================================================
+
+class BatchAnalyzerTests : public ::testing::Test
+{
+protected:
+    std::filesystem::path directory_ = std::filesystem::temp_directory_path() / "bpm_finder_batch_analyzer_tests";
+    TimeDomainOnsetDetectionConfig config_;
+
+    void SetUp() override
+    {
+        std::filesystem::remove_all(directory_);
+        std::filesystem::create_directories(directory_);
+    }
+
+    void TearDown() override
+    {
+        std::filesystem::remove_all(directory_);
+    }
+
+    // Writes a click track in the waveform.bin format: short 100 Hz bursts on every beat, on top of quiet noise
+    std::filesystem::path WriteClickTrack(const std::string& name, const float bpm, const float seconds) const
+    {
+        std::mt19937 generator(42);
+        std::uniform_real_distribution<float> noise(-0.01f, 0.01f);
+
+        const auto length = static_cast<size_t>(seconds * static_cast<float>(config_.sampleRate));
+        const auto beatPeriod = static_cast<size_t>(60.0f / bpm * static_cast<float>(config_.sampleRate));
+        std::vector<float> signal(length);
+        for (size_t n = 0; n < length; ++n)
+        {
+            const size_t position = n % beatPeriod;
+            const float burst = position < 2000
+                                    ? std::sin(2.0f * static_cast<float>(M_PI) * 100.0f * static_cast<float>(position) /
+                                        static_cast<float>(config_.sampleRate))
+                                    : 0.0f;
+            signal[n] = burst + noise(generator);
+        }
+
+        const auto path = directory_ / name;
+        std::ofstream file(path, std::ios::binary);
+        file.write(reinterpret_cast<const char*>(signal.data()),
+                   static_cast<std::streamsize>(signal.size() * sizeof(float)));
+        return path;
+    }
+};
+
+TEST_F(BatchAnalyzerTests, WhenAnalyzingDirectory_ThenEveryFileGetsItsBpmInOrder)
+{
+    // -------------------- Arrange --------------------
+    WriteClickTrack("b.bin", 120.0f, 20.0f);
+    WriteClickTrack("a.bin", 100.0f, 20.0f);
+    WriteClickTrack("c.bin", 140.0f, 20.0f);
+    std::ofstream(directory_ / "notes.txt") << "not a recording";
+
+    BatchAnalyzer analyzer(config_, 2);
+
+    // -------------------- Act ------------------------
+    const auto files = BatchAnalyzer::CollectInputFiles({directory_.string()});
+    const auto results = analyzer.Analyze(files);
+
+    // -------------------- Assert ---------------------
+    ASSERT_EQ(results.size(), 3u);
+    EXPECT_EQ(results[0].file.filename(), "a.bin");
+    EXPECT_EQ(results[1].file.filename(), "b.bin");
+    EXPECT_EQ(results[2].file.filename(), "c.bin");
+
+    const std::vector<float> tempos = {100.0f, 120.0f, 140.0f};
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        EXPECT_TRUE(results[i].success);
+        EXPECT_EQ(results[i].sampleCount, static_cast<size_t>(20 * config_.sampleRate));
+        EXPECT_DOUBLE_EQ(results[i].audioSeconds, 20.0);
+        EXPECT_NEAR(results[i].bpm, tempos[i], tempos[i] * 0.06f) << results[i].file;
+    }
+
+    const auto& summary = analyzer.GetSummary();
+    EXPECT_EQ(summary.fileCount, 3u);
+    EXPECT_EQ(summary.failedCount, 0u);
+    EXPECT_DOUBLE_EQ(summary.audioSeconds, 60.0);
+    EXPECT_GT(summary.realtimeFactor, 1.0);
+}
+
+TEST_F(BatchAnalyzerTests, WhenFileIsMissing_ThenOnlyThatFileFails)
+{
+    // -------------------- Arrange --------------------
+    const auto existing = WriteClickTrack("existing.bin", 120.0f, 20.0f);
+    const auto missing = directory_ / "missing.bin";
+
+    BatchAnalyzer analyzer(config_, 4);
+
+    // -------------------- Act ------------------------
+    const auto results = analyzer.Analyze({missing, existing});
+
+    // -------------------- Assert ---------------------
+    ASSERT_EQ(results.size(), 2u);
+    EXPECT_FALSE(results[0].success);
+    EXPECT_FALSE(results[0].error.empty());
+    EXPECT_TRUE(results[1].success);
+    EXPECT_EQ(analyzer.GetSummary().failedCount, 1u);
+}
+
+TEST_F(BatchAnalyzerTests, WhenFileCanNotBeRead_ThenItIsAFailedRowAndTheBatchGoesOn)
+{
+    // -------------------- Arrange --------------------
+    const auto existing = WriteClickTrack("existing.bin", 120.0f, 20.0f);
+    const auto unreadable = directory_ / "folder.bin"; // Opens, but every read fails
+    std::filesystem::create_directories(unreadable);
+
+    BatchAnalyzer analyzer(config_, 1);
+
+    // -------------------- Act ------------------------
+    const auto results = analyzer.Analyze({unreadable, existing});
+
+    // -------------------- Assert ---------------------
+    ASSERT_EQ(results.size(), 2u);
+    EXPECT_FALSE(results[0].success);
+    EXPECT_FALSE(results[0].error.empty());
+    EXPECT_TRUE(results[1].success);
+    EXPECT_EQ(analyzer.GetSummary().failedCount, 1u);
+}
+
+#ifndef _WIN32
+TEST_F(BatchAnalyzerTests, WhenFileIsAPipe_ThenItIsReadUntilTheWriterClosesIt)
+{
+    // -------------------- Arrange --------------------
+    const auto path = WriteClickTrack("click.bin", 120.0f, 20.0f);
+    std::ifstream input(path, std::ios::binary);
+    const std::vector<char> bytes{std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>()};
+    const auto fifo = directory_ / "fifo";
+    ASSERT_EQ(mkfifo(fifo.c_str(), 0600), 0);
+
+    // Odd pieces, so floats are split between two reads
+    std::thread writer([&]
+    {
+        std::ofstream output(fifo, std::ios::binary);
+        for (size_t offset = 0; offset < bytes.size(); offset += 1001)
+        {
+            output.write(bytes.data() + offset, static_cast<std::streamsize>(std::min<size_t>(1001, bytes.size() -
+                             offset)));
+        }
+    });
+
+    BatchAnalyzer analyzer(config_, 1);
+
+    // -------------------- Act ------------------------
+    const auto results = analyzer.Analyze({fifo, path});
+    writer.join();
+
+    // -------------------- Assert ---------------------
+    ASSERT_EQ(results.size(), 2u);
+    ASSERT_TRUE(results[0].success) << results[0].error;
+    EXPECT_EQ(results[0].sampleCount, results[1].sampleCount);
+    EXPECT_FLOAT_EQ(results[0].bpm, results[1].bpm);
+}
+#endif
+
+TEST_F(BatchAnalyzerTests, WhenWritingResults_ThenOneCsvRowPerFile)
+{
+    // -------------------- Arrange --------------------
+    const auto file = WriteClickTrack("track.bin", 120.0f, 20.0f);
+    BatchAnalyzer analyzer(config_, 1);
+    const auto results = analyzer.Analyze({file});
+    const auto outputFile = directory_ / "results.csv";
+
+    // -------------------- Act ------------------------
+    ASSERT_TRUE(BatchAnalyzer::WriteResults(outputFile, results));
+
+    // -------------------- Assert ---------------------
+    std::ifstream in(outputFile);
+    std::string header, row, end;
+    std::getline(in, header);
+    std::getline(in, row);
+    EXPECT_EQ(header, "file,success,samples,audio_seconds,wall_seconds,realtime_factor,bpm,cache,error");
+    EXPECT_NE(row.find("track.bin\",1,960000,20,"), std::string::npos) << row;
+    EXPECT_FALSE(std::getline(in, end));
+}
+
+TEST_F(BatchAnalyzerTests, WhenFileOrErrorHoldsCommasQuotesOrLineBreaks_ThenTheyAreQuotedInTheirField)
+{
+    // -------------------- Arrange --------------------
+    FileAnalysisResult result;
+    result.file = "my \"best\", track.bin";
+    result.error = "failed: \"x\",\nagain";
+    const auto outputFile = directory_ / "results.csv";
+
+    // -------------------- Act ------------------------
+    ASSERT_TRUE(BatchAnalyzer::WriteResults(outputFile, {result}));
+
+    // -------------------- Assert ---------------------
+    std::ifstream in(outputFile);
+    const std::string content{std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+    EXPECT_EQ(content, "file,success,samples,audio_seconds,wall_seconds,realtime_factor,bpm,cache,error\n"
+              "\"my \"\"best\"\", track.bin\",0,0,0,0,0,0,off,\"failed: \"\"x\"\",\nagain\"\n");
+}
+
+TEST_F(BatchAnalyzerTests, WhenAnalyzingTwice_ThenSecondRunIsCacheHit)
+{
+    // -------------------- Arrange --------------------
+    const auto file = WriteClickTrack("track.bin", 120.0f, 20.0f);
+    const auto cache = std::make_shared<AnalysisResultCache>(directory_ / "cache");
+    BatchAnalyzer analyzer(config_, 1, cache);
+
+    // -------------------- Act ------------------------
+    const auto first = analyzer.Analyze({file});
+    const auto second = analyzer.Analyze({file});
+
+    // -------------------- Assert ---------------------
+    EXPECT_EQ(first[0].cacheStatus, CacheStatus::Miss);
+    EXPECT_EQ(second[0].cacheStatus, CacheStatus::Hit);
+    EXPECT_EQ(second[0].bpm, first[0].bpm);
+    EXPECT_EQ(second[0].sampleCount, first[0].sampleCount);
+}
+
+TEST_F(BatchAnalyzerTests, WhenOnlyDownstreamParametersChange_ThenResultMatchesFullAnalysis)
+{
+    // -------------------- Arrange --------------------
+    const auto file = WriteClickTrack("track.bin", 120.0f, 20.0f);
+    const auto cache = std::make_shared<AnalysisResultCache>(directory_ / "cache");
+    (void)BatchAnalyzer(config_, 1, cache).Analyze({file});
+
+    auto changedConfig = config_;
+    changedConfig.peakThreshold = 0.4f;
+    changedConfig.slidingWindowSizeSeconds = 10;
+
+    // -------------------- Act ------------------------
+    const auto resumed = BatchAnalyzer(changedConfig, 1, cache).Analyze({file});
+    const auto uncached = BatchAnalyzer(changedConfig, 1).Analyze({file});
+
+    // -------------------- Assert ---------------------
+    EXPECT_EQ(resumed[0].cacheStatus, CacheStatus::OnsetSeriesHit);
+    EXPECT_EQ(uncached[0].cacheStatus, CacheStatus::Disabled);
+    EXPECT_GT(uncached[0].bpm, 0.0f);
+    EXPECT_EQ(resumed[0].bpm, uncached[0].bpm);
+}
+
+TEST_F(BatchAnalyzerTests, WhenUpstreamParametersChange_ThenFileIsAnalyzedAgain)
+{
+    // -------------------- Arrange --------------------
+    const auto file = WriteClickTrack("track.bin", 120.0f, 20.0f);
+    const auto cache = std::make_shared<AnalysisResultCache>(directory_ / "cache");
+    (void)BatchAnalyzer(config_, 1, cache).Analyze({file});
+
+    auto changedConfig = config_;
+    changedConfig.bandPassHighCutoff = 400;
+
+    // -------------------- Act ------------------------
+    const auto results = BatchAnalyzer(changedConfig, 1, cache).Analyze({file});
+
+    // -------------------- Assert ---------------------
+    EXPECT_EQ(results[0].cacheStatus, CacheStatus::Miss);
+}
+
+TEST_F(BatchAnalyzerTests, WhenAnalyzingWav_ThenSampleRateIsTakenFromHeader)
+{
+    // -------------------- Arrange --------------------
+    // The click track at 44.1 kHz as a 16 bit mono WAV: analyzed at 48 kHz it would come out ~9% too fast
+    config_.sampleRate = 44100;
+    const auto clickTrack = WriteClickTrack("track.bin", 120.0f, 20.0f);
+    config_.sampleRate = 48000;
+
+    std::vector<float> samples(std::filesystem::file_size(clickTrack) / sizeof(float));
+    std::ifstream(clickTrack, std::ios::binary).read(reinterpret_cast<char*>(samples.data()),
+                                                     static_cast<std::streamsize>(samples.size() * sizeof(float)));
+    std::filesystem::remove(clickTrack);
+
+    const auto wavPath = directory_ / "track.WAV";
+    {
+        const auto dataBytes = static_cast<uint32_t>(samples.size() * sizeof(int16_t));
+        std::ofstream wav(wavPath, std::ios::binary);
+        const auto write = [&wav](const uint32_t value, const int bytes)
+        {
+            for (int i = 0; i < bytes; ++i)
+            {
+                wav.put(static_cast<char>(value >> (8 * i) & 0xFF));
+            }
+        };
+        wav << "RIFF";
+        write(36 + dataBytes, 4);
+        wav << "WAVEfmt ";
+        write(16, 4);
+        write(1, 2); // PCM
+        write(1, 2); // Mono
+        write(44100, 4);
+        write(44100 * 2, 4);
+        write(2, 2);
+        write(16, 2);
+        wav << "data";
+        write(dataBytes, 4);
+        for (const float sample : samples)
+        {
+            const auto value = static_cast<int16_t>(std::clamp(sample, -1.0f, 1.0f) * 32767.0f);
+            write(static_cast<uint16_t>(value), 2);
+        }
+    }
+
+    BatchAnalyzer analyzer(config_, 1);
+
+    // -------------------- Act ------------------------
+    const auto files = BatchAnalyzer::CollectInputFiles({directory_.string()});
+    const auto results = analyzer.Analyze(files);
+
+    // -------------------- Assert ---------------------
+    ASSERT_EQ(results.size(), 1u);
+    EXPECT_TRUE(results[0].success);
+    EXPECT_EQ(results[0].sampleCount, samples.size());
+    EXPECT_DOUBLE_EQ(results[0].audioSeconds, 20.0);
+    EXPECT_NEAR(results[0].bpm, 120.0f, 120.0f * 0.06f);
+}
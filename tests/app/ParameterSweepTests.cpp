@@ -0,0 +1,206 @@
+//
+// Created by Robert on 2025-10-31.
+//
+
+#include <gtest/gtest.h>
+#include "../../src/app/ParameterSweep.h"
+#include "../../src/app/BatchAnalyzer.h"
+#include "../../src/files/recording/RecordingWriter.h"
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <vector>
+
+using namespace bpmfinder::app;
+using namespace bpmfinder::dsp::time_domain_onset_detection;
+
+// ============================================================================
+// Test Fixture
+// ============================================================================
+
+class ParameterSweepTests : public ::testing::Test
+{
+protected:
+    std::filesystem::path directory_ = std::filesystem::temp_directory_path() / "bpm_finder_parameter_sweep_tests";
+    TimeDomainOnsetDetectionConfig config_;
+
+    void SetUp() override
+    {
+        std::filesystem::remove_all(directory_);
+        std::filesystem::create_directories(directory_);
+    }
+
+    void TearDown() override
+    {
+        std::filesystem::remove_all(directory_);
+    }
+
+    // Click track: short 100 Hz bursts on every beat, on top of quiet noise
+    static std::vector<float> CreateClickTrack(const float bpm, const float seconds, const int sampleRate)
+    {
+        std::mt19937 generator(42);
+        std::uniform_real_distribution<float> noise(-0.01f, 0.01f);
+
+        const auto length = static_cast<size_t>(seconds * static_cast<float>(sampleRate));
+        const auto beatPeriod = static_cast<size_t>(60.0f / bpm * static_cast<float>(sampleRate));
+        std::vector<float> signal(length);
+        for (size_t n = 0; n < length; ++n)
+        {
+            const size_t position = n % beatPeriod;
+            const float burst = position < 2000
+                                    ? std::sin(2.0f * static_cast<float>(M_PI) * 100.0f * static_cast<float>(position) /
+                                        static_cast<float>(sampleRate))
+                                    : 0.0f;
+            signal[n] = burst + noise(generator);
+        }
+        return signal;
+    }
+
+    // Writes a click track in the waveform.bin format
+    std::filesystem::path WriteClickTrack(const std::string& name, const float bpm, const float seconds) const
+    {
+        const auto signal = CreateClickTrack(bpm, seconds, config_.sampleRate);
+        const auto path = directory_ / name;
+        std::ofstream file(path, std::ios::binary);
+        file.write(reinterpret_cast<const char*>(signal.data()),
+                   static_cast<std::streamsize>(signal.size() * sizeof(float)));
+        return path;
+    }
+
+    ParameterGrid CreateGrid() const
+    {
+        ParameterGrid grid;
+        grid.base = config_;
+        grid.bandPassCutoffs = {{40, 800}, {60, 400}};
+        grid.slidingWindowSizeSeconds = {10, 15};
+        grid.peakThresholds = {0.5f, 0.6f};
+        return grid;
+    }
+};
+
+TEST_F(ParameterSweepTests, WhenSweepingGrid_ThenEveryCombinationMatchesFullAnalysis)
+{
+    // -------------------- Arrange --------------------
+    const std::vector<LabelledRecording> corpus = {
+        {WriteClickTrack("a.bin", 100.0f, 20.0f), 100.0f},
+        {WriteClickTrack("b.bin", 120.0f, 20.0f), 120.0f},
+        {WriteClickTrack("c.bin", 140.0f, 20.0f), 140.0f},
+    };
+    ParameterSweep sweep(CreateGrid(), 2, 0.06f);
+
+    // -------------------- Act ------------------------
+    const auto results = sweep.Run(corpus);
+
+    // -------------------- Assert ---------------------
+    ASSERT_EQ(results.size(), 8u);
+    for (const auto& result : results)
+    {
+        // Sharing the onset curve must not change anything compared to analyzing each combination on its own
+        const auto reference = BatchAnalyzer(result.config, 1).Analyze({corpus[0].file, corpus[1].file,
+                                                                        corpus[2].file});
+        for (size_t r = 0; r < corpus.size(); ++r)
+        {
+            EXPECT_EQ(result.bpm[r], reference[r].bpm) << corpus[r].file << " low " << result.config.bandPassLowCutoff
+                << " window " << result.config.slidingWindowSizeSeconds << " threshold " << result.config.
+                peakThreshold;
+        }
+    }
+
+    const auto defaultCombination = std::find_if(results.begin(), results.end(), [this](const auto& result)
+    {
+        return result.config.bandPassHighCutoff == config_.bandPassHighCutoff &&
+            result.config.slidingWindowSizeSeconds == config_.slidingWindowSizeSeconds &&
+            result.config.peakThreshold == config_.peakThreshold;
+    });
+    ASSERT_NE(defaultCombination, results.end());
+    EXPECT_EQ(defaultCombination->correctCount, 3u);
+    EXPECT_DOUBLE_EQ(defaultCombination->accuracy, 1.0);
+
+    const auto& summary = sweep.GetSummary();
+    EXPECT_EQ(summary.combinationCount, 8u);
+    EXPECT_EQ(summary.upstreamComputations, 6u); // 3 recordings * 2 cutoff pairs, not * 8 combinations
+    EXPECT_EQ(summary.downstreamComputations, 24u);
+}
+
+TEST_F(ParameterSweepTests, WhenRecordingIsMissing_ThenItCountsAsWrong)
+{
+    // -------------------- Arrange --------------------
+    const std::vector<LabelledRecording> corpus = {
+        {WriteClickTrack("a.bin", 120.0f, 20.0f), 120.0f},
+        {directory_ / "missing.bin", 120.0f},
+    };
+    ParameterGrid grid;
+    grid.base = config_;
+    grid.bandPassCutoffs = {{40, 800}};
+    grid.slidingWindowSizeSeconds = {15};
+    grid.peakThresholds = {0.6f};
+    ParameterSweep sweep(grid, 2, 0.06f);
+
+    // -------------------- Act ------------------------
+    const auto results = sweep.Run(corpus);
+
+    // -------------------- Assert ---------------------
+    ASSERT_EQ(results.size(), 1u);
+    EXPECT_EQ(results[0].correctCount, 1u);
+    EXPECT_DOUBLE_EQ(results[0].accuracy, 0.5);
+    EXPECT_EQ(sweep.GetSummary().failedRecordingCount, 1u);
+}
+
+TEST_F(ParameterSweepTests, WhenRecordingIsStereoAtItsOwnRate_ThenItIsMixedDownAndAnalyzedAtThatRate)
+{
+    // -------------------- Arrange --------------------
+    // 44.1 kHz while the base config says 48 kHz: analyzed at the wrong rate, 120 BPM would come out as 130.6
+    constexpr int sampleRate = 44100;
+    const auto mono = CreateClickTrack(120.0f, 20.0f, sampleRate);
+    std::vector<float> frames(2 * mono.size());
+    for (size_t i = 0; i < mono.size(); ++i)
+    {
+        frames[2 * i] = mono[i];
+        frames[2 * i + 1] = 0.5f * mono[i];
+    }
+    const auto path = directory_ / "stereo.bpmr";
+    {
+        bpmfinder::files::WriteBehindFile file;
+        ASSERT_TRUE(file.Open(path.string()));
+        bpmfinder::files::recording::RecordingWriter writer(file, {sampleRate, 2});
+        writer.Write(frames.data(), mono.size());
+        writer.Finish();
+        ASSERT_TRUE(file.Close());
+    }
+
+    ParameterGrid grid;
+    grid.base = config_;
+    grid.bandPassCutoffs = {{config_.bandPassLowCutoff, config_.bandPassHighCutoff}};
+    grid.slidingWindowSizeSeconds = {config_.slidingWindowSizeSeconds};
+    grid.peakThresholds = {config_.peakThreshold};
+    ParameterSweep sweep(grid, 1, 0.04f);
+
+    // -------------------- Act ------------------------
+    const auto results = sweep.Run({{path, 120.0f}});
+    const auto reference = BatchAnalyzer(config_, 1).Analyze({path});
+
+    // -------------------- Assert ---------------------
+    ASSERT_EQ(results.size(), 1u);
+    ASSERT_TRUE(reference[0].success);
+    EXPECT_EQ(results[0].bpm[0], reference[0].bpm);
+    EXPECT_EQ(results[0].correctCount, 1u);
+    EXPECT_EQ(sweep.GetSummary().failedRecordingCount, 0u);
+}
+
+TEST_F(ParameterSweepTests, WhenLoadingLabels_ThenRelativePathsAreResolvedAndHeaderIsSkipped)
+{
+    // -------------------- Arrange --------------------
+    const auto labelsFile = directory_ / "labels.csv";
+    std::ofstream(labelsFile) << "file,bpm\r\na.bin,100\r\n/absolute/b.bin,128.5\r\n";
+
+    // -------------------- Act ------------------------
+    const auto corpus = ParameterSweep::LoadLabels(labelsFile);
+
+    // -------------------- Assert ---------------------
+    ASSERT_EQ(corpus.size(), 2u);
+    EXPECT_EQ(corpus[0].file, directory_ / "a.bin");
+    EXPECT_EQ(corpus[0].bpm, 100.0f);
+    EXPECT_EQ(corpus[1].file, std::filesystem::path("/absolute/b.bin"));
+    EXPECT_EQ(corpus[1].bpm, 128.5f);
+}
@@ -3,7 +3,9 @@
 //
 
 #include <gtest/gtest.h>
+#include "../../src/audio/BinFileAudioSource.h"
 #include "../../src/files/bin/AudioBinFileSink.h"
+#include <filesystem>
 #include <fstream>
 
 using namespace bpmfinder::files::bin;
@@ -29,7 +31,8 @@ public:
 TEST(AudioBinFileSinkTests, WhenProcessingAudioChunk_ThenDataIsWrittenToFile)
 {
     // -------------------- Arrange --------------------
-    const std::string filename = "test_audio.bin";
+    const auto path = std::filesystem::temp_directory_path() / "bpm_finder_audio_bin_file_sink_process.bin";
+    const std::string filename = path.string();
     AudioChunk testData = {1.0f, 2.0f, 3.0f, 4.0f};
 
     // -------------------- Act ------------------------
@@ -48,6 +51,38 @@ TEST(AudioBinFileSinkTests, WhenProcessingAudioChunk_ThenDataIsWrittenToFile)
     EXPECT_EQ(readData, testData);
 
     file.close();
+    std::filesystem::remove(path);
 }
 
 
+
+TEST(AudioBinFileSinkTests, WhenChunksArriveThroughTheQueue_ThenAllOfThemAreInTheFileAfterDestruction)
+{
+    // -------------------- Arrange --------------------
+    const auto path = std::filesystem::temp_directory_path() / "bpm_finder_audio_bin_file_sink_test.bin";
+    std::vector<float> expected;
+
+    // -------------------- Act ------------------------
+    {
+        AudioBinFileSink sink(path.string(), {16 * 1024});
+        sink.Start();
+        for (int i = 0; i < 100; ++i)
+        {
+            AudioChunk chunk(480);
+            for (size_t j = 0; j < chunk.size(); ++j)
+            {
+                chunk[j] = static_cast<float>(i * 480 + j);
+            }
+            expected.insert(expected.end(), chunk.begin(), chunk.end());
+            sink.PushData(chunk);
+        }
+        sink.StopAndDrain();
+        EXPECT_EQ(sink.GetWrittenCount(), 100u);
+    } // Writes the last buffer
+
+    // -------------------- Assert ---------------------
+    std::vector<float> samples;
+    ASSERT_TRUE(bpmfinder::audio::BinFileAudioSource::ReadSamples(path.string(), samples));
+    EXPECT_EQ(samples, expected);
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,58 @@
+//
+// Created by Robert on 2025-11-16.
+//
+
+#pragma once
+
+#include "../../src/audio/IAudioSource.h"
+#include "../../src/core/CopySink.h"
+#include <chrono>
+#include <mutex>
+#include <vector>
+
+namespace bpmfinder::tests
+{
+    /**
+     * @brief Collects every chunk it receives, for the tests of the audio sources and stages
+     */
+    class AudioChunkCollector : public core::CopySink<audio::AudioChunk>
+    {
+    public:
+        void Process(audio::AudioChunk data) override
+        {
+            std::lock_guard lock(chunksMutex_);
+            chunks_.push_back(std::move(data));
+        }
+
+        std::vector<audio::AudioChunk> GetChunks()
+        {
+            std::lock_guard lock(chunksMutex_);
+            return chunks_;
+        }
+
+        // The chunks received so far, concatenated
+        std::vector<float> GetSamples()
+        {
+            std::lock_guard lock(chunksMutex_);
+            std::vector<float> samples;
+            for (const auto& chunk : chunks_)
+            {
+                samples.insert(samples.end(), chunk.begin(), chunk.end());
+            }
+            return samples;
+        }
+
+        // Waits until the collector has handled `count` end of stream tokens. A finite source sends the token
+        // behind its last chunk, so once it is handled every chunk of the stream has been collected. The collector
+        // must be started and subscribed to the source.
+        bool WaitForEndOfStream(const size_t count = 1,
+                                const std::chrono::milliseconds timeout = std::chrono::seconds(5))
+        {
+            return WaitForControl(core::ControlToken::EndOfStream, count, timeout);
+        }
+
+    private:
+        std::mutex chunksMutex_;
+        std::vector<audio::AudioChunk> chunks_;
+    };
+}
@@ -0,0 +1,251 @@
+//
+// Created by Robert on 2025-11-01.
+//
+
+#include <gtest/gtest.h>
+#include "../../src/audio/BinFileAudioSource.h"
+#include "../../src/files/recording/RecordingWriter.h"
+#include "AudioChunkCollector.h"
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#ifndef _WIN32
+#include <sys/stat.h>
+#endif
+
+using namespace bpmfinder::audio;
+using namespace bpmfinder::tests;
+
+// ============================================================================
+// Test Fixture
+// ============================================================================
+
+class BinFileAudioSourceTests : public ::testing::TestWithParam<BinFileReadMode>
+{
+protected:
+    std::filesystem::path directory_ = std::filesystem::temp_directory_path() / "bpm_finder_bin_file_source_tests";
+
+    void SetUp() override
+    {
+        std::filesystem::remove_all(directory_);
+        std::filesystem::create_directories(directory_);
+    }
+
+    void TearDown() override
+    {
+        std::filesystem::remove_all(directory_);
+    }
+
+    std::vector<float> WriteRecording(const std::filesystem::path& path, const size_t sampleCount) const
+    {
+        std::vector<float> samples(sampleCount);
+        for (size_t i = 0; i < sampleCount; ++i)
+        {
+            samples[i] = static_cast<float>(i) * 0.5f;
+        }
+        std::ofstream file(path, std::ios::binary);
+        file.write(reinterpret_cast<const char*>(samples.data()),
+                   static_cast<std::streamsize>(samples.size() * sizeof(float)));
+        return samples;
+    }
+};
+
+TEST_P(BinFileAudioSourceTests, WhenReadingFile_ThenAllSamplesArriveInOrderFollowedByTheEndOfStream)
+{
+    // -------------------- Arrange --------------------
+    const auto path = directory_ / "recording.bin";
+    const auto expected = WriteRecording(path, 10 * 512 + 100); // Ends with a partial chunk
+
+    BinFileAudioSource source(path.string(), 512, GetParam(), 2);
+    AudioChunkCollector collector;
+    source.Subscribe(&collector);
+    collector.Start();
+
+    // -------------------- Act ------------------------
+    ASSERT_TRUE(source.Initialize());
+    source.Start();
+    ASSERT_TRUE(collector.WaitForEndOfStream());
+    source.Stop();
+    collector.StopAndDrain();
+
+    // -------------------- Assert ---------------------
+    EXPECT_EQ(source.GetEndOfStreamCount(), 1u);
+    const auto chunks = collector.GetChunks();
+    ASSERT_EQ(chunks.size(), 11u);
+    EXPECT_EQ(chunks.front().size(), 512u);
+    EXPECT_EQ(chunks.back().size(), 100u);
+    EXPECT_EQ(collector.GetSamples(), expected);
+    EXPECT_EQ(source.GetReadMode(), GetParam());
+}
+
+TEST_P(BinFileAudioSourceTests, WhenInitializedAgain_ThenFileIsReadFromTheStart)
+{
+    // -------------------- Arrange --------------------
+    const auto path = directory_ / "recording.bin";
+    const auto expected = WriteRecording(path, 3 * 256);
+
+    BinFileAudioSource source(path.string(), 256, GetParam());
+    AudioChunkCollector collector;
+    source.Subscribe(&collector);
+    collector.Start();
+
+    // -------------------- Act ------------------------
+    for (size_t pass = 1; pass <= 2; ++pass)
+    {
+        ASSERT_TRUE(source.Initialize());
+        source.Start();
+        ASSERT_TRUE(collector.WaitForEndOfStream(pass));
+        source.Stop();
+    }
+    collector.StopAndDrain();
+
+    // -------------------- Assert ---------------------
+    auto twice = expected;
+    twice.insert(twice.end(), expected.begin(), expected.end());
+    EXPECT_EQ(collector.GetSamples(), twice);
+}
+
+TEST_P(BinFileAudioSourceTests, WhenFileDoesNotExist_ThenInitializeFails)
+{
+    // -------------------- Arrange --------------------
+    BinFileAudioSource source((directory_ / "missing.bin").string(), 512, GetParam());
+
+    // -------------------- Act & Assert ---------------
+    EXPECT_FALSE(source.Initialize());
+}
+
+TEST_P(BinFileAudioSourceTests, WhenReplayIsPaced_ThenChunksAreReleasedAtTheRecordingSpeed)
+{
+    // -------------------- Arrange --------------------
+    const auto path = directory_ / "recording.bin";
+    const auto expected = WriteRecording(path, 48000 / 2); // 0.5 s of audio
+
+    BinFileAudioSource source(path.string(), 480, GetParam());
+    source.SetReplayOptions({BinFileReplayMode::Paced, 48000, 10.0}); // 50 ms at 10x
+    AudioChunkCollector collector;
+    source.Subscribe(&collector);
+    collector.Start();
+
+    // -------------------- Act ------------------------
+    const auto start = std::chrono::steady_clock::now();
+    ASSERT_TRUE(source.Initialize());
+    source.Start();
+    ASSERT_TRUE(collector.WaitForEndOfStream()); // From the dispatcher, behind the last chunk it passed on
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    source.Stop();
+    collector.StopAndDrain();
+
+    // -------------------- Assert ---------------------
+    EXPECT_GE(elapsed, std::chrono::milliseconds(45));
+    EXPECT_EQ(collector.GetSamples(), expected);
+}
+
+TEST_P(BinFileAudioSourceTests, WhenPacedReplayIsStopped_ThenStopReturnsWithoutWaitingForTheRecording)
+{
+    // -------------------- Arrange --------------------
+    const auto path = directory_ / "recording.bin";
+    WriteRecording(path, 48000 * 60); // One minute of audio
+
+    BinFileAudioSource source(path.string(), 480, GetParam());
+    source.SetReplayOptions({BinFileReplayMode::Paced, 48000, 1.0});
+    ASSERT_TRUE(source.Initialize());
+    source.Start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+    // -------------------- Act ------------------------
+    const auto start = std::chrono::steady_clock::now();
+    source.Stop();
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+
+    // -------------------- Assert ---------------------
+    EXPECT_LT(elapsed, std::chrono::seconds(1));
+    EXPECT_FALSE(source.IsFinished());
+    EXPECT_EQ(source.GetEndOfStreamCount(), 0u); // Stopped early, whoever stopped it ends the stream
+}
+
+TEST_P(BinFileAudioSourceTests, WhenReplayingPartOfARecording_ThenOnlyFramesOfThatRangeArrive)
+{
+    // -------------------- Arrange --------------------
+    const auto path = directory_ / "recording.bpmr";
+    std::vector<float> frames(2 * 8000); // 1 s of stereo at 8 kHz
+    for (size_t i = 0; i < frames.size(); ++i)
+    {
+        frames[i] = static_cast<float>(i) * 0.25f;
+    }
+    {
+        bpmfinder::files::WriteBehindFile file;
+        ASSERT_TRUE(file.Open(path.string()));
+        bpmfinder::files::recording::RecordingWriter writer(file, {8000, 2, 1000, true, true});
+        writer.Write(frames.data(), 8000);
+        writer.Finish();
+        ASSERT_TRUE(file.Close());
+    }
+
+    BinFileAudioSource source(path.string(), 512, GetParam());
+    BinFileReplayOptions options;
+    options.startSeconds = 0.25;
+    options.durationSeconds = 0.5;
+    source.SetReplayOptions(options);
+    AudioChunkCollector collector;
+    source.Subscribe(&collector);
+    collector.Start();
+
+    // -------------------- Act ------------------------
+    ASSERT_TRUE(source.Initialize());
+    source.Start();
+    ASSERT_TRUE(collector.WaitForEndOfStream());
+    source.Stop();
+    collector.StopAndDrain();
+
+    // -------------------- Assert ---------------------
+    EXPECT_TRUE(source.IsRecording());
+    EXPECT_EQ(source.GetChannelCount(), 2);
+    EXPECT_EQ(source.GetSampleRate(), 8000);
+    const auto samples = collector.GetSamples();
+    EXPECT_EQ(collector.GetChunks().front().size(), 2u * 512u); // 512 frames of both channels
+    EXPECT_EQ(samples, std::vector<float>(frames.begin() + 2 * 2000, frames.begin() + 2 * 6000));
+}
+
+INSTANTIATE_TEST_SUITE_P(ReadModes, BinFileAudioSourceTests,
+                         ::testing::Values(BinFileReadMode::MemoryMapped, BinFileReadMode::Streaming));
+
+#ifndef _WIN32
+TEST_F(BinFileAudioSourceTests, WhenReadingPipe_ThenSourceFallsBackToStreaming)
+{
+    // -------------------- Arrange --------------------
+    const auto pipePath = directory_ / "recording.fifo";
+    ASSERT_EQ(mkfifo(pipePath.c_str(), 0600), 0);
+
+    std::vector<float> expected(4 * 512 + 3);
+    for (size_t i = 0; i < expected.size(); ++i)
+    {
+        expected[i] = static_cast<float>(i);
+    }
+
+    // Opening a pipe blocks until both ends are open
+    std::thread writer([&]
+    {
+        std::ofstream pipe(pipePath, std::ios::binary);
+        pipe.write(reinterpret_cast<const char*>(expected.data()),
+                   static_cast<std::streamsize>(expected.size() * sizeof(float)));
+    });
+
+    BinFileAudioSource source(pipePath.string(), 512, BinFileReadMode::MemoryMapped, 1);
+    AudioChunkCollector collector;
+    source.Subscribe(&collector);
+    collector.Start();
+
+    // -------------------- Act ------------------------
+    ASSERT_TRUE(source.Initialize());
+    source.Start();
+    ASSERT_TRUE(collector.WaitForEndOfStream());
+    source.Stop();
+    writer.join();
+    collector.StopAndDrain();
+
+    // -------------------- Assert ---------------------
+    EXPECT_EQ(source.GetReadMode(), BinFileReadMode::Streaming);
+    EXPECT_EQ(collector.GetSamples(), expected);
+}
+#endif
@@ -0,0 +1,177 @@
+//
+// Created by Robert on 2025-11-10.
+//
+
+#include <gtest/gtest.h>
+#include "../../src/audio/CaptureHandoff.h"
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace bpmfinder::audio;
+
+// ============================================================================
+// Test Fixture
+// ============================================================================
+
+class CaptureHandoffTests : public ::testing::Test
+{
+protected:
+    std::mutex chunksMutex_;
+    std::vector<AudioChunk> chunks_;
+
+    // Blocks the dispatcher while blocked_ is set, like a subscriber whose queue mutex is held
+    std::mutex blockMutex_;
+    std::condition_variable blockCv_;
+    bool blocked_ = false;
+
+    CaptureHandoff::Dispatch CreateDispatch()
+    {
+        return [this](const AudioChunk& chunk)
+        {
+            {
+                std::unique_lock lock(blockMutex_);
+                blockCv_.wait(lock, [this] { return !blocked_; });
+            }
+            std::lock_guard lock(chunksMutex_);
+            chunks_.push_back(chunk);
+        };
+    }
+
+    void SetBlocked(const bool blocked)
+    {
+        {
+            std::lock_guard lock(blockMutex_);
+            blocked_ = blocked;
+        }
+        blockCv_.notify_all();
+    }
+
+    std::vector<float> GetSamples()
+    {
+        std::lock_guard lock(chunksMutex_);
+        std::vector<float> samples;
+        for (const auto& chunk : chunks_)
+        {
+            samples.insert(samples.end(), chunk.begin(), chunk.end());
+        }
+        return samples;
+    }
+
+    static bool WaitUntilDrained(const CaptureHandoff& handoff)
+    {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while (!handoff.IsDrained())
+        {
+            if (std::chrono::steady_clock::now() > deadline)
+            {
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
+    }
+};
+
+TEST_F(CaptureHandoffTests, WhenCaptureWritesPacketsOfAnySize_ThenChunksOfFixedSizeArriveInOrder)
+{
+    // -------------------- Arrange --------------------
+    CaptureHandoff handoff(256, 8, CreateDispatch());
+    handoff.Start();
+
+    std::vector<float> written;
+    for (int i = 0; i < 10000; ++i)
+    {
+        written.push_back(static_cast<float>(i));
+    }
+
+    // -------------------- Act ------------------------
+    // Packets of 1 to 300 samples from another thread, with the occasional pause
+    std::thread capture([&]
+    {
+        size_t offset = 0;
+        for (size_t packet = 1; offset < written.size(); packet = packet % 300 + 37)
+        {
+            const size_t count = std::min(packet, written.size() - offset);
+            while (!handoff.Write(written.data() + offset, count))
+            {
+                std::this_thread::yield(); // The test wants every sample, a real capture would drop it
+            }
+            offset += count;
+            if (packet % 7 == 0)
+            {
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+            }
+        }
+        handoff.Close();
+    });
+    capture.join();
+    const bool drained = WaitUntilDrained(handoff);
+    handoff.Stop();
+
+    // -------------------- Assert ---------------------
+    ASSERT_TRUE(drained);
+    EXPECT_EQ(GetSamples(), written);
+    std::lock_guard lock(chunksMutex_);
+    for (size_t i = 0; i + 1 < chunks_.size(); ++i)
+    {
+        EXPECT_EQ(chunks_[i].size(), 256u);
+    }
+    EXPECT_EQ(chunks_.back().size(), 10000u % 256u);
+}
+
+TEST_F(CaptureHandoffTests, WhenDispatcherIsBlocked_ThenCaptureDropsWritesAndCountsOverruns)
+{
+    // -------------------- Arrange --------------------
+    CaptureHandoff handoff(100, 4, CreateDispatch()); // Room for 512 samples
+    SetBlocked(true);
+    handoff.Start();
+
+    // -------------------- Act ------------------------
+    // Ten chunks while the dispatcher hangs in its first Notify; none of the writes may wait
+    std::vector<float> packet(100, 1.0f);
+    const auto start = std::chrono::steady_clock::now();
+    size_t accepted = 0;
+    for (int i = 0; i < 10; ++i)
+    {
+        accepted += handoff.Write(packet.data(), packet.size()) ? 1 : 0;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    const auto statistics = handoff.GetStatistics();
+
+    SetBlocked(false);
+    handoff.Close();
+    const bool drained = WaitUntilDrained(handoff);
+    handoff.Stop();
+
+    // -------------------- Assert ---------------------
+    EXPECT_LT(elapsed, std::chrono::seconds(1));
+    ASSERT_TRUE(drained);
+
+    // The dispatcher took the first chunk out before it blocked, then five more fit
+    EXPECT_EQ(accepted, 6u);
+    EXPECT_EQ(statistics.overrunCount, 4u);
+    EXPECT_EQ(statistics.lostSamples, 400u);
+    EXPECT_EQ(statistics.writtenSamples, 600u);
+    EXPECT_EQ(statistics.highWaterMark, 500u);
+    EXPECT_EQ(GetSamples().size(), 600u);
+}
+
+TEST_F(CaptureHandoffTests, WhenStoppedWithoutClose_ThenStopReturnsAndNothingIsDrained)
+{
+    // -------------------- Arrange --------------------
+    CaptureHandoff handoff(100, 4, CreateDispatch());
+    handoff.Start();
+    std::vector<float> packet(50, 1.0f);
+    handoff.Write(packet.data(), packet.size());
+
+    // -------------------- Act ------------------------
+    handoff.Stop();
+
+    // -------------------- Assert ---------------------
+    EXPECT_FALSE(handoff.IsDrained());
+    EXPECT_TRUE(GetSamples().empty());
+}
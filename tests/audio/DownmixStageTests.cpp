@@ -0,0 +1,122 @@
+//
+// Created by Robert on 2025-11-06.
+//
+
+#include <gtest/gtest.h>
+#include "../../src/audio/DownmixStage.h"
+#include "AudioChunkCollector.h"
+#include <vector>
+
+using namespace bpmfinder::audio;
+using namespace bpmfinder::tests;
+
+/**
+ * @brief Makes the protected Process callable, so chunks can be fed to the stage synchronously
+ */
+class TestDownmixStage : public DownmixStage
+{
+public:
+    using DownmixStage::DownmixStage;
+    using DownmixStage::Process;
+};
+
+// ============================================================================
+// Test Fixture
+// ============================================================================
+
+class DownmixStageTests : public ::testing::Test
+{
+protected:
+    // Frame i holds i + c for channel c
+    static AudioChunk CreateInterleaved(const size_t frames, const size_t channels)
+    {
+        AudioChunk chunk(frames * channels);
+        for (size_t i = 0; i < frames; ++i)
+        {
+            for (size_t c = 0; c < channels; ++c)
+            {
+                chunk[i * channels + c] = static_cast<float>(i + c);
+            }
+        }
+        return chunk;
+    }
+
+    static std::vector<AudioChunk> Run(TestDownmixStage& stage, AudioChunk chunk)
+    {
+        AudioChunkCollector collector;
+        stage.Subscribe(&collector);
+        collector.Start();
+        stage.Process(std::move(chunk));
+        collector.StopAndDrain();
+        return collector.GetChunks();
+    }
+};
+
+TEST_F(DownmixStageTests, WhenMixingStereo_ThenEveryFrameBecomesTheMeanOfItsChannels)
+{
+    // -------------------- Arrange --------------------
+    constexpr size_t frames = 1000; // Several blocks and a partial one
+    TestDownmixStage stage(2);
+
+    // -------------------- Act ------------------------
+    const auto chunks = Run(stage, CreateInterleaved(frames, 2));
+
+    // -------------------- Assert ---------------------
+    ASSERT_EQ(chunks.size(), 1u);
+    ASSERT_EQ(chunks[0].size(), frames);
+    for (size_t i = 0; i < frames; ++i)
+    {
+        ASSERT_FLOAT_EQ(chunks[0][i], static_cast<float>(i) + 0.5f) << "at frame " << i;
+    }
+}
+
+TEST_F(DownmixStageTests, WhenMixingSixChannels_ThenEveryFrameBecomesTheMeanOfItsChannels)
+{
+    // -------------------- Arrange --------------------
+    constexpr size_t frames = 300;
+    TestDownmixStage stage(6);
+
+    // -------------------- Act ------------------------
+    const auto chunks = Run(stage, CreateInterleaved(frames, 6));
+
+    // -------------------- Assert ---------------------
+    ASSERT_EQ(chunks.size(), 1u);
+    ASSERT_EQ(chunks[0].size(), frames);
+    for (size_t i = 0; i < frames; ++i)
+    {
+        ASSERT_FLOAT_EQ(chunks[0][i], static_cast<float>(i) + 2.5f) << "at frame " << i;
+    }
+}
+
+TEST_F(DownmixStageTests, WhenChannelIsSelected_ThenOnlyThatChannelIsKept)
+{
+    // -------------------- Arrange --------------------
+    constexpr size_t frames = 600;
+    TestDownmixStage stage(4, 3);
+
+    // -------------------- Act ------------------------
+    const auto chunks = Run(stage, CreateInterleaved(frames, 4));
+
+    // -------------------- Assert ---------------------
+    ASSERT_EQ(chunks.size(), 1u);
+    ASSERT_EQ(chunks[0].size(), frames);
+    for (size_t i = 0; i < frames; ++i)
+    {
+        ASSERT_FLOAT_EQ(chunks[0][i], static_cast<float>(i + 3)) << "at frame " << i;
+    }
+}
+
+TEST_F(DownmixStageTests, WhenChunkEndsWithPartialFrame_ThenPartialFrameIsDropped)
+{
+    // -------------------- Arrange --------------------
+    TestDownmixStage stage(2);
+    auto chunk = CreateInterleaved(10, 2);
+    chunk.push_back(99.0f);
+
+    // -------------------- Act ------------------------
+    const auto chunks = Run(stage, chunk);
+
+    // -------------------- Assert ---------------------
+    ASSERT_EQ(chunks.size(), 1u);
+    EXPECT_EQ(chunks[0].size(), 10u);
+}
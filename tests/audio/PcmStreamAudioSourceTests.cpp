@@ -0,0 +1,241 @@
+//
+// Created by Robert on 2025-11-04.
+//
+
+#include <gtest/gtest.h>
+#include "../../src/audio/PcmStreamAudioSource.h"
+#include "AudioChunkCollector.h"
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <thread>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace bpmfinder::audio;
+using namespace bpmfinder::tests;
+
+// ============================================================================
+// Test Fixture
+// ============================================================================
+
+class PcmStreamAudioSourceTests : public ::testing::Test
+{
+protected:
+    std::filesystem::path directory_ = std::filesystem::temp_directory_path() / "bpm_finder_pcm_stream_source_tests";
+
+    void SetUp() override
+    {
+        std::filesystem::remove_all(directory_);
+        std::filesystem::create_directories(directory_);
+    }
+
+    void TearDown() override
+    {
+        std::filesystem::remove_all(directory_);
+    }
+
+    template <typename Sample>
+    static void WriteSamples(std::ostream& out, const std::vector<Sample>& samples)
+    {
+        out.write(reinterpret_cast<const char*>(samples.data()),
+                  static_cast<std::streamsize>(samples.size() * sizeof(Sample)));
+    }
+};
+
+TEST_F(PcmStreamAudioSourceTests, WhenConvertingInterleavedFrames_ThenChannelsAreAveraged)
+{
+    // -------------------- Arrange --------------------
+    const std::vector<int16_t> int16Frames = {16384, -16384, 32767, 32767, -32768, 0};
+    const std::vector<float> floatFrames = {0.3f, 0.6f, 0.9f, -0.3f, -0.6f, -0.9f};
+    std::vector<float> int16Output(3);
+    std::vector<float> floatOutput(2);
+
+    // -------------------- Act ------------------------
+    ConvertToMonoFloat(reinterpret_cast<const std::byte*>(int16Frames.data()), 3, 2, PcmSampleFormat::Int16,
+                       int16Output.data());
+    ConvertToMonoFloat(reinterpret_cast<const std::byte*>(floatFrames.data()), 2, 3, PcmSampleFormat::Float32,
+                       floatOutput.data());
+
+    // -------------------- Assert ---------------------
+    EXPECT_FLOAT_EQ(int16Output[0], 0.0f);
+    EXPECT_NEAR(int16Output[1], 1.0f, 1e-4f);
+    EXPECT_FLOAT_EQ(int16Output[2], -0.5f);
+    EXPECT_NEAR(floatOutput[0], 0.6f, 1e-6f);
+    EXPECT_NEAR(floatOutput[1], -0.6f, 1e-6f);
+}
+
+TEST_F(PcmStreamAudioSourceTests, WhenReadingStereoInt16File_ThenMonoChunksArriveAndSourceFinishes)
+{
+    // -------------------- Arrange --------------------
+    constexpr size_t frameCount = 5 * 256 + 17; // Ends with a partial chunk
+    std::vector<int16_t> frames(frameCount * 2);
+    std::vector<float> expected(frameCount);
+    for (size_t i = 0; i < frameCount; ++i)
+    {
+        frames[2 * i] = static_cast<int16_t>(i);
+        frames[2 * i + 1] = static_cast<int16_t>(i + 2);
+        expected[i] = static_cast<float>(i + 1) / 32768.0f;
+    }
+    const auto path = directory_ / "stereo.pcm";
+    {
+        std::ofstream file(path, std::ios::binary);
+        WriteSamples(file, frames);
+    }
+
+    PcmStreamAudioSource source(path.string(), {PcmSampleFormat::Int16, 2, 44100}, 256, 1000);
+    AudioChunkCollector collector;
+    source.Subscribe(&collector);
+    collector.Start();
+
+    // -------------------- Act ------------------------
+    ASSERT_TRUE(source.Initialize());
+    source.Start();
+    ASSERT_TRUE(collector.WaitForEndOfStream());
+    source.Stop();
+    collector.StopAndDrain();
+
+    // -------------------- Assert ---------------------
+    const auto chunks = collector.GetChunks();
+    ASSERT_EQ(chunks.size(), 6u);
+    EXPECT_EQ(chunks.front().size(), 256u);
+    EXPECT_EQ(chunks.back().size(), 17u);
+    const auto samples = collector.GetSamples();
+    ASSERT_EQ(samples.size(), expected.size());
+    for (size_t i = 0; i < expected.size(); ++i)
+    {
+        EXPECT_FLOAT_EQ(samples[i], expected[i]) << "at sample " << i;
+    }
+    EXPECT_EQ(source.GetSampleCount(), frameCount);
+}
+
+TEST_F(PcmStreamAudioSourceTests, WhenFileDoesNotExist_ThenInitializeFails)
+{
+    // -------------------- Arrange --------------------
+    PcmStreamAudioSource source((directory_ / "missing.pcm").string(), {});
+
+    // -------------------- Act & Assert ---------------
+    EXPECT_FALSE(source.Initialize());
+}
+
+#ifndef _WIN32
+TEST_F(PcmStreamAudioSourceTests, WhenFramesAreSplitAcrossPipeWrites_ThenEveryFrameArrivesOnce)
+{
+    // -------------------- Arrange --------------------
+    const auto pipePath = directory_ / "stream.fifo";
+    ASSERT_EQ(mkfifo(pipePath.c_str(), 0600), 0);
+
+    constexpr size_t frameCount = 3000;
+    std::vector<float> frames(frameCount * 2);
+    std::vector<float> expected(frameCount);
+    for (size_t i = 0; i < frameCount; ++i)
+    {
+        frames[2 * i] = static_cast<float>(i);
+        frames[2 * i + 1] = static_cast<float>(i) + 1.0f;
+        expected[i] = static_cast<float>(i) + 0.5f;
+    }
+
+    // Odd write sizes, so frames and even samples are split between reads
+    std::thread writer([&]
+    {
+        std::ofstream pipe(pipePath, std::ios::binary);
+        const auto* bytes = reinterpret_cast<const char*>(frames.data());
+        const size_t total = frames.size() * sizeof(float);
+        for (size_t offset = 0; offset < total; offset += 1001)
+        {
+            pipe.write(bytes + offset, static_cast<std::streamsize>(std::min<size_t>(1001, total - offset)));
+            pipe.flush();
+        }
+    });
+
+    PcmStreamAudioSource source(pipePath.string(), {PcmSampleFormat::Float32, 2, 48000}, 512);
+    AudioChunkCollector collector;
+    source.Subscribe(&collector);
+    collector.Start();
+
+    // -------------------- Act ------------------------
+    ASSERT_TRUE(source.Initialize());
+    source.Start();
+    ASSERT_TRUE(collector.WaitForEndOfStream());
+    source.Stop();
+    writer.join();
+    collector.StopAndDrain();
+
+    // -------------------- Assert ---------------------
+    EXPECT_EQ(collector.GetSamples(), expected);
+}
+
+TEST_F(PcmStreamAudioSourceTests, WhenProducerIsIdle_ThenStopReturnsWithoutWaitingForData)
+{
+    // -------------------- Arrange --------------------
+    const auto pipePath = directory_ / "idle.fifo";
+    ASSERT_EQ(mkfifo(pipePath.c_str(), 0600), 0);
+
+    // Keeps the pipe open without writing anything
+    std::unique_ptr<std::ofstream> pipe;
+    std::thread writer([&] { pipe = std::make_unique<std::ofstream>(pipePath, std::ios::binary); });
+
+    PcmStreamAudioSource source(pipePath.string(), {});
+    ASSERT_TRUE(source.Initialize());
+    writer.join();
+    source.Start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+    // -------------------- Act ------------------------
+    const auto start = std::chrono::steady_clock::now();
+    source.Stop();
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    pipe.reset();
+
+    // -------------------- Assert ---------------------
+    EXPECT_LT(elapsed, std::chrono::seconds(1));
+    EXPECT_FALSE(source.IsFinished());
+}
+
+TEST_F(PcmStreamAudioSourceTests, WhenReadFails_ThenStreamEndsAsFailedInsteadOfWaitingForever)
+{
+    // -------------------- Arrange --------------------
+    // The source reads stdin: a pipe here, which the test can swap for something else under it
+    int pipeFds[2];
+    ASSERT_EQ(pipe(pipeFds), 0);
+    const int savedStdin = dup(STDIN_FILENO);
+    ASSERT_GE(dup2(pipeFds[0], STDIN_FILENO), 0);
+    close(pipeFds[0]);
+
+    PcmStreamAudioSource source("-", {PcmSampleFormat::Float32, 1, 48000}, 4);
+    AudioChunkCollector collector;
+    source.Subscribe(&collector);
+    collector.Start();
+    ASSERT_TRUE(source.Initialize());
+    source.Start();
+
+    const std::vector<float> samples = {0.1f, 0.2f, 0.3f, 0.4f, 0.5f, 0.6f};
+    ASSERT_EQ(write(pipeFds[1], samples.data(), samples.size() * sizeof(float)),
+              static_cast<ssize_t>(samples.size() * sizeof(float)));
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    // -------------------- Act ------------------------
+    // A directory is always ready for poll, but every read fails
+    const int directory = open(directory_.c_str(), O_RDONLY | O_DIRECTORY);
+    ASSERT_GE(directory, 0);
+    dup2(directory, STDIN_FILENO);
+    close(directory);
+    const bool ended = collector.WaitForEndOfStream();
+    source.Stop();
+    collector.StopAndDrain();
+
+    dup2(savedStdin, STDIN_FILENO);
+    close(savedStdin);
+    close(pipeFds[1]);
+
+    // -------------------- Assert ---------------------
+    EXPECT_TRUE(ended);
+    EXPECT_TRUE(source.HasFailed());
+    EXPECT_EQ(collector.GetSamples(), samples); // Including the shorter last chunk
+}
+#endif
@@ -0,0 +1,274 @@
+//
+// Created by Robert on 2025-11-09.
+//
+
+#include <gtest/gtest.h>
+#include "../../src/audio/RtpAudioSource.h"
+#include "AudioChunkCollector.h"
+#include <bit>
+#include <chrono>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace bpmfinder::audio;
+using namespace bpmfinder::net;
+using namespace bpmfinder::tests;
+
+// ============================================================================
+// Test Fixture
+// ============================================================================
+
+class RtpAudioSourceTests : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        socket_ = socket(AF_INET, SOCK_DGRAM, 0);
+        ASSERT_GE(socket_, 0);
+    }
+
+    void TearDown() override
+    {
+        close(socket_);
+    }
+
+    void Send(const uint16_t port, const std::vector<std::byte>& datagram) const
+    {
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(port);
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        sendto(socket_, datagram.data(), datagram.size(), 0, reinterpret_cast<const sockaddr*>(&address),
+               sizeof(address));
+    }
+
+    // RTP packet with payload type 96 and big endian 16 bit samples
+    static std::vector<std::byte> CreateRtpPacket(const uint16_t sequenceNumber, const std::vector<int16_t>& samples)
+    {
+        std::vector<std::byte> packet(12 + samples.size() * 2);
+        packet[0] = std::byte{0x80};
+        packet[1] = std::byte{96};
+        packet[2] = static_cast<std::byte>(sequenceNumber >> 8);
+        packet[3] = static_cast<std::byte>(sequenceNumber & 0xFF);
+        for (size_t i = 0; i < samples.size(); ++i)
+        {
+            const auto value = static_cast<uint16_t>(samples[i]);
+            packet[12 + 2 * i] = static_cast<std::byte>(value >> 8);
+            packet[13 + 2 * i] = static_cast<std::byte>(value & 0xFF);
+        }
+        return packet;
+    }
+
+    // Stereo frames of packet p: p * 100 + i in the left channel, the negated value in the right one
+    static std::vector<int16_t> CreatePacketSamples(const int packet, const int frames)
+    {
+        std::vector<int16_t> samples;
+        for (int i = 0; i < frames; ++i)
+        {
+            samples.push_back(static_cast<int16_t>(packet * 100 + i));
+            samples.push_back(static_cast<int16_t>(-(packet * 100 + i)));
+        }
+        return samples;
+    }
+
+    template <typename Condition>
+    static bool WaitFor(Condition condition)
+    {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (!condition())
+        {
+            if (std::chrono::steady_clock::now() > deadline)
+            {
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
+    }
+
+    int socket_ = -1;
+};
+
+TEST_F(RtpAudioSourceTests, WhenPacketsAreReorderedAndLost_ThenChunksAreInOrderWithSilenceForTheLostOne)
+{
+    // -------------------- Arrange --------------------
+    constexpr int framesPerPacket = 4;
+    RtpAudioSourceOptions options;
+    options.address = "127.0.0.1";
+    options.port = 0;
+    options.channels = 2;
+    options.payloadType = 96;
+    options.jitterBufferDepth = 2;
+
+    RtpAudioSource source(options, framesPerPacket * 2, std::make_shared<NetworkIoThread>());
+    AudioChunkCollector collector;
+    source.Subscribe(&collector);
+    collector.Start();
+    ASSERT_TRUE(source.Initialize());
+    source.Start();
+
+    // -------------------- Act ------------------------
+    // 3 is lost, 5 and 6 are swapped, 7 is sent twice
+    for (const int packet : {0, 1, 2, 4, 6, 5, 7, 7, 8, 9, 10, 11})
+    {
+        Send(source.GetPort(), CreateRtpPacket(static_cast<uint16_t>(65530 + packet),
+                                               CreatePacketSamples(packet, framesPerPacket)));
+    }
+    const bool received = WaitFor([&] { return source.GetStatistics().receivedPackets == 12; });
+    source.Stop();
+    collector.StopAndDrain();
+
+    // -------------------- Assert ---------------------
+    ASSERT_TRUE(received);
+    const auto statistics = source.GetStatistics();
+    EXPECT_EQ(statistics.lostPackets, 1u);
+    EXPECT_EQ(statistics.duplicatePackets, 1u);
+    EXPECT_EQ(statistics.concealedSamples, static_cast<uint64_t>(framesPerPacket * 2));
+    EXPECT_EQ(statistics.malformedPackets, 0u);
+
+    // Six chunks of two packets each
+    std::vector<float> expected;
+    for (int packet = 0; packet < 12; ++packet)
+    {
+        for (const auto sample : CreatePacketSamples(packet, framesPerPacket))
+        {
+            expected.push_back(packet == 3 ? 0.0f : static_cast<float>(sample) / 32768.0f);
+        }
+    }
+    EXPECT_EQ(collector.GetSamples(), expected);
+}
+
+TEST_F(RtpAudioSourceTests, WhenRawFloatDatagramsArrive_ThenSamplesArePassedOnInArrivalOrder)
+{
+    // -------------------- Arrange --------------------
+    RtpAudioSourceOptions options;
+    options.address = "127.0.0.1";
+    options.port = 0;
+    options.sampleFormat = PcmSampleFormat::Float32;
+    options.rtp = false;
+
+    RtpAudioSource source(options, 8, std::make_shared<NetworkIoThread>());
+    AudioChunkCollector collector;
+    source.Subscribe(&collector);
+    collector.Start();
+    ASSERT_TRUE(source.Initialize());
+    source.Start();
+
+    // -------------------- Act ------------------------
+    std::vector<float> sent;
+    for (int datagram = 0; datagram < 4; ++datagram)
+    {
+        std::vector<std::byte> bytes;
+        for (int i = 0; i < 4; ++i)
+        {
+            const float value = static_cast<float>(datagram * 4 + i) * 0.125f;
+            sent.push_back(value);
+            const auto bits = std::bit_cast<uint32_t>(value);
+            for (int shift = 24; shift >= 0; shift -= 8)
+            {
+                bytes.push_back(static_cast<std::byte>(bits >> shift & 0xFF));
+            }
+        }
+        Send(source.GetPort(), bytes);
+    }
+    const bool received = WaitFor([&] { return collector.GetSamples().size() == sent.size(); });
+    source.Stop();
+    collector.StopAndDrain();
+
+    // -------------------- Assert ---------------------
+    ASSERT_TRUE(received);
+    EXPECT_EQ(collector.GetSamples(), sent);
+}
+
+TEST_F(RtpAudioSourceTests, WhenPacketsAreMalformed_ThenTheyAreCountedAndDropped)
+{
+    // -------------------- Arrange --------------------
+    RtpAudioSourceOptions options;
+    options.address = "127.0.0.1";
+    options.port = 0;
+    options.payloadType = 96;
+
+    RtpAudioSource source(options, 4, std::make_shared<NetworkIoThread>());
+    ASSERT_TRUE(source.Initialize());
+    source.Start();
+
+    auto wrongVersion = CreateRtpPacket(1, {1, 2});
+    wrongVersion[0] = std::byte{0x40};
+    auto wrongPayloadType = CreateRtpPacket(2, {1, 2});
+    wrongPayloadType[1] = std::byte{97};
+    auto extensionTooLong = CreateRtpPacket(3, {1, 2});
+    extensionTooLong[0] |= std::byte{0x10};
+    extensionTooLong[15] = std::byte{0x10};
+
+    // -------------------- Act ------------------------
+    Send(source.GetPort(), std::vector<std::byte>(8));
+    Send(source.GetPort(), wrongVersion);
+    Send(source.GetPort(), wrongPayloadType);
+    Send(source.GetPort(), extensionTooLong);
+    Send(source.GetPort(), CreateRtpPacket(4, {1, 2}));
+    const bool received = WaitFor([&]
+    {
+        const auto statistics = source.GetStatistics();
+        return statistics.malformedPackets + statistics.receivedPackets == 5;
+    });
+    source.Stop();
+
+    // -------------------- Assert ---------------------
+    ASSERT_TRUE(received);
+    EXPECT_EQ(source.GetStatistics().malformedPackets, 4u);
+    EXPECT_EQ(source.GetStatistics().receivedPackets, 1u);
+}
+
+TEST_F(RtpAudioSourceTests, WhenSeveralSourcesShareOneIoThread_ThenEachReceivesItsOwnStream)
+{
+    // -------------------- Arrange --------------------
+    const auto ioThread = std::make_shared<NetworkIoThread>();
+    RtpAudioSourceOptions options;
+    options.address = "127.0.0.1";
+    options.port = 0;
+
+    RtpAudioSource first(options, 2, ioThread);
+    RtpAudioSource second(options, 2, ioThread);
+    AudioChunkCollector firstCollector;
+    AudioChunkCollector secondCollector;
+    first.Subscribe(&firstCollector);
+    second.Subscribe(&secondCollector);
+    firstCollector.Start();
+    secondCollector.Start();
+    ASSERT_TRUE(first.Initialize());
+    ASSERT_TRUE(second.Initialize());
+    first.Start();
+    second.Start();
+    const auto handlerCount = ioThread->GetHandlerCount();
+
+    // -------------------- Act ------------------------
+    for (uint16_t sequenceNumber = 0; sequenceNumber < 8; ++sequenceNumber)
+    {
+        Send(first.GetPort(), CreateRtpPacket(sequenceNumber, {1000, 1000}));
+        Send(second.GetPort(), CreateRtpPacket(sequenceNumber, {-1000, -1000}));
+    }
+    const bool received = WaitFor([&]
+    {
+        return first.GetStatistics().receivedPackets == 8 && second.GetStatistics().receivedPackets == 8;
+    });
+    first.Stop();
+    second.Stop();
+    firstCollector.StopAndDrain();
+    secondCollector.StopAndDrain();
+
+    // -------------------- Assert ---------------------
+    ASSERT_TRUE(received);
+    EXPECT_EQ(handlerCount, 2u);
+    EXPECT_EQ(ioThread->GetHandlerCount(), 0u);
+    EXPECT_NE(first.GetPort(), second.GetPort());
+    EXPECT_EQ(firstCollector.GetSamples(), std::vector<float>(16, 1000.0f / 32768.0f));
+    EXPECT_EQ(secondCollector.GetSamples(), std::vector<float>(16, -1000.0f / 32768.0f));
+}
+#endif
@@ -0,0 +1,225 @@
+//
+// Created by Robert on 2025-11-08.
+//
+
+#include <gtest/gtest.h>
+#include "../../src/audio/SharedMemoryAudioSource.h"
+#include "../../src/ipc/SharedMemoryRing.h"
+#include "AudioChunkCollector.h"
+#include <chrono>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+using namespace bpmfinder::audio;
+using namespace bpmfinder::ipc;
+using namespace bpmfinder::tests;
+
+// ============================================================================
+// Test Fixture
+// ============================================================================
+
+class SharedMemoryAudioSourceTests : public ::testing::Test
+{
+protected:
+#ifndef _WIN32
+    std::string name_ = "/bpm_finder_test_" + std::to_string(getpid());
+#else
+    std::string name_ = "bpm_finder_test";
+#endif
+
+    // Frame i holds i in the first channel and -i in the second one
+    static std::vector<float> CreateFrames(const size_t first, const size_t count, const int channels)
+    {
+        std::vector<float> frames(count * static_cast<size_t>(channels));
+        for (size_t i = 0; i < count; ++i)
+        {
+            for (int c = 0; c < channels; ++c)
+            {
+                frames[i * channels + c] = static_cast<float>(first + i) * (c == 0 ? 1.0f : -1.0f);
+            }
+        }
+        return frames;
+    }
+};
+
+TEST_F(SharedMemoryAudioSourceTests, WhenSamplesWereOverwritten_ThenReadFails)
+{
+    // -------------------- Arrange --------------------
+    SharedMemoryRingWriter writer;
+    ASSERT_TRUE(writer.Create(name_, {48000, 1}, 1000)); // Rounded up to 1024
+    SharedMemoryRingReader reader;
+    ASSERT_TRUE(reader.Open(name_));
+
+    const auto frames = CreateFrames(0, 1100, 1);
+    writer.Write(frames.data(), frames.size());
+
+    // -------------------- Act ------------------------
+    std::vector<float> output(100);
+    const bool oldRead = reader.Read(0, output.data(), output.size());
+    const bool newRead = reader.Read(1000, output.data(), output.size());
+
+    // -------------------- Assert ---------------------
+    EXPECT_EQ(reader.GetCapacity(), 1024u);
+    EXPECT_EQ(reader.GetWritePosition(), 1100u);
+    EXPECT_FALSE(oldRead);
+    ASSERT_TRUE(newRead);
+    EXPECT_EQ(output, CreateFrames(1000, 100, 1));
+}
+
+TEST_F(SharedMemoryAudioSourceTests, WhenInitializedAgainAfterTheProducerClosed_ThenTheRingIsReplayed)
+{
+    // -------------------- Arrange --------------------
+    SharedMemoryRingWriter writer;
+    ASSERT_TRUE(writer.Create(name_, {48000, 2}, 4096));
+    const auto frames = CreateFrames(0, 1000, 2);
+    writer.Write(frames.data(), 1000);
+    writer.Close();
+
+    SharedMemoryAudioSource source(name_, 256);
+    AudioChunkCollector collector;
+    source.Subscribe(&collector);
+    collector.Start();
+
+    // -------------------- Act ------------------------
+    // Not stopped in between, the second Start has to take over the worker that ended on its own
+    for (size_t pass = 1; pass <= 2; ++pass)
+    {
+        ASSERT_TRUE(source.Initialize());
+        source.Start();
+        ASSERT_TRUE(collector.WaitForEndOfStream(pass));
+    }
+    source.Stop();
+    collector.StopAndDrain();
+
+    // -------------------- Assert ---------------------
+    auto twice = frames;
+    twice.insert(twice.end(), frames.begin(), frames.end());
+    EXPECT_EQ(source.GetEndOfStreamCount(), 2u);
+    EXPECT_EQ(collector.GetSamples(), twice);
+}
+
+TEST_F(SharedMemoryAudioSourceTests, WhenConsumerFallsBehind_ThenOverrunIsCountedAndReadingContinuesInOrder)
+{
+    // -------------------- Arrange --------------------
+    SharedMemoryRingWriter writer;
+    ASSERT_TRUE(writer.Create(name_, {44100, 2}, 4096));
+
+    SharedMemoryAudioSource source(name_, 256);
+    AudioChunkCollector collector;
+    source.Subscribe(&collector);
+    collector.Start();
+    ASSERT_TRUE(source.Initialize());
+
+    // Ten times the capacity before the source starts reading
+    const auto frames = CreateFrames(0, 20480, 2);
+    for (size_t offset = 0; offset < frames.size(); offset += 512)
+    {
+        writer.Write(frames.data() + offset, 256);
+    }
+    writer.Close();
+
+    // -------------------- Act ------------------------
+    source.Start();
+    const bool finished = collector.WaitForEndOfStream(1, std::chrono::seconds(10));
+    source.Stop();
+    collector.StopAndDrain();
+
+    // -------------------- Assert ---------------------
+    ASSERT_TRUE(finished);
+    EXPECT_EQ(source.GetEndOfStreamCount(), 1u);
+    EXPECT_EQ(source.GetChannelCount(), 2);
+    EXPECT_EQ(source.GetFormat().sampleRate, 44100);
+    EXPECT_EQ(source.GetOverrunCount(), 1u);
+
+    // Whatever arrived is the newest part of the stream, in order and without gaps
+    const auto samples = collector.GetSamples();
+    ASSERT_EQ(samples.size() + source.GetLostSamples(), frames.size());
+    const size_t firstFrame = source.GetLostSamples() / 2;
+    EXPECT_EQ(samples, CreateFrames(firstFrame, samples.size() / 2, 2));
+}
+
+TEST_F(SharedMemoryAudioSourceTests, WhenRingDoesNotExist_ThenInitializeFails)
+{
+    // -------------------- Arrange --------------------
+    SharedMemoryAudioSource source(name_ + "_missing");
+
+    // -------------------- Act & Assert ---------------
+    EXPECT_FALSE(source.Initialize());
+    EXPECT_FALSE(SharedMemoryAudioSource::ReadFormat(name_ + "_missing").has_value());
+}
+
+#ifndef _WIN32
+TEST_F(SharedMemoryAudioSourceTests, WhenProducerRunsInAnotherProcess_ThenEverySampleArrivesInOrder)
+{
+    // -------------------- Arrange --------------------
+    constexpr size_t totalFrames = 100000;
+    constexpr size_t blockFrames = 500;
+    int ready[2];
+    int go[2];
+    ASSERT_EQ(pipe(ready), 0);
+    ASSERT_EQ(pipe(go), 0);
+
+    const pid_t producer = fork();
+    ASSERT_GE(producer, 0);
+    if (producer == 0)
+    {
+        // Producer process: only the writer, no gtest and no logging in here
+        close(ready[0]);
+        close(go[1]);
+        int status = 1;
+        {
+            SharedMemoryRingWriter writer;
+            if (writer.Create(name_, {48000, 2}, 1 << 15))
+            {
+                char signal = 1;
+                if (write(ready[1], &signal, 1) == 1 && read(go[0], &signal, 1) == 1)
+                {
+                    for (size_t frame = 0; frame < totalFrames; frame += blockFrames)
+                    {
+                        const auto block = CreateFrames(frame, blockFrames, 2);
+                        writer.Write(block.data(), blockFrames);
+                        usleep(1000);
+                    }
+                    writer.Close();
+                    status = 0;
+                }
+            }
+        }
+        _exit(status);
+    }
+
+    close(ready[1]);
+    close(go[0]);
+    char signal = 0;
+    ASSERT_EQ(read(ready[0], &signal, 1), 1) << "producer could not create the ring";
+
+    SharedMemoryAudioSource source(name_, 1024, std::chrono::microseconds(200));
+    AudioChunkCollector collector;
+    source.Subscribe(&collector);
+    collector.Start();
+    ASSERT_TRUE(source.Initialize());
+
+    // -------------------- Act ------------------------
+    source.Start();
+    ASSERT_EQ(write(go[1], &signal, 1), 1);
+    const bool finished = collector.WaitForEndOfStream(1, std::chrono::seconds(10));
+    source.Stop();
+    collector.StopAndDrain();
+
+    int status = -1;
+    waitpid(producer, &status, 0);
+    close(ready[0]);
+    close(go[1]);
+
+    // -------------------- Assert ---------------------
+    ASSERT_TRUE(finished);
+    EXPECT_TRUE(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    EXPECT_EQ(source.GetOverrunCount(), 0u);
+    EXPECT_EQ(collector.GetSamples(), CreateFrames(0, totalFrames, 2));
+}
+#endif
@@ -0,0 +1,199 @@
+//
+// Created by Robert on 2025-11-07.
+//
+
+#include <gtest/gtest.h>
+#include "../../src/audio/SignalGeneratorAudioSource.h"
+#include "AudioChunkCollector.h"
+#include <chrono>
+#include <cmath>
+#include <vector>
+
+using namespace bpmfinder::audio;
+using namespace bpmfinder::tests;
+
+// ============================================================================
+// Test Fixture
+// ============================================================================
+
+class SignalGeneratorAudioSourceTests : public ::testing::Test
+{
+protected:
+    static std::vector<float> Generate(SignalGenerator& generator, const size_t count, const size_t blockSize)
+    {
+        std::vector<float> samples(count);
+        for (size_t offset = 0; offset < count; offset += blockSize)
+        {
+            generator.Generate(samples.data() + offset, std::min(blockSize, count - offset));
+        }
+        return samples;
+    }
+};
+
+TEST_F(SignalGeneratorAudioSourceTests, WhenGeneratedInDifferentBlockSizes_ThenSamplesAreIdentical)
+{
+    // -------------------- Arrange --------------------
+    SignalGeneratorOptions options;
+    options.swing = 0.2f;
+    options.snrDb = 6.0f;
+    options.noiseLowCutoff = 50.0f;
+    options.noiseHighCutoff = 2000.0f;
+    SignalGenerator whole(options);
+    SignalGenerator pieces(options);
+
+    // -------------------- Act ------------------------
+    const auto expected = Generate(whole, 100000, 100000);
+    const auto actual = Generate(pieces, 100000, 333);
+    pieces.Reset();
+    const auto again = Generate(pieces, 100000, 7);
+
+    // -------------------- Assert ---------------------
+    EXPECT_EQ(actual, expected);
+    EXPECT_EQ(again, expected);
+}
+
+TEST_F(SignalGeneratorAudioSourceTests, WhenTempoIsConstant_ThenClicksAreOneBeatApartAndSwingDelaysEverySecondOne)
+{
+    // -------------------- Arrange --------------------
+    SignalGeneratorOptions options;
+    options.bpm = 120.0f;
+    options.swing = 0.25f;
+    const SignalGenerator generator(options);
+
+    // -------------------- Act ------------------------
+    const auto positions = generator.GetClickPositions(48000 * 4);
+
+    // -------------------- Assert ---------------------
+    ASSERT_EQ(positions.size(), 8u);
+    for (size_t i = 0; i < positions.size(); ++i)
+    {
+        EXPECT_EQ(positions[i], i * 24000 + (i % 2 == 1 ? 6000 : 0)) << "click " << i;
+    }
+}
+
+TEST_F(SignalGeneratorAudioSourceTests, WhenTempoRamps_ThenClicksGetCloserUntilTheEndTempo)
+{
+    // -------------------- Arrange --------------------
+    SignalGeneratorOptions options;
+    options.bpm = 100.0f;
+    options.endBpm = 150.0f;
+    options.rampSeconds = 10.0f;
+    const SignalGenerator generator(options);
+
+    // -------------------- Act ------------------------
+    const auto positions = generator.GetClickPositions(48000 * 20);
+
+    // -------------------- Assert ---------------------
+    ASSERT_GT(positions.size(), 2u);
+    EXPECT_EQ(positions[1] - positions[0], 28800u); // 100 BPM
+    for (size_t i = 2; i < positions.size(); ++i)
+    {
+        EXPECT_LE(positions[i] - positions[i - 1], positions[i - 1] - positions[i - 2]);
+    }
+    EXPECT_NEAR(static_cast<double>(positions.back() - positions[positions.size() - 2]), 19200.0, 1.0); // 150 BPM
+}
+
+TEST_F(SignalGeneratorAudioSourceTests, WhenNoiseIsBandLimited_ThenItsLevelIsStillTheConfiguredOne)
+{
+    // -------------------- Arrange --------------------
+    SignalGeneratorOptions options;
+    options.bpm = 0.0f;
+    options.noiseRms = 0.2f;
+    options.noiseLowCutoff = 100.0f;
+    options.noiseHighCutoff = 1000.0f;
+    SignalGenerator generator(options);
+
+    // -------------------- Act ------------------------
+    const auto samples = Generate(generator, 48000 * 5, 1024);
+
+    // -------------------- Assert ---------------------
+    double power = 0.0;
+    for (const float sample : samples)
+    {
+        power += static_cast<double>(sample) * sample;
+    }
+    EXPECT_NEAR(std::sqrt(power / static_cast<double>(samples.size())), 0.2, 0.2 * 0.05);
+}
+
+TEST_F(SignalGeneratorAudioSourceTests, WhenSignalIsFinite_ThenSourcePassesOnExactlyItsLengthAndFinishes)
+{
+    // -------------------- Arrange --------------------
+    SignalGeneratorOptions options;
+    options.durationSeconds = 1.0;
+    options.snrDb = 10.0f;
+    SignalGeneratorAudioSource source(options, 1000);
+    AudioChunkCollector collector;
+    source.Subscribe(&collector);
+    collector.Start();
+
+    SignalGenerator reference(options);
+    const auto expected = Generate(reference, 48000, 48000);
+
+    // -------------------- Act ------------------------
+    ASSERT_TRUE(source.Initialize());
+    source.Start();
+    const bool finished = collector.WaitForEndOfStream();
+    source.Stop();
+    collector.StopAndDrain();
+
+    // -------------------- Assert ---------------------
+    EXPECT_TRUE(finished);
+    EXPECT_EQ(source.GetEndOfStreamCount(), 1u);
+    EXPECT_EQ(collector.GetSamples(), expected);
+}
+
+TEST_F(SignalGeneratorAudioSourceTests, WhenInitializedAgainAfterTheSignalFinished_ThenItIsGeneratedFromTheStart)
+{
+    // -------------------- Arrange --------------------
+    SignalGeneratorOptions options;
+    options.durationSeconds = 0.5;
+    SignalGeneratorAudioSource source(options, 1000);
+    AudioChunkCollector collector;
+    source.Subscribe(&collector);
+    collector.Start();
+
+    SignalGenerator reference(options);
+    const auto once = Generate(reference, 24000, 24000);
+
+    // -------------------- Act ------------------------
+    // Not stopped in between, the second Start has to take over the worker that ended on its own
+    for (size_t pass = 1; pass <= 2; ++pass)
+    {
+        ASSERT_TRUE(source.Initialize());
+        source.Start();
+        ASSERT_TRUE(collector.WaitForEndOfStream(pass));
+    }
+    source.Stop();
+    collector.StopAndDrain();
+
+    // -------------------- Assert ---------------------
+    auto twice = once;
+    twice.insert(twice.end(), once.begin(), once.end());
+    EXPECT_EQ(source.GetEndOfStreamCount(), 2u);
+    EXPECT_EQ(collector.GetSamples(), twice);
+}
+
+TEST_F(SignalGeneratorAudioSourceTests, WhenPaced_ThenSignalTakesItsDurationOverTheSpeed)
+{
+    // -------------------- Arrange --------------------
+    SignalGeneratorOptions options;
+    options.durationSeconds = 1.0;
+    options.speed = 5.0;
+    SignalGeneratorAudioSource source(options, 1024);
+    AudioChunkCollector collector;
+    source.Subscribe(&collector);
+    collector.Start();
+    ASSERT_TRUE(source.Initialize());
+
+    // -------------------- Act ------------------------
+    const auto start = std::chrono::steady_clock::now();
+    source.Start();
+    const bool finished = collector.WaitForEndOfStream();
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    source.Stop();
+    collector.StopAndDrain();
+
+    // -------------------- Assert ---------------------
+    EXPECT_TRUE(finished);
+    EXPECT_GE(elapsed, std::chrono::milliseconds(190));
+}
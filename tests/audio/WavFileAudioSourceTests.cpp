@@ -0,0 +1,267 @@
+//
+// Created by Robert on 2025-11-05.
+//
+
+#include <gtest/gtest.h>
+#include "../../src/audio/WavFileAudioSource.h"
+#include "AudioChunkCollector.h"
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+using namespace bpmfinder::audio;
+using namespace bpmfinder::tests;
+
+struct WavTestFormat
+{
+    PcmSampleFormat sampleFormat;
+    bool extensible;
+};
+
+// ============================================================================
+// Test Fixture
+// ============================================================================
+
+class WavFileAudioSourceTests : public ::testing::TestWithParam<WavTestFormat>
+{
+protected:
+    std::filesystem::path directory_ = std::filesystem::temp_directory_path() / "bpm_finder_wav_file_source_tests";
+
+    void SetUp() override
+    {
+        std::filesystem::remove_all(directory_);
+        std::filesystem::create_directories(directory_);
+    }
+
+    void TearDown() override
+    {
+        std::filesystem::remove_all(directory_);
+    }
+
+    static void Append(std::string& out, const uint32_t value, const size_t bytes)
+    {
+        for (size_t i = 0; i < bytes; ++i)
+        {
+            out.push_back(static_cast<char>(value >> (8 * i) & 0xFF));
+        }
+    }
+
+    static void AppendSample(std::string& out, const float value, const PcmSampleFormat format)
+    {
+        switch (format)
+        {
+        case PcmSampleFormat::Float32:
+            {
+                uint32_t bits;
+                std::memcpy(&bits, &value, sizeof(bits));
+                Append(out, bits, 4);
+                break;
+            }
+        case PcmSampleFormat::Int16:
+            Append(out, static_cast<uint32_t>(static_cast<int32_t>(std::lround(value * 32768.0f))), 2);
+            break;
+        case PcmSampleFormat::Int24:
+            Append(out, static_cast<uint32_t>(static_cast<int32_t>(std::lround(value * 8388608.0f))), 3);
+            break;
+        case PcmSampleFormat::Int32:
+            Append(out, static_cast<uint32_t>(static_cast<int32_t>(std::lround(value * 2147483648.0))), 4);
+            break;
+        }
+    }
+
+    /**
+     * @brief Writes a stereo WAV whose channels are value and value / 2, with a LIST chunk between fmt and data and
+     * a trailing chunk after the data.
+     * @return The expected mono samples
+     */
+    std::vector<float> WriteWav(const std::filesystem::path& path, const WavTestFormat& format, const size_t frames,
+                                const bool unknownDataSize = false) const
+    {
+        constexpr uint16_t channels = 2;
+        constexpr uint32_t sampleRate = 44100;
+        const auto bytesPerSample = static_cast<uint16_t>(GetBytesPerSample(format.sampleFormat));
+        const uint16_t formatTag = format.sampleFormat == PcmSampleFormat::Float32 ? 3 : 1;
+
+        std::string fmt;
+        Append(fmt, format.extensible ? 0xFFFE : formatTag, 2);
+        Append(fmt, channels, 2);
+        Append(fmt, sampleRate, 4);
+        Append(fmt, sampleRate * channels * bytesPerSample, 4);
+        Append(fmt, channels * bytesPerSample, 2);
+        Append(fmt, bytesPerSample * 8, 2);
+        if (format.extensible)
+        {
+            Append(fmt, 22, 2); // cbSize
+            Append(fmt, bytesPerSample * 8, 2); // Valid bits
+            Append(fmt, 0x3, 4); // Front left, front right
+            Append(fmt, formatTag, 2); // Sub format GUID, the rest is the fixed KSDATAFORMAT suffix
+            fmt += std::string("\x00\x00\x00\x00\x10\x00\x80\x00\x00\xAA\x00\x38\x9B\x71", 14);
+        }
+
+        std::vector<float> expected(frames);
+        std::string data;
+        for (size_t i = 0; i < frames; ++i)
+        {
+            const float value = std::sin(static_cast<float>(i) * 0.01f) * 0.5f;
+            AppendSample(data, value, format.sampleFormat);
+            AppendSample(data, value / 2.0f, format.sampleFormat);
+            expected[i] = value * 0.75f;
+        }
+
+        std::string file = "RIFF";
+        Append(file, 0, 4); // Readers do not rely on the RIFF size
+        file += "WAVE";
+        file += "fmt ";
+        Append(file, static_cast<uint32_t>(fmt.size()), 4);
+        file += fmt;
+        file += "LIST";
+        Append(file, 5, 4);
+        file += std::string("INFOx\0", 6); // Odd size, padded
+        file += "data";
+        Append(file, unknownDataSize ? 0xFFFFFFFF : static_cast<uint32_t>(data.size()), 4);
+        file += data;
+        if (!unknownDataSize)
+        {
+            file += "junk";
+            Append(file, 4, 4);
+            file += "1234";
+        }
+
+        std::ofstream out(path, std::ios::binary);
+        out.write(file.data(), static_cast<std::streamsize>(file.size()));
+        return expected;
+    }
+
+    static float GetTolerance(const PcmSampleFormat format)
+    {
+        return format == PcmSampleFormat::Int16 ? 1e-4f : 1e-6f;
+    }
+
+    static std::vector<float> Stream(WavFileAudioSource& source)
+    {
+        AudioChunkCollector collector;
+        source.Subscribe(&collector);
+        collector.Start();
+        EXPECT_TRUE(source.Initialize());
+        source.Start();
+        EXPECT_TRUE(collector.WaitForEndOfStream());
+        source.Stop();
+        collector.StopAndDrain();
+        return collector.GetSamples();
+    }
+};
+
+TEST_P(WavFileAudioSourceTests, WhenStreamingWav_ThenSamplesAreMixedDownAndFormatIsTakenFromHeader)
+{
+    // -------------------- Arrange --------------------
+    const auto path = directory_ / "test.wav";
+    const auto expected = WriteWav(path, GetParam(), 3 * 512 + 100);
+    WavFileAudioSource source(path.string(), 512, 1000);
+
+    // -------------------- Act ------------------------
+    const auto samples = Stream(source);
+
+    // -------------------- Assert ---------------------
+    EXPECT_EQ(source.GetFormat().sampleFormat, GetParam().sampleFormat);
+    EXPECT_EQ(source.GetFormat().channels, 2);
+    EXPECT_EQ(source.GetFormat().sampleRate, 44100);
+    ASSERT_EQ(samples.size(), expected.size()); // The trailing chunk is not read as samples
+    for (size_t i = 0; i < expected.size(); ++i)
+    {
+        ASSERT_NEAR(samples[i], expected[i], GetTolerance(GetParam().sampleFormat)) << "at sample " << i;
+    }
+}
+
+TEST_P(WavFileAudioSourceTests, WhenReadingWholeWav_ThenSamplesMatchStreamedSamples)
+{
+    // -------------------- Arrange --------------------
+    const auto path = directory_ / "test.wav";
+    const auto expected = WriteWav(path, GetParam(), 2000);
+
+    // -------------------- Act ------------------------
+    std::vector<float> samples;
+    WavHeader header;
+    const bool success = WavFileAudioSource::ReadSamples(path.string(), samples, header);
+
+    // -------------------- Assert ---------------------
+    ASSERT_TRUE(success);
+    EXPECT_EQ(header.format.sampleRate, 44100);
+    ASSERT_EQ(samples.size(), expected.size());
+    for (size_t i = 0; i < expected.size(); ++i)
+    {
+        ASSERT_NEAR(samples[i], expected[i], GetTolerance(GetParam().sampleFormat)) << "at sample " << i;
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(Formats, WavFileAudioSourceTests,
+                         ::testing::Values(WavTestFormat{PcmSampleFormat::Int16, false},
+                             WavTestFormat{PcmSampleFormat::Int24, true},
+                             WavTestFormat{PcmSampleFormat::Int32, false},
+                             WavTestFormat{PcmSampleFormat::Float32, false},
+                             WavTestFormat{PcmSampleFormat::Float32, true}));
+
+TEST_F(WavFileAudioSourceTests, WhenDataSizeIsUnknown_ThenWavIsReadToTheEnd)
+{
+    // -------------------- Arrange --------------------
+    const auto path = directory_ / "streamed.wav";
+    const auto expected = WriteWav(path, {PcmSampleFormat::Int16, false}, 1234, true);
+    WavFileAudioSource source(path.string(), 256);
+
+    // -------------------- Act ------------------------
+    const auto samples = Stream(source);
+
+    // -------------------- Assert ---------------------
+    EXPECT_EQ(samples.size(), expected.size());
+}
+
+TEST_F(WavFileAudioSourceTests, WhenFileIsNotASupportedWav_ThenInitializeFails)
+{
+    // -------------------- Arrange --------------------
+    const auto rawPath = directory_ / "raw.wav";
+    {
+        std::ofstream out(rawPath, std::ios::binary);
+        out << "this is not a RIFF file at all";
+    }
+
+    // 8 bit PCM
+    const auto eightBitPath = directory_ / "8bit.wav";
+    {
+        std::string file = "RIFF";
+        Append(file, 0, 4);
+        file += "WAVEfmt ";
+        Append(file, 16, 4);
+        Append(file, 1, 2);
+        Append(file, 1, 2);
+        Append(file, 8000, 4);
+        Append(file, 8000, 4);
+        Append(file, 1, 2);
+        Append(file, 8, 2);
+        file += "data";
+        Append(file, 0, 4);
+        std::ofstream out(eightBitPath, std::ios::binary);
+        out.write(file.data(), static_cast<std::streamsize>(file.size()));
+    }
+
+    WavFileAudioSource rawSource(rawPath.string());
+    WavFileAudioSource eightBitSource(eightBitPath.string());
+
+    // -------------------- Act & Assert ---------------
+    EXPECT_FALSE(rawSource.Initialize());
+    EXPECT_FALSE(eightBitSource.Initialize());
+    EXPECT_FALSE(WavFileAudioSource::ReadFileHeader(eightBitPath.string()).has_value());
+}
+
+TEST_F(WavFileAudioSourceTests, WhenHeaderRateDiffersFromExpectedRate_ThenInitializeFails)
+{
+    // -------------------- Arrange --------------------
+    const auto path = directory_ / "44k.wav";
+    WriteWav(path, {PcmSampleFormat::Int16, false}, 100); // 44.1 kHz
+    WavFileAudioSource expecting48k(path.string(), 256, WavFileAudioSource::DefaultReadBufferBytes, 48000);
+    WavFileAudioSource expecting44k(path.string(), 256, WavFileAudioSource::DefaultReadBufferBytes, 44100);
+
+    // -------------------- Act & Assert ---------------
+    EXPECT_FALSE(expecting48k.Initialize());
+    EXPECT_TRUE(expecting44k.Initialize());
+}
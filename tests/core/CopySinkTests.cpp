@@ -5,10 +5,14 @@
 #include <gtest/gtest.h>
 #include "../../src/core/CopySink.h"
 #include "../../src/core/CopyObservable.h"
+#include "../../src/core/CopyStage.h"
 #include <string>
 #include <vector>
 #include <thread>
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
+#include <mutex>
 
 using namespace bpmfinder::core;
 
@@ -387,3 +391,338 @@ TEST_F(CopySinkTests, WhenConcurrentDataPush_ThenAllDataProcessed)
 
     EXPECT_EQ(sink_->GetProcessedData().size(), total_items);
 }
+
+// ============================================================================
+// Backpressure Tests
+// ============================================================================
+
+/**
+ * @class GatedTestSink
+ * @brief Processes an item only once the gate is open, to simulate a slow consumer.
+ */
+class GatedTestSink : public CopySink<std::string>
+{
+public:
+    void OpenGate()
+    {
+        {
+            std::lock_guard lock(gate_mutex_);
+            open_ = true;
+        }
+        gate_cv_.notify_all();
+    }
+
+protected:
+    void Process(std::string) override
+    {
+        std::unique_lock lock(gate_mutex_);
+        gate_cv_.wait(lock, [this] { return open_; });
+    }
+
+private:
+    std::mutex gate_mutex_;
+    std::condition_variable gate_cv_;
+    bool open_ = false;
+};
+
+TEST_F(CopySinkTests, WhenQueueIsFull_ThenPushDataBlocksUntilThereIsRoom)
+{
+    // -------------------- Arrange --------------------
+    GatedTestSink sink;
+    sink.SetCapacity(2);
+    sink.Start();
+    std::atomic<size_t> pushed{0};
+
+    // -------------------- Act ------------------------
+    std::thread producer([&]
+    {
+        for (int i = 0; i < 5; ++i)
+        {
+            sink.PushData("item_" + std::to_string(i));
+            ++pushed;
+        }
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    const size_t pushedWhileBlocked = pushed;
+
+    sink.OpenGate();
+    producer.join();
+
+    // -------------------- Assert ---------------------
+    EXPECT_EQ(pushedWhileBlocked, 3u); // One item in Process, two in the queue
+    EXPECT_TRUE(WaitForCondition([&] { return sink.GetProcessedCount() == 5; }));
+    sink.Stop();
+}
+
+TEST_F(CopySinkTests, WhenSinkIsNotRunning_ThenPushDataDoesNotBlock)
+{
+    // -------------------- Arrange --------------------
+    sink_->SetCapacity(2);
+
+    // -------------------- Act ------------------------
+    for (int i = 0; i < 10; ++i)
+    {
+        sink_->PushData("item_" + std::to_string(i));
+    }
+
+    // -------------------- Assert ---------------------
+    EXPECT_EQ(sink_->GetQueuedCount(), 10u);
+}
+
+TEST_F(CopySinkTests, WhenSinkIsStopped_ThenBlockedProducerIsReleased)
+{
+    // -------------------- Arrange --------------------
+    GatedTestSink sink;
+    sink.SetCapacity(1);
+    sink.Start();
+    std::atomic<bool> producerDone{false};
+
+    std::thread producer([&]
+    {
+        for (int i = 0; i < 5; ++i)
+        {
+            sink.PushData("item_" + std::to_string(i));
+        }
+        producerDone = true;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    ASSERT_FALSE(producerDone);
+
+    // -------------------- Act ------------------------
+    std::thread stopper([&] { sink.Stop(); });
+
+    // -------------------- Assert ---------------------
+    EXPECT_TRUE(WaitForCondition([&] { return producerDone.load(); }));
+    sink.OpenGate(); // Let the worker finish, so Stop can join it
+    stopper.join();
+    producer.join();
+}
+
+// ============================================================================
+// Inline Execution Tests
+// ============================================================================
+
+TEST_F(CopySinkTests, WhenStartedInline_ThenDataIsProcessedBeforePushDataReturns)
+{
+    // -------------------- Arrange --------------------
+    sink_->Start(ExecutionMode::Inline);
+
+    // -------------------- Act ------------------------
+    sink_->PushData("data1");
+    sink_->PushData(std::string("data2"));
+
+    // -------------------- Assert ---------------------
+    EXPECT_TRUE(sink_->IsInline());
+    EXPECT_EQ(sink_->GetProcessedData(), (std::vector<std::string>{"data1", "data2"}));
+    EXPECT_TRUE(sink_->IsQueueEmpty());
+    EXPECT_EQ(sink_->GetQueuedCount(), 2u);
+}
+
+TEST_F(CopySinkTests, WhenStartedInline_ThenDataPushedBeforeStartIsProcessedByStart)
+{
+    // -------------------- Arrange --------------------
+    sink_->PushData("early1");
+    sink_->PushData("early2");
+
+    // -------------------- Act ------------------------
+    sink_->Start(ExecutionMode::Inline);
+    sink_->PushData("late");
+
+    // -------------------- Assert ---------------------
+    EXPECT_EQ(sink_->GetProcessedData(), (std::vector<std::string>{"early1", "early2", "late"}));
+}
+
+TEST_F(CopySinkTests, WhenStartedInline_ThenProcessRunsOnThePushingThread)
+{
+    // -------------------- Arrange --------------------
+    class ThreadRecordingSink : public CopySink<int>
+    {
+    public:
+        std::thread::id processThread;
+
+    protected:
+        void Process(int) override { processThread = std::this_thread::get_id(); }
+    };
+    ThreadRecordingSink sink;
+    sink.Start(ExecutionMode::Inline);
+
+    // -------------------- Act ------------------------
+    std::thread::id pushThread;
+    std::thread producer([&]
+    {
+        pushThread = std::this_thread::get_id();
+        sink.PushData(1);
+    });
+    producer.join();
+
+    // -------------------- Assert ---------------------
+    EXPECT_EQ(sink.processThread, pushThread);
+}
+
+TEST_F(CopySinkTests, WhenInlineSinkIsStopped_ThenDataIsQueuedAgain)
+{
+    // -------------------- Arrange --------------------
+    sink_->Start(ExecutionMode::Inline);
+    sink_->PushData("processed");
+
+    // -------------------- Act ------------------------
+    sink_->StopAndDrain();
+    sink_->PushData("queued");
+
+    // -------------------- Assert ---------------------
+    EXPECT_FALSE(sink_->IsRunning());
+    EXPECT_FALSE(sink_->IsInline());
+    EXPECT_EQ(sink_->GetProcessedData(), std::vector<std::string>{"processed"});
+    EXPECT_FALSE(sink_->IsQueueEmpty());
+}
+
+TEST_F(CopySinkTests, WhenStagesRunInline_ThenItemsTravelThroughTheWholeChainOnTheCallingThread)
+{
+    // -------------------- Arrange --------------------
+    class AppendStage : public CopyStage<std::string, std::string>
+    {
+    protected:
+        void Process(std::string data) override { Notify(data + "+"); }
+    };
+    AppendStage first;
+    AppendStage second;
+    first.Subscribe(&second);
+    second.Subscribe(sink_.get());
+    first.Start(ExecutionMode::Inline);
+    second.Start(ExecutionMode::Inline);
+    sink_->Start(ExecutionMode::Inline);
+
+    // -------------------- Act ------------------------
+    first.PushData("a");
+    first.PushData("b");
+
+    // -------------------- Assert ---------------------
+    EXPECT_EQ(sink_->GetProcessedData(), (std::vector<std::string>{"a++", "b++"}));
+    EXPECT_EQ(first.GetProcessedCount(), 2u);
+    EXPECT_EQ(second.GetProcessedCount(), 2u);
+}
+
+// ============================================================================
+// Control Token Tests
+// ============================================================================
+
+/**
+ * @class ControlRecordingSink
+ * @brief Records data and control tokens in the order they are handled.
+ */
+class ControlRecordingSink : public CopySink<std::string>
+{
+public:
+    std::vector<std::string> GetLog()
+    {
+        std::lock_guard lock(log_mutex_);
+        return log_;
+    }
+
+protected:
+    void Process(std::string data) override
+    {
+        std::lock_guard lock(log_mutex_);
+        log_.push_back(std::move(data));
+    }
+
+    void OnControl(const ControlToken token) override
+    {
+        std::lock_guard lock(log_mutex_);
+        log_.push_back(token == ControlToken::Reset ? "<Reset>" : token == ControlToken::Flush ? "<Flush>" : "<EOS>");
+    }
+
+private:
+    std::vector<std::string> log_;
+    std::mutex log_mutex_;
+};
+
+TEST_F(CopySinkTests, WhenControlTokenIsPushedBetweenData_ThenItIsHandledInOrder)
+{
+    // -------------------- Arrange --------------------
+    ControlRecordingSink sink;
+    sink.PushData("a");
+    sink.PushData("b");
+    sink.PushControl(ControlToken::Reset);
+    sink.PushData("c");
+    sink.PushControl(ControlToken::EndOfStream);
+
+    // -------------------- Act ------------------------
+    sink.Start();
+    const bool handled = sink.WaitForControl(ControlToken::EndOfStream, 1, std::chrono::seconds(5));
+
+    // -------------------- Assert ---------------------
+    ASSERT_TRUE(handled);
+    EXPECT_EQ(sink.GetLog(), (std::vector<std::string>{"a", "b", "<Reset>", "c", "<EOS>"}));
+    EXPECT_EQ(sink.GetControlCount(ControlToken::Reset), 1u);
+    EXPECT_EQ(sink.GetControlCount(ControlToken::Flush), 0u);
+    EXPECT_TRUE(sink.IsQueueEmpty());
+    sink.Stop();
+}
+
+TEST_F(CopySinkTests, WhenNoControlTokenArrives_ThenWaitForControlTimesOut)
+{
+    // -------------------- Arrange --------------------
+    ControlRecordingSink sink;
+    sink.Start();
+    sink.PushData("a");
+
+    // -------------------- Act ------------------------
+    const bool handled = sink.WaitForControl(ControlToken::Flush, 1, std::chrono::milliseconds(20));
+
+    // -------------------- Assert ---------------------
+    EXPECT_FALSE(handled);
+    sink.Stop();
+}
+
+TEST_F(CopySinkTests, WhenControlTokenPassesAStage_ThenItFollowsTheOutputOfTheStage)
+{
+    // -------------------- Arrange --------------------
+    class AppendStage : public CopyStage<std::string, std::string>
+    {
+    public:
+        std::vector<ControlToken> seen;
+
+    protected:
+        void Process(std::string data) override { Notify(data + "+"); }
+        void OnControl(const ControlToken token) override { seen.push_back(token); }
+    };
+    AppendStage stage;
+    ControlRecordingSink sink;
+    stage.Subscribe(&sink);
+    sink.Start();
+    stage.Start();
+
+    // -------------------- Act ------------------------
+    for (int i = 0; i < 100; ++i)
+    {
+        stage.PushData(std::to_string(i));
+    }
+    stage.PushControl(ControlToken::Flush);
+    const bool handled = sink.WaitForControl(ControlToken::Flush, 1, std::chrono::seconds(5));
+
+    // -------------------- Assert ---------------------
+    ASSERT_TRUE(handled);
+    const auto log = sink.GetLog();
+    ASSERT_EQ(log.size(), 101u);
+    EXPECT_EQ(log[99], "99+");
+    EXPECT_EQ(log[100], "<Flush>");
+    EXPECT_EQ(stage.seen, std::vector<ControlToken>{ControlToken::Flush});
+    stage.Stop();
+    sink.Stop();
+}
+
+TEST_F(CopySinkTests, WhenStartedInline_ThenControlTokenIsHandledBeforePushControlReturns)
+{
+    // -------------------- Arrange --------------------
+    ControlRecordingSink sink;
+    sink.Start(ExecutionMode::Inline);
+    sink.PushData("a");
+
+    // -------------------- Act ------------------------
+    sink.PushControl(ControlToken::Reset);
+
+    // -------------------- Assert ---------------------
+    EXPECT_EQ(sink.GetLog(), (std::vector<std::string>{"a", "<Reset>"}));
+    EXPECT_EQ(sink.GetControlCount(ControlToken::Reset), 1u);
+}
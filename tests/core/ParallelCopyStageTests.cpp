@@ -0,0 +1,218 @@
+//
+// Created by Robert on 2025-10-26.
+//
+
+#include <gtest/gtest.h>
+#include "../../src/core/ParallelCopyStage.h"
+#include <atomic>
+#include <set>
+#include <thread>
+#include <vector>
+
+using namespace bpmfinder::core;
+
+struct TestItem
+{
+    size_t chunkIndex;
+    int value;
+};
+
+/**
+ * @class TestStatelessStage
+ * @brief A stateless stage that doubles the value of every item.
+ *
+ * Items with an even index take longer to process than items with an odd index, so replicas finish their work out of
+ * order and the reorder buffer actually has something to do. Every worker thread that processed an item is recorded.
+ */
+class TestStatelessStage : public CopyStage<TestItem, TestItem>
+{
+public:
+    static constexpr bool IsStateless = true;
+
+    static std::set<std::thread::id> GetWorkerThreads()
+    {
+        std::lock_guard lock(threadsMutex_);
+        return workerThreads_;
+    }
+
+    static void ClearWorkerThreads()
+    {
+        std::lock_guard lock(threadsMutex_);
+        workerThreads_.clear();
+    }
+
+protected:
+    void Process(TestItem data) override
+    {
+        {
+            std::lock_guard lock(threadsMutex_);
+            workerThreads_.insert(std::this_thread::get_id());
+        }
+
+        std::this_thread::sleep_for(std::chrono::microseconds(data.chunkIndex % 2 == 0 ? 500 : 50));
+
+        data.value *= 2;
+        this->Notify(data);
+    }
+
+private:
+    inline static std::mutex threadsMutex_;
+    inline static std::set<std::thread::id> workerThreads_;
+};
+
+/**
+ * @class TestCollectingSink
+ * @brief Collects everything the parallel stage emits.
+ */
+class TestCollectingSink : public CopySink<TestItem>
+{
+public:
+    std::vector<TestItem> GetProcessedData()
+    {
+        std::lock_guard lock(data_mutex_);
+        return processed_data_;
+    }
+
+protected:
+    void Process(TestItem data) override
+    {
+        std::lock_guard lock(data_mutex_);
+        processed_data_.push_back(data);
+    }
+
+private:
+    std::vector<TestItem> processed_data_;
+    std::mutex data_mutex_;
+};
+
+// ============================================================================
+// Test Fixture
+// ============================================================================
+
+class ParallelCopyStageTests : public ::testing::Test
+{
+protected:
+    // The worker threads are recorded in a static set, every test only sees its own replicas
+    void SetUp() override
+    {
+        TestStatelessStage::ClearWorkerThreads();
+    }
+};
+
+TEST_F(ParallelCopyStageTests, WhenItemsProcessedByReplicas_ThenOutputKeepsInputOrder)
+{
+    // -------------------- Arrange --------------------
+    constexpr size_t itemCount = 200;
+    ParallelCopyStage<TestStatelessStage> stage(4);
+    TestCollectingSink sink;
+    stage.Subscribe(&sink);
+    sink.Start();
+    stage.Start();
+
+    // -------------------- Act ------------------------
+    for (size_t i = 0; i < itemCount; ++i)
+    {
+        stage.PushData(TestItem{i, static_cast<int>(i)});
+    }
+
+    stage.Stop();
+    sink.Stop();
+
+    // -------------------- Assert ---------------------
+    const auto processed = sink.GetProcessedData();
+    ASSERT_EQ(processed.size(), itemCount);
+    for (size_t i = 0; i < itemCount; ++i)
+    {
+        EXPECT_EQ(processed[i].chunkIndex, i);
+        EXPECT_EQ(processed[i].value, static_cast<int>(2 * i));
+    }
+}
+
+TEST_F(ParallelCopyStageTests, WhenItemsProcessed_ThenWorkIsSpreadAcrossReplicas)
+{
+    // -------------------- Arrange --------------------
+    ParallelCopyStage<TestStatelessStage> stage(3);
+    TestCollectingSink sink;
+    stage.Subscribe(&sink);
+    sink.Start();
+    stage.Start();
+
+    // -------------------- Act ------------------------
+    for (size_t i = 0; i < 30; ++i)
+    {
+        stage.PushData(TestItem{i, 1});
+    }
+
+    stage.StopAndDrain();
+    sink.Stop();
+
+    // -------------------- Assert ---------------------
+    EXPECT_EQ(stage.GetReplicaCount(), 3);
+    EXPECT_GE(TestStatelessStage::GetWorkerThreads().size(), 3);
+    EXPECT_EQ(sink.GetProcessedData().size(), 30);
+}
+
+TEST_F(ParallelCopyStageTests, WhenReplicaCountIsZero_ThenOneReplicaIsUsed)
+{
+    ParallelCopyStage<TestStatelessStage> stage(0);
+    EXPECT_EQ(stage.GetReplicaCount(), 1);
+}
+
+TEST_F(ParallelCopyStageTests, WhenStartedInline_ThenItemsAreEmittedInOrderBeforePushDataReturns)
+{
+    // -------------------- Arrange --------------------
+    ParallelCopyStage<TestStatelessStage> stage(3);
+    TestCollectingSink sink;
+    stage.Subscribe(&sink);
+    sink.Start(ExecutionMode::Inline);
+    stage.Start(ExecutionMode::Inline);
+
+    // -------------------- Act ------------------------
+    for (size_t i = 0; i < 10; ++i)
+    {
+        stage.PushData(TestItem{i, static_cast<int>(i)});
+    }
+
+    // -------------------- Assert ---------------------
+    const auto processed = sink.GetProcessedData();
+    ASSERT_EQ(processed.size(), 10u);
+    for (size_t i = 0; i < processed.size(); ++i)
+    {
+        EXPECT_EQ(processed[i].chunkIndex, i);
+        EXPECT_EQ(processed[i].value, static_cast<int>(2 * i));
+    }
+    EXPECT_TRUE(stage.IsQueueEmpty());
+}
+
+TEST_F(ParallelCopyStageTests, WhenControlTokenIsPushed_ThenItIsEmittedAfterEveryItemBeforeIt)
+{
+    // -------------------- Arrange --------------------
+    class RecordingSink : public TestCollectingSink
+    {
+    public:
+        std::atomic<size_t> itemsBeforeToken{0};
+
+    protected:
+        void OnControl(ControlToken) override { itemsBeforeToken = GetProcessedData().size(); }
+    };
+    ParallelCopyStage<TestStatelessStage> stage(4);
+    RecordingSink sink;
+    stage.Subscribe(&sink);
+    sink.Start();
+    stage.Start();
+
+    // -------------------- Act ------------------------
+    for (size_t i = 0; i < 50; ++i)
+    {
+        stage.PushData(TestItem{i, 1});
+    }
+    stage.PushControl(ControlToken::Flush);
+    const bool handled = sink.WaitForControl(ControlToken::Flush, 1, std::chrono::seconds(5));
+
+    // -------------------- Assert ---------------------
+    ASSERT_TRUE(handled);
+    EXPECT_EQ(sink.itemsBeforeToken, 50u);
+    EXPECT_TRUE(stage.IsQueueEmpty());
+    stage.Stop();
+    sink.Stop();
+}
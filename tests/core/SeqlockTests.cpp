@@ -0,0 +1,107 @@
+//
+// Created by Robert on 2025-11-16.
+//
+
+#include <gtest/gtest.h>
+#include "../../src/core/Seqlock.h"
+#include <array>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace bpmfinder::core;
+
+namespace
+{
+    // Every field holds the same number, a torn read would mix two of them
+    struct Wide
+    {
+        std::array<uint64_t, 8> values;
+    };
+}
+
+TEST(SeqlockTests, WhenNothingStored_ThenValueIsDefaultAndVersionIsZero)
+{
+    const Seqlock<Wide> seqlock;
+
+    EXPECT_EQ(seqlock.Load().values[0], 0u);
+    EXPECT_EQ(seqlock.GetVersion(), 0u);
+}
+
+TEST(SeqlockTests, WhenStored_ThenLoadReturnsTheValueAndVersionCountsTheStores)
+{
+    // -------------------- Arrange --------------------
+    Seqlock<Wide> seqlock;
+    Wide value{};
+    value.values.fill(7);
+
+    // -------------------- Act ------------------------
+    seqlock.Store(value);
+    seqlock.Store(value);
+    Wide loaded{};
+    const bool consistent = seqlock.TryLoad(loaded);
+
+    // -------------------- Assert ---------------------
+    EXPECT_TRUE(consistent);
+    EXPECT_EQ(loaded.values, value.values);
+    EXPECT_EQ(seqlock.GetVersion(), 2u);
+}
+
+TEST(SeqlockTests, WhenWriterStoresWhileReadersLoad_ThenNoReadIsTorn)
+{
+    // -------------------- Arrange --------------------
+    Seqlock<Wide> seqlock;
+    std::atomic<bool> writing{true};
+    std::atomic<size_t> torn{0};
+    std::atomic<size_t> reads{0};
+    std::atomic<int> started{0};
+
+    // -------------------- Act ------------------------
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 3; ++r)
+    {
+        readers.emplace_back([&]
+        {
+            uint64_t last = 0;
+            started.fetch_add(1);
+            while (writing.load(std::memory_order_relaxed))
+            {
+                const Wide value = seqlock.Load();
+                for (const uint64_t v : value.values)
+                {
+                    if (v != value.values[0])
+                    {
+                        torn.fetch_add(1);
+                    }
+                }
+                if (value.values[0] < last)
+                {
+                    torn.fetch_add(1); // Went back in time
+                }
+                last = value.values[0];
+                reads.fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+    }
+
+    while (started.load() < 3)
+    {
+        std::this_thread::yield();
+    }
+    Wide value{};
+    for (uint64_t i = 1; i <= 200000; ++i)
+    {
+        value.values.fill(i);
+        seqlock.Store(value);
+    }
+    writing = false;
+    for (auto& reader : readers)
+    {
+        reader.join();
+    }
+
+    // -------------------- Assert ---------------------
+    EXPECT_EQ(torn.load(), 0u);
+    EXPECT_GT(reads.load(), 0u);
+    EXPECT_EQ(seqlock.Load().values[0], 200000u);
+}
@@ -0,0 +1,101 @@
+//
+// Created by Robert on 2025-11-10.
+//
+
+#include <gtest/gtest.h>
+#include "../../src/core/SpscRing.h"
+#include <thread>
+#include <vector>
+
+using namespace bpmfinder::core;
+
+TEST(SpscRingTests, WhenCapacityIsNotAPowerOfTwo_ThenItIsRoundedUp)
+{
+    // -------------------- Arrange & Act --------------
+    const SpscRing<float> ring(1000);
+
+    // -------------------- Assert ---------------------
+    EXPECT_EQ(ring.GetCapacity(), 1024u);
+}
+
+TEST(SpscRingTests, WhenWriteDoesNotFit_ThenNothingIsWritten)
+{
+    // -------------------- Arrange --------------------
+    SpscRing<int> ring(8);
+    const std::vector<int> first{1, 2, 3, 4, 5, 6};
+    const std::vector<int> second{7, 8, 9};
+
+    // -------------------- Act ------------------------
+    const bool firstWritten = ring.Write(first.data(), first.size());
+    const bool secondWritten = ring.Write(second.data(), second.size());
+
+    // -------------------- Assert ---------------------
+    EXPECT_TRUE(firstWritten);
+    EXPECT_FALSE(secondWritten);
+    EXPECT_EQ(ring.GetReadable(), 6u);
+}
+
+TEST(SpscRingTests, WhenPositionsWrapAround_ThenElementsComeOutInOrder)
+{
+    // -------------------- Arrange --------------------
+    SpscRing<int> ring(8);
+    std::vector<int> output(5);
+    const std::vector<int> first{1, 2, 3, 4, 5, 6};
+    const std::vector<int> second{7, 8, 9, 10, 11};
+
+    // -------------------- Act ------------------------
+    ring.Write(first.data(), first.size());
+    const size_t firstRead = ring.Read(output.data(), 4);
+    ring.Write(second.data(), second.size()); // Slots 6, 7, 0, 1, 2
+    output.resize(7);
+    const size_t secondRead = ring.Read(output.data(), 100);
+
+    // -------------------- Assert ---------------------
+    EXPECT_EQ(firstRead, 4u);
+    EXPECT_EQ(secondRead, 7u);
+    EXPECT_EQ(output, (std::vector<int>{5, 6, 7, 8, 9, 10, 11}));
+}
+
+TEST(SpscRingTests, WhenProducerAndConsumerRunConcurrently_ThenEveryElementArrivesOnce)
+{
+    // -------------------- Arrange --------------------
+    constexpr int count = 100000;
+    SpscRing<int> ring(64);
+    std::vector<int> received;
+    received.reserve(count);
+
+    // -------------------- Act ------------------------
+    std::thread producer([&]
+    {
+        for (int i = 0; i < count;)
+        {
+            const int block[3] = {i, i + 1, i + 2};
+            const int size = std::min(3, count - i);
+            if (ring.Write(block, static_cast<size_t>(size)))
+            {
+                i += size;
+            }
+            else
+            {
+                std::this_thread::yield(); // Full
+            }
+        }
+    });
+    int buffer[16];
+    while (received.size() < count)
+    {
+        const size_t read = ring.Read(buffer, 16);
+        received.insert(received.end(), buffer, buffer + read);
+        if (read == 0)
+        {
+            std::this_thread::yield(); // Empty
+        }
+    }
+    producer.join();
+
+    // -------------------- Assert ---------------------
+    for (int i = 0; i < count; ++i)
+    {
+        ASSERT_EQ(received[i], i);
+    }
+}
@@ -132,3 +132,24 @@ TEST_F(BandPassFilterTests, BlocksDCSignal)
     // Output should decay to near-zero
     EXPECT_NEAR(output.back(), 0.0f, 0.01f);
 }
+
+TEST_F(BandPassFilterTests, ResetForgetsPreviousInput)
+{
+    // -------------------- Arrange --------------------
+    BandPassFilter fresh(100.0f, 10000.0f, 48000.0f);
+    BandPassFilter used(100.0f, 10000.0f, 48000.0f);
+    for (int i = 0; i < 100; ++i)
+    {
+        used.Process(i % 2 == 0 ? 1.0f : -1.0f);
+    }
+
+    // -------------------- Act ------------------------
+    used.Reset();
+
+    // -------------------- Assert ---------------------
+    for (int i = 0; i < 100; ++i)
+    {
+        const float sample = std::sin(static_cast<float>(i) * 0.1f);
+        EXPECT_FLOAT_EQ(used.Process(sample), fresh.Process(sample));
+    }
+}
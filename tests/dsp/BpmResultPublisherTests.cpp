@@ -0,0 +1,113 @@
+//
+// Created by Robert on 2025-11-16.
+//
+
+#include <gtest/gtest.h>
+#include "../../src/dsp/time_domain_onset_detection/BpmResultPublisher.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace bpmfinder::dsp::time_domain_onset_detection;
+
+namespace
+{
+    BpmSnapshot CreateSnapshot(const uint64_t chunkIndex)
+    {
+        BpmSnapshot snapshot;
+        snapshot.bpm = 120.0f;
+        snapshot.chunkIndex = chunkIndex;
+        return snapshot;
+    }
+}
+
+TEST(BpmResultPublisherTests, WhenEstimateIsPublished_ThenCallbackGetsItOnAnotherThread)
+{
+    // -------------------- Arrange --------------------
+    BpmResultPublisher publisher;
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::vector<uint64_t> received;
+    std::thread::id callbackThread;
+    publisher.AddCallback([&](const BpmSnapshot& snapshot)
+    {
+        std::lock_guard lock(mutex);
+        received.push_back(snapshot.chunkIndex);
+        callbackThread = std::this_thread::get_id();
+        cv.notify_all();
+    });
+
+    // -------------------- Act ------------------------
+    publisher.Publish(CreateSnapshot(42));
+    std::unique_lock lock(mutex);
+    const bool called = cv.wait_for(lock, std::chrono::seconds(5), [&] { return !received.empty(); });
+
+    // -------------------- Assert ---------------------
+    ASSERT_TRUE(called);
+    EXPECT_EQ(received.back(), 42u);
+    EXPECT_NE(callbackThread, std::this_thread::get_id());
+}
+
+TEST(BpmResultPublisherTests, WhenCallbackIsSlow_ThenPublishDoesNotWaitAndLatestEstimateArrives)
+{
+    // -------------------- Arrange --------------------
+    BpmResultPublisher publisher;
+    std::atomic<bool> release{false};
+    std::atomic<uint64_t> last{0};
+    std::atomic<size_t> calls{0};
+    publisher.AddCallback([&](const BpmSnapshot& snapshot)
+    {
+        while (!release.load())
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        last = snapshot.chunkIndex;
+        calls.fetch_add(1);
+    });
+
+    // -------------------- Act ------------------------
+    const auto start = std::chrono::steady_clock::now();
+    for (uint64_t i = 1; i <= 1000; ++i)
+    {
+        publisher.Publish(CreateSnapshot(i));
+    }
+    const auto publishTime = std::chrono::steady_clock::now() - start;
+    release = true;
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (last.load() != 1000 && std::chrono::steady_clock::now() < deadline)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    // -------------------- Assert ---------------------
+    EXPECT_LT(publishTime, std::chrono::seconds(1)); // The callback blocked the whole time
+    EXPECT_EQ(last.load(), 1000u);
+    EXPECT_LT(calls.load(), 1000u); // Coalesced, not a backlog
+}
+
+TEST(BpmResultPublisherTests, WhenCallbackIsRemoved_ThenItIsNotCalledAnymore)
+{
+    // -------------------- Arrange --------------------
+    BpmResultPublisher publisher;
+    std::atomic<size_t> removedCalls{0};
+    std::atomic<size_t> keptCalls{0};
+    const size_t removed = publisher.AddCallback([&](const BpmSnapshot&) { removedCalls.fetch_add(1); });
+    publisher.AddCallback([&](const BpmSnapshot&) { keptCalls.fetch_add(1); });
+
+    // -------------------- Act ------------------------
+    publisher.RemoveCallback(removed);
+    publisher.Publish(CreateSnapshot(1));
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (keptCalls.load() == 0 && std::chrono::steady_clock::now() < deadline)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    // -------------------- Assert ---------------------
+    EXPECT_EQ(keptCalls.load(), 1u);
+    EXPECT_EQ(removedCalls.load(), 0u);
+}
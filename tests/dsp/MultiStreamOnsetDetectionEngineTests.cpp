@@ -0,0 +1,185 @@
+//
+// Created by Robert on 2025-10-28.
+//
+
+#include <gtest/gtest.h>
+#include "../../src/dsp/time_domain_onset_detection/MultiStreamOnsetDetectionEngine.h"
+#include "../../src/dsp/time_domain_onset_detection/TempoEstimation.h"
+#include "../../src/dsp/filters/BandPassFilter.h"
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace bpmfinder::dsp::time_domain_onset_detection;
+using namespace bpmfinder::dsp::filters;
+
+// ============================================================================
+// Test Fixture
+// ============================================================================
+
+class MultiStreamOnsetDetectionEngineTests : public ::testing::Test
+{
+protected:
+    TimeDomainOnsetDetectionConfig config_;
+
+    /**
+     * @brief Scalar reference for one stream, computed the same way the pipeline stages compute it.
+     */
+    struct ReferenceStream
+    {
+        explicit ReferenceStream(const TimeDomainOnsetDetectionConfig& config)
+            : config(config),
+              filter(config.bandPassLowCutoff, config.bandPassHighCutoff, config.sampleRate, config.bandPassGain)
+        {
+        }
+
+        void ProcessChunk(const std::vector<float>& chunk)
+        {
+            energy = 0.0f;
+            for (const float sample : chunk)
+            {
+                const float filtered = filter.Process(sample);
+                energy += filtered * filtered;
+            }
+
+            onsetStrength = std::max(0.0f, energy - previousEnergy);
+            previousEnergy = energy;
+
+            const size_t bufferSize = CalculateOnsetBufferSize(config.sampleRate, config.chunkSize,
+                                                               config.slidingWindowSizeSeconds);
+            onsetBuffer.push_back(onsetStrength);
+            if (onsetBuffer.size() > bufferSize)
+            {
+                onsetBuffer.erase(onsetBuffer.begin());
+            }
+
+            if (onsetBuffer.size() >= bufferSize)
+            {
+                if (const auto peaks = DetectPeakIndices(onsetBuffer, config.peakThreshold); peaks.size() > 2)
+                {
+                    const float interval = CalculateDominantInterval(CalculateInterOnsetIntervals(peaks));
+                    if (const float newBpm = CalculateBpm(interval, config.sampleRate, config.chunkSize); newBpm > 0)
+                    {
+                        bpm = newBpm;
+                    }
+                }
+            }
+        }
+
+        TimeDomainOnsetDetectionConfig config;
+        BandPassFilter filter;
+        float energy = 0.0f;
+        float previousEnergy = 0.0f;
+        float onsetStrength = 0.0f;
+        std::vector<float> onsetBuffer;
+        float bpm = 0.0f;
+    };
+
+    // Short 100 Hz bursts on every beat, on top of quiet noise
+    std::vector<float> CreateClickTrack(const float bpm, const size_t length, const unsigned seed) const
+    {
+        std::mt19937 generator(seed);
+        std::uniform_real_distribution<float> noise(-0.01f, 0.01f);
+
+        const auto beatPeriod = static_cast<size_t>(60.0f / bpm * static_cast<float>(config_.sampleRate));
+        std::vector<float> signal(length);
+        for (size_t n = 0; n < length; ++n)
+        {
+            const size_t position = n % beatPeriod;
+            const float burst = position < 2000
+                                    ? std::sin(2.0f * static_cast<float>(M_PI) * 100.0f * static_cast<float>(position) /
+                                        static_cast<float>(config_.sampleRate))
+                                    : 0.0f;
+            signal[n] = burst + noise(generator);
+        }
+        return signal;
+    }
+
+    // Frame-major layout the engine expects: frames[n * streamCount + streamIndex]
+    std::vector<float> InterleaveChunk(const std::vector<std::vector<float>>& streams, const size_t chunk) const
+    {
+        std::vector<float> frames(config_.chunkSize * streams.size());
+        for (int n = 0; n < config_.chunkSize; ++n)
+        {
+            for (size_t s = 0; s < streams.size(); ++s)
+            {
+                frames[n * streams.size() + s] = streams[s][chunk * config_.chunkSize + n];
+            }
+        }
+        return frames;
+    }
+};
+
+TEST_F(MultiStreamOnsetDetectionEngineTests, WhenProcessingManyStreams_ThenEveryLaneMatchesScalarReference)
+{
+    // -------------------- Arrange --------------------
+    constexpr size_t streamCount = 13; // Not a multiple of any SIMD width, so the remainder loop is covered too
+    constexpr size_t chunkCount = 800; // More than the sliding window, so tempo estimation runs as well
+
+    std::vector<std::vector<float>> streams;
+    std::vector<ReferenceStream> references;
+    std::vector<int> streamIds;
+    for (size_t s = 0; s < streamCount; ++s)
+    {
+        streams.push_back(CreateClickTrack(90.0f + 5.0f * static_cast<float>(s), chunkCount * config_.chunkSize,
+                                           static_cast<unsigned>(s)));
+        references.emplace_back(config_);
+        streamIds.push_back(100 + static_cast<int>(s));
+    }
+
+    MultiStreamOnsetDetectionEngine engine(streamIds, config_);
+
+    // -------------------- Act & Assert ---------------
+    for (size_t chunk = 0; chunk < chunkCount; ++chunk)
+    {
+        engine.ProcessChunk(InterleaveChunk(streams, chunk).data());
+
+        for (size_t s = 0; s < streamCount; ++s)
+        {
+            references[s].ProcessChunk(std::vector<float>(streams[s].begin() + chunk * config_.chunkSize,
+                                                          streams[s].begin() + (chunk + 1) * config_.chunkSize));
+
+            ASSERT_EQ(engine.GetEnergy(s), references[s].energy) << "stream " << s << " chunk " << chunk;
+            ASSERT_EQ(engine.GetOnsetStrength(s), references[s].onsetStrength) << "stream " << s << " chunk " << chunk;
+            ASSERT_EQ(engine.GetBpm(s), references[s].bpm) << "stream " << s << " chunk " << chunk;
+        }
+    }
+
+    EXPECT_EQ(engine.GetProcessedChunkCount(), chunkCount);
+    for (size_t s = 0; s < streamCount; ++s)
+    {
+        EXPECT_GT(engine.GetBpm(s), 0.0f) << "stream " << s; // Make sure the tempo estimation was compared as well
+    }
+}
+
+TEST_F(MultiStreamOnsetDetectionEngineTests, WhenProcessingClickTracks_ThenBpmIsReportedPerStreamId)
+{
+    // -------------------- Arrange --------------------
+    constexpr size_t chunkCount = 1000;
+    const std::vector<float> tempos = {100.0f, 120.0f, 140.0f};
+    const std::vector<int> streamIds = {7, 3, 42};
+
+    std::vector<std::vector<float>> streams;
+    for (size_t s = 0; s < tempos.size(); ++s)
+    {
+        streams.push_back(CreateClickTrack(tempos[s], chunkCount * config_.chunkSize, static_cast<unsigned>(s)));
+    }
+
+    MultiStreamOnsetDetectionEngine engine(streamIds, config_);
+
+    // -------------------- Act ------------------------
+    for (size_t chunk = 0; chunk < chunkCount; ++chunk)
+    {
+        engine.ProcessChunk(InterleaveChunk(streams, chunk).data());
+    }
+
+    // -------------------- Assert ---------------------
+    // One chunk is 21 ms, so the tempo can only be resolved to about +-5% at these tempos
+    const auto results = engine.GetResults();
+    ASSERT_EQ(results.size(), tempos.size());
+    for (size_t s = 0; s < tempos.size(); ++s)
+    {
+        EXPECT_EQ(results[s].streamId, streamIds[s]);
+        EXPECT_NEAR(results[s].bpm, tempos[s], tempos[s] * 0.06f) << "stream id " << streamIds[s];
+    }
+}
@@ -0,0 +1,115 @@
+//
+// Created by Robert on 2025-10-27.
+//
+
+#include <gtest/gtest.h>
+#include "../../src/dsp/filters/SegmentedBandPassFilter.h"
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace bpmfinder::dsp::filters;
+
+// ============================================================================
+// Test Fixture
+// ============================================================================
+
+class SegmentedBandPassFilterTests : public ::testing::Test
+{
+protected:
+    int sampleRate = 48000;
+    int lowCutoff = 40;
+    int highCutoff = 800;
+
+    // Documented tolerance of the segmented filter for full scale input, see docs/dsp/time_domain_onset_detection.md
+    static constexpr float maxDeviation = 5e-5f;
+
+    // Full scale white noise, excites every frequency the filter has
+    static std::vector<float> CreateNoise(const size_t length)
+    {
+        std::mt19937 generator(42);
+        std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+
+        std::vector<float> noise(length);
+        for (auto& sample : noise)
+        {
+            sample = distribution(generator);
+        }
+        return noise;
+    }
+
+    std::vector<float> ProcessSerial(const std::vector<float>& input) const
+    {
+        BandPassFilter filter(lowCutoff, highCutoff, sampleRate);
+        std::vector<float> output;
+        output.reserve(input.size());
+        for (const float sample : input)
+        {
+            output.push_back(filter.Process(sample));
+        }
+        return output;
+    }
+
+    static float MaxAbsoluteDifference(const std::vector<float>& a, const std::vector<float>& b)
+    {
+        float maxDifference = 0.0f;
+        for (size_t i = 0; i < a.size(); ++i)
+        {
+            maxDifference = std::max(maxDifference, std::abs(a[i] - b[i]));
+        }
+        return maxDifference;
+    }
+};
+
+TEST_F(SegmentedBandPassFilterTests, WhenFilteringInSegments_ThenOutputMatchesSerialFilter)
+{
+    // -------------------- Arrange --------------------
+    const auto input = CreateNoise(sampleRate * 10);
+    const SegmentedBandPassFilter filter(lowCutoff, highCutoff, sampleRate, 1.0f, 8);
+
+    // -------------------- Act ------------------------
+    const auto segmented = filter.Process(input);
+    const auto serial = ProcessSerial(input);
+
+    // -------------------- Assert ---------------------
+    ASSERT_EQ(segmented.size(), serial.size());
+    EXPECT_LT(MaxAbsoluteDifference(segmented, serial), maxDeviation);
+}
+
+TEST_F(SegmentedBandPassFilterTests, WhenInputShorterThanWarmUp_ThenSingleSegmentIsExact)
+{
+    // -------------------- Arrange --------------------
+    const auto input = CreateNoise(1000);
+    const SegmentedBandPassFilter filter(lowCutoff, highCutoff, sampleRate, 1.0f, 8);
+
+    // -------------------- Act ------------------------
+    const auto segmented = filter.Process(input);
+
+    // -------------------- Assert ---------------------
+    EXPECT_EQ(segmented, ProcessSerial(input));
+}
+
+TEST_F(SegmentedBandPassFilterTests, WarmUpCoversDecayOfImpulseResponse)
+{
+    // -------------------- Arrange --------------------
+    constexpr float tolerance = 1e-4f;
+    BandPassFilter filter(lowCutoff, highCutoff, sampleRate);
+    const size_t settlingSamples = filter.GetSettlingSamples(tolerance);
+
+    // -------------------- Act ------------------------
+    float peak = std::abs(filter.Process(1.0f));
+    float tail = 0.0f;
+    for (size_t i = 1; i < 2 * settlingSamples; ++i)
+    {
+        const float output = std::abs(filter.Process(0.0f));
+        peak = std::max(peak, output);
+        if (i >= settlingSamples)
+        {
+            tail = std::max(tail, output);
+        }
+    }
+
+    // -------------------- Assert ---------------------
+    EXPECT_GT(settlingSamples, 0);
+    EXPECT_LT(tail, peak * tolerance * 10.0f);
+}
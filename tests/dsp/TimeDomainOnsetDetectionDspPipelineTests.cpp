@@ -0,0 +1,532 @@
+//
+// Created by Robert on 2025-11-03.
+//
+
+#include <gtest/gtest.h>
+#include "../../src/app/BatchAnalyzer.h"
+#include "../../src/audio/BinFileAudioSource.h"
+#include "../../src/audio/SignalGeneratorAudioSource.h"
+#include "../../src/dsp/time_domain_onset_detection/TimeDomainOnsetDetectionDspPipeline.h"
+#include "../../src/files/features/FeatureLogReader.h"
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace bpmfinder::audio;
+using namespace bpmfinder::dsp::time_domain_onset_detection;
+
+/**
+ * @brief Sends a mono signal as interleaved stereo frames, with the right channel at half the level of the left one
+ */
+class StereoTestSource : public IAudioSource
+{
+public:
+    StereoTestSource(std::vector<float> mono, const size_t chunkFrames)
+        : mono_(std::move(mono)), chunkFrames_(chunkFrames)
+    {
+    }
+
+    ~StereoTestSource() override { StereoTestSource::Stop(); }
+
+    bool Initialize() override { return true; }
+
+    void Start() override
+    {
+        worker_ = std::thread([this]
+        {
+            AudioChunk chunk;
+            for (size_t offset = 0; offset + chunkFrames_ <= mono_.size(); offset += chunkFrames_)
+            {
+                chunk.resize(2 * chunkFrames_);
+                for (size_t i = 0; i < chunkFrames_; ++i)
+                {
+                    chunk[2 * i] = mono_[offset + i] * (4.0f / 3.0f);
+                    chunk[2 * i + 1] = mono_[offset + i] * (2.0f / 3.0f);
+                }
+                Notify(chunk);
+            }
+            EndStream();
+            finished_ = true;
+        });
+    }
+
+    void Stop() override
+    {
+        if (worker_.joinable())
+        {
+            worker_.join();
+        }
+    }
+
+    [[nodiscard]] int GetChannelCount() const override { return 2; }
+    [[nodiscard]] bool IsFinished() const override { return finished_; }
+
+private:
+    std::vector<float> mono_;
+    size_t chunkFrames_;
+    std::thread worker_;
+    std::atomic<bool> finished_{false};
+};
+
+/**
+ * @brief Sends a mono signal in chunks from the thread that calls Publish, and the end of stream on End. Start does
+ * nothing.
+ */
+class CallerThreadTestSource : public IAudioSource
+{
+public:
+    bool Initialize() override { return true; }
+    void Start() override {}
+    void Stop() override {}
+
+    void Publish(const std::vector<float>& mono, const size_t chunkSize)
+    {
+        for (size_t offset = 0; offset + chunkSize <= mono.size(); offset += chunkSize)
+        {
+            Notify(AudioChunk(mono.begin() + static_cast<std::ptrdiff_t>(offset),
+                              mono.begin() + static_cast<std::ptrdiff_t>(offset + chunkSize)));
+        }
+    }
+
+    void End()
+    {
+        EndStream();
+        finished_ = true;
+    }
+
+    [[nodiscard]] bool IsFinished() const override { return finished_; }
+
+private:
+    bool finished_ = false;
+};
+
+// ============================================================================
+// Test Fixture
+// ============================================================================
+
+class TimeDomainOnsetDetectionDspPipelineTests : public ::testing::Test
+{
+protected:
+    std::filesystem::path directory_ = std::filesystem::temp_directory_path() / "bpm_finder_dsp_pipeline_tests";
+    TimeDomainOnsetDetectionConfig config_;
+
+    void SetUp() override
+    {
+        std::filesystem::remove_all(directory_);
+        std::filesystem::create_directories(directory_);
+        config_.slidingWindowSizeSeconds = 4;
+    }
+
+    void TearDown() override
+    {
+        std::filesystem::remove_all(directory_);
+    }
+
+    // Click track of whole chunks: short 100 Hz bursts on every beat, on top of quiet noise
+    std::filesystem::path WriteClickTrack(const float bpm, const size_t chunkCount) const
+    {
+        std::mt19937 generator(7);
+        std::uniform_real_distribution<float> noise(-0.01f, 0.01f);
+
+        const size_t length = chunkCount * static_cast<size_t>(config_.chunkSize);
+        const auto beatPeriod = static_cast<size_t>(60.0f / bpm * static_cast<float>(config_.sampleRate));
+        std::vector<float> signal(length);
+        for (size_t n = 0; n < length; ++n)
+        {
+            const size_t position = n % beatPeriod;
+            const float burst = position < 2000
+                                    ? std::sin(2.0f * static_cast<float>(M_PI) * 100.0f * static_cast<float>(position) /
+                                        static_cast<float>(config_.sampleRate))
+                                    : 0.0f;
+            signal[n] = burst + noise(generator);
+        }
+
+        const auto path = directory_ / "click_track.bin";
+        std::ofstream file(path, std::ios::binary);
+        file.write(reinterpret_cast<const char*>(signal.data()),
+                   static_cast<std::streamsize>(signal.size() * sizeof(float)));
+        return path;
+    }
+};
+
+TEST_F(TimeDomainOnsetDetectionDspPipelineTests, WhenReplayingFlatOut_ThenEveryChunkIsProcessedAndBpmMatchesOfflineAnalysis)
+{
+    // -------------------- Arrange --------------------
+    constexpr size_t chunkCount = 300; // 6.4 s
+    const auto path = WriteClickTrack(120.0f, chunkCount);
+
+    BinFileAudioSource source(path.string(), config_.chunkSize);
+    source.SetReplayOptions({BinFileReplayMode::FlatOut});
+    ASSERT_TRUE(source.Initialize());
+
+    // Small queues, so the source is throttled by the slowest stage
+    TimeDomainOnsetDetectionDspPipeline pipeline(source, config_, 4, "");
+
+    bpmfinder::app::BatchAnalyzer analyzer(config_, 1);
+    const auto expected = analyzer.Analyze({path});
+
+    // -------------------- Act ------------------------
+    pipeline.Start();
+    const bool finished = pipeline.WaitUntilFinished(std::chrono::seconds(30));
+
+    // -------------------- Assert ---------------------
+    ASSERT_TRUE(finished);
+    EXPECT_EQ(pipeline.GetProcessedChunkCount(), chunkCount);
+    ASSERT_TRUE(expected[0].success);
+    EXPECT_GT(expected[0].bpm, 0.0f);
+    EXPECT_FLOAT_EQ(pipeline.GetCurrentBpm(), expected[0].bpm);
+}
+
+TEST_F(TimeDomainOnsetDetectionDspPipelineTests, WhenStoppedTwice_ThenSecondStopIsIgnored)
+{
+    // -------------------- Arrange --------------------
+    const auto path = WriteClickTrack(120.0f, 10);
+    BinFileAudioSource source(path.string(), config_.chunkSize);
+    ASSERT_TRUE(source.Initialize());
+    TimeDomainOnsetDetectionDspPipeline pipeline(source, config_, 4, "");
+
+    // -------------------- Act ------------------------
+    pipeline.Start();
+    ASSERT_TRUE(pipeline.WaitUntilFinished(std::chrono::seconds(10)));
+    pipeline.Stop();
+
+    // -------------------- Assert ---------------------
+    EXPECT_EQ(pipeline.GetProcessedChunkCount(), 10u);
+}
+
+TEST_F(TimeDomainOnsetDetectionDspPipelineTests, WhenSourceIsStereo_ThenChunksAreMixedDownBeforeTheAnalysis)
+{
+    // -------------------- Arrange --------------------
+    constexpr size_t chunkCount = 300;
+    const auto path = WriteClickTrack(120.0f, chunkCount);
+    std::vector<float> mono;
+    ASSERT_TRUE(BinFileAudioSource::ReadSamples(path.string(), mono));
+
+    StereoTestSource source(mono, config_.chunkSize);
+    TimeDomainOnsetDetectionDspPipeline pipeline(source, config_, 4, "");
+
+    bpmfinder::app::BatchAnalyzer analyzer(config_, 1);
+    const auto expected = analyzer.Analyze({path});
+
+    // -------------------- Act ------------------------
+    pipeline.Start();
+    const bool finished = pipeline.WaitUntilFinished(std::chrono::seconds(30));
+
+    // -------------------- Assert ---------------------
+    ASSERT_TRUE(finished);
+    EXPECT_EQ(pipeline.GetProcessedChunkCount(), chunkCount);
+    EXPECT_GT(expected[0].bpm, 0.0f);
+    EXPECT_NEAR(pipeline.GetCurrentBpm(), expected[0].bpm, 1e-3f);
+}
+
+TEST_F(TimeDomainOnsetDetectionDspPipelineTests, WhenClickTracksAreMixedWithNoise_ThenBpmIsFoundWithinTolerance)
+{
+    for (const float bpm : {90.0f, 120.0f, 150.0f})
+    {
+        // -------------------- Arrange --------------------
+        SignalGeneratorOptions options;
+        options.sampleRate = config_.sampleRate;
+        options.durationSeconds = 8.0;
+        options.bpm = bpm;
+        options.snrDb = 10.0f;
+        SignalGeneratorAudioSource source(options, config_.chunkSize);
+        ASSERT_TRUE(source.Initialize());
+        TimeDomainOnsetDetectionDspPipeline pipeline(source, config_, 4, "");
+
+        // -------------------- Act ------------------------
+        pipeline.Start();
+        const bool finished = pipeline.WaitUntilFinished(std::chrono::seconds(30));
+
+        // -------------------- Assert ---------------------
+        ASSERT_TRUE(finished) << bpm << " BPM";
+        EXPECT_NEAR(pipeline.GetCurrentBpm(), bpm, bpm * 0.04f) << bpm << " BPM";
+    }
+}
+
+TEST_F(TimeDomainOnsetDetectionDspPipelineTests, WhenStartedInline_ThenChunksAreProcessedOnTheCallingThreadBeforePublishReturns)
+{
+    // -------------------- Arrange --------------------
+    constexpr size_t chunkCount = 300;
+    const auto path = WriteClickTrack(120.0f, chunkCount);
+    std::vector<float> mono;
+    ASSERT_TRUE(BinFileAudioSource::ReadSamples(path.string(), mono));
+
+    CallerThreadTestSource source;
+    TimeDomainOnsetDetectionDspPipeline pipeline(source, config_, 4, "");
+
+    bpmfinder::app::BatchAnalyzer analyzer(config_, 1);
+    const auto expected = analyzer.Analyze({path});
+
+    // -------------------- Act ------------------------
+    pipeline.Start(bpmfinder::core::ExecutionMode::Inline);
+    source.Publish(mono, config_.chunkSize);
+    source.End();
+
+    // -------------------- Assert ---------------------
+    EXPECT_EQ(pipeline.GetProcessedChunkCount(), chunkCount); // Nothing left to wait for
+    ASSERT_TRUE(expected[0].success);
+    EXPECT_FLOAT_EQ(pipeline.GetCurrentBpm(), expected[0].bpm);
+    EXPECT_TRUE(pipeline.WaitUntilFinished(std::chrono::seconds(1)));
+}
+
+TEST_F(TimeDomainOnsetDetectionDspPipelineTests, WhenResetBetweenTwoStreams_ThenSecondStreamIsAnalyzedLikeOnItsOwn)
+{
+    // -------------------- Arrange --------------------
+    constexpr size_t chunkCount = 300;
+    std::vector<float> first;
+    ASSERT_TRUE(BinFileAudioSource::ReadSamples(WriteClickTrack(90.0f, chunkCount).string(), first));
+    const auto path = WriteClickTrack(150.0f, chunkCount);
+    std::vector<float> second;
+    ASSERT_TRUE(BinFileAudioSource::ReadSamples(path.string(), second));
+
+    CallerThreadTestSource source;
+    TimeDomainOnsetDetectionDspPipeline pipeline(source, config_, 4, "");
+
+    bpmfinder::app::BatchAnalyzer analyzer(config_, 1);
+    const auto expected = analyzer.Analyze({path});
+
+    // -------------------- Act ------------------------
+    pipeline.Start();
+    source.Publish(first, config_.chunkSize);
+    const bool reset = pipeline.Reset();
+    source.Publish(second, config_.chunkSize);
+    const bool flushed = pipeline.Flush();
+
+    // -------------------- Assert ---------------------
+    ASSERT_TRUE(reset);
+    ASSERT_TRUE(flushed);
+    EXPECT_EQ(pipeline.GetProcessedChunkCount(), 2 * chunkCount); // Flush is a barrier, nothing left in a queue
+    ASSERT_TRUE(expected[0].success);
+    EXPECT_FLOAT_EQ(pipeline.GetCurrentBpm(), expected[0].bpm);
+    pipeline.Stop();
+}
+
+TEST_F(TimeDomainOnsetDetectionDspPipelineTests, WhenEnergyCalculationIsReplicated_ThenResultsMatchTheSingleStage)
+{
+    // -------------------- Arrange --------------------
+    constexpr size_t chunkCount = 300;
+    std::vector<float> first;
+    ASSERT_TRUE(BinFileAudioSource::ReadSamples(WriteClickTrack(90.0f, chunkCount).string(), first));
+    const auto path = WriteClickTrack(150.0f, chunkCount);
+    std::vector<float> second;
+    ASSERT_TRUE(BinFileAudioSource::ReadSamples(path.string(), second));
+
+    bpmfinder::app::BatchAnalyzer analyzer(config_, 1);
+    const auto expected = analyzer.Analyze({path});
+
+    config_.energyCalculationReplicas = 3;
+    CallerThreadTestSource source;
+    TimeDomainOnsetDetectionDspPipeline pipeline(source, config_, 4, "");
+
+    // -------------------- Act ------------------------
+    pipeline.Start();
+    source.Publish(first, config_.chunkSize);
+    const bool reset = pipeline.Reset(); // Tokens pass the replicas in order with the chunks
+    source.Publish(second, config_.chunkSize);
+    source.End();
+    const bool finished = pipeline.WaitUntilFinished(std::chrono::seconds(30));
+
+    // -------------------- Assert ---------------------
+    ASSERT_TRUE(reset);
+    ASSERT_TRUE(finished);
+    EXPECT_EQ(pipeline.GetProcessedChunkCount(), 2 * chunkCount);
+    ASSERT_TRUE(expected[0].success);
+    EXPECT_FLOAT_EQ(pipeline.GetCurrentBpm(), expected[0].bpm);
+    const auto counts = pipeline.GetControlCounts(bpmfinder::core::ControlToken::Reset);
+    EXPECT_EQ(counts.size(), 8u); // The replicated stage counts once
+    for (const size_t count : counts)
+    {
+        EXPECT_EQ(count, 1u);
+    }
+}
+
+TEST_F(TimeDomainOnsetDetectionDspPipelineTests, WhenNotStarted_ThenFlushReturnsFalse)
+{
+    // -------------------- Arrange --------------------
+    CallerThreadTestSource source;
+    TimeDomainOnsetDetectionDspPipeline pipeline(source, config_, 4, "");
+
+    // -------------------- Act ------------------------
+    const bool flushed = pipeline.Flush(std::chrono::milliseconds(10));
+
+    // -------------------- Assert ---------------------
+    EXPECT_FALSE(flushed);
+}
+
+TEST_F(TimeDomainOnsetDetectionDspPipelineTests, WhenPublisherIsGiven_ThenItGetsTheEstimatesOfTheSnapshot)
+{
+    // -------------------- Arrange --------------------
+    constexpr size_t chunkCount = 300;
+    const auto path = WriteClickTrack(120.0f, chunkCount);
+    std::vector<float> mono;
+    ASSERT_TRUE(BinFileAudioSource::ReadSamples(path.string(), mono));
+
+    BpmResultPublisher publisher;
+    std::mutex mutex;
+    std::condition_variable cv;
+    BpmSnapshot last;
+    publisher.AddCallback([&](const BpmSnapshot& snapshot)
+    {
+        std::lock_guard lock(mutex);
+        last = snapshot;
+        cv.notify_all();
+    });
+
+    CallerThreadTestSource source;
+    TimeDomainOnsetDetectionDspPipeline pipeline(source, config_, 4, "", "", nullptr, &publisher);
+
+    // -------------------- Act ------------------------
+    pipeline.Start(bpmfinder::core::ExecutionMode::Inline);
+    source.Publish(mono, config_.chunkSize);
+    const auto snapshot = pipeline.GetBpmSnapshot();
+
+    // -------------------- Assert ---------------------
+    EXPECT_FLOAT_EQ(snapshot.bpm, pipeline.GetCurrentBpm());
+    EXPECT_NEAR(snapshot.bpm, 120.0f, 120.0f * 0.04f);
+    EXPECT_GT(snapshot.confidence, 0.5f);
+    EXPECT_LE(snapshot.confidence, 1.0f);
+    EXPECT_EQ(snapshot.chunkIndex, chunkCount - 1);
+    EXPECT_LE(snapshot.GetTimestamp(), std::chrono::steady_clock::now());
+
+    std::unique_lock lock(mutex);
+    ASSERT_TRUE(cv.wait_for(lock, std::chrono::seconds(5), [&] { return last.chunkIndex == chunkCount - 1; }));
+    EXPECT_FLOAT_EQ(last.bpm, snapshot.bpm);
+}
+
+TEST_F(TimeDomainOnsetDetectionDspPipelineTests, WhenSourceIsStereo_ThenEveryStageAndSinkGetsEachTokenOnce)
+{
+    // -------------------- Arrange --------------------
+    const auto path = WriteClickTrack(120.0f, 50);
+    std::vector<float> mono;
+    ASSERT_TRUE(BinFileAudioSource::ReadSamples(path.string(), mono));
+
+    bpmfinder::files::recording::FlightRecorder flightRecorder;
+    bpmfinder::files::recording::FlightRecorderOptions options;
+    options.seconds = 5.0;
+    ASSERT_TRUE(flightRecorder.Open((directory_ / "flight.ring").string(), options));
+
+    // Waveform and flight recorder sinks sit behind the downmix stage
+    StereoTestSource source(mono, config_.chunkSize);
+    TimeDomainOnsetDetectionDspPipeline pipeline(source, config_, 4, (directory_ / "waveform.bin").string(),
+                                                 (directory_ / "features.bpmf").string(), &flightRecorder);
+
+    // -------------------- Act ------------------------
+    pipeline.Start();
+    const bool first = pipeline.Flush();
+    const bool second = pipeline.Flush();
+    const auto counts = pipeline.GetControlCounts(bpmfinder::core::ControlToken::Flush);
+    pipeline.Stop();
+
+    // -------------------- Assert ---------------------
+    EXPECT_TRUE(first);
+    EXPECT_TRUE(second);
+    EXPECT_EQ(counts.size(), 13u); // Downmix, 8 stages, waveform, feature log, flight recorder audio and features
+    for (const size_t count : counts)
+    {
+        EXPECT_EQ(count, 2u);
+    }
+    for (const size_t count : pipeline.GetControlCounts(bpmfinder::core::ControlToken::EndOfStream))
+    {
+        EXPECT_EQ(count, 1u);
+    }
+}
+
+TEST_F(TimeDomainOnsetDetectionDspPipelineTests, WhenSourceEndsTheStream_ThenWaitForEndOfStreamReturnsAfterTheLastChunk)
+{
+    // -------------------- Arrange --------------------
+    constexpr size_t chunkCount = 50;
+    std::vector<float> mono;
+    ASSERT_TRUE(BinFileAudioSource::ReadSamples(WriteClickTrack(120.0f, chunkCount).string(), mono));
+
+    CallerThreadTestSource source;
+    TimeDomainOnsetDetectionDspPipeline pipeline(source, config_, 4, "");
+    pipeline.Start();
+    source.Publish(mono, config_.chunkSize);
+
+    // -------------------- Act ------------------------
+    const bool beforeEnd = pipeline.WaitForEndOfStream(std::chrono::milliseconds(50));
+    source.End();
+    const bool afterEnd = pipeline.WaitForEndOfStream(std::chrono::seconds(10));
+    const size_t processed = pipeline.GetProcessedChunkCount();
+    pipeline.Stop();
+
+    // -------------------- Assert ---------------------
+    EXPECT_FALSE(beforeEnd); // A source that has not ended yet is live as far as the pipeline knows
+    EXPECT_TRUE(afterEnd);
+    EXPECT_EQ(processed, chunkCount);
+    for (const size_t count : pipeline.GetControlCounts(bpmfinder::core::ControlToken::EndOfStream))
+    {
+        EXPECT_EQ(count, 1u); // Stop does not send a second one
+    }
+}
+
+TEST_F(TimeDomainOnsetDetectionDspPipelineTests, WhenFlushed_ThenWaveformAndFeatureLogHoldEveryChunkSoFar)
+{
+    // -------------------- Arrange --------------------
+    constexpr size_t chunkCount = 50;
+    std::vector<float> mono;
+    ASSERT_TRUE(BinFileAudioSource::ReadSamples(WriteClickTrack(120.0f, chunkCount).string(), mono));
+    const auto waveformPath = directory_ / "waveform.bin";
+    const auto featureLogPath = directory_ / "features.bpmf";
+
+    CallerThreadTestSource source;
+    TimeDomainOnsetDetectionDspPipeline pipeline(source, config_, 4, waveformPath.string(), featureLogPath.string());
+    pipeline.Start();
+    source.Publish(mono, config_.chunkSize);
+
+    // -------------------- Act ------------------------
+    const bool flushed = pipeline.Flush();
+    const auto waveformBytes = std::filesystem::file_size(waveformPath);
+    bpmfinder::files::features::FeatureLogReader reader;
+    const bool opened = reader.Open(featureLogPath.string());
+    std::vector<bpmfinder::files::features::FeatureRow> rows;
+    const bool read = reader.ReadAll(rows);
+    pipeline.Stop();
+
+    // -------------------- Assert ---------------------
+    ASSERT_TRUE(flushed);
+    EXPECT_EQ(waveformBytes, mono.size() * sizeof(float));
+    ASSERT_TRUE(opened);
+    ASSERT_TRUE(read);
+    EXPECT_EQ(rows.size(), chunkCount);
+}
+
+TEST_F(TimeDomainOnsetDetectionDspPipelineTests, WhenNoTempoIsKnownYet_ThenFeatureLogRowsHaveNoBpm)
+{
+    // -------------------- Arrange --------------------
+    constexpr size_t chunkCount = 300;
+    std::vector<float> mono;
+    ASSERT_TRUE(BinFileAudioSource::ReadSamples(WriteClickTrack(120.0f, chunkCount).string(), mono));
+    const auto featureLogPath = directory_ / "features.bpmf";
+
+    CallerThreadTestSource source;
+    float bpm = 0.0f;
+
+    // -------------------- Act ------------------------
+    {
+        TimeDomainOnsetDetectionDspPipeline pipeline(source, config_, 4, "", featureLogPath.string());
+        pipeline.Start();
+        source.Publish(mono, config_.chunkSize);
+        source.End();
+        ASSERT_TRUE(pipeline.WaitUntilFinished(std::chrono::seconds(30)));
+        bpm = pipeline.GetCurrentBpm();
+    } // Closes the feature log
+    bpmfinder::files::features::FeatureLogReader reader;
+    ASSERT_TRUE(reader.Open(featureLogPath.string()));
+    std::vector<bpmfinder::files::features::FeatureRow> rows;
+    ASSERT_TRUE(reader.ReadAll(rows));
+
+    // -------------------- Assert ---------------------
+    ASSERT_EQ(rows.size(), chunkCount);
+    EXPECT_FALSE(rows.front().bpm.has_value()); // The sliding window is not full yet
+    ASSERT_TRUE(rows.back().bpm.has_value());
+    EXPECT_GT(bpm, 0.0f);
+    EXPECT_FLOAT_EQ(*rows.back().bpm, bpm);
+}
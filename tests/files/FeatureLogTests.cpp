@@ -0,0 +1,200 @@
+//
+// Created by Robert on 2025-11-13.
+//
+
+#include <gtest/gtest.h>
+#include "../../src/files/bin/FeatureLogFileSink.h"
+#include "../../src/files/features/FeatureLogReader.h"
+#include "../../src/files/features/FeatureLogWriter.h"
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+using namespace bpmfinder::files;
+using namespace bpmfinder::files::features;
+
+// ============================================================================
+// Test Fixture
+// ============================================================================
+
+class FeatureLogTests : public ::testing::Test
+{
+protected:
+    std::filesystem::path directory_ = std::filesystem::temp_directory_path() / "bpm_finder_feature_log_tests";
+
+    void SetUp() override
+    {
+        std::filesystem::remove_all(directory_);
+        std::filesystem::create_directories(directory_);
+    }
+
+    void TearDown() override
+    {
+        std::filesystem::remove_all(directory_);
+    }
+
+    // Like the pipeline: every chunk has energy and onset strength, peaks and intervals every 50 chunks, a BPM that
+    // changes every 300 chunks once the first one is known
+    static std::vector<FeatureRow> CreateRows(const size_t count)
+    {
+        std::vector<FeatureRow> rows(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            auto& row = rows[i];
+            row.chunkIndex = i + (i > 700 ? 5 : 0); // A gap, as if chunks were lost
+            row.energy = static_cast<float>(i % 17) * 0.25f;
+            row.onsetStrength = static_cast<float>(i % 5) - 2.0f;
+            if (i % 50 == 0)
+            {
+                row.peakIndices = std::vector<uint64_t>{i * 1024, i * 1024 + 300, i * 1024 + 90}; // Not sorted
+                row.interOnsetIntervals = std::vector<float>{0.5f, 0.49f};
+                row.dominantInterval = 0.5f;
+            }
+            if (i >= 120)
+            {
+                row.bpm = 120.0f + static_cast<float>(i / 300);
+            }
+        }
+        return rows;
+    }
+
+    static void Write(const std::filesystem::path& path, const std::vector<FeatureRow>& rows,
+                      const uint32_t rowsPerBlock)
+    {
+        WriteBehindFile file;
+        ASSERT_TRUE(file.Open(path.string()));
+        FeatureLogWriter writer(file, {44100, 1024, rowsPerBlock});
+        for (const auto& row : rows)
+        {
+            writer.Append(row);
+        }
+        writer.Finish();
+        ASSERT_TRUE(file.Close());
+    }
+};
+
+TEST_F(FeatureLogTests, WhenReadingLog_ThenRowsAreExactlyAsWritten)
+{
+    // -------------------- Arrange --------------------
+    const auto path = directory_ / "features.bpmf";
+    const auto expected = CreateRows(2500);
+    Write(path, expected, 1024);
+
+    // -------------------- Act ------------------------
+    FeatureLogReader reader;
+    ASSERT_TRUE(reader.Open(path.string()));
+    std::vector<FeatureRow> rows;
+    const bool complete = reader.ReadAll(rows);
+
+    // -------------------- Assert ---------------------
+    EXPECT_TRUE(complete);
+    EXPECT_EQ(reader.GetSampleRate(), 44100u);
+    EXPECT_EQ(reader.GetChunkSize(), 1024u);
+    EXPECT_EQ(reader.GetBlockCount(), 3u);
+    EXPECT_EQ(reader.GetRowCount(), 2500u);
+    ASSERT_EQ(rows.size(), expected.size());
+    for (size_t i = 0; i < rows.size(); ++i)
+    {
+        ASSERT_EQ(rows[i], expected[i]) << "row " << i;
+    }
+}
+
+TEST_F(FeatureLogTests, WhenFieldsAreSparse_ThenRowsTakeLittleMoreThanEnergyAndOnsetStrength)
+{
+    // -------------------- Arrange --------------------
+    const auto path = directory_ / "features.bpmf";
+    const auto rows = CreateRows(10000);
+
+    // -------------------- Act ------------------------
+    Write(path, rows, 1024);
+
+    // -------------------- Assert ---------------------
+    // 8 bytes for the two floats; indices, presence and the BPM runs add almost nothing, the peaks every 50 rows
+    // about 0.5 bytes per row
+    const double bytesPerRow = static_cast<double>(std::filesystem::file_size(path)) / rows.size();
+    EXPECT_LT(bytesPerRow, 9.0);
+}
+
+TEST_F(FeatureLogTests, WhenBlockIsDamaged_ThenItIsNotDecoded)
+{
+    // -------------------- Arrange --------------------
+    const auto path = directory_ / "features.bpmf";
+    Write(path, CreateRows(300), 100);
+    {
+        // A byte in the first block's energy column
+        std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(static_cast<std::streamoff>(sizeof(FeatureLogHeader) + sizeof(FeatureBlockHeader) + 40));
+        file.put('\x7F');
+    }
+
+    // -------------------- Act ------------------------
+    FeatureLogReader reader;
+    ASSERT_TRUE(reader.Open(path.string()));
+    std::vector<FeatureRow> rows;
+    const bool firstBlock = reader.ReadBlock(0, rows);
+    const bool secondBlock = reader.ReadBlock(1, rows);
+
+    // -------------------- Assert ---------------------
+    EXPECT_FALSE(firstBlock);
+    EXPECT_TRUE(secondBlock);
+    ASSERT_EQ(rows.size(), 100u);
+    EXPECT_EQ(rows.front().chunkIndex, 100u);
+}
+
+TEST_F(FeatureLogTests, WhenPayloadIsTruncated_ThenDecodingFailsWithoutRows)
+{
+    // -------------------- Arrange --------------------
+    const auto expected = CreateRows(200);
+    std::vector<std::byte> payload;
+    EncodeFeatureBlock(expected, payload);
+
+    // -------------------- Act & Assert ---------------
+    for (size_t size = 0; size < payload.size(); size += 7)
+    {
+        std::vector<FeatureRow> rows;
+        EXPECT_FALSE(DecodeFeatureBlock(payload.data(), size, expected.size(), rows)) << size << " bytes";
+        EXPECT_TRUE(rows.empty());
+    }
+    std::vector<FeatureRow> rows;
+    EXPECT_TRUE(DecodeFeatureBlock(payload.data(), payload.size(), expected.size(), rows));
+    EXPECT_EQ(rows, expected);
+}
+
+TEST_F(FeatureLogTests, WhenSinkIsDestroyed_ThenLogHoldsEveryResultWithoutAudio)
+{
+    // -------------------- Arrange --------------------
+    using bpmfinder::dsp::time_domain_onset_detection::TimeDomainOnsetDetectionResult;
+    const auto path = directory_ / "features.bpmf";
+
+    // -------------------- Act ------------------------
+    {
+        bin::FeatureLogFileSink sink(path.string(), {48000, 512, 4});
+        sink.Start();
+        for (size_t i = 0; i < 10; ++i)
+        {
+            TimeDomainOnsetDetectionResult result(i, bpmfinder::audio::AudioChunk(512, 0.5f), 48000, 512, 40, 800,
+                                                  1.0f);
+            result.energy = static_cast<float>(i);
+            if (i == 6)
+            {
+                result.peakIndices = std::vector<size_t>{100, 2000};
+                result.bpm = 128.0f;
+            }
+            sink.PushData(result);
+        }
+        sink.StopAndDrain();
+        EXPECT_EQ(sink.GetWrittenCount(), 10u);
+    } // Writes the last block
+
+    // -------------------- Assert ---------------------
+    FeatureLogReader reader;
+    ASSERT_TRUE(reader.Open(path.string()));
+    std::vector<FeatureRow> rows;
+    ASSERT_TRUE(reader.ReadAll(rows));
+    ASSERT_EQ(rows.size(), 10u);
+    EXPECT_EQ(reader.GetBlockCount(), 3u);
+    EXPECT_EQ(rows[9].energy, 9.0f);
+    EXPECT_EQ(rows[6].peakIndices, (std::vector<uint64_t>{100, 2000}));
+    EXPECT_EQ(rows[6].bpm, 128.0f);
+    EXPECT_FALSE(rows[5].bpm.has_value());
+}
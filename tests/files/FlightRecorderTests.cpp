@@ -0,0 +1,214 @@
+//
+// Created by Robert on 2025-11-14.
+//
+
+#include <gtest/gtest.h>
+#include "../../src/files/features/FeatureLogReader.h"
+#include "../../src/files/recording/FlightRecorder.h"
+#include "../../src/files/recording/RecordingReader.h"
+#include <atomic>
+#include <filesystem>
+#include <thread>
+#include <vector>
+
+using namespace bpmfinder::files;
+using namespace bpmfinder::files::recording;
+
+// ============================================================================
+// Test Fixture
+// ============================================================================
+
+class FlightRecorderTests : public ::testing::Test
+{
+protected:
+    std::filesystem::path directory_ = std::filesystem::temp_directory_path() / "bpm_finder_flight_recorder_tests";
+
+    // 1000 frames: 10 chunks of 100 frames
+    static constexpr FlightRecorderOptions Options{1000, 100, 1.0};
+
+    void SetUp() override
+    {
+        std::filesystem::remove_all(directory_);
+        std::filesystem::create_directories(directory_);
+    }
+
+    void TearDown() override
+    {
+        std::filesystem::remove_all(directory_);
+    }
+
+    // Every sample is its position in the stream
+    static void WriteRamp(FlightRecorder& recorder, const uint64_t first, const size_t count)
+    {
+        std::vector<float> samples(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            samples[i] = static_cast<float>(first + i);
+        }
+        recorder.WriteAudio(samples.data(), samples.size());
+    }
+
+    static std::vector<float> ReadRecording(const std::filesystem::path& path)
+    {
+        RecordingReader reader;
+        EXPECT_TRUE(reader.Open(path.string()));
+        std::vector<float> samples(reader.GetFrameCount());
+        EXPECT_EQ(samples.size(), reader.ReadFrames(0, samples.size(), samples.data()));
+        return samples;
+    }
+};
+
+TEST_F(FlightRecorderTests, WhenLessThanCapacityWasWritten_ThenSnapshotHoldsAll)
+{
+    // -------------------- Arrange --------------------
+    FlightRecorder recorder;
+    ASSERT_TRUE(recorder.Open((directory_ / "flight.ring").string(), Options));
+    WriteRamp(recorder, 0, 250);
+    const auto prefix = directory_ / "snapshot";
+
+    // -------------------- Act --------------------
+    const double seconds = recorder.Snapshot(prefix.string());
+
+    // -------------------- Assert --------------------
+    EXPECT_DOUBLE_EQ(0.25, seconds);
+    const auto samples = ReadRecording(prefix.string() + ".bpmr");
+    ASSERT_EQ(250u, samples.size());
+    EXPECT_EQ(0.0f, samples.front());
+    EXPECT_EQ(249.0f, samples.back());
+}
+
+TEST_F(FlightRecorderTests, WhenRingWrapped_ThenSnapshotHoldsLastSecondsFromChunkBoundary)
+{
+    // -------------------- Arrange --------------------
+    FlightRecorder recorder;
+    ASSERT_TRUE(recorder.Open((directory_ / "flight.ring").string(), Options));
+    for (uint64_t written = 0; written < 2550; written += 150)
+    {
+        WriteRamp(recorder, written, 150);
+    }
+    const auto prefix = directory_ / "snapshot";
+
+    // -------------------- Act --------------------
+    const double seconds = recorder.Snapshot(prefix.string());
+
+    // -------------------- Assert --------------------
+    // The ring holds 1550..2549, the recording starts at the next chunk boundary
+    EXPECT_EQ(2550u, recorder.GetWrittenFrames());
+    EXPECT_DOUBLE_EQ(0.95, seconds);
+    const auto samples = ReadRecording(prefix.string() + ".bpmr");
+    ASSERT_EQ(950u, samples.size());
+    for (size_t i = 0; i < samples.size(); ++i)
+    {
+        ASSERT_EQ(static_cast<float>(1600 + i), samples[i]) << "at " << i;
+    }
+}
+
+TEST_F(FlightRecorderTests, WhenWriteIsLongerThanRing_ThenItsEndIsKept)
+{
+    // -------------------- Arrange --------------------
+    FlightRecorder recorder;
+    ASSERT_TRUE(recorder.Open((directory_ / "flight.ring").string(), Options));
+    WriteRamp(recorder, 0, 3000);
+    const auto prefix = directory_ / "snapshot";
+
+    // -------------------- Act --------------------
+    recorder.Snapshot(prefix.string());
+
+    // -------------------- Assert --------------------
+    const auto samples = ReadRecording(prefix.string() + ".bpmr");
+    ASSERT_EQ(1000u, samples.size());
+    EXPECT_EQ(2000.0f, samples.front());
+    EXPECT_EQ(2999.0f, samples.back());
+}
+
+TEST_F(FlightRecorderTests, WhenTakingSnapshot_ThenFeaturesAreRebasedToTheRecording)
+{
+    // -------------------- Arrange --------------------
+    FlightRecorder recorder;
+    ASSERT_TRUE(recorder.Open((directory_ / "flight.ring").string(), Options));
+    WriteRamp(recorder, 0, 2550);
+    for (uint64_t chunk = 0; chunk < 25; ++chunk)
+    {
+        FlightRecord record;
+        record.chunkIndex = chunk;
+        record.energy = static_cast<float>(chunk);
+        record.onsetStrength = 0.5f;
+        if (chunk % 4 == 0)
+        {
+            record.bpm = 120.0f + static_cast<float>(chunk);
+            record.flags = FlightRecord::HasBpm;
+        }
+        recorder.WriteFeatures(record);
+    }
+    const auto prefix = directory_ / "snapshot";
+
+    // -------------------- Act --------------------
+    ASSERT_GT(recorder.Snapshot(prefix.string()), 0.0);
+
+    // -------------------- Assert --------------------
+    // The recording starts with chunk 16; features of chunks before it are dropped, chunk 25 was not analyzed yet
+    features::FeatureLogReader reader;
+    ASSERT_TRUE(reader.Open(prefix.string() + ".bpmf"));
+    std::vector<features::FeatureRow> rows;
+    ASSERT_TRUE(reader.ReadAll(rows));
+    ASSERT_EQ(9u, rows.size());
+    for (size_t i = 0; i < rows.size(); ++i)
+    {
+        const uint64_t chunk = 16 + i;
+        EXPECT_EQ(i, rows[i].chunkIndex);
+        EXPECT_EQ(static_cast<float>(chunk), rows[i].energy);
+        EXPECT_EQ(chunk % 4 == 0, rows[i].bpm.has_value());
+        EXPECT_FALSE(rows[i].dominantInterval.has_value());
+    }
+    EXPECT_EQ(136.0f, rows[0].bpm.value());
+}
+
+TEST_F(FlightRecorderTests, WhenSnapshotRacesWriter_ThenSamplesAreNeverTorn)
+{
+    // -------------------- Arrange --------------------
+    // Small writes into a small ring: the writer laps the snapshot's copy now and then
+    FlightRecorder recorder;
+    ASSERT_TRUE(recorder.Open((directory_ / "flight.ring").string(), Options));
+    std::atomic<bool> running{true};
+    std::thread writer([&]
+    {
+        uint64_t written = 0;
+        while (running.load(std::memory_order_relaxed))
+        {
+            // Floats are exact up to 2^24
+            WriteRamp(recorder, written % (1u << 23), 30);
+            written = (written + 30) % (1u << 23);
+        }
+    });
+
+    // -------------------- Act & Assert --------------------
+    const auto prefix = directory_ / "snapshot";
+    for (int snapshot = 0; snapshot < 50; ++snapshot)
+    {
+        ASSERT_GE(recorder.Snapshot(prefix.string()), 0.0);
+        const auto samples = ReadRecording(prefix.string() + ".bpmr");
+        for (size_t i = 1; i < samples.size(); ++i)
+        {
+            if (samples[i] != 0.0f)
+            {
+                ASSERT_EQ(samples[i - 1] + 1.0f, samples[i]) << "snapshot " << snapshot << " at " << i;
+            }
+        }
+    }
+    running = false;
+    writer.join();
+}
+
+TEST_F(FlightRecorderTests, WhenFileCannotBeCreated_ThenOpenFails)
+{
+    // -------------------- Arrange --------------------
+    FlightRecorder recorder;
+
+    // -------------------- Act --------------------
+    const bool opened = recorder.Open((directory_ / "missing" / "flight.ring").string(), Options);
+
+    // -------------------- Assert --------------------
+    EXPECT_FALSE(opened);
+    EXPECT_FALSE(recorder.IsOpen());
+    EXPECT_LT(recorder.Snapshot((directory_ / "snapshot").string()), 0.0);
+}
@@ -0,0 +1,330 @@
+//
+// Created by Robert on 2025-11-12.
+//
+
+#include <gtest/gtest.h>
+#include "../../src/files/bin/RecordingFileSink.h"
+#include "../../src/files/recording/RecordingReader.h"
+#include "../../src/files/recording/RecordingWriter.h"
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <random>
+#include <vector>
+
+using namespace bpmfinder::files;
+using namespace bpmfinder::files::recording;
+
+// ============================================================================
+// Test Fixture
+// ============================================================================
+
+class RecordingTests : public ::testing::TestWithParam<RecordingOptions>
+{
+protected:
+    std::filesystem::path directory_ = std::filesystem::temp_directory_path() / "bpm_finder_recording_tests";
+
+    void SetUp() override
+    {
+        std::filesystem::remove_all(directory_);
+        std::filesystem::create_directories(directory_);
+    }
+
+    void TearDown() override
+    {
+        std::filesystem::remove_all(directory_);
+    }
+
+    // A decaying sine per channel, with a burst of noise and a stretch of silence in between
+    static std::vector<float> CreateFrames(const size_t frames, const size_t channels)
+    {
+        std::mt19937 random(42);
+        std::uniform_real_distribution noise(-1.0f, 1.0f);
+        std::vector<float> samples(frames * channels);
+        for (size_t i = 0; i < frames; ++i)
+        {
+            for (size_t c = 0; c < channels; ++c)
+            {
+                float value = std::sin(static_cast<float>(i) * 0.01f * static_cast<float>(c + 1)) *
+                    std::exp(-static_cast<float>(i % 5000) / 2000.0f);
+                if (i % 7000 > 6000)
+                {
+                    value = noise(random);
+                }
+                else if (i % 7000 < 500)
+                {
+                    value = 0.0f;
+                }
+                samples[i * channels + c] = value;
+            }
+        }
+        return samples;
+    }
+
+    static void Write(const std::filesystem::path& path, const RecordingOptions& options,
+                      const std::vector<float>& samples, const bool finish = true)
+    {
+        WriteBehindFile file;
+        ASSERT_TRUE(file.Open(path.string()));
+        RecordingWriter writer(file, options);
+
+        // Odd piece sizes, so blocks are filled across several writes
+        const size_t frames = samples.size() / options.channels;
+        size_t frame = 0;
+        for (size_t size = 1; frame < frames; size = size * 7 % 3001 + 1)
+        {
+            const size_t count = std::min(size, frames - frame);
+            writer.Write(samples.data() + frame * options.channels, count);
+            frame += count;
+        }
+        if (finish)
+        {
+            writer.Finish();
+        }
+        ASSERT_TRUE(file.Close());
+    }
+};
+
+TEST_P(RecordingTests, WhenReadingWholeRecording_ThenFramesAndFormatAreExactlyAsWritten)
+{
+    // -------------------- Arrange --------------------
+    const auto& options = GetParam();
+    const auto path = directory_ / "recording.bpmr";
+    const auto expected = CreateFrames(30000, options.channels);
+    Write(path, options, expected);
+
+    // -------------------- Act ------------------------
+    RecordingReader reader;
+    ASSERT_TRUE(reader.Open(path.string()));
+    std::vector<float> samples(expected.size());
+    const size_t frames = reader.ReadFrames(0, 30000, samples.data());
+
+    // -------------------- Assert ---------------------
+    EXPECT_FALSE(reader.IsRecovered());
+    EXPECT_EQ(reader.GetSampleRate(), options.sampleRate);
+    EXPECT_EQ(reader.GetChannels(), options.channels);
+    EXPECT_EQ(reader.GetFrameCount(), 30000u);
+    EXPECT_EQ(reader.GetBlockCount(), (30000 + options.blockFrames - 1) / options.blockFrames);
+    ASSERT_EQ(frames, 30000u);
+    EXPECT_EQ(std::memcmp(samples.data(), expected.data(), expected.size() * sizeof(float)), 0); // Bit exact
+    EXPECT_TRUE(reader.Verify());
+}
+
+TEST_P(RecordingTests, WhenReadingAtAnyTime_ThenFramesMatchThatPartOfTheRecording)
+{
+    // -------------------- Arrange --------------------
+    const auto& options = GetParam();
+    const auto path = directory_ / "recording.bpmr";
+    const auto expected = CreateFrames(30000, options.channels);
+    Write(path, options, expected);
+
+    RecordingReader reader;
+    ASSERT_TRUE(reader.Open(path.string()));
+
+    // -------------------- Act & Assert ---------------
+    // Backwards, so no read can profit from the block the previous one decoded
+    for (uint64_t first = 29990; first > 0; first = first > 1777 ? first - 1777 : 0)
+    {
+        std::vector<float> samples(1000 * options.channels);
+        const size_t frames = reader.ReadFrames(first, 1000, samples.data());
+        const size_t expectedFrames = std::min<size_t>(1000, 30000 - first);
+        ASSERT_EQ(frames, expectedFrames) << "from frame " << first;
+        EXPECT_EQ(std::memcmp(samples.data(), expected.data() + first * options.channels,
+                              frames * options.channels * sizeof(float)), 0) << "from frame " << first;
+    }
+
+    EXPECT_EQ(reader.GetFrameAt(0.25), static_cast<uint64_t>(0.25 * options.sampleRate));
+    EXPECT_EQ(reader.GetFrameAt(3600.0), 30000u);
+}
+
+TEST_P(RecordingTests, WhenFooterIsMissing_ThenBlocksAreRecoveredFromTheirHeaders)
+{
+    // -------------------- Arrange --------------------
+    const auto& options = GetParam();
+    const auto path = directory_ / "recording.bpmr";
+    const auto expected = CreateFrames(30000, options.channels);
+    Write(path, options, expected, false); // Like a writer that died: the last, partial block is lost
+
+    // -------------------- Act ------------------------
+    RecordingReader reader;
+    ASSERT_TRUE(reader.Open(path.string()));
+    std::vector<float> samples(expected.size());
+    const size_t frames = reader.ReadFrames(0, 30000, samples.data());
+
+    // -------------------- Assert ---------------------
+    const size_t fullBlockFrames = 30000 / options.blockFrames * options.blockFrames;
+    EXPECT_TRUE(reader.IsRecovered());
+    EXPECT_EQ(reader.GetFrameCount(), fullBlockFrames);
+    ASSERT_EQ(frames, fullBlockFrames);
+    EXPECT_EQ(std::memcmp(samples.data(), expected.data(), frames * options.channels * sizeof(float)), 0);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    Options, RecordingTests,
+    ::testing::Values(RecordingOptions{48000, 1, 4096, true, true}, RecordingOptions{44100, 2, 1000, true, false},
+                      RecordingOptions{48000, 2, 4096, false, true}, RecordingOptions{8000, 3, 1, true, true}),
+    [](const ::testing::TestParamInfo<RecordingOptions>& info)
+    {
+        return std::to_string(info.param.channels) + "ch_" + std::to_string(info.param.blockFrames) + "frames" +
+            (info.param.checksums ? "_checksums" : "") + (info.param.compression ? "_compressed" : "");
+    });
+
+TEST_F(RecordingTests, WhenBlockIsDamaged_ThenReadsStopBeforeItAndVerifyFails)
+{
+    // -------------------- Arrange --------------------
+    const auto path = directory_ / "recording.bpmr";
+    const RecordingOptions options{48000, 1, 1000, true, true};
+    const auto expected = CreateFrames(5000, 1);
+    Write(path, options, expected);
+
+    size_t thirdBlock;
+    {
+        RecordingReader reader;
+        ASSERT_TRUE(reader.Open(path.string()));
+        std::vector<float> samples(5000);
+        ASSERT_EQ(reader.ReadFrames(0, 5000, samples.data()), 5000u);
+    }
+    {
+        // Find the third block from the index in front of the footer
+        std::ifstream file(path, std::ios::binary);
+        file.seekg(-static_cast<std::streamoff>(sizeof(RecordingFooter) + 5 * sizeof(uint64_t) - 2 * sizeof(uint64_t)),
+                   std::ios::end);
+        uint64_t offset = 0;
+        file.read(reinterpret_cast<char*>(&offset), sizeof(offset));
+        thirdBlock = static_cast<size_t>(offset);
+    }
+    {
+        // Flip one bit of its payload
+        std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekg(static_cast<std::streamoff>(thirdBlock + sizeof(BlockHeader) + 10));
+        char byte = 0;
+        file.read(&byte, 1);
+        byte ^= 0x10;
+        file.seekp(static_cast<std::streamoff>(thirdBlock + sizeof(BlockHeader) + 10));
+        file.write(&byte, 1);
+    }
+
+    // -------------------- Act ------------------------
+    RecordingReader reader;
+    ASSERT_TRUE(reader.Open(path.string()));
+    std::vector<float> samples(5000);
+    const size_t frames = reader.ReadFrames(0, 5000, samples.data());
+    std::vector<float> after(1000);
+    const size_t framesAfter = reader.ReadFrames(3000, 1000, after.data());
+
+    // -------------------- Assert ---------------------
+    EXPECT_EQ(frames, 2000u);
+    EXPECT_EQ(framesAfter, 1000u); // The blocks behind it are fine
+    EXPECT_FALSE(reader.Verify());
+    EXPECT_GE(reader.GetDamagedBlockCount(), 1u);
+}
+
+TEST_F(RecordingTests, WhenHeaderFieldsAreCorrupt_ThenOpenFailsInsteadOfAllocating)
+{
+    // -------------------- Arrange --------------------
+    const auto path = directory_ / "recording.bpmr";
+    const RecordingOptions options{48000, 1, 1000, true, true};
+    const auto expected = CreateFrames(5000, 1);
+    Write(path, options, expected);
+
+    const auto openWithHeader = [&](const uint32_t channels, const uint32_t blockFrames)
+    {
+        std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(static_cast<std::streamoff>(offsetof(RecordingHeader, channels)));
+        file.write(reinterpret_cast<const char*>(&channels), sizeof(channels));
+        file.seekp(static_cast<std::streamoff>(offsetof(RecordingHeader, blockFrames)));
+        file.write(reinterpret_cast<const char*>(&blockFrames), sizeof(blockFrames));
+        file.close();
+
+        RecordingReader reader;
+        return reader.Open(path.string());
+    };
+
+    // -------------------- Act ------------------------
+    const bool tooManyChannels = openWithHeader(std::numeric_limits<uint32_t>::max(), 1000);
+    const bool tooLargeBlocks = openWithHeader(1, std::numeric_limits<uint32_t>::max());
+    const bool largerThanTheFile = openWithHeader(MaxRecordingChannels, MaxRecordingBlockFrames);
+    const bool restored = openWithHeader(1, 1000);
+
+    // -------------------- Assert ---------------------
+    EXPECT_FALSE(tooManyChannels);
+    EXPECT_FALSE(tooLargeBlocks);
+    EXPECT_FALSE(largerThanTheFile);
+    EXPECT_TRUE(restored);
+}
+
+TEST_F(RecordingTests, WhenFileIsRawFloats_ThenItIsNotARecording)
+{
+    // -------------------- Arrange --------------------
+    const auto path = directory_ / "waveform.bin";
+    const std::vector<float> samples(1000, 0.5f);
+    std::ofstream(path, std::ios::binary).write(reinterpret_cast<const char*>(samples.data()),
+                                                static_cast<std::streamsize>(samples.size() * sizeof(float)));
+
+    // -------------------- Act ------------------------
+    RecordingReader reader;
+    const bool opened = reader.Open(path.string());
+
+    // -------------------- Assert ---------------------
+    EXPECT_FALSE(RecordingReader::IsRecording(path.string()));
+    EXPECT_FALSE(opened);
+}
+
+TEST_F(RecordingTests, WhenAudioIsCompressed_ThenSilenceAndTonesTakeLessSpaceThanRawFloats)
+{
+    // -------------------- Arrange --------------------
+    std::vector<float> silence(4096, 0.0f);
+    std::vector<float> tone(4096);
+    for (size_t i = 0; i < tone.size(); ++i)
+    {
+        tone[i] = std::round(std::sin(static_cast<float>(i) * 0.05f) * 32767.0f) / 32768.0f; // 16 bit source
+    }
+    std::vector<std::byte> encoded;
+    std::vector<float> decoded(4096);
+
+    // -------------------- Act & Assert ---------------
+    EncodeXorBytes(silence.data(), silence.size(), 1, encoded);
+    EXPECT_EQ(encoded.size(), silence.size() / 2);
+    ASSERT_TRUE(DecodeXorBytes(encoded.data(), encoded.size(), 4096, 1, decoded.data()));
+    EXPECT_EQ(decoded, silence);
+
+    EncodeXorBytes(tone.data(), tone.size(), 1, encoded);
+    EXPECT_LT(encoded.size(), tone.size() * sizeof(float) * 3 / 4);
+    ASSERT_TRUE(DecodeXorBytes(encoded.data(), encoded.size(), 4096, 1, decoded.data()));
+    EXPECT_EQ(decoded, tone);
+
+    // Truncated payloads are rejected, not read past their end
+    EXPECT_FALSE(DecodeXorBytes(encoded.data(), encoded.size() - 1, 4096, 1, decoded.data()));
+}
+
+TEST_F(RecordingTests, WhenSinkIsDestroyed_ThenRecordingHoldsEveryChunk)
+{
+    // -------------------- Arrange --------------------
+    const auto path = directory_ / "waveform.bpmr";
+    const auto expected = CreateFrames(10 * 512, 2);
+
+    // -------------------- Act ------------------------
+    {
+        bin::RecordingFileSink sink(path.string(), RecordingOptions{44100, 2, 4096, true, true});
+        sink.Start();
+        for (size_t i = 0; i < 10; ++i)
+        {
+            sink.PushData(bpmfinder::audio::AudioChunk(expected.begin() + i * 1024, expected.begin() + (i + 1) * 1024));
+        }
+        sink.StopAndDrain();
+        EXPECT_EQ(sink.GetWrittenCount(), 10u);
+    } // Writes the last block and the index
+
+    // -------------------- Assert ---------------------
+    RecordingReader reader;
+    ASSERT_TRUE(reader.Open(path.string()));
+    EXPECT_EQ(reader.GetSampleRate(), 44100u);
+    ASSERT_EQ(reader.GetFrameCount(), 5120u);
+    std::vector<float> samples(expected.size());
+    ASSERT_EQ(reader.ReadFrames(0, 5120, samples.data()), 5120u);
+    EXPECT_EQ(samples, expected);
+}
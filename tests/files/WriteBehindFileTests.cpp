@@ -0,0 +1,163 @@
+//
+// Created by Robert on 2025-11-11.
+//
+
+#include <gtest/gtest.h>
+#include "../../src/files/WriteBehindFile.h"
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <thread>
+#include <vector>
+#ifndef _WIN32
+#include <sys/stat.h>
+#endif
+
+using namespace bpmfinder::files;
+
+// ============================================================================
+// Test Fixture
+// ============================================================================
+
+class WriteBehindFileTests : public ::testing::TestWithParam<WriteBehindOptions>
+{
+protected:
+    std::filesystem::path directory_ = std::filesystem::temp_directory_path() / "bpm_finder_write_behind_tests";
+
+    void SetUp() override
+    {
+        std::filesystem::remove_all(directory_);
+        std::filesystem::create_directories(directory_);
+    }
+
+    void TearDown() override
+    {
+        std::filesystem::remove_all(directory_);
+    }
+
+    static std::vector<char> ReadFile(const std::filesystem::path& path)
+    {
+        std::ifstream file(path, std::ios::binary);
+        return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+    }
+};
+
+TEST_P(WriteBehindFileTests, WhenAppendsSpanManyBuffers_ThenFileHoldsExactlyTheAppendedBytes)
+{
+    // -------------------- Arrange --------------------
+    const auto path = directory_ / "recording.bin";
+    std::vector<char> expected;
+    for (int i = 0; i < 100000; ++i)
+    {
+        expected.push_back(static_cast<char>(i * 7));
+    }
+
+    WriteBehindFile file;
+    ASSERT_TRUE(file.Open(path.string(), GetParam()));
+
+    // -------------------- Act ------------------------
+    // Odd sizes, so neither the buffers nor the end of the file are aligned
+    size_t offset = 0;
+    for (size_t size = 1; offset < expected.size(); size = size * 3 % 5000 + 1)
+    {
+        const size_t count = std::min(size, expected.size() - offset);
+        file.Append(expected.data() + offset, count);
+        offset += count;
+    }
+    const bool closed = file.Close();
+
+    // -------------------- Assert ---------------------
+    EXPECT_TRUE(closed);
+    EXPECT_FALSE(file.IsOpen());
+    EXPECT_EQ(file.GetAppendedBytes(), expected.size());
+    EXPECT_EQ(ReadFile(path), expected);
+}
+
+TEST_P(WriteBehindFileTests, WhenFlushedInBetween_ThenFileHoldsTheBytesSoFarAndAppendsGoOnBehindThem)
+{
+    // -------------------- Arrange --------------------
+    const auto path = directory_ / "recording.bin";
+    std::vector<char> expected;
+    for (int i = 0; i < 30000; ++i)
+    {
+        expected.push_back(static_cast<char>(i * 7));
+    }
+
+    WriteBehindFile file;
+    ASSERT_TRUE(file.Open(path.string(), GetParam()));
+
+    // -------------------- Act ------------------------
+    file.Append(expected.data(), 10001);
+    const bool flushed = file.Flush();
+    const auto afterFlush = ReadFile(path);
+    file.Append(expected.data() + 10001, expected.size() - 10001);
+    const bool closed = file.Close();
+
+    // -------------------- Assert ---------------------
+    EXPECT_TRUE(flushed);
+    EXPECT_EQ(afterFlush, std::vector<char>(expected.begin(), expected.begin() + 10001));
+    EXPECT_TRUE(closed);
+    EXPECT_EQ(ReadFile(path), expected);
+}
+
+INSTANTIATE_TEST_SUITE_P(Options, WriteBehindFileTests, ::testing::Values(
+                             WriteBehindOptions{4096, false, FsyncPolicy::Never},
+                             WriteBehindOptions{4096, true, FsyncPolicy::Never},
+                             WriteBehindOptions{8192, false, FsyncPolicy::EveryBuffer},
+                             WriteBehindOptions{5000, true, FsyncPolicy::Periodic, std::chrono::milliseconds(1)}));
+
+TEST_F(WriteBehindFileTests, WhenNothingIsAppended_ThenFileIsEmpty)
+{
+    // -------------------- Arrange --------------------
+    const auto path = directory_ / "empty.bin";
+    WriteBehindFile file;
+
+    // -------------------- Act ------------------------
+    ASSERT_TRUE(file.Open(path.string()));
+    const bool closed = file.Close();
+
+    // -------------------- Assert ---------------------
+    EXPECT_TRUE(closed);
+    ASSERT_TRUE(std::filesystem::exists(path));
+    EXPECT_EQ(std::filesystem::file_size(path), 0u);
+}
+
+TEST_F(WriteBehindFileTests, WhenDirectoryDoesNotExist_ThenOpenFails)
+{
+    // -------------------- Arrange --------------------
+    WriteBehindFile file;
+
+    // -------------------- Act & Assert ---------------
+    EXPECT_FALSE(file.Open((directory_ / "missing" / "recording.bin").string()));
+    EXPECT_FALSE(file.IsOpen());
+    EXPECT_TRUE(file.Close());
+}
+
+#ifndef _WIN32
+TEST_F(WriteBehindFileTests, WhenSyncFails_ThenFlushAndCloseReportIt)
+{
+    // -------------------- Arrange --------------------
+    // The writes into a FIFO succeed, but it can not be synced (EINVAL), like a disk whose writeback failed
+    const auto fifo = directory_ / "fifo";
+    ASSERT_EQ(mkfifo(fifo.c_str(), 0600), 0);
+    std::thread reader([&]
+    {
+        std::ifstream input(fifo, std::ios::binary);
+        std::vector<char> drained{std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>()};
+    });
+
+    WriteBehindFile file;
+    ASSERT_TRUE(file.Open(fifo.string(), {4096, false, FsyncPolicy::Periodic, std::chrono::hours(1)}));
+    const std::vector<char> bytes(100, 'x');
+    file.Append(bytes.data(), bytes.size());
+
+    // -------------------- Act ------------------------
+    const bool flushed = file.Flush();
+    const bool closed = file.Close();
+    reader.join();
+
+    // -------------------- Assert ---------------------
+    EXPECT_FALSE(flushed);
+    EXPECT_FALSE(closed);
+}
+#endif
@@ -0,0 +1,142 @@
+//
+// Created by Robert on 2025-11-16.
+//
+
+#include <gtest/gtest.h>
+#include "../../src/ipc/SharedResultBlock.h"
+#include <atomic>
+#include <string>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+using namespace bpmfinder::ipc;
+using bpmfinder::dsp::time_domain_onset_detection::BpmSnapshot;
+
+// ============================================================================
+// Test Fixture
+// ============================================================================
+
+class SharedResultBlockTests : public ::testing::Test
+{
+protected:
+#ifndef _WIN32
+    std::string name_ = "/bpm_finder_result_test_" + std::to_string(getpid());
+#else
+    std::string name_ = "bpm_finder_result_test";
+#endif
+
+    static BpmSnapshot CreateSnapshot(const float bpm)
+    {
+        BpmSnapshot snapshot;
+        snapshot.bpm = bpm;
+        snapshot.confidence = 0.75f;
+        snapshot.chunkIndex = 1234;
+        snapshot.timestampNanoseconds = 5678;
+        return snapshot;
+    }
+};
+
+TEST_F(SharedResultBlockTests, WhenNothingPublished_ThenVersionIsZeroAndBlockIsOpen)
+{
+    // -------------------- Arrange --------------------
+    SharedResultBlockWriter writer;
+    ASSERT_TRUE(writer.Create(name_));
+
+    // -------------------- Act ------------------------
+    SharedResultBlockReader reader;
+    const bool opened = reader.Open(name_);
+
+    // -------------------- Assert ---------------------
+    ASSERT_TRUE(opened);
+    EXPECT_EQ(reader.GetVersion(), 0u);
+    ASSERT_TRUE(reader.Read().has_value());
+    EXPECT_EQ(reader.Read()->bpm, 0.0f);
+    EXPECT_FALSE(reader.IsClosed());
+}
+
+TEST_F(SharedResultBlockTests, WhenEstimatesArePublished_ThenReaderSeesTheLatest)
+{
+    // -------------------- Arrange --------------------
+    SharedResultBlockWriter writer;
+    ASSERT_TRUE(writer.Create(name_));
+    SharedResultBlockReader reader;
+    ASSERT_TRUE(reader.Open(name_));
+
+    // -------------------- Act ------------------------
+    writer.Publish(CreateSnapshot(120.0f));
+    writer.Publish(CreateSnapshot(128.5f));
+    writer.Close();
+    BpmSnapshot snapshot;
+    const bool read = reader.TryRead(snapshot);
+
+    // -------------------- Assert ---------------------
+    ASSERT_TRUE(read);
+    EXPECT_EQ(reader.GetVersion(), 2u);
+    EXPECT_FLOAT_EQ(snapshot.bpm, 128.5f);
+    EXPECT_FLOAT_EQ(snapshot.confidence, 0.75f);
+    EXPECT_EQ(snapshot.chunkIndex, 1234u);
+    EXPECT_EQ(snapshot.timestampNanoseconds, 5678);
+    EXPECT_TRUE(reader.IsClosed());
+}
+
+TEST_F(SharedResultBlockTests, WhenThereIsNoBlock_ThenOpenFails)
+{
+    SharedResultBlockReader reader;
+
+    EXPECT_FALSE(reader.Open(name_ + "_missing"));
+    EXPECT_FALSE(reader.IsOpen());
+}
+
+TEST_F(SharedResultBlockTests, WhenWriterIsDestroyed_ThenAttachedReaderKeepsTheLastEstimate)
+{
+    // -------------------- Arrange --------------------
+    SharedResultBlockReader reader;
+    {
+        SharedResultBlockWriter writer;
+        ASSERT_TRUE(writer.Create(name_));
+        ASSERT_TRUE(reader.Open(name_));
+        writer.Publish(CreateSnapshot(99.0f));
+    }
+
+    // -------------------- Act ------------------------
+    const auto snapshot = reader.Read();
+
+    // -------------------- Assert ---------------------
+    ASSERT_TRUE(snapshot.has_value());
+    EXPECT_FLOAT_EQ(snapshot->bpm, 99.0f);
+}
+
+#ifndef _WIN32
+TEST_F(SharedResultBlockTests, WhenWriterDiedWhilePublishing_ThenReadGivesUpInsteadOfSpinning)
+{
+    // -------------------- Arrange --------------------
+    SharedResultBlockWriter writer;
+    ASSERT_TRUE(writer.Create(name_));
+    writer.Publish(CreateSnapshot(99.0f));
+    SharedResultBlockReader reader;
+    ASSERT_TRUE(reader.Open(name_));
+
+    // A writer killed between the two stores of the seqlock leaves its sequence, the first member, odd
+    const int fd = shm_open(name_.c_str(), O_RDWR, 0);
+    ASSERT_GE(fd, 0);
+    void* view = mmap(nullptr, sizeof(SharedResultBlockHeader), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    ASSERT_NE(view, MAP_FAILED);
+    auto* sequence = reinterpret_cast<std::atomic<uint64_t>*>(&static_cast<SharedResultBlockHeader*>(view)->result);
+    sequence->fetch_add(1);
+
+    // -------------------- Act ------------------------
+    const auto snapshot = reader.Read();
+    BpmSnapshot attempt;
+    const bool read = reader.TryRead(attempt);
+    munmap(view, sizeof(SharedResultBlockHeader));
+
+    // -------------------- Assert ---------------------
+    EXPECT_FALSE(snapshot.has_value());
+    EXPECT_FALSE(read);
+}
+#endif
@@ -0,0 +1,76 @@
+//
+// Created by Robert on 2025-11-15.
+//
+
+#include <gtest/gtest.h>
+#include "../../src/logging/Log.h"
+#include <spdlog/sinks/ostream_sink.h>
+#include <memory>
+#include <sstream>
+
+// ============================================================================
+// Test Fixture
+// ============================================================================
+
+class LogTests : public ::testing::Test
+{
+protected:
+    std::ostringstream output_;
+    std::shared_ptr<spdlog::logger> logger_;
+
+    void SetUp() override
+    {
+        auto sink = std::make_shared<spdlog::sinks::ostream_sink_mt>(output_);
+        sink->set_pattern("%l %v");
+        logger_ = std::make_shared<spdlog::logger>("LogTests", sink);
+    }
+
+    // Counts how often the arguments of a log call are evaluated
+    int Evaluate()
+    {
+        return ++evaluations_;
+    }
+
+    int evaluations_ = 0;
+};
+
+TEST_F(LogTests, WhenLoggerLevelIsAboveCall_ThenArgumentsAreNotEvaluated)
+{
+    // -------------------- Arrange --------------------
+    logger_->set_level(spdlog::level::warn);
+
+    // -------------------- Act --------------------
+    BPM_LOG_CALL(logger_, spdlog::level::info, "Chunk {}", Evaluate());
+
+    // -------------------- Assert --------------------
+    EXPECT_EQ(0, evaluations_);
+    EXPECT_TRUE(output_.str().empty());
+}
+
+TEST_F(LogTests, WhenLoggerLevelAllowsCall_ThenMessageIsWritten)
+{
+    // -------------------- Arrange --------------------
+    logger_->set_level(spdlog::level::info);
+
+    // -------------------- Act --------------------
+    BPM_LOG_CALL(logger_, spdlog::level::info, "Chunk {}", Evaluate());
+    BPM_LOG_ERROR(logger_, "Failed {}", 2);
+
+    // -------------------- Assert --------------------
+    EXPECT_EQ(1, evaluations_);
+    EXPECT_NE(std::string::npos, output_.str().find("info Chunk 1"));
+    EXPECT_NE(std::string::npos, output_.str().find("error Failed 2"));
+}
+
+TEST_F(LogTests, WhenLevelIsBelowActiveLevel_ThenCallIsCompiledOut)
+{
+    // -------------------- Arrange --------------------
+    logger_->set_level(spdlog::level::trace);
+
+    // -------------------- Act --------------------
+    BPM_LOG_TRACE(logger_, "Chunk {}", Evaluate());
+
+    // -------------------- Assert --------------------
+    const int expected = BPM_LOG_ACTIVE_LEVEL <= BPM_LOG_LEVEL_TRACE ? 1 : 0;
+    EXPECT_EQ(expected, evaluations_);
+}
@@ -0,0 +1,150 @@
+//
+// Created by Robert on 2025-11-09.
+//
+
+#include <gtest/gtest.h>
+#include "../../src/net/RtpJitterBuffer.h"
+#include <cstdint>
+#include <vector>
+
+using namespace bpmfinder::net;
+
+// ============================================================================
+// Test Fixture
+// ============================================================================
+
+class RtpJitterBufferTests : public ::testing::Test
+{
+protected:
+    RtpJitterBuffer buffer_{2, 16};
+    std::vector<float> output_;
+
+    // Packet with 'count' samples that all hold 'value'
+    void Push(const uint16_t sequenceNumber, const float value, const size_t count = 2)
+    {
+        const std::vector<float> samples(count, value);
+        buffer_.Push(sequenceNumber, samples.data(), samples.size());
+        buffer_.Pop(output_);
+    }
+};
+
+TEST_F(RtpJitterBufferTests, WhenPacketsArriveOutOfOrder_ThenTheyArePassedOnInOrder)
+{
+    // -------------------- Act ------------------------
+    Push(10, 1.0f);
+    Push(12, 3.0f);
+    Push(11, 2.0f);
+    Push(13, 4.0f);
+
+    // -------------------- Assert ---------------------
+    EXPECT_EQ(output_, (std::vector<float>{1, 1, 2, 2, 3, 3, 4, 4}));
+    EXPECT_EQ(buffer_.GetStatistics().receivedPackets, 4u);
+    EXPECT_EQ(buffer_.GetStatistics().lostPackets, 0u);
+}
+
+TEST_F(RtpJitterBufferTests, WhenPacketIsMissingForDepthPackets_ThenItIsReplacedBySilence)
+{
+    // -------------------- Act ------------------------
+    Push(100, 1.0f);
+    Push(102, 3.0f);
+    const auto beforeDecision = output_;
+    Push(103, 4.0f);
+
+    // -------------------- Assert ---------------------
+    EXPECT_EQ(beforeDecision, (std::vector<float>{1, 1}));
+    EXPECT_EQ(output_, (std::vector<float>{1, 1, 0, 0, 3, 3, 4, 4}));
+    EXPECT_EQ(buffer_.GetStatistics().lostPackets, 1u);
+    EXPECT_EQ(buffer_.GetStatistics().concealedSamples, 2u);
+}
+
+TEST_F(RtpJitterBufferTests, WhenPacketArrivesAfterItWasConcealed_ThenItIsDroppedAsLate)
+{
+    // -------------------- Act ------------------------
+    Push(1, 1.0f);
+    Push(3, 3.0f);
+    Push(4, 4.0f);
+    Push(2, 2.0f);
+
+    // -------------------- Assert ---------------------
+    EXPECT_EQ(output_, (std::vector<float>{1, 1, 0, 0, 3, 3, 4, 4}));
+    EXPECT_EQ(buffer_.GetStatistics().latePackets, 1u);
+}
+
+TEST_F(RtpJitterBufferTests, WhenPacketIsDuplicatedBeforeOrAfterItWasPassedOn_ThenItIsPassedOnOnce)
+{
+    // -------------------- Act ------------------------
+    Push(7, 1.0f);
+    Push(9, 3.0f);
+    Push(9, 3.0f);
+    Push(8, 2.0f);
+    Push(8, 2.0f);
+
+    // -------------------- Assert ---------------------
+    EXPECT_EQ(output_, (std::vector<float>{1, 1, 2, 2, 3, 3}));
+    EXPECT_EQ(buffer_.GetStatistics().duplicatePackets, 2u);
+    EXPECT_EQ(buffer_.GetStatistics().latePackets, 0u);
+}
+
+TEST_F(RtpJitterBufferTests, WhenSequenceNumberWrapsAround_ThenOrderIsKept)
+{
+    // -------------------- Act ------------------------
+    Push(65534, 1.0f);
+    Push(0, 3.0f);
+    Push(65535, 2.0f);
+    Push(1, 4.0f);
+
+    // -------------------- Assert ---------------------
+    EXPECT_EQ(output_, (std::vector<float>{1, 1, 2, 2, 3, 3, 4, 4}));
+    EXPECT_EQ(buffer_.GetStatistics().lostPackets, 0u);
+    EXPECT_EQ(buffer_.GetStatistics().latePackets, 0u);
+}
+
+TEST_F(RtpJitterBufferTests, WhenSequenceNumberJumpsBeyondCapacity_ThenBufferResyncsWithoutFilling)
+{
+    // -------------------- Act ------------------------
+    Push(10, 1.0f);
+    Push(5000, 2.0f);
+    Push(5001, 3.0f);
+
+    // -------------------- Assert ---------------------
+    EXPECT_EQ(output_, (std::vector<float>{1, 1, 2, 2, 3, 3}));
+    EXPECT_EQ(buffer_.GetStatistics().resyncs, 1u);
+    EXPECT_EQ(buffer_.GetStatistics().lostPackets, 0u);
+}
+
+TEST_F(RtpJitterBufferTests, WhenSenderRestartsWithLowerSequenceNumbers_ThenBufferResyncsAfterTwoPacketsInOrder)
+{
+    // -------------------- Arrange --------------------
+    for (uint16_t sequence = 40000; sequence < 40010; ++sequence)
+    {
+        Push(sequence, 1.0f);
+    }
+    output_.clear();
+
+    // -------------------- Act ------------------------
+    for (uint16_t sequence = 30000; sequence < 31000; ++sequence)
+    {
+        Push(sequence, 2.0f);
+    }
+
+    // -------------------- Assert ---------------------
+    EXPECT_EQ(output_, std::vector<float>(999 * 2, 2.0f)); // All but the first packet of the new run
+    EXPECT_EQ(buffer_.GetStatistics().resyncs, 1u);
+    EXPECT_EQ(buffer_.GetStatistics().latePackets, 1u);
+    EXPECT_EQ(buffer_.GetStatistics().lostPackets, 0u);
+}
+
+TEST_F(RtpJitterBufferTests, WhenSinglePacketArrivesFarBehindTheStream_ThenItIsDroppedWithoutResync)
+{
+    // -------------------- Act ------------------------
+    Push(1000, 1.0f);
+    Push(1001, 2.0f);
+    Push(100, 9.0f);
+    Push(1002, 3.0f);
+    Push(101, 9.0f); // Follows the stray packet, but the stream has moved on in between
+
+    // -------------------- Assert ---------------------
+    EXPECT_EQ(output_, (std::vector<float>{1, 1, 2, 2, 3, 3}));
+    EXPECT_EQ(buffer_.GetStatistics().resyncs, 0u);
+    EXPECT_EQ(buffer_.GetStatistics().latePackets, 2u);
+}
@@ -0,0 +1,205 @@
+//
+// Created by Robert on 2025-11-16.
+//
+
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <vector>
+#include "dsp/time_domain_onset_detection/TimeDomainOnsetDetectionResult.h"
+
+namespace bpmfinder::tools::dsp::time_domain_onset_detection
+{
+    // Binary alternative to the JSON lines of JsonTools.h, for driving the stage tools with whole recordings.
+    // A stream is a sequence of frames, little endian:
+    //
+    //   uint32_t payloadBytes                0 ends the stream
+    //   StageFrameHeader                     fixed fields of the result, array lengths
+    //   float rawAudio[rawAudioCount]
+    //   float bandPassFiltered[bandPassFilteredCount]
+    //   uint64_t peakIndices[peakIndexCount]
+    //   float interOnsetIntervals[interOnsetIntervalCount]
+    //
+    // Input of PipelineResultInitialization is a frame with only rawAudio set. See stage_tool.py for the Python side.
+
+    static_assert(std::endian::native == std::endian::little, "Frames are read and written in host byte order");
+
+    enum StageFrameFlags : uint32_t
+    {
+        HasPeakIndices = 1u << 0,
+        HasInterOnsetIntervals = 1u << 1,
+        HasDominantInterval = 1u << 2,
+        HasBpm = 1u << 3
+    };
+
+    struct StageFrameHeader
+    {
+        uint64_t chunkIndex;
+        int32_t sampleRate;
+        int32_t chunkSize;
+        int32_t bandPassLowCutoff;
+        int32_t bandPassHighCutoff;
+        float bandPassGain;
+        float energy;
+        float onsetStrength;
+        float dominantInterval; // Only with HasDominantInterval
+        float bpm; // Only with HasBpm
+        uint32_t flags;
+        uint32_t rawAudioCount;
+        uint32_t bandPassFilteredCount;
+        uint32_t peakIndexCount;
+        uint32_t interOnsetIntervalCount;
+    };
+
+    static_assert(sizeof(StageFrameHeader) == 64);
+
+    enum class FrameStatus
+    {
+        Ok,
+        End, // End frame, or the input ended between frames
+        Error // Truncated frame, or lengths that do not add up
+    };
+
+    inline void WriteResultFrame(std::ostream& output,
+                                 const bpmfinder::dsp::time_domain_onset_detection::TimeDomainOnsetDetectionResult&
+                                 result)
+    {
+        StageFrameHeader header{};
+        header.chunkIndex = result.chunkIndex;
+        header.sampleRate = result.sampleRate;
+        header.chunkSize = result.chunkSize;
+        header.bandPassLowCutoff = result.bandPassLowCutoff;
+        header.bandPassHighCutoff = result.bandPassHighCutoff;
+        header.bandPassGain = result.bandPassGain;
+        header.energy = result.energy;
+        header.onsetStrength = result.onsetStrength;
+        header.rawAudioCount = static_cast<uint32_t>(result.rawAudio.size());
+        header.bandPassFilteredCount = static_cast<uint32_t>(result.bandPassFiltered.size());
+
+        std::vector<uint64_t> peakIndices;
+        if (result.peakIndices)
+        {
+            header.flags |= HasPeakIndices;
+            peakIndices.assign(result.peakIndices->begin(), result.peakIndices->end());
+            header.peakIndexCount = static_cast<uint32_t>(peakIndices.size());
+        }
+        if (result.interOnsetIntervals)
+        {
+            header.flags |= HasInterOnsetIntervals;
+            header.interOnsetIntervalCount = static_cast<uint32_t>(result.interOnsetIntervals->size());
+        }
+        if (result.dominantInterval)
+        {
+            header.flags |= HasDominantInterval;
+            header.dominantInterval = *result.dominantInterval;
+        }
+        if (result.bpm)
+        {
+            header.flags |= HasBpm;
+            header.bpm = *result.bpm;
+        }
+
+        const auto payloadBytes = static_cast<uint32_t>(
+            sizeof(header) + (header.rawAudioCount + header.bandPassFilteredCount + header.interOnsetIntervalCount) *
+            sizeof(float) + header.peakIndexCount * sizeof(uint64_t));
+        output.write(reinterpret_cast<const char*>(&payloadBytes), sizeof(payloadBytes));
+        output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        output.write(reinterpret_cast<const char*>(result.rawAudio.data()),
+                     static_cast<std::streamsize>(result.rawAudio.size() * sizeof(float)));
+        output.write(reinterpret_cast<const char*>(result.bandPassFiltered.data()),
+                     static_cast<std::streamsize>(result.bandPassFiltered.size() * sizeof(float)));
+        output.write(reinterpret_cast<const char*>(peakIndices.data()),
+                     static_cast<std::streamsize>(peakIndices.size() * sizeof(uint64_t)));
+        if (result.interOnsetIntervals)
+        {
+            output.write(reinterpret_cast<const char*>(result.interOnsetIntervals->data()),
+                         static_cast<std::streamsize>(result.interOnsetIntervals->size() * sizeof(float)));
+        }
+    }
+
+    inline void WriteEndFrame(std::ostream& output)
+    {
+        constexpr uint32_t payloadBytes = 0;
+        output.write(reinterpret_cast<const char*>(&payloadBytes), sizeof(payloadBytes));
+    }
+
+    // Reads the next frame into 'result'; the buffer is reused from frame to frame
+    inline FrameStatus ReadResultFrame(
+        std::istream& input, std::vector<char>& buffer,
+        std::unique_ptr<bpmfinder::dsp::time_domain_onset_detection::TimeDomainOnsetDetectionResult>& result)
+    {
+        uint32_t payloadBytes = 0;
+        if (!input.read(reinterpret_cast<char*>(&payloadBytes), sizeof(payloadBytes)))
+        {
+            return input.gcount() == 0 ? FrameStatus::End : FrameStatus::Error;
+        }
+        if (payloadBytes == 0)
+        {
+            return FrameStatus::End;
+        }
+        if (payloadBytes < sizeof(StageFrameHeader))
+        {
+            return FrameStatus::Error;
+        }
+
+        buffer.resize(payloadBytes);
+        if (!input.read(buffer.data(), payloadBytes))
+        {
+            return FrameStatus::Error;
+        }
+
+        StageFrameHeader header;
+        std::memcpy(&header, buffer.data(), sizeof(header));
+        const uint64_t expected = sizeof(header) +
+            (static_cast<uint64_t>(header.rawAudioCount) + header.bandPassFilteredCount +
+                header.interOnsetIntervalCount) * sizeof(float) +
+            static_cast<uint64_t>(header.peakIndexCount) * sizeof(uint64_t);
+        if (expected != payloadBytes)
+        {
+            return FrameStatus::Error;
+        }
+
+        const char* data = buffer.data() + sizeof(header);
+        const auto readFloats = [&data](const uint32_t count)
+        {
+            std::vector<float> values(count);
+            std::memcpy(values.data(), data, count * sizeof(float));
+            data += count * sizeof(float);
+            return values;
+        };
+
+        result = std::make_unique<bpmfinder::dsp::time_domain_onset_detection::TimeDomainOnsetDetectionResult>(
+            header.chunkIndex, readFloats(header.rawAudioCount), header.sampleRate, header.chunkSize,
+            header.bandPassLowCutoff, header.bandPassHighCutoff, header.bandPassGain);
+        result->bandPassFiltered = readFloats(header.bandPassFilteredCount);
+        result->energy = header.energy;
+        result->onsetStrength = header.onsetStrength;
+
+        std::vector<uint64_t> peakIndices(header.peakIndexCount);
+        std::memcpy(peakIndices.data(), data, peakIndices.size() * sizeof(uint64_t));
+        data += peakIndices.size() * sizeof(uint64_t);
+        if ((header.flags & HasPeakIndices) != 0)
+        {
+            result->peakIndices.emplace(peakIndices.begin(), peakIndices.end());
+        }
+        auto interOnsetIntervals = readFloats(header.interOnsetIntervalCount);
+        if ((header.flags & HasInterOnsetIntervals) != 0)
+        {
+            result->interOnsetIntervals = std::move(interOnsetIntervals);
+        }
+        if ((header.flags & HasDominantInterval) != 0)
+        {
+            result->dominantInterval = header.dominantInterval;
+        }
+        if ((header.flags & HasBpm) != 0)
+        {
+            result->bpm = header.bpm;
+        }
+        return FrameStatus::Ok;
+    }
+}
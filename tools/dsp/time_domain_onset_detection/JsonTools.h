@@ -118,6 +118,30 @@ namespace bpmfinder::tools::dsp::time_domain_onset_detection
         j["bandPassGain"] = result.bandPassGain;
         j["rawAudio"] = result.rawAudio;
 
+        // What the stages fill in, the fields ParseJsonResult reads
+        if (!result.bandPassFiltered.empty())
+        {
+            j["bandPassFiltered"] = result.bandPassFiltered;
+        }
+        j["energy"] = result.energy;
+        j["onsetStrength"] = result.onsetStrength;
+        if (result.peakIndices)
+        {
+            j["peakIndices"] = *result.peakIndices;
+        }
+        if (result.interOnsetIntervals)
+        {
+            j["interOnsetIntervals"] = *result.interOnsetIntervals;
+        }
+        if (result.dominantInterval)
+        {
+            j["dominantInterval"] = *result.dominantInterval;
+        }
+        if (result.bpm)
+        {
+            j["bpm"] = *result.bpm;
+        }
+
         return j;
     }
 }
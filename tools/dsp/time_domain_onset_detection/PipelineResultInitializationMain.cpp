@@ -4,7 +4,6 @@
 
 #include <iostream>
 #include <string>
-#include <thread>
 #include <atomic>
 #include <csignal>
 #include <vector>
@@ -14,6 +13,7 @@
 #include "JsonTools.h"
 #include "StageTestObservable.h"
 #include "StageTestObserver.h"
+#include "StageToolRunner.h"
 #include "dsp/time_domain_onset_detection/PipelineResultInitializationStage.h"
 #include "dsp/time_domain_onset_detection/TimeDomainOnsetDetectionResult.h"
 
@@ -27,19 +27,36 @@ void signalHandler(const int signum)
     running = false;
 }
 
-int main(const int argc, char* argv[])
+int main(int argc, char* argv[])
 {
-    // Disable output buffering for immediate visibility in pipes
-    std::cout.setf(std::ios::unitbuf);
+    using namespace bpmfinder::tools::dsp::time_domain_onset_detection;
+
+    // --binary, --input and --output stream results instead of answering line by line, see StageToolRunner.h
+    const auto options = ExtractStageToolOptions(argc, argv);
 
     if (argc < 6)
     {
         std::cerr <<
-            "[ERR] Usage: <sampleRate (int)> <chunkSize (int)> <bandPassLowCutoff (int)> <bandPassHighCutoff (int)> <bandPassGain (float)>"
+            "[ERR] Usage: [--binary] [--input FILE] [--output FILE] <sampleRate (int)> <chunkSize (int)> <bandPassLowCutoff (int)> <bandPassHighCutoff (int)> <bandPassGain (float)>"
             << std::endl;
         return 1;
     }
 
+    if (options.IsStreaming())
+    {
+        InitializeStageToolLogging(options);
+        bpmfinder::dsp::time_domain_onset_detection::PipelineResultInitializationStage stage(
+            std::atoi(argv[1]), std::atoi(argv[2]), std::atoi(argv[3]), std::atoi(argv[4]),
+            static_cast<float>(std::atof(argv[5])));
+        return RunStageStream<bpmfinder::audio::AudioChunk>(stage, options, [](ResultObject& result)
+        {
+            return result.rawAudio; // Only the samples are input
+        });
+    }
+
+    // Disable output buffering for immediate visibility in pipes
+    std::cout.setf(std::ios::unitbuf);
+
     // Register signal handlers for graceful shutdown
     std::signal(SIGINT, signalHandler);
     std::signal(SIGTERM, signalHandler);
@@ -63,7 +80,8 @@ int main(const int argc, char* argv[])
     auto observer = bpmfinder::tools::dsp::time_domain_onset_detection::StageTestObserver<
         bpmfinder::dsp::time_domain_onset_detection::TimeDomainOnsetDetectionResult>();
     stage.Subscribe(&observer);
-    stage.Start();
+    // Inline: Publish returns after the stage has processed the input, the result is in the observer then
+    stage.Start(bpmfinder::core::ExecutionMode::Inline);
 
     // Create an observable that will publish the input of the stage
     std::cout << "[LOG] Creating StageTestObservable" << std::endl;
@@ -105,13 +123,6 @@ int main(const int argc, char* argv[])
             std::cerr << std::string("[ERR] Failed to parse JSON: ") + e.what() << std::endl;
         }
 
-        // Wait for the observer to receive the result => it's asynchronous in another thread!
-        auto timeout = std::chrono::steady_clock::now() + std::chrono::seconds(5);
-        while (!observer.HasResult() && std::chrono::steady_clock::now() < timeout)
-        {
-            std::this_thread::sleep_for(std::chrono::milliseconds(10));
-        }
-
         if (observer.HasResult())
         {
             std::cout << "[LOG] Observer has " << observer.GetQueuedCount() << " results" << std::endl;
@@ -28,7 +28,7 @@ namespace bpmfinder::tools::dsp::time_domain_onset_detection
         {
             if (argc < 2)
             {
-                std::cerr << "[ERR] Usage: <stageName (string)> <args>" << std::endl;
+                std::cerr << "[ERR] Usage: [--binary] [--input FILE] [--output FILE] <stageName (string)> <args>" << std::endl;
                 return nullptr;
             }
 
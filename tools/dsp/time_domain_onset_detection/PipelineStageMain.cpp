@@ -4,7 +4,6 @@
 
 #include <iostream>
 #include <string>
-#include <thread>
 #include <atomic>
 #include <csignal>
 #include <vector>
@@ -15,6 +14,7 @@
 #include "PipelineStageFactory.h"
 #include "StageTestObservable.h"
 #include "StageTestObserver.h"
+#include "StageToolRunner.h"
 #include "dsp/time_domain_onset_detection/PipelineResultInitializationStage.h"
 #include "dsp/time_domain_onset_detection/TimeDomainOnsetDetectionResult.h"
 
@@ -30,8 +30,27 @@ void signalHandler(const int signum)
     running = false;
 }
 
-int main(const int argc, char* argv[])
+int main(int argc, char* argv[])
 {
+    using namespace bpmfinder::tools::dsp::time_domain_onset_detection;
+
+    // --binary, --input and --output stream results instead of answering line by line, see StageToolRunner.h
+    const auto options = ExtractStageToolOptions(argc, argv);
+    if (options.IsStreaming())
+    {
+        InitializeStageToolLogging(options);
+        PipelineStageFactory factory;
+        const auto stage = factory.CreatePipelineStage(argc, argv);
+        if (stage == nullptr)
+        {
+            return 1;
+        }
+        return RunStageStream<ResultObject>(*stage, options, [](ResultObject& result) -> ResultObject&
+        {
+            return result;
+        });
+    }
+
     // Disable output buffering for immediate visibility in pipes
     std::cout.setf(std::ios::unitbuf);
 
@@ -52,7 +71,8 @@ int main(const int argc, char* argv[])
     std::cout << "[LOG] Creating StageTestObserver" << std::endl;
     auto observer = bpmfinder::tools::dsp::time_domain_onset_detection::StageTestObserver<ResultObject>();
     stage->Subscribe(&observer);
-    stage->Start();
+    // Inline: Publish returns after the stage has processed the input, the result is in the observer then
+    stage->Start(bpmfinder::core::ExecutionMode::Inline);
 
     // Create an observable that will publish the input of the stage
     std::cout << "[LOG] Creating StageTestObservable" << std::endl;
@@ -95,13 +115,6 @@ int main(const int argc, char* argv[])
             std::cerr << std::string("[ERR] Failed to parse JSON: ") + e.what() << std::endl;
         }
 
-        // Wait for the observer to receive the result => it's asynchronous in another thread!
-        auto timeout = std::chrono::steady_clock::now() + std::chrono::seconds(5);
-        while (!observer.HasResult() && std::chrono::steady_clock::now() < timeout)
-        {
-            std::this_thread::sleep_for(std::chrono::milliseconds(10));
-        }
-
         if (observer.HasResult())
         {
             std::cout << "[LOG] Observer has " << observer.GetQueuedCount() << " results" << std::endl;
@@ -0,0 +1,232 @@
+//
+// Created by Robert on 2025-11-16.
+//
+
+#pragma once
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "BinaryFraming.h"
+#include "JsonTools.h"
+#include "core/CopyObservable.h"
+#include "core/CopySink.h"
+#include "logging/LoggerFactory.h"
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#endif
+
+namespace bpmfinder::tools::dsp::time_domain_onset_detection
+{
+    struct StageToolOptions
+    {
+        bool binary = false; // Frames of BinaryFraming.h instead of JSON lines, both ways
+        std::string inputFile; // Read from this file instead of stdin
+        std::string outputFile; // Write to this file instead of stdout
+
+        // Streaming: inputs are passed on as fast as they are read, results written as they come. The interactive
+        // JSON mode waits for the result of every line instead.
+        [[nodiscard]] bool IsStreaming() const { return binary || !inputFile.empty() || !outputFile.empty(); }
+    };
+
+    // Takes --binary, --input FILE and --output FILE out of argv, so the positional arguments stay where the tools
+    // expect them
+    inline StageToolOptions ExtractStageToolOptions(int& argc, char* argv[])
+    {
+        StageToolOptions options;
+        int kept = 1;
+        for (int i = 1; i < argc; ++i)
+        {
+            if (std::strcmp(argv[i], "--binary") == 0)
+            {
+                options.binary = true;
+            }
+            else if (std::strcmp(argv[i], "--input") == 0 && i + 1 < argc)
+            {
+                options.inputFile = argv[++i];
+            }
+            else if (std::strcmp(argv[i], "--output") == 0 && i + 1 < argc)
+            {
+                options.outputFile = argv[++i];
+            }
+            else
+            {
+                argv[kept++] = argv[i];
+            }
+        }
+        argc = kept;
+        return options;
+    }
+
+    // Frames on stdout must not be mixed with the log lines of the console sink: no logging then
+    inline void InitializeStageToolLogging(const StageToolOptions& options)
+    {
+        if (options.binary && options.outputFile.empty())
+        {
+            logging::LoggerFactory::Initialize(spdlog::level::off);
+        }
+    }
+
+    // Publishes the inputs without the [LOG] line per chunk of the StageTestObservable
+    template <typename T>
+    class StageToolSource : public core::CopyObservable<T>
+    {
+    public:
+        void Publish(const T& data) { this->Notify(data); }
+    };
+
+    // Writes every result it receives, as frame or JSON line
+    class StageToolResultWriter : public core::CopySink<ResultObject>
+    {
+    public:
+        StageToolResultWriter(std::ostream& output, const bool binary, const bool flushEach) :
+            output_(output),
+            binary_(binary),
+            flushEach_(flushEach)
+        {
+        }
+
+        ~StageToolResultWriter() override
+        {
+            Stop();
+        }
+
+        [[nodiscard]] size_t GetWrittenCount() const { return writtenCount_; }
+
+    protected:
+        void Process(const ResultObject data) override
+        {
+            if (binary_)
+            {
+                WriteResultFrame(output_, data);
+            }
+            else
+            {
+                output_ << SerializeResultToJson(data) << '\n';
+            }
+            if (flushEach_)
+            {
+                output_.flush(); // Someone reads the pipe chunk by chunk
+            }
+            ++writtenCount_;
+        }
+
+    private:
+        std::ostream& output_;
+        bool binary_;
+        bool flushEach_;
+        std::atomic<size_t> writtenCount_{0};
+    };
+
+    // Streams every input through the stage, see StageToolOptions. 'toInput' turns the decoded frame or JSON line
+    // into what the stage takes. Returns the exit code of the tool.
+    template <typename Input, typename Stage, typename ToInput>
+    int RunStageStream(Stage& stage, const StageToolOptions& options, ToInput toInput)
+    {
+#ifdef _WIN32
+        if (options.binary)
+        {
+            _setmode(_fileno(stdin), _O_BINARY);
+            _setmode(_fileno(stdout), _O_BINARY);
+        }
+#endif
+        std::ios::sync_with_stdio(false);
+        std::cin.tie(nullptr); // The writer flushes where it has to, not before every read
+
+        std::ifstream inputFile;
+        std::istream* input = &std::cin;
+        if (!options.inputFile.empty())
+        {
+            inputFile.open(options.inputFile, std::ios::binary);
+            if (!inputFile)
+            {
+                std::cerr << "[ERR] Failed to open " << options.inputFile << std::endl;
+                return 1;
+            }
+            input = &inputFile;
+        }
+
+        std::ofstream outputFile;
+        std::ostream* output = &std::cout;
+        if (!options.outputFile.empty())
+        {
+            outputFile.open(options.outputFile, std::ios::binary | std::ios::trunc);
+            if (!outputFile)
+            {
+                std::cerr << "[ERR] Failed to create " << options.outputFile << std::endl;
+                return 1;
+            }
+            output = &outputFile;
+        }
+
+        // Stage and writer run inline on this thread: one input after the other is read, processed and written,
+        // in order, without a queue or a thread hop in between
+        StageToolResultWriter writer(*output, options.binary, options.outputFile.empty());
+        stage.Subscribe(&writer);
+        writer.Start(core::ExecutionMode::Inline);
+        stage.Start(core::ExecutionMode::Inline);
+
+        StageToolSource<Input> source;
+        source.Subscribe(&stage);
+
+        size_t inputCount = 0;
+        bool failed = false;
+        std::unique_ptr<ResultObject> result;
+        if (options.binary)
+        {
+            std::vector<char> buffer;
+            FrameStatus status;
+            while ((status = ReadResultFrame(*input, buffer, result)) == FrameStatus::Ok)
+            {
+                source.Publish(toInput(*result));
+                ++inputCount;
+            }
+            if (status == FrameStatus::Error)
+            {
+                std::cerr << "[ERR] Malformed frame after " << inputCount << " frames" << std::endl;
+                failed = true;
+            }
+        }
+        else
+        {
+            std::string line;
+            while (std::getline(*input, line))
+            {
+                line.erase(0, line.find_first_not_of(" \t\n\r"));
+                line.erase(line.find_last_not_of(" \t\n\r") + 1);
+                if (line.empty())
+                {
+                    continue;
+                }
+                if (line == "exit")
+                {
+                    break;
+                }
+                if (result = ParseJsonResult(line); result == nullptr)
+                {
+                    failed = true;
+                    continue; // ParseJsonResult reported it
+                }
+                source.Publish(toInput(*result));
+                ++inputCount;
+            }
+        }
+
+        stage.Stop();
+        writer.Stop();
+        if (options.binary)
+        {
+            WriteEndFrame(*output);
+        }
+        output->flush();
+
+        std::cerr << "[LOG] " << inputCount << " inputs, " << writer.GetWrittenCount() << " results" << std::endl;
+        return failed || !*output ? 1 : 0;
+    }
+}
@@ -0,0 +1,127 @@
+"""Binary framing of the stage tools (see BinaryFraming.h), for driving them with whole recordings.
+
+    chunks = read_waveform_chunks('waveform.bin', 1024)
+    results = run_stage(['PipelineResultInitialization', '44100', '1024', '40', '120', '1.0'],
+                        [{'rawAudio': chunk} for chunk in chunks])
+    results = run_stage(['PipelineStageTest', 'BandPassFilterStage', '44100', '40', '120', '1.0'], results)
+
+Results are dicts with the fields of the JSON mode; arrays are array.array, numpy.asarray takes them as they are.
+"""
+
+import array
+import os
+import struct
+import subprocess
+import tempfile
+
+# StageFrameHeader: chunkIndex, sampleRate, chunkSize, bandPassLowCutoff, bandPassHighCutoff, bandPassGain, energy,
+# onsetStrength, dominantInterval, bpm, flags, rawAudioCount, bandPassFilteredCount, peakIndexCount,
+# interOnsetIntervalCount
+HEADER = struct.Struct('<Q4i5f5I')
+LENGTH = struct.Struct('<I')
+
+HAS_PEAK_INDICES = 1
+HAS_INTER_ONSET_INTERVALS = 2
+HAS_DOMINANT_INTERVAL = 4
+HAS_BPM = 8
+
+
+def encode_frame(result):
+    """One frame for a dict with at least 'rawAudio'."""
+    raw_audio = array.array('f', result.get('rawAudio', []))
+    band_pass_filtered = array.array('f', result.get('bandPassFiltered', []))
+    peak_indices = result.get('peakIndices')
+    intervals = result.get('interOnsetIntervals')
+    dominant_interval = result.get('dominantInterval')
+    bpm = result.get('bpm')
+
+    flags = 0
+    flags |= HAS_PEAK_INDICES if peak_indices is not None else 0
+    flags |= HAS_INTER_ONSET_INTERVALS if intervals is not None else 0
+    flags |= HAS_DOMINANT_INTERVAL if dominant_interval is not None else 0
+    flags |= HAS_BPM if bpm is not None else 0
+    peak_indices = array.array('Q', peak_indices or [])
+    intervals = array.array('f', intervals or [])
+
+    header = HEADER.pack(result.get('chunkIndex', 0), result.get('sampleRate', 0), result.get('chunkSize', 0),
+                         result.get('bandPassLowCutoff', 0), result.get('bandPassHighCutoff', 0),
+                         result.get('bandPassGain', 0.0), result.get('energy', 0.0), result.get('onsetStrength', 0.0),
+                         dominant_interval or 0.0, bpm or 0.0, flags, len(raw_audio), len(band_pass_filtered),
+                         len(peak_indices), len(intervals))
+    payload = b''.join([header, raw_audio.tobytes(), band_pass_filtered.tobytes(), peak_indices.tobytes(),
+                        intervals.tobytes()])
+    return LENGTH.pack(len(payload)) + payload
+
+
+def decode_frames(data):
+    """All results of a stream of frames, up to the end frame."""
+    results = []
+    offset = 0
+    while offset + LENGTH.size <= len(data):
+        (length,) = LENGTH.unpack_from(data, offset)
+        offset += LENGTH.size
+        if length == 0:
+            break
+        (chunk_index, sample_rate, chunk_size, low_cutoff, high_cutoff, gain, energy, onset_strength,
+         dominant_interval, bpm, flags, raw_count, filtered_count, peak_count,
+         interval_count) = HEADER.unpack_from(data, offset)
+        position = offset + HEADER.size
+
+        def take(typecode, count):
+            nonlocal position
+            values = array.array(typecode)
+            values.frombytes(data[position:position + count * values.itemsize])
+            position += count * values.itemsize
+            return values
+
+        result = {'chunkIndex': chunk_index, 'sampleRate': sample_rate, 'chunkSize': chunk_size,
+                  'bandPassLowCutoff': low_cutoff, 'bandPassHighCutoff': high_cutoff, 'bandPassGain': gain,
+                  'rawAudio': take('f', raw_count), 'bandPassFiltered': take('f', filtered_count),
+                  'energy': energy, 'onsetStrength': onset_strength}
+        peak_indices = take('Q', peak_count)
+        intervals = take('f', interval_count)
+        if flags & HAS_PEAK_INDICES:
+            result['peakIndices'] = peak_indices
+        if flags & HAS_INTER_ONSET_INTERVALS:
+            result['interOnsetIntervals'] = intervals
+        if flags & HAS_DOMINANT_INTERVAL:
+            result['dominantInterval'] = dominant_interval
+        if flags & HAS_BPM:
+            result['bpm'] = bpm
+        results.append(result)
+        offset += length
+    return results
+
+
+def read_waveform_chunks(path, chunk_size):
+    """A raw float recording (waveform.bin) cut into chunks, the last partial chunk dropped."""
+    samples = array.array('f')
+    with open(path, 'rb') as file:
+        samples.frombytes(file.read())
+    return [samples[i:i + chunk_size] for i in range(0, len(samples) - chunk_size + 1, chunk_size)]
+
+
+def run_stage(command, inputs, executable_dir=None):
+    """Runs a stage tool in batch mode over all inputs and returns its results.
+
+    command: tool name and its positional arguments. executable_dir defaults to cmake-build-debug/tools of the
+    repository.
+    """
+    if executable_dir is None:
+        repository_root = os.path.dirname(os.path.dirname(os.path.dirname(os.path.dirname(os.path.realpath(
+            __file__)))))
+        executable_dir = os.path.join(repository_root, 'cmake-build-debug', 'tools')
+    executable = os.path.join(executable_dir, command[0] + ('.exe' if os.name == 'nt' else ''))
+
+    with tempfile.TemporaryDirectory() as directory:
+        input_path = os.path.join(directory, 'input.frames')
+        output_path = os.path.join(directory, 'output.frames')
+        with open(input_path, 'wb') as file:
+            for result in inputs:
+                file.write(encode_frame(result))
+            file.write(LENGTH.pack(0))
+
+        subprocess.run([executable, '--binary', '--input', input_path, '--output', output_path] + command[1:],
+                       check=True, stdout=subprocess.DEVNULL)
+        with open(output_path, 'rb') as file:
+            return decode_frames(file.read())
@@ -0,0 +1,93 @@
+//
+// Created by Robert on 2025-11-13.
+//
+
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "files/features/FeatureLogReader.h"
+
+// Converts a feature log (bpm-finder replay --feature-log) into CSV files for the Python plotting tools:
+//   PREFIX.csv            one row per chunk, empty cells for fields the chunk does not have
+//   PREFIX_peaks.csv      one row per detected peak
+//   PREFIX_intervals.csv  one row per inter-onset interval
+
+namespace
+{
+    void WriteOptional(std::ostream& out, const std::optional<float>& value)
+    {
+        out << ',';
+        if (value)
+        {
+            out << *value;
+        }
+    }
+}
+
+int main(const int argc, char* argv[])
+{
+    if (argc < 2)
+    {
+        std::cout << "Usage: FeatureLogToCsv FILE [PREFIX]\n"
+            << "  FILE    feature log (*.bpmf)\n"
+            << "  PREFIX  of the CSV files (default: FILE without extension)\n";
+        return 1;
+    }
+
+    const std::string filename = argv[1];
+    std::string prefix = argc > 2 ? argv[2] : filename.substr(0, filename.rfind('.'));
+
+    bpmfinder::files::features::FeatureLogReader reader;
+    if (!reader.Open(filename))
+    {
+        return 1;
+    }
+    std::vector<bpmfinder::files::features::FeatureRow> rows;
+    const bool complete = reader.ReadAll(rows);
+
+    const double secondsPerChunk = reader.GetSampleRate() > 0
+                                       ? static_cast<double>(reader.GetChunkSize()) / reader.GetSampleRate()
+                                       : 0.0;
+
+    std::ofstream chunks(prefix + ".csv");
+    std::ofstream peaks(prefix + "_peaks.csv");
+    std::ofstream intervals(prefix + "_intervals.csv");
+    if (!chunks || !peaks || !intervals)
+    {
+        std::cerr << "Failed to create " << prefix << "*.csv" << std::endl;
+        return 1;
+    }
+
+    chunks << "chunk_index,time_seconds,energy,onset_strength,peak_count,dominant_interval,bpm\n";
+    peaks << "chunk_index,peak_index\n";
+    intervals << "chunk_index,interval\n";
+    for (const auto& row : rows)
+    {
+        chunks << row.chunkIndex << ',' << static_cast<double>(row.chunkIndex) * secondsPerChunk << ','
+            << row.energy << ',' << row.onsetStrength << ',';
+        if (row.peakIndices)
+        {
+            chunks << row.peakIndices->size();
+            for (const uint64_t peak : *row.peakIndices)
+            {
+                peaks << row.chunkIndex << ',' << peak << '\n';
+            }
+        }
+        WriteOptional(chunks, row.dominantInterval);
+        WriteOptional(chunks, row.bpm);
+        chunks << '\n';
+
+        if (row.interOnsetIntervals)
+        {
+            for (const float interval : *row.interOnsetIntervals)
+            {
+                intervals << row.chunkIndex << ',' << interval << '\n';
+            }
+        }
+    }
+
+    std::cout << rows.size() << " chunks written to " << prefix << ".csv" << std::endl;
+    return complete ? 0 : 2;
+}
@@ -0,0 +1,44 @@
+import subprocess
+import sys
+import os
+
+import matplotlib.pyplot as plt
+import numpy as np
+
+# Usage: feature_log_plot.py [FILE], FILE written by 'bpm-finder replay --feature-log FILE' (default: features.bpmf in
+# cmake-build-debug)
+script_dir = os.path.dirname(os.path.abspath(__file__))
+repository_root = os.path.dirname(os.path.dirname(script_dir))
+build_dir = os.path.join(repository_root, 'cmake-build-debug')
+log_path = sys.argv[1] if len(sys.argv) > 1 else os.path.join(build_dir, 'features.bpmf')
+
+if sys.platform == 'win32':
+    converter = os.path.join(build_dir, 'tools', 'FeatureLogToCsv.exe')
+else:
+    converter = os.path.join(build_dir, 'tools', 'FeatureLogToCsv')
+
+prefix = os.path.splitext(log_path)[0]
+subprocess.run([converter, log_path, prefix], check=True)
+
+# Empty cells (chunks without a BPM yet) become NaN
+chunks = np.genfromtxt(prefix + '.csv', delimiter=',', names=True)
+peaks = np.genfromtxt(prefix + '_peaks.csv', delimiter=',', names=True, ndmin=1)
+
+figure, (energy_axis, onset_axis, bpm_axis) = plt.subplots(3, 1, sharex=True)
+
+energy_axis.plot(chunks['time_seconds'], chunks['energy'])
+energy_axis.set_ylabel('Energy')
+
+onset_axis.plot(chunks['time_seconds'], chunks['onset_strength'])
+onset_axis.set_ylabel('Onset strength')
+if peaks.size > 0:
+    # Mark the chunks in which peaks were reported
+    peak_chunks = np.isin(chunks['chunk_index'], peaks['chunk_index'])
+    onset_axis.plot(chunks['time_seconds'][peak_chunks], chunks['onset_strength'][peak_chunks], 'rx')
+
+bpm_axis.plot(chunks['time_seconds'], chunks['bpm'])
+bpm_axis.set_ylabel('BPM')
+bpm_axis.set_xlabel('Time (s)')
+
+figure.suptitle(os.path.basename(log_path))
+plt.show()
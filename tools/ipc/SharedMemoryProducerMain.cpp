@@ -0,0 +1,110 @@
+//
+// Created by Robert on 2025-11-08.
+//
+
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "audio/SignalGeneratorAudioSource.h"
+#include "ipc/SharedMemoryRing.h"
+
+// Producer side of a shared memory ring, as a separate process: writes a click track into the ring in real time,
+// the way a decoder or capture daemon would. Run 'bpm-finder shm NAME' next to it.
+
+std::atomic<bool> running = true;
+
+void signalHandler(const int signum)
+{
+    std::cout << "\n=== Interrupt signal (" << signum << ") received ===" << std::endl;
+    running = false;
+}
+
+int main(const int argc, char* argv[])
+{
+    std::signal(SIGINT, signalHandler);
+    std::signal(SIGTERM, signalHandler);
+
+    if (argc < 2)
+    {
+        std::cout << "Usage: SharedMemoryProducer NAME [--bpm N] [--snr DB] [--seconds S] [--channels N] [--rate HZ]\n"
+            << "  NAME  shared memory name, e.g. /bpm-finder\n";
+        return 1;
+    }
+
+    const std::string name = argv[1];
+    bpmfinder::audio::SignalGeneratorOptions options;
+    options.durationSeconds = 30.0;
+    int channels = 2;
+    for (int i = 2; i + 1 < argc; i += 2)
+    {
+        const std::string option = argv[i];
+        const std::string value = argv[i + 1];
+        if (option == "--bpm")
+        {
+            options.bpm = std::stof(value);
+        }
+        else if (option == "--snr")
+        {
+            options.snrDb = std::stof(value);
+        }
+        else if (option == "--seconds")
+        {
+            options.durationSeconds = std::stod(value);
+        }
+        else if (option == "--channels")
+        {
+            channels = std::stoi(value);
+        }
+        else if (option == "--rate")
+        {
+            options.sampleRate = std::stoi(value);
+        }
+    }
+
+    // Two seconds of room, far more than a consumer that keeps up ever needs
+    bpmfinder::ipc::SharedMemoryRingWriter writer;
+    if (!writer.Create(name, {options.sampleRate, channels}, static_cast<size_t>(options.sampleRate) * channels * 2))
+    {
+        std::cerr << "Failed to create shared memory ring " << name << std::endl;
+        return 1;
+    }
+    std::cout << "Writing " << options.bpm << " BPM into " << name << " (" << channels << " channels, "
+        << options.sampleRate << " Hz)" << std::endl;
+
+    // Blocks of 10 ms, released in real time. Every channel gets the same signal.
+    const auto blockFrames = static_cast<size_t>(options.sampleRate / 100);
+    bpmfinder::audio::SignalGenerator generator(options);
+    std::vector<float> mono(blockFrames);
+    std::vector<float> frames(blockFrames * static_cast<size_t>(channels));
+
+    const auto start = std::chrono::steady_clock::now();
+    uint64_t blocks = 0;
+    while (running && !generator.IsFinished())
+    {
+        const auto count = static_cast<size_t>(std::min<uint64_t>(
+            blockFrames, generator.GetLength() - generator.GetPosition()));
+        generator.Generate(mono.data(), count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            for (int c = 0; c < channels; ++c)
+            {
+                frames[i * channels + c] = mono[i];
+            }
+        }
+        writer.Write(frames.data(), count);
+
+        ++blocks;
+        std::this_thread::sleep_until(start + std::chrono::milliseconds(10 * blocks));
+    }
+
+    writer.Close();
+    std::cout << "Done, " << writer.GetWritePosition() / channels << " frames written" << std::endl;
+
+    // Removing the name on exit is fine: attached consumers keep their mapping and read the rest
+    return 0;
+}
@@ -0,0 +1,86 @@
+//
+// Created by Robert on 2025-11-16.
+//
+
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "ipc/SharedResultBlock.h"
+
+// Reader side of the shared memory result block, as a separate process: polls it the way a front end would once per
+// frame and prints every new estimate. Run 'bpm-finder ... --result-block NAME' next to it.
+
+std::atomic<bool> running = true;
+
+void signalHandler(const int signum)
+{
+    std::cout << "\n=== Interrupt signal (" << signum << ") received ===" << std::endl;
+    running = false;
+}
+
+int main(const int argc, char* argv[])
+{
+    std::signal(SIGINT, signalHandler);
+    std::signal(SIGTERM, signalHandler);
+
+    if (argc < 2)
+    {
+        std::cout << "Usage: SharedResultMonitor NAME [--interval MS]\n"
+            << "  NAME        shared memory name, e.g. /bpm-finder-result\n"
+            << "  --interval  milliseconds between two polls (default: 16)\n";
+        return 1;
+    }
+
+    const std::string name = argv[1];
+    auto interval = std::chrono::milliseconds(16);
+    if (argc >= 4 && std::string(argv[2]) == "--interval")
+    {
+        interval = std::chrono::milliseconds(std::stoi(argv[3]));
+    }
+
+    // The analysis may not have created the block yet
+    bpmfinder::ipc::SharedResultBlockReader reader;
+    while (running && !reader.Open(name))
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+
+    uint64_t version = 0;
+    bool stale = false;
+    while (running)
+    {
+        const bool closed = reader.IsClosed(); // Before the read, so the last estimate is not missed
+        if (const uint64_t latest = reader.GetVersion(); latest != version)
+        {
+            // Not read means the writer was publishing all the time, the version is kept so the next poll tries again
+            if (const auto snapshot = reader.Read())
+            {
+                version = latest;
+                stale = false;
+                const auto age = std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now() - snapshot->GetTimestamp());
+                std::printf("BPM %6.1f  confidence %4.2f  chunk %8llu  age %lld us\n", snapshot->bpm,
+                            snapshot->confidence, static_cast<unsigned long long>(snapshot->chunkIndex),
+                            static_cast<long long>(age.count()));
+                std::fflush(stdout);
+            }
+            else if (!stale)
+            {
+                stale = true;
+                std::cout << "Estimate is stale: the analysis has not finished publishing the next one" << std::endl;
+            }
+        }
+        if (closed)
+        {
+            std::cout << "Analysis ended" << std::endl;
+            break;
+        }
+        std::this_thread::sleep_for(interval);
+    }
+    return 0;
+}